@@ -1,16 +1,33 @@
 #ifndef KATANA_LIBGALOIS_KATANA_GRAPHTOPOLOGY_H_
 #define KATANA_LIBGALOIS_KATANA_GRAPHTOPOLOGY_H_
 
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <typeindex>
 #include <utility>
 #include <vector>
 
+#include <arrow/type_fwd.h>
 #include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/filter_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 
 #include "katana/DynamicBitset.h"
 #include "katana/Iterators.h"
 #include "katana/NUMAArray.h"
+#include "katana/Result.h"
 #include "katana/config.h"
 
+namespace tsuba {
+class CompressedCSRView;
+class RDG;
+}  // namespace tsuba
+
 namespace katana {
 
 class KATANA_EXPORT PropertyGraph;
@@ -23,7 +40,15 @@ class KATANA_EXPORT PropertyGraph;
 
 /// Types used by all topologies
 struct KATANA_EXPORT GraphTopologyTypes {
+  /// Node ids are 32 bits unless the build sets KATANA_NODE_ID_64. The
+  /// compact default halves the size of the edge destination array, which
+  /// dominates topology memory and traversal bandwidth, but limits graphs to
+  /// 2^32 nodes.
+#ifdef KATANA_NODE_ID_64
+  using Node = uint64_t;
+#else
   using Node = uint32_t;
+#endif
   using Edge = uint64_t;
   using PropertyIndex = uint64_t;
   using EntityType = uint8_t;
@@ -41,6 +66,7 @@ struct KATANA_EXPORT GraphTopologyTypes {
 
 class KATANA_EXPORT EdgeShuffleTopology;
 class KATANA_EXPORT EdgeTypeAwareTopology;
+class KATANA_EXPORT PGViewCache;
 class KATANA_EXPORT ProjectedTypeTopology;
 
 /// A graph topology represents the adjacency information for a graph in CSR
@@ -63,6 +89,28 @@ public:
 
   static GraphTopology Copy(const GraphTopology& that) noexcept;
 
+  /// Build a topology that borrows its CSR arrays instead of copying them,
+  /// e.g., from a read-only mapping of a topology file. The topology holds
+  /// owner, if given, for as long as it borrows the arrays; otherwise the
+  /// arrays must stay valid for the life of the topology. The arrays must
+  /// not be modified. They are copied into private memory only when
+  /// something needs to modify them (MakeMutable).
+  static GraphTopology MakeBorrowed(
+      const Edge* adj_indices, size_t num_nodes, const Node* dests,
+      size_t num_edges, std::shared_ptr<const void> owner = nullptr) noexcept;
+
+  /// @returns true if the CSR arrays are borrowed rather than owned
+  bool is_borrowed() const noexcept { return borrowed_; }
+
+  /// Replace borrowed CSR arrays with private copies that may be modified.
+  /// Does nothing if this topology already owns its arrays.
+  void MakeMutable() noexcept;
+
+  /// Touch the pages of borrowed CSR arrays from all active threads in
+  /// round-robin order so that pages that are not resident yet get spread
+  /// across NUMA nodes. Owned arrays are already allocated interleaved.
+  void PageInInterleaved() const noexcept;
+
   uint64_t num_nodes() const noexcept { return adj_indices_.size(); }
 
   uint64_t num_edges() const noexcept { return dests_.size(); }
@@ -175,11 +223,21 @@ private:
   friend class EdgeShuffleTopology;
   friend class EdgeTypeAwareTopology;
 
-  NUMAArray<Edge>& GetAdjIndices() noexcept { return adj_indices_; }
-  NUMAArray<Node>& GetDests() noexcept { return dests_; }
+  // The arrays returned may be modified, so borrowed arrays are copied first
+  NUMAArray<Edge>& GetAdjIndices() noexcept {
+    MakeMutable();
+    return adj_indices_;
+  }
+  NUMAArray<Node>& GetDests() noexcept {
+    MakeMutable();
+    return dests_;
+  }
 
   NUMAArray<Edge> adj_indices_;
   NUMAArray<Node> dests_;
+  bool borrowed_{false};
+  /// Keeps borrowed arrays alive, see MakeBorrowed
+  std::shared_ptr<const void> borrowed_owner_;
 };
 
 // TODO(amber): In the future, when we group properties e.g., by node or edge type,
@@ -309,6 +367,9 @@ protected:
   }
 
 private:
+  // need access to the raw arrays to load and persist derived topologies
+  friend class PGViewCache;
+
   bool is_valid_ = true;
   TransposeKind tpose_state_ = TransposeKind::kNo;
   EdgeSortKind edge_sort_state_ = EdgeSortKind::kAny;
@@ -325,10 +386,22 @@ class KATANA_EXPORT ShuffleTopology : public EdgeShuffleTopology {
   using Base = EdgeShuffleTopology;
 
 public:
+  /// Values are persisted with derived topologies; only append new kinds.
   enum class NodeSortKind : int {
     kAny = 0,
     kSortedByDegree,
     kSortedByNodeType,
+    /// Reverse Cuthill-McKee: breadth-first order, see
+    /// katana::ReverseCuthillMcKeeOrder
+    kReverseCuthillMcKee,
+    /// Hubs first in descending order of degree, see katana::HubSortOrder
+    kHubSorted,
+    /// Hubs first in their original order, see katana::HubClusterOrder
+    kHubClustered,
+    /// Greedy window ordering, see katana::GorderOrder
+    kGorder,
+    /// Community ordering, see katana::RabbitOrder
+    kRabbitOrder,
   };
 
   PropertyIndex node_property_index(const Node& nid) const noexcept {
@@ -352,6 +425,12 @@ public:
   static std::unique_ptr<ShuffleTopology> MakeSortedByNodeType(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo) noexcept;
 
+  /// Renumber nodes to improve the locality of traversals, using one of the
+  /// orderings in katana/NodeOrdering.h
+  static std::unique_ptr<ShuffleTopology> MakeReorderedForLocality(
+      const EdgeShuffleTopology& seed_topo,
+      const NodeSortKind& node_sort_todo) noexcept;
+
   static std::unique_ptr<ShuffleTopology> MakeFromTopo(
       const PropertyGraph* pg, const EdgeShuffleTopology& seed_topo,
       const NodeSortKind& node_sort_todo,
@@ -368,6 +447,13 @@ public:
     case NodeSortKind::kSortedByNodeType:
       ret = MakeSortedByNodeType(pg, seed_topo);
       break;
+    case NodeSortKind::kReverseCuthillMcKee:
+    case NodeSortKind::kHubSorted:
+    case NodeSortKind::kHubClustered:
+    case NodeSortKind::kGorder:
+    case NodeSortKind::kRabbitOrder:
+      ret = MakeReorderedForLocality(seed_topo, node_sort_todo);
+      break;
     default:
       KATANA_LOG_FATAL("switch case fell through");
     }
@@ -378,6 +464,9 @@ public:
   }
 
 private:
+  // need access to the raw arrays to load and persist derived topologies
+  friend class PGViewCache;
+
   template <typename CmpFunc>
   static std::unique_ptr<ShuffleTopology> MakeNodeSortedTopo(
       const EdgeShuffleTopology& seed_topo, const CmpFunc& cmp,
@@ -393,63 +482,15 @@ private:
         node_prop_indices.begin(), node_prop_indices.end(),
         [&](const auto& i1, const auto& i2) { return cmp(i1, i2); });
 
-    GraphTopology::AdjIndexVec degrees;
-    degrees.allocateInterleaved(seed_topo.num_nodes());
-
-    katana::NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
-    old_to_new_map.allocateInterleaved(seed_topo.num_nodes());
-    // TODO(amber): given 32-bit node ids, put a check here that
-    // node_prop_indices.size() < 2^32
-    katana::do_all(
-        katana::iterate(size_t{0}, node_prop_indices.size()),
-        [&](auto i) {
-          // node_prop_indices[i] gives old node id
-          old_to_new_map[node_prop_indices[i]] = i;
-          degrees[i] = seed_topo.degree(node_prop_indices[i]);
-        },
-        katana::no_stats());
-
-    KATANA_LOG_DEBUG_ASSERT(std::is_sorted(degrees.begin(), degrees.end()));
-
-    katana::ParallelSTL::partial_sum(
-        degrees.begin(), degrees.end(), degrees.begin());
-
-    GraphTopologyTypes::EdgeDestVec new_dest_vec;
-    new_dest_vec.allocateInterleaved(seed_topo.num_edges());
-
-    GraphTopologyTypes::PropIndexVec edge_prop_indices;
-    edge_prop_indices.allocateInterleaved(seed_topo.num_edges());
-
-    katana::do_all(
-        katana::iterate(seed_topo.all_nodes()),
-        [&](auto old_src_id) {
-          auto new_srd_id = old_to_new_map[old_src_id];
-          auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
-
-          for (auto e : seed_topo.edges(old_src_id)) {
-            auto new_edge_dest = old_to_new_map[seed_topo.edge_dest(e)];
-            KATANA_LOG_DEBUG_ASSERT(new_edge_dest < seed_topo.num_nodes());
-
-            auto new_edge_id = new_out_index;
-            ++new_out_index;
-            KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
-
-            new_dest_vec[new_edge_id] = new_edge_dest;
-
-            // copy over edge_property_index mapping from old edge to new edge
-            edge_prop_indices[new_edge_id] = seed_topo.edge_property_index(e);
-          }
-          KATANA_LOG_DEBUG_ASSERT(new_out_index == degrees[new_srd_id]);
-        },
-        katana::steal(), katana::no_stats());
-
-    return std::make_unique<ShuffleTopology>(ShuffleTopology{
-        seed_topo.transpose_state(), node_sort_todo,
-        seed_topo.edge_sort_state(), std::move(degrees),
-        std::move(node_prop_indices), std::move(new_dest_vec),
-        std::move(edge_prop_indices)});
+    return MakeNodePermutedTopo(
+        seed_topo, std::move(node_prop_indices), node_sort_todo);
   }
 
+  /// \param node_prop_indices the node of seed_topo that becomes each node
+  static std::unique_ptr<ShuffleTopology> MakeNodePermutedTopo(
+      const EdgeShuffleTopology& seed_topo, PropIndexVec&& node_prop_indices,
+      const NodeSortKind& node_sort_todo) noexcept;
+
   ShuffleTopology(
       const TransposeKind& tpose_todo, const NodeSortKind& node_sort_todo,
       const EdgeSortKind& edge_sort_todo, AdjIndexVec&& adj_indices,
@@ -602,6 +643,10 @@ public:
     return topo().original_edge_id(eid);
   }
 
+  /// Identifies the topology this wraps. Wrappers of one type with the same
+  /// topology_id number their nodes and edges the same way.
+  const void* topology_id() const noexcept { return topo_ptr_; }
+
 protected:
   const Topo& topo() const noexcept { return *topo_ptr_; }
 
@@ -625,6 +670,9 @@ public:
 
   uint64_t num_edges() const noexcept { return dests_.size(); }
 
+  /// @returns the memory used by the topology and its node and edge mappings
+  size_t num_bytes() const noexcept;
+
   const Edge* adj_data() const noexcept { return adj_indices_.data(); }
 
   const Node* dest_data() const noexcept { return dests_.data(); }
@@ -750,7 +798,7 @@ public:
 
   /// this function creates an empty graph with num_new_nodes nodes
   static std::unique_ptr<ProjectedTopology> CreateEmptyEdgeProjectedTopology(
-      const katana::PropertyGraph* pg, uint32_t num_new_nodes);
+      const katana::PropertyGraph* pg, Node num_new_nodes);
 
   /// this function creates an empty graph
   static std::unique_ptr<ProjectedTopology> CreateEmptyProjectedTopology(
@@ -785,6 +833,174 @@ private:
   NUMAArray<Edge> projected_to_original_edges_mapping_;
 };
 
+/// Selects nodes and edges of a topology with bit masks instead of copying
+/// them like ProjectedTopology. Node and edge ids, and so property indexes,
+/// are those of the underlying topology; iteration skips the nodes and edges
+/// that are not selected. num_nodes() and num_edges() are the sizes of the id
+/// spaces, e.g., for sizing per node arrays; num_selected_nodes() and
+/// num_selected_edges() count what is selected.
+///
+/// The masks take a bit per node and edge, so building a masked topology is
+/// much cheaper than projecting, but every traversal still pays to skip
+/// unselected elements. See PGViewCache::BuildOrGetFilteredTopo for choosing
+/// between the two.
+class KATANA_EXPORT MaskedTopology : public GraphTopologyTypes {
+  struct IsSelected {
+    const DynamicBitset* mask;
+    bool operator()(uint64_t i) const noexcept { return mask->test(i); }
+  };
+
+public:
+  using masked_node_iterator =
+      boost::filter_iterator<IsSelected, node_iterator>;
+  using masked_edge_iterator =
+      boost::filter_iterator<IsSelected, edge_iterator>;
+  using masked_nodes_range = StandardRange<masked_node_iterator>;
+  using masked_edges_range = StandardRange<masked_edge_iterator>;
+
+  /// Select the nodes of topo set in node_mask and the edges set in
+  /// edge_mask. Every selected edge must connect selected nodes.
+  MaskedTopology(
+      const GraphTopology* topo, std::shared_ptr<DynamicBitset> node_mask,
+      std::shared_ptr<DynamicBitset> edge_mask) noexcept;
+
+  /// Select the nodes with one of node_types and the edges between them with
+  /// one of edge_types, like ProjectedTopology::MakeTypeProjectedTopology
+  static MaskedTopology MakeTypeMasked(
+      const PropertyGraph* pg, const std::vector<std::string>& node_types,
+      const std::vector<std::string>& edge_types) noexcept;
+
+  uint64_t num_nodes() const noexcept { return topo_->num_nodes(); }
+
+  uint64_t num_edges() const noexcept { return topo_->num_edges(); }
+
+  uint64_t num_selected_nodes() const noexcept { return num_selected_nodes_; }
+
+  uint64_t num_selected_edges() const noexcept { return num_selected_edges_; }
+
+  bool is_selected_node(Node node) const noexcept {
+    return node_mask_->test(node);
+  }
+
+  bool is_selected_edge(Edge edge) const noexcept {
+    return edge_mask_->test(edge);
+  }
+
+  /// @returns the fraction of edges that are selected
+  double selectivity() const noexcept {
+    return num_edges() == 0 ? 1.0
+                            : static_cast<double>(num_selected_edges_) /
+                                  static_cast<double>(num_edges());
+  }
+
+  /// @returns the memory used by the masks
+  size_t num_bytes() const noexcept {
+    return (num_nodes() + num_edges() + 7) / 8;
+  }
+
+  /// Gets the selected edges of some node.
+  ///
+  /// \param node node to get the edge range of
+  /// \returns iterable edge range for node.
+  masked_edges_range edges(Node node) const noexcept {
+    auto all = topo_->edges(node);
+    IsSelected pred{edge_mask_.get()};
+    return MakeStandardRange(
+        masked_edge_iterator(pred, all.begin(), all.end()),
+        masked_edge_iterator(pred, all.end(), all.end()));
+  }
+
+  Node edge_dest(Edge edge_id) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(is_selected_edge(edge_id));
+    return topo_->edge_dest(edge_id);
+  }
+
+  Node edge_source(Edge edge_id) const noexcept {
+    return topo_->edge_source(edge_id);
+  }
+
+  ///@param node node to get degree for
+  ///@returns the number of selected edges of node
+  size_t degree(Node node) const noexcept {
+    auto range = edges(node);
+    return std::distance(range.begin(), range.end());
+  }
+
+  masked_nodes_range nodes(Node begin, Node end) const noexcept {
+    IsSelected pred{node_mask_.get()};
+    return MakeStandardRange(
+        masked_node_iterator(pred, node_iterator(begin), node_iterator(end)),
+        masked_node_iterator(pred, node_iterator(end), node_iterator(end)));
+  }
+
+  masked_nodes_range all_nodes() const noexcept {
+    return nodes(Node{0}, static_cast<Node>(num_nodes()));
+  }
+
+  // Standard container concepts
+
+  masked_node_iterator begin() const noexcept { return all_nodes().begin(); }
+
+  masked_node_iterator end() const noexcept { return all_nodes().end(); }
+
+  size_t size() const noexcept { return num_nodes(); }
+
+  bool empty() const noexcept { return num_selected_nodes_ == 0; }
+
+  PropertyIndex edge_property_index(const Edge& eid) const noexcept {
+    return eid;
+  }
+
+  PropertyIndex node_property_index(const Node& nid) const noexcept {
+    return nid;
+  }
+
+  /// Identifies the underlying topology, whose ids a masked topology keeps,
+  /// see BasicTopologyWrapper::topology_id
+  const void* topology_id() const noexcept { return topo_; }
+
+private:
+  const GraphTopology* topo_;
+  std::shared_ptr<DynamicBitset> node_mask_;
+  std::shared_ptr<DynamicBitset> edge_mask_;
+  uint64_t num_selected_nodes_;
+  uint64_t num_selected_edges_;
+};
+
+/// A type filtered topology of a graph, either a MaskedTopology or a
+/// ProjectedTopology, see PGViewCache::BuildOrGetFilteredTopo. Both map
+/// their nodes and edges to the graph's properties with node_property_index
+/// and edge_property_index, so code that is generic over the topology type
+/// runs on either through Visit.
+class KATANA_EXPORT FilteredTopology {
+public:
+  explicit FilteredTopology(MaskedTopology masked) noexcept
+      : masked_(std::move(masked)) {}
+
+  explicit FilteredTopology(
+      std::shared_ptr<ProjectedTopology> projected) noexcept
+      : projected_(std::move(projected)) {}
+
+  bool is_masked() const noexcept { return masked_.has_value(); }
+
+  const MaskedTopology& masked() const noexcept { return *masked_; }
+
+  const ProjectedTopology& projected() const noexcept { return *projected_; }
+
+  /// Call fn with the topology, as a MaskedTopology or a ProjectedTopology
+  template <typename Fn>
+  decltype(auto) Visit(Fn&& fn) const {
+    if (is_masked()) {
+      return fn(masked());
+    }
+    return fn(projected());
+  }
+
+private:
+  std::optional<MaskedTopology> masked_;
+  std::shared_ptr<ProjectedTopology> projected_;
+};
+
 template <typename Topo>
 class KATANA_EXPORT ProjectedTopologyWrapper : public GraphTopologyTypes {
 public:
@@ -1144,6 +1360,12 @@ public:
   auto find_edges(const Node& src, const Node& dst) const noexcept {
     return Base::topo().find_edges(src, dst);
   }
+
+  /// @returns the destinations of the edges of node, in increasing order, as
+  /// an array of degree(node) elements for the kernels of SetIntersection.h
+  const Node* sorted_dests(const Node& node) const noexcept {
+    return Base::topo().dest_data() + *Base::topo().edges(node).begin();
+  }
 };
 
 using EdgesSortedByDestTopology = SortedTopologyWrapper<EdgeShuffleTopology>;
@@ -1151,6 +1373,101 @@ using EdgesSortedByDestTopology = SortedTopologyWrapper<EdgeShuffleTopology>;
 using NodesSortedByDegreeEdgesSortedByDestIDTopology =
     SortedTopologyWrapper<ShuffleTopology>;
 
+using NodesReorderedTopology = BasicTopologyWrapper<ShuffleTopology>;
+
+/// An index for edge membership queries on a topology whose edges are sorted
+/// by destination. Nodes with at least hash_degree edges get an open
+/// addressing hash set of their destinations, so a query on a hub costs
+/// about one cache miss however many neighbors it has. Other nodes are
+/// searched in their sorted edges, which is as fast for short lists and
+/// takes no extra memory.
+class KATANA_EXPORT EdgeMembershipIndex : public GraphTopologyTypes {
+public:
+  /// Default degree from which nodes get a hash set
+  static constexpr uint64_t kDefaultHashDegree = 256;
+
+  EdgeMembershipIndex() = default;
+  EdgeMembershipIndex(EdgeMembershipIndex&&) = default;
+  EdgeMembershipIndex& operator=(EdgeMembershipIndex&&) = default;
+
+  EdgeMembershipIndex(const EdgeMembershipIndex&) = delete;
+  EdgeMembershipIndex& operator=(const EdgeMembershipIndex&) = delete;
+
+  /// Build the index of topo in parallel. The index refers to topo, which
+  /// must outlive it.
+  static EdgeMembershipIndex Make(
+      const EdgeShuffleTopology* topo,
+      uint64_t hash_degree = kDefaultHashDegree) noexcept;
+
+  bool has_edge(Node src, Node dst) const noexcept {
+    uint64_t begin = src > 0 ? table_ends_[src - 1] : 0;
+    uint64_t capacity = table_ends_[src] - begin;
+    if (capacity == 0) {
+      return topo_->has_edge(src, dst);
+    }
+    // Capacities are powers of two and tables are at most half full
+    uint64_t mask = capacity - 1;
+    for (uint64_t slot = Hash(dst) & mask;; slot = (slot + 1) & mask) {
+      Node entry = slots_[begin + slot];
+      if (entry == dst) {
+        return true;
+      }
+      if (entry == kEmptySlot) {
+        return false;
+      }
+    }
+  }
+
+  const EdgeShuffleTopology* topology() const noexcept { return topo_; }
+
+  uint64_t hash_degree() const noexcept { return hash_degree_; }
+
+  /// The number of bytes of the hash sets and their offsets
+  size_t size_bytes() const noexcept {
+    return table_ends_.size() * sizeof(uint64_t) + slots_.size() * sizeof(Node);
+  }
+
+private:
+  static constexpr Node kEmptySlot = std::numeric_limits<Node>::max();
+
+  static uint64_t Hash(uint64_t x) noexcept {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+  }
+
+  const EdgeShuffleTopology* topo_{nullptr};
+  uint64_t hash_degree_{kDefaultHashDegree};
+  /// table_ends_[n] is the end of the hash set of n in slots_
+  NUMAArray<uint64_t> table_ends_;
+  NUMAArray<Node> slots_;
+};
+
+/// A topology sorted by destination whose edge membership queries go through
+/// an EdgeMembershipIndex
+class EdgesSortedByDestIndexedTopology : public EdgesSortedByDestTopology {
+  using Base = EdgesSortedByDestTopology;
+
+public:
+  EdgesSortedByDestIndexedTopology(
+      const EdgeShuffleTopology* t, const EdgeMembershipIndex* index) noexcept
+      : Base(t), index_(index) {
+    KATANA_LOG_DEBUG_ASSERT(index->topology() == t);
+  }
+
+  bool has_edge(const Node& src, const Node& dst) const noexcept {
+    return index_->has_edge(src, dst);
+  }
+
+  auto find_edge(const Node& src, const Node& dst) const noexcept {
+    return has_edge(src, dst) ? Base::find_edge(src, dst) : edges(src).end();
+  }
+
+private:
+  const EdgeMembershipIndex* index_;
+};
+
 class KATANA_EXPORT EdgeTypeAwareBiDirTopology
     : public BasicBiDirTopoWrapper<
           EdgeTypeAwareTopology, EdgeTypeAwareTopology> {
@@ -1263,6 +1580,350 @@ public:
   }
 };
 
+/// A topology that stores edge destinations compressed, for graphs whose CSR
+/// barely fits in memory. The destinations of each node are delta coded, the
+/// first relative to the node and the rest relative to the previous
+/// destination, and stored as zigzag variable-byte codes of 7 bits per byte
+/// as in Ligra+. Nodes and edges keep the ids (and so the properties) they
+/// have in the topology the compressed topology is made from. A destination
+/// takes one or two bytes instead of sizeof(Node) when the edges of each node
+/// are sorted by destination and neighbors have nearby ids, e.g., after a
+/// locality ordering (see NodeOrdering.h).
+///
+/// Destinations can only be decoded in order, so edges are Edge handles that
+/// carry their destination: edges() decodes as it iterates and edge_dest is
+/// free. Loops that only need destinations should use ForEachNeighbor, which
+/// decodes without the bookkeeping of an iterator.
+class KATANA_EXPORT CompressedTopology : public GraphTopologyTypes {
+public:
+  /// An edge id together with its destination. Converts to the edge id.
+  struct Edge {
+    GraphTopologyTypes::Edge id;
+    Node dest;
+
+    operator GraphTopologyTypes::Edge() const noexcept { return id; }
+  };
+
+  /// Iterates over edges in order of id, decoding their destinations
+  class edge_iterator
+      : public boost::iterator_facade<
+            edge_iterator, Edge, std::forward_iterator_tag, Edge> {
+  public:
+    edge_iterator() = default;
+
+    /// An iterator to the edge with id edge, the first edge of node src (or
+    /// the end of the edges of src), whose code starts at bytes
+    edge_iterator(
+        const GraphTopologyTypes::Edge* adj_indices, const uint8_t* bytes,
+        Node src, GraphTopologyTypes::Edge edge,
+        GraphTopologyTypes::Edge end) noexcept
+        : adj_indices_(adj_indices),
+          bytes_(bytes),
+          src_(src),
+          edge_{edge, src},
+          end_(end) {
+      if (edge_.id != end_) {
+        SkipEmptyNodes();
+        edge_.dest = src_ + DecodeDelta(&bytes_);
+      }
+    }
+
+  private:
+    friend class boost::iterator_core_access;
+
+    Edge dereference() const noexcept { return edge_; }
+
+    bool equal(const edge_iterator& that) const noexcept {
+      return edge_.id == that.edge_.id;
+    }
+
+    void increment() noexcept {
+      ++edge_.id;
+      if (edge_.id == end_) {
+        return;
+      }
+      if (edge_.id == adj_indices_[src_]) {
+        SkipEmptyNodes();
+        edge_.dest = src_;
+      }
+      edge_.dest += DecodeDelta(&bytes_);
+    }
+
+    /// Move src_ to the node that edge_ belongs to
+    void SkipEmptyNodes() noexcept {
+      while (adj_indices_[src_] == edge_.id) {
+        ++src_;
+      }
+    }
+
+    const GraphTopologyTypes::Edge* adj_indices_{nullptr};
+    const uint8_t* bytes_{nullptr};
+    Node src_{0};
+    Edge edge_{0, 0};
+    GraphTopologyTypes::Edge end_{0};
+  };
+
+  using edges_range = StandardRange<edge_iterator>;
+
+  CompressedTopology() = default;
+  CompressedTopology(CompressedTopology&&) = default;
+  CompressedTopology& operator=(CompressedTopology&&) = default;
+
+  CompressedTopology(const CompressedTopology&) = delete;
+  CompressedTopology& operator=(const CompressedTopology&) = delete;
+
+  /// Compress topo. Edge e of the result is edge e of topo.
+  static CompressedTopology Make(const GraphTopology& topo) noexcept;
+
+  /// Build the compressed topology of a compressed topology file without
+  /// materializing its CSR. Blocks of the file are decoded one at a time
+  /// into a buffer of their edges and encoded from there.
+  static Result<CompressedTopology> Make(
+      const tsuba::CompressedCSRView& view) noexcept;
+
+  /// Decode the topology into CSR form. Edge e of the result is edge e of
+  /// this topology.
+  GraphTopology Decompress() const noexcept;
+
+  uint64_t num_nodes() const noexcept { return adj_indices_.size(); }
+
+  uint64_t num_edges() const noexcept {
+    return adj_indices_.empty() ? 0 : adj_indices_[num_nodes() - 1];
+  }
+
+  /// @returns the number of bytes used by the topology
+  size_t size_bytes() const noexcept {
+    return adj_indices_.size() * sizeof(GraphTopologyTypes::Edge) +
+           byte_offsets_.size() * sizeof(uint64_t) + bytes_.size();
+  }
+
+  /// Gets the edge range of some node.
+  ///
+  /// \param node node to get the edge range of
+  /// \returns iterable edge range for node.
+  edges_range edges(Node node) const noexcept {
+    KATANA_LOG_DEBUG_ASSERT(node < num_nodes());
+    auto e_end = adj_indices_[node];
+    return MakeStandardRange(
+        edge_iterator(
+            adj_indices_.data(), node_bytes(node), node, edge_begin(node),
+            e_end),
+        edge_iterator(
+            adj_indices_.data(), nullptr, node, e_end, e_end));
+  }
+
+  edges_range all_edges() const noexcept {
+    auto e_end = num_edges();
+    return MakeStandardRange(
+        edge_iterator(adj_indices_.data(), bytes_.data(), 0, 0, e_end),
+        edge_iterator(adj_indices_.data(), nullptr, 0, e_end, e_end));
+  }
+
+  Node edge_dest(const Edge& edge) const noexcept { return edge.dest; }
+
+  Node edge_source(const Edge& edge) const noexcept {
+    auto it = std::upper_bound(
+        adj_indices_.begin(), adj_indices_.end(), edge.id);
+    KATANA_LOG_DEBUG_ASSERT(it != adj_indices_.end());
+    return static_cast<Node>(std::distance(adj_indices_.begin(), it));
+  }
+
+  /// Call fn(dest) for the destination of each edge of node in order. This
+  /// is the decode loop to use for push and pull loops that do not need
+  /// edge ids.
+  template <typename F>
+  void ForEachNeighbor(Node node, F fn) const noexcept {
+    const uint8_t* bytes = node_bytes(node);
+    Node dest = node;
+    for (auto n = degree(node); n > 0; --n) {
+      dest += DecodeDelta(&bytes);
+      fn(dest);
+    }
+  }
+
+  /// Like ForEachNeighbor but stop after the first destination for which fn
+  /// returns true, e.g., once a pull loop has found a parent.
+  /// @returns true if fn returned true
+  template <typename F>
+  bool ForEachNeighborUntil(Node node, F fn) const noexcept {
+    const uint8_t* bytes = node_bytes(node);
+    Node dest = node;
+    for (auto n = degree(node); n > 0; --n) {
+      dest += DecodeDelta(&bytes);
+      if (fn(dest)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Decode the destinations of node into out, which must have room for
+  /// degree(node) of them
+  /// @returns the degree of node
+  size_t DecodeNeighbors(Node node, Node* out) const noexcept {
+    size_t i = 0;
+    ForEachNeighbor(node, [&](Node dest) { out[i++] = dest; });
+    return i;
+  }
+
+  nodes_range nodes(Node begin, Node end) const noexcept {
+    return MakeStandardRange<node_iterator>(begin, end);
+  }
+
+  nodes_range all_nodes() const noexcept {
+    return nodes(Node{0}, static_cast<Node>(num_nodes()));
+  }
+
+  // Standard container concepts
+
+  node_iterator begin() const noexcept { return node_iterator(0); }
+
+  node_iterator end() const noexcept { return node_iterator(num_nodes()); }
+
+  size_t size() const noexcept { return num_nodes(); }
+
+  bool empty() const noexcept { return num_nodes() == 0; }
+
+  ///@param node node to get degree for
+  ///@returns Degree of node N
+  size_t degree(Node node) const noexcept {
+    return adj_indices_[node] - edge_begin(node);
+  }
+
+  PropertyIndex edge_property_index(const Edge& edge) const noexcept {
+    return edge.id;
+  }
+
+  PropertyIndex node_property_index(const Node& nid) const noexcept {
+    return nid;
+  }
+
+  Node original_node_id(const Node& nid) const noexcept { return nid; }
+
+  GraphTopologyTypes::Edge original_edge_id(const Edge& edge) const noexcept {
+    return edge.id;
+  }
+
+  /// Decode a zigzag variable-byte code at *bytes and advance *bytes past it
+  static Node DecodeDelta(const uint8_t** bytes) noexcept {
+    const uint8_t* p = *bytes;
+    uint64_t code = *p++;
+    if (code >= 0x80) {
+      code &= 0x7f;
+      for (int shift = 7;; shift += 7) {
+        uint64_t byte = *p++;
+        code |= (byte & 0x7f) << shift;
+        if (byte < 0x80) {
+          break;
+        }
+      }
+    }
+    *bytes = p;
+    // Undo zigzag; unsigned wraparound makes negative deltas work
+    return static_cast<Node>((code >> 1) ^ (~(code & 1) + 1));
+  }
+
+private:
+  GraphTopologyTypes::Edge edge_begin(Node node) const noexcept {
+    return node > 0 ? adj_indices_[node - 1] : 0;
+  }
+
+  const uint8_t* node_bytes(Node node) const noexcept {
+    return bytes_.data() + (node > 0 ? byte_offsets_[node - 1] : 0);
+  }
+
+  /// adj_indices_[n] is the end of the edges of n, as in GraphTopology
+  NUMAArray<GraphTopologyTypes::Edge> adj_indices_;
+  /// byte_offsets_[n] is the end of the code of the edges of n in bytes_
+  NUMAArray<uint64_t> byte_offsets_;
+  NUMAArray<uint8_t> bytes_;
+};
+
+/// A view of a CompressedTopology. The view shares ownership of the
+/// topology, so it stays valid after the view cache drops the topology.
+class KATANA_EXPORT CompressedTopologyWrapper : public GraphTopologyTypes {
+public:
+  using Edge = CompressedTopology::Edge;
+  using edge_iterator = CompressedTopology::edge_iterator;
+  using edges_range = CompressedTopology::edges_range;
+
+  explicit CompressedTopologyWrapper(
+      std::shared_ptr<const CompressedTopology> t) noexcept
+      : topo_ptr_(std::move(t)) {
+    KATANA_LOG_DEBUG_ASSERT(topo_ptr_);
+  }
+
+  auto num_nodes() const noexcept { return topo().num_nodes(); }
+
+  auto num_edges() const noexcept { return topo().num_edges(); }
+
+  auto edges(const Node& node) const noexcept { return topo().edges(node); }
+
+  auto edge_dest(const Edge& edge) const noexcept {
+    return topo().edge_dest(edge);
+  }
+
+  auto edge_source(const Edge& edge) const noexcept {
+    return topo().edge_source(edge);
+  }
+
+  auto degree(const Node& node) const noexcept { return topo().degree(node); }
+
+  template <typename F>
+  void ForEachNeighbor(const Node& node, F fn) const noexcept {
+    topo().ForEachNeighbor(node, fn);
+  }
+
+  template <typename F>
+  bool ForEachNeighborUntil(const Node& node, F fn) const noexcept {
+    return topo().ForEachNeighborUntil(node, fn);
+  }
+
+  auto nodes(const Node& begin, const Node& end) const noexcept {
+    return topo().nodes(begin, end);
+  }
+
+  auto all_nodes() const noexcept { return topo().all_nodes(); }
+
+  auto all_edges() const noexcept { return topo().all_edges(); }
+
+  // Standard container concepts
+
+  auto begin() const noexcept { return topo().begin(); }
+
+  auto end() const noexcept { return topo().end(); }
+
+  auto size() const noexcept { return topo().size(); }
+
+  auto empty() const noexcept { return topo().empty(); }
+
+  auto edge_property_index(const Edge& edge) const noexcept {
+    return topo().edge_property_index(edge);
+  }
+
+  auto node_property_index(const Node& nid) const noexcept {
+    return topo().node_property_index(nid);
+  }
+
+  auto original_node_id(const Node& nid) const noexcept {
+    return topo().original_node_id(nid);
+  }
+
+  auto original_edge_id(const Edge& edge) const noexcept {
+    return topo().original_edge_id(edge);
+  }
+
+  /// Identifies the topology this wraps, see
+  /// BasicTopologyWrapper::topology_id
+  const void* topology_id() const noexcept { return topo_ptr_.get(); }
+
+protected:
+  const CompressedTopology& topo() const noexcept { return *topo_ptr_; }
+
+private:
+  std::shared_ptr<const CompressedTopology> topo_ptr_;
+};
+
 template <typename Topo>
 class BasicPropGraphViewWrapper : public Topo {
   using Base = Topo;
@@ -1281,12 +1942,18 @@ private:
 namespace internal {
 using PGViewEdgesSortedByDestID =
     BasicPropGraphViewWrapper<EdgesSortedByDestTopology>;
+using PGViewEdgesSortedByDestIDIndexed =
+    BasicPropGraphViewWrapper<EdgesSortedByDestIndexedTopology>;
 using PGViewNodesSortedByDegreeEdgesSortedByDestID =
     BasicPropGraphViewWrapper<NodesSortedByDegreeEdgesSortedByDestIDTopology>;
 using PGViewBiDirectional = BasicPropGraphViewWrapper<SimpleBiDirTopology>;
 using PGViewEdgeTypeAwareBiDir =
     BasicPropGraphViewWrapper<EdgeTypeAwareBiDirTopology>;
 using PGViewProjectedGraph = BasicPropGraphViewWrapper<ProjectedTopology>;
+using PGViewMaskedGraph = BasicPropGraphViewWrapper<MaskedTopology>;
+using PGViewNodesReordered =
+    BasicPropGraphViewWrapper<NodesReorderedTopology>;
+using PGViewCompressed = BasicPropGraphViewWrapper<CompressedTopologyWrapper>;
 
 template <typename PGView>
 struct PGViewBuilder {};
@@ -1320,6 +1987,21 @@ struct PGViewBuilder<PGViewEdgesSortedByDestID> {
   }
 };
 
+template <>
+struct PGViewBuilder<PGViewEdgesSortedByDestIDIndexed> {
+  template <typename ViewCache>
+  static PGViewEdgesSortedByDestIDIndexed BuildView(
+      const PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto sorted_topo = viewCache.BuildOrGetEdgeShuffTopo(
+        pg, EdgeShuffleTopology::TransposeKind::kNo,
+        EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
+    auto index = viewCache.BuildOrGetMembershipIndex(sorted_topo);
+
+    return PGViewEdgesSortedByDestIDIndexed{
+        pg, EdgesSortedByDestIndexedTopology{sorted_topo, index}};
+  }
+};
+
 template <>
 struct PGViewBuilder<PGViewNodesSortedByDegreeEdgesSortedByDestID> {
   template <typename ViewCache>
@@ -1335,6 +2017,31 @@ struct PGViewBuilder<PGViewNodesSortedByDegreeEdgesSortedByDestID> {
   }
 };
 
+template <>
+struct PGViewBuilder<PGViewNodesReordered> {
+  template <typename ViewCache>
+  static PGViewNodesReordered BuildView(
+      const PropertyGraph* pg, ViewCache& viewCache,
+      const ShuffleTopology::NodeSortKind& node_sort_todo) noexcept {
+    auto reordered_topo = viewCache.BuildOrGetShuffTopo(
+        pg, EdgeShuffleTopology::TransposeKind::kNo, node_sort_todo,
+        EdgeShuffleTopology::EdgeSortKind::kAny);
+
+    return PGViewNodesReordered{pg, NodesReorderedTopology{reordered_topo}};
+  }
+};
+
+template <>
+struct PGViewBuilder<PGViewCompressed> {
+  template <typename ViewCache>
+  static PGViewCompressed BuildView(
+      const PropertyGraph* pg, ViewCache& viewCache) noexcept {
+    auto compressed_topo = viewCache.BuildOrGetCompressedTopo(pg);
+
+    return PGViewCompressed{pg, CompressedTopologyWrapper{compressed_topo}};
+  }
+};
+
 template <>
 struct PGViewBuilder<PGViewEdgeTypeAwareBiDir> {
   template <typename ViewCache>
@@ -1361,40 +2068,194 @@ struct PGViewBuilder<PGViewProjectedGraph> {
   }
 };
 
+template <>
+struct PGViewBuilder<PGViewMaskedGraph> {
+  template <typename ViewCache>
+  static PGViewMaskedGraph BuildView(
+      const PropertyGraph* pg, ViewCache&,
+      const std::vector<std::string>& node_types,
+      const std::vector<std::string>& edge_types) noexcept {
+    return PGViewMaskedGraph{
+        pg, MaskedTopology::MakeTypeMasked(pg, node_types, edge_types)};
+  }
+};
+
 }  // end namespace internal
 
 struct PropertyGraphViews {
   using BiDirectional = internal::PGViewBiDirectional;
   using EdgesSortedByDestID = internal::PGViewEdgesSortedByDestID;
+  /// EdgesSortedByDestID with fast has_edge, see EdgeMembershipIndex
+  using EdgesSortedByDestIDIndexed = internal::PGViewEdgesSortedByDestIDIndexed;
   using EdgeTypeAwareBiDir = internal::PGViewEdgeTypeAwareBiDir;
   using NodesSortedByDegreeEdgesSortedByDestID =
       internal::PGViewNodesSortedByDegreeEdgesSortedByDestID;
   using ProjectedGraph = internal::PGViewProjectedGraph;
+  using MaskedGraph = internal::PGViewMaskedGraph;
+  using NodesReordered = internal::PGViewNodesReordered;
+  using Compressed = internal::PGViewCompressed;
 };
 
+/// Caches the topologies and property copies that views of a PropertyGraph
+/// are built from. Projected topologies and permuted properties may be
+/// requested concurrently, e.g., by tenants sharing a graph; building the
+/// other topologies and dropping them must not run concurrently with any
+/// other use of the cache.
 class KATANA_EXPORT PGViewCache {
   std::vector<std::unique_ptr<EdgeShuffleTopology>> edge_shuff_topos_;
   std::vector<std::unique_ptr<ShuffleTopology>> fully_shuff_topos_;
   std::vector<std::unique_ptr<EdgeTypeAwareTopology>> edge_type_aware_topos_;
   std::unique_ptr<CondensedTypeIDMap> edge_type_id_map_;
+  std::shared_ptr<const CompressedTopology> compressed_topo_;
+  std::unique_ptr<EdgeMembershipIndex> membership_index_;
   // TODO(amber): define a node_type_id_map_;
-  std::unique_ptr<ProjectedTopology> projected_topos_;
+
+  /// A projected topology and the (sorted, unique) types that select it
+  struct ProjectedTopologyEntry {
+    std::vector<std::string> node_types;
+    std::vector<std::string> edge_types;
+    std::shared_ptr<ProjectedTopology> topo;
+  };
+  /// Cached projected topologies, most recently used first
+  std::list<ProjectedTopologyEntry> projected_topos_;
+  size_t projected_topos_bytes_{0};
+  size_t projected_topos_budget_;
+
+  /// A copy of a property in the order of the nodes or edges of a view.
+  /// Views of one type can have different orders (e.g., nodes reordered by
+  /// different sorts), so copies are keyed by the topology the view reads as
+  /// well, see BasicTopologyWrapper::topology_id.
+  struct PermutedPropertyEntry {
+    bool is_node;
+    std::type_index view_type;
+    const void* topology_id;
+    std::string name;
+    std::shared_ptr<arrow::Array> array;
+    size_t num_bytes;
+  };
+  /// Cached permuted copies, most recently used first
+  std::list<PermutedPropertyEntry> permuted_props_;
+  size_t permuted_props_bytes_{0};
+  size_t permuted_props_budget_;
+
+  /// Guards projected_topos_ and permuted_props_ and their byte counts and
+  /// budgets. Held by pointer so that the cache stays movable.
+  std::unique_ptr<std::mutex> lru_mutex_{std::make_unique<std::mutex>()};
 
   template <typename>
   friend struct internal::PGViewBuilder;
 
 public:
-  PGViewCache() = default;
+  PGViewCache();
   PGViewCache(PGViewCache&&) = default;
   PGViewCache& operator=(PGViewCache&&) = default;
 
   PGViewCache(const PGViewCache&) = delete;
   PGViewCache& operator=(const PGViewCache&) = delete;
 
-  template <typename PGView>
-  PGView BuildView(const PropertyGraph* pg) noexcept {
-    return internal::PGViewBuilder<PGView>::BuildView(pg, *this);
-  }
+  /// Build a view of pg. Some views take arguments, e.g., the node and edge
+  /// types of PropertyGraphViews::MaskedGraph.
+  template <typename PGView, typename... Args>
+  PGView BuildView(const PropertyGraph* pg, const Args&... args) noexcept {
+    return internal::PGViewBuilder<PGView>::BuildView(pg, *this, args...);
+  }
+
+  /// Add every valid cached edge shuffled or fully shuffled topology that is
+  /// not already stored with rdg to it, so that the next store of rdg
+  /// persists it and later loads can skip rebuilding it
+  Result<void> PersistDerivedTopologies(tsuba::RDG* rdg) const noexcept;
+
+  /// Return the topology of pg projected to the nodes with one of node_types
+  /// and the edges with one of edge_types (an empty list selects all nodes or
+  /// edges). Projections are cached by their types, so requests that differ
+  /// only in the order of the types share one. Cached projections are evicted
+  /// least recently used first once they take more than
+  /// projected_topology_budget() bytes; an evicted projection stays alive
+  /// while a caller still holds it.
+  std::shared_ptr<ProjectedTopology> BuildOrGetProjectedGraphTopo(
+      const PropertyGraph* pg, const std::vector<std::string>& node_types,
+      const std::vector<std::string>& edge_types) noexcept;
+
+  /// The number of bytes of projected topologies to keep cached. The default
+  /// is taken from KATANA_PROJECTED_TOPOLOGY_CACHE_MB, or 4 GiB if it is not
+  /// set. The most recently used projection is kept even if it alone exceeds
+  /// the budget.
+  size_t projected_topology_budget() const noexcept {
+    std::lock_guard<std::mutex> lock(*lru_mutex_);
+    return projected_topos_budget_;
+  }
+  void set_projected_topology_budget(size_t bytes) noexcept;
+
+  size_t num_cached_projected_topologies() const noexcept {
+    std::lock_guard<std::mutex> lock(*lru_mutex_);
+    return projected_topos_.size();
+  }
+
+  /// Return the topology of pg filtered to node_types and edge_types (see
+  /// BuildOrGetProjectedGraphTopo), choosing how to represent it. A cached
+  /// projection is used if there is one. Otherwise the filter is masked (see
+  /// MaskedTopology), which costs a bit per node and edge, and the mask is
+  /// kept if it selects at least min_masked_selectivity of the edges. More
+  /// selective filters are projected and cached instead, since traversing a
+  /// mask that selects little of the graph mostly skips elements. Filters
+  /// whose type counts show they cannot reach min_masked_selectivity are
+  /// projected without building the mask.
+  FilteredTopology BuildOrGetFilteredTopo(
+      const PropertyGraph* pg, const std::vector<std::string>& node_types,
+      const std::vector<std::string>& edge_types,
+      double min_masked_selectivity = kMinMaskedSelectivity) noexcept;
+
+  /// Default fraction of edges a filter must select to be masked rather than
+  /// projected
+  static constexpr double kMinMaskedSelectivity = 0.25;
+
+  /// Return a copy of node property name of pg in the order of the nodes of
+  /// views of type view_type that read the topology topology_id, where
+  /// property_index(n) is the property index of node n of the view. Loops
+  /// over the view can then read the copy sequentially instead of gathering
+  /// from the property. The copy is built on first use and cached until
+  /// DropPermutedNodeProperties or DropTopologies, or until it is evicted
+  /// (see permuted_property_budget). The copy is shared by all callers and
+  /// must not be written to.
+  Result<std::shared_ptr<arrow::Array>> BuildOrGetPermutedNodeProperty(
+      const PropertyGraph* pg, std::type_index view_type,
+      const void* topology_id, const std::string& name, uint64_t num_nodes,
+      const std::function<PropertyIndex(uint64_t)>& property_index) noexcept;
+
+  /// Return a copy of edge property name of pg in the order of the edges of
+  /// views of type view_type, see BuildOrGetPermutedNodeProperty
+  Result<std::shared_ptr<arrow::Array>> BuildOrGetPermutedEdgeProperty(
+      const PropertyGraph* pg, std::type_index view_type,
+      const void* topology_id, const std::string& name, uint64_t num_edges,
+      const std::function<PropertyIndex(uint64_t)>& property_index) noexcept;
+
+  /// The number of bytes of permuted property copies to keep cached. The
+  /// default is taken from KATANA_PERMUTED_PROPERTY_CACHE_MB, or 1 GiB if it
+  /// is not set. Copies are evicted least recently used first; an evicted
+  /// copy stays alive while a view still holds it.
+  size_t permuted_property_budget() const noexcept {
+    std::lock_guard<std::mutex> lock(*lru_mutex_);
+    return permuted_props_budget_;
+  }
+  void set_permuted_property_budget(size_t bytes) noexcept;
+
+  size_t num_cached_permuted_properties() const noexcept {
+    std::lock_guard<std::mutex> lock(*lru_mutex_);
+    return permuted_props_.size();
+  }
+
+  /// Forget permuted copies of node properties, e.g., because the properties
+  /// changed. Copies still held by callers stay alive until they are
+  /// released, but are no longer returned.
+  void DropPermutedNodeProperties() noexcept { DropPermutedProperties(true); }
+
+  /// Forget permuted copies of edge properties
+  void DropPermutedEdgeProperties() noexcept { DropPermutedProperties(false); }
+
+  /// Forget every topology derived from the topology of the graph, e.g.,
+  /// because the topology is about to change. Topologies still used by views
+  /// stay alive, but are no longer returned or persisted.
+  void DropTopologies() noexcept;
 
 private:
   const GraphTopology* GetOriginalTopology(
@@ -1402,6 +2263,19 @@ private:
 
   CondensedTypeIDMap* BuildOrGetEdgeTypeIndex(const PropertyGraph* pg) noexcept;
 
+  /// Return the topology of this kind stored with pg's RDG, or nullptr if
+  /// there is none or it cannot be used
+  std::unique_ptr<EdgeShuffleTopology> LoadEdgeShuffTopo(
+      const PropertyGraph* pg,
+      const EdgeShuffleTopology::TransposeKind& tpose_kind,
+      const EdgeShuffleTopology::EdgeSortKind& sort_kind) const noexcept;
+
+  std::unique_ptr<ShuffleTopology> LoadShuffTopo(
+      const PropertyGraph* pg,
+      const EdgeShuffleTopology::TransposeKind& tpose_kind,
+      const ShuffleTopology::NodeSortKind& node_sort_todo,
+      const EdgeShuffleTopology::EdgeSortKind& edge_sort_todo) const noexcept;
+
   EdgeShuffleTopology* BuildOrGetEdgeShuffTopo(
       const PropertyGraph* pg,
       const EdgeShuffleTopology::TransposeKind& tpose_kind,
@@ -1417,9 +2291,41 @@ private:
       const PropertyGraph* pg,
       const EdgeShuffleTopology::TransposeKind& tpose_kind) noexcept;
 
-  ProjectedTopology* BuildOrGetProjectedGraphTopo(
-      const PropertyGraph* pg, const std::vector<std::string>& node_properties,
-      const std::vector<std::string>& edge_properties) noexcept;
+  /// Return the compressed topology of pg. A graph loaded from a compressed
+  /// topology file already has one, which is shared rather than compressing
+  /// the CSR again.
+  std::shared_ptr<const CompressedTopology> BuildOrGetCompressedTopo(
+      const PropertyGraph* pg) noexcept;
+
+  /// Return the membership index of sorted_topo, a cached topology sorted by
+  /// destination
+  EdgeMembershipIndex* BuildOrGetMembershipIndex(
+      const EdgeShuffleTopology* sorted_topo) noexcept;
+
+  /// Return the cached projection selected by the sorted, unique node_types
+  /// and edge_types and mark it most recently used, or return nullptr if
+  /// there is none. lru_mutex_ must be held.
+  std::shared_ptr<ProjectedTopology> GetCachedProjectedTopo(
+      const std::vector<std::string>& node_types,
+      const std::vector<std::string>& edge_types) noexcept;
+
+  /// Evict least recently used projected topologies, other than the most
+  /// recently used one, until they fit in the budget. lru_mutex_ must be
+  /// held.
+  void EvictProjectedTopologies() noexcept;
+
+  Result<std::shared_ptr<arrow::Array>> BuildOrGetPermutedProperty(
+      const PropertyGraph* pg, bool is_node, std::type_index view_type,
+      const void* topology_id, const std::string& name, uint64_t num_rows,
+      const std::function<PropertyIndex(uint64_t)>& property_index) noexcept;
+
+  /// Forget the permuted copies of node properties if is_node, otherwise of
+  /// edge properties
+  void DropPermutedProperties(bool is_node) noexcept;
+
+  /// Evict least recently used permuted copies until they fit in the
+  /// budget. lru_mutex_ must be held.
+  void EvictPermutedProperties() noexcept;
 };
 
 /// Creates a uniform-random CSR GrpahTopology instance, where each node as
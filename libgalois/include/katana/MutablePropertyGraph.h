@@ -0,0 +1,180 @@
+#ifndef KATANA_LIBGALOIS_KATANA_MUTABLEPROPERTYGRAPH_H_
+#define KATANA_LIBGALOIS_KATANA_MUTABLEPROPERTYGRAPH_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <arrow/type_fwd.h>
+
+#include "katana/DynamicBitset.h"
+#include "katana/GraphTopology.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A property graph that absorbs batches of edge insertions and deletions in
+/// time proportional to the batch rather than to the graph.
+///
+/// Edges live in the CSR topology of the last compacted snapshot, where
+/// deleted edges are marked by tombstones, and in delta blocks, one per
+/// inserted batch, each a small CSR over the nodes the batch touches. Blocks
+/// are merged once there are more than kMaxDeltaBlocks of them, which bounds
+/// the cost of reading the edges of a node. Compact folds the deltas and
+/// tombstones into a fresh snapshot in parallel.
+///
+/// Snapshots are ordinary PropertyGraphs. Compact does not change the
+/// previous snapshot, so views and analytics can run against one while
+/// updates continue; they see the updates after the next Compact. Updates
+/// and Compact must not run concurrently with each other. Compact runs
+/// synchronously on the calling thread; callers that want to compact in the
+/// background can run it on their own thread between batches of updates.
+///
+/// A new snapshot shares the arrays of its node properties with the previous
+/// one, so write results to new properties (as the analytics do) rather than
+/// into existing ones. Snapshots live in memory only: they are not
+/// associated with the storage of the graph passed to Make, so write them
+/// with PropertyGraph::Write to keep them.
+class KATANA_EXPORT MutablePropertyGraph {
+public:
+  using Node = GraphTopologyTypes::Node;
+  using Edge = GraphTopologyTypes::Edge;
+
+  /// Delta blocks kept before they are merged into one
+  static constexpr size_t kMaxDeltaBlocks = 8;
+
+  /// Default fraction of inserted and deleted edges, relative to the edges of
+  /// the snapshot, from which NeedsCompaction returns true
+  static constexpr double kDefaultCompactionFraction = 0.1;
+
+  /// Start from pg, which becomes the first snapshot. Snapshots are built
+  /// from loaded properties only, so pg must have all of its properties
+  /// loaded (see PropertyGraph::EnsureNodePropertyLoaded); graphs with
+  /// unloaded properties are rejected rather than losing them.
+  static Result<std::unique_ptr<MutablePropertyGraph>> Make(
+      std::shared_ptr<PropertyGraph> pg) noexcept;
+
+  /// Insert the edges srcs[i] -> dests[i]. properties has a row for each new
+  /// edge and the schema of the loaded edge properties of the graph; it may
+  /// be null if the graph has no edge properties. New edges have the unknown
+  /// entity type.
+  Result<void> InsertEdges(
+      const std::vector<Node>& srcs, const std::vector<Node>& dests,
+      const std::shared_ptr<arrow::Table>& properties = nullptr) noexcept;
+
+  /// Delete every edge srcs[i] -> dests[i], including parallel edges
+  /// \returns the number of edges deleted
+  Result<uint64_t> DeleteEdges(
+      const std::vector<Node>& srcs, const std::vector<Node>& dests) noexcept;
+
+  uint64_t num_nodes() const noexcept { return snapshot_->num_nodes(); }
+
+  /// The number of edges, counting updates since the last snapshot
+  uint64_t num_edges() const noexcept {
+    return snapshot_->num_edges() - num_deleted_snapshot_edges_ +
+           num_delta_edges_;
+  }
+
+  bool has_edge(Node src, Node dst) const noexcept;
+
+  /// Call fn(dest) for each edge out of n, counting updates since the last
+  /// snapshot. Edges of the snapshot come first, then inserted edges by
+  /// destination.
+  template <typename F>
+  void ForEachNeighbor(Node n, F fn) const {
+    const GraphTopology& topo = snapshot_->topology();
+    for (auto e : topo.edges(n)) {
+      if (!snapshot_deleted_.test(e)) {
+        fn(topo.edge_dest(e));
+      }
+    }
+    for (const auto& block : deltas_) {
+      auto [begin, end] = block.edges(n);
+      for (uint64_t i = begin; i < end; ++i) {
+        if (!block.deleted.test(i)) {
+          fn(block.dests[i]);
+        }
+      }
+    }
+  }
+
+  /// Whether the updates since the last snapshot amount to more than
+  /// fraction of its edges
+  bool NeedsCompaction(
+      double fraction = kDefaultCompactionFraction) const noexcept {
+    return num_delta_edges_ + num_deleted_snapshot_edges_ >
+           fraction * snapshot_->num_edges();
+  }
+
+  /// Build a new snapshot with the updates since the last one. It has the
+  /// properties and entity types of the last snapshot, but no storage; fails
+  /// if a property of the last snapshot has been unloaded.
+  Result<void> Compact() noexcept;
+
+  /// The last snapshot; it does not reflect later updates
+  std::shared_ptr<PropertyGraph> snapshot() const noexcept {
+    return snapshot_;
+  }
+
+  /// Compact if there are updates since the last snapshot and return it
+  Result<std::shared_ptr<PropertyGraph>> Snapshot() noexcept {
+    if (num_delta_edges_ > 0 || num_deleted_snapshot_edges_ > 0) {
+      KATANA_CHECKED(Compact());
+    }
+    return snapshot_;
+  }
+
+  size_t num_delta_blocks() const noexcept { return deltas_.size(); }
+
+private:
+  /// The edges of one inserted batch (or of merged batches), sorted by
+  /// source and destination
+  struct DeltaBlock {
+    /// The sources of the block in increasing order, and the end of the
+    /// edges of each in dests
+    std::vector<Node> srcs;
+    std::vector<uint64_t> ends;
+    std::vector<Node> dests;
+    /// The row of each edge in properties
+    std::vector<uint64_t> rows;
+    DynamicBitset deleted;
+    std::shared_ptr<arrow::Table> properties;
+
+    /// The range of n's edges in dests
+    std::pair<uint64_t, uint64_t> edges(Node n) const noexcept {
+      auto it = std::lower_bound(srcs.begin(), srcs.end(), n);
+      if (it == srcs.end() || *it != n) {
+        return {0, 0};
+      }
+      size_t i = it - srcs.begin();
+      return {i > 0 ? ends[i - 1] : 0, ends[i]};
+    }
+  };
+
+  /// An edge of a delta block: source, destination and property row
+  using DeltaEdge = std::tuple<Node, Node, uint64_t>;
+
+  explicit MutablePropertyGraph(std::shared_ptr<PropertyGraph> pg) noexcept;
+
+  /// Build a block from edges sorted by source and destination
+  static DeltaBlock MakeDeltaBlock(const std::vector<DeltaEdge>& edges);
+
+  /// Merge all delta blocks into one, dropping deleted edges
+  Result<void> MergeDeltaBlocks() noexcept;
+
+  std::shared_ptr<PropertyGraph> snapshot_;
+  DynamicBitset snapshot_deleted_;
+  uint64_t num_deleted_snapshot_edges_{0};
+  std::vector<DeltaBlock> deltas_;
+  /// Live edges in deltas_
+  uint64_t num_delta_edges_{0};
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef KATANA_LIBGALOIS_KATANA_NODEORDERING_H_
+#define KATANA_LIBGALOIS_KATANA_NODEORDERING_H_
+
+#include <cstdint>
+
+#include "katana/GraphTopology.h"
+#include "katana/config.h"
+
+/// Node orderings that improve the locality of graph traversals.
+///
+/// Each function returns a permutation of the nodes of a topology: the node
+/// at position i of the result becomes node i of the reordered topology,
+/// which is the node_prop_indices convention of ShuffleTopology. Orderings
+/// that group related nodes ignore edge direction and self loops. All are
+/// deterministic for a given topology.
+///
+/// Use them through ShuffleTopology::NodeSortKind to get a cached (and
+/// persisted) reordered view of a graph, or through CreateReorderedGraph to
+/// renumber a graph together with its properties.
+
+namespace katana {
+
+/// Window size used by Gorder's authors
+constexpr uint32_t kGorderDefaultWindow = 5;
+
+/// Reverse Cuthill-McKee: a breadth-first order that visits the neighbors of
+/// each node in increasing order of degree, starting every component at a
+/// node of minimum degree, reversed. Reduces the bandwidth of the adjacency
+/// matrix. BFS levels are expanded in parallel.
+KATANA_EXPORT GraphTopologyTypes::PropIndexVec ReverseCuthillMcKeeOrder(
+    const GraphTopology& topo);
+
+/// Hub sorting: nodes with more than the average number of edges (hubs)
+/// first, in descending order of degree, followed by the other nodes in their
+/// original order.
+KATANA_EXPORT GraphTopologyTypes::PropIndexVec HubSortOrder(
+    const GraphTopology& topo);
+
+/// Hub clustering: like HubSortOrder but hubs keep their original relative
+/// order, which preserves more of the locality already in the input.
+KATANA_EXPORT GraphTopologyTypes::PropIndexVec HubClusterOrder(
+    const GraphTopology& topo);
+
+/// Gorder: greedily place next the node that shares the most neighbors and
+/// edges with the last window nodes placed. Nodes are ordered in fixed-size
+/// blocks of their original ids, in parallel.
+KATANA_EXPORT GraphTopologyTypes::PropIndexVec GorderOrder(
+    const GraphTopology& topo, uint32_t window = kGorderDefaultWindow);
+
+/// Rabbit order: merge nodes, in increasing order of degree, into the
+/// neighboring community that most increases modularity, then number the
+/// nodes of each community consecutively by a traversal of its merge tree.
+/// Merging is sequential; numbering is parallel across communities.
+KATANA_EXPORT GraphTopologyTypes::PropIndexVec RabbitOrder(
+    const GraphTopology& topo);
+
+}  // namespace katana
+
+#endif
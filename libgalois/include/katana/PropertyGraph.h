@@ -1,6 +1,9 @@
 #ifndef KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 #define KATANA_LIBGALOIS_KATANA_PROPERTYGRAPH_H_
 
+#include <memory>
+#include <mutex>
+#include <typeinfo>
 #include <utility>
 
 #include <arrow/api.h>
@@ -74,9 +77,20 @@ private:
   Result<void> WriteView(
       const std::string& uri, const std::string& command_line);
 
+  /// Decode topology_ from compressed_topology_, once
+  void DecodeTopology() const noexcept;
+
   tsuba::RDG rdg_;
   std::unique_ptr<tsuba::RDGFile> file_;
-  GraphTopology topology_;
+  /// For a graph with a compressed_topology_, a cache of it decoded on first
+  /// use. Decoding does not change the graph, so it is done from const
+  /// accessors.
+  mutable GraphTopology topology_;
+  /// The topology of a graph loaded from a compressed topology file.
+  /// topology_ is only decoded from it on first use, so a graph used through
+  /// PropertyGraphViews::Compressed does not hold its CSR as well.
+  std::shared_ptr<const CompressedTopology> compressed_topology_;
+  std::unique_ptr<std::once_flag> topology_decoded_;
 
   /// Manages the relations between the node entity types
   EntityTypeManager node_entity_type_manager_;
@@ -97,6 +111,8 @@ private:
   PGViewCache pg_view_cache_;
 
   friend class PropertyGraphRetractor;
+  // loads derived topologies stored with rdg_
+  friend class PGViewCache;
 
 public:
   /// PropertyView provides a uniform interface when you don't need to
@@ -200,10 +216,16 @@ public:
       GraphTopology&& topo, EntityTypeIDArray&& node_entity_type_ids,
       EntityTypeIDArray&& edge_entity_type_ids,
       EntityTypeManager&& node_type_manager,
-      EntityTypeManager&& edge_type_manager) noexcept
+      EntityTypeManager&& edge_type_manager,
+      std::shared_ptr<const CompressedTopology> compressed_topo =
+          nullptr) noexcept
       : rdg_(std::move(rdg)),
         file_(std::move(rdg_file)),
         topology_(std::move(topo)),
+        compressed_topology_(std::move(compressed_topo)),
+        topology_decoded_(
+            compressed_topology_ ? std::make_unique<std::once_flag>()
+                                 : nullptr),
         node_entity_type_manager_(std::move(node_type_manager)),
         edge_entity_type_manager_(std::move(edge_type_manager)),
         node_entity_type_ids_(std::move(node_entity_type_ids)),
@@ -212,10 +234,68 @@ public:
     KATANA_LOG_DEBUG_ASSERT(edge_entity_type_ids_.size() == num_edges());
   }
 
+  template <typename PGView, typename... Args>
+  PGView BuildView(const Args&... args) noexcept {
+    return pg_view_cache_.BuildView<PGView>(this, args...);
+  }
+
+  /// \returns the topology of this graph projected to the nodes with one of
+  /// node_types and the edges with one of edge_types; an empty list selects
+  /// all nodes or edges. Projections are cached by their types, see
+  /// PGViewCache::BuildOrGetProjectedGraphTopo.
+  std::shared_ptr<ProjectedTopology> BuildProjectedTopology(
+      const std::vector<std::string>& node_types,
+      const std::vector<std::string>& edge_types) noexcept {
+    return pg_view_cache_.BuildOrGetProjectedGraphTopo(
+        this, node_types, edge_types);
+  }
+
+  /// \returns the topology of this graph filtered to node_types and
+  /// edge_types, either masked or projected depending on how much of the
+  /// graph the filter selects, see PGViewCache::BuildOrGetFilteredTopo
+  FilteredTopology BuildFilteredTopology(
+      const std::vector<std::string>& node_types,
+      const std::vector<std::string>& edge_types) noexcept {
+    return pg_view_cache_.BuildOrGetFilteredTopo(this, node_types, edge_types);
+  }
+
+  /// Set the number of bytes of projected topologies to keep cached, see
+  /// PGViewCache::projected_topology_budget
+  void SetProjectedTopologyCacheBudget(size_t bytes) noexcept {
+    pg_view_cache_.set_projected_topology_budget(bytes);
+  }
+
+  /// Set the number of bytes of permuted property copies to keep cached, see
+  /// PGViewCache::permuted_property_budget
+  void SetPermutedPropertyCacheBudget(size_t bytes) noexcept {
+    pg_view_cache_.set_permuted_property_budget(bytes);
+  }
+
+  /// \returns a copy of node property name in the order of the nodes of
+  /// view rather than in the order of the property, so that loops over view
+  /// read it sequentially instead of through view.node_property_index. Copies
+  /// are cached per type of view and topology it reads (see
+  /// PGViewCache::BuildOrGetPermutedNodeProperty) until the property is
+  /// upserted, removed or unloaded, or the topology changes. The copy is
+  /// shared with other callers, so it must not be written to.
   template <typename PGView>
-  PGView BuildView() noexcept {
-    return pg_view_cache_.BuildView<PGView>(this);
+  Result<std::shared_ptr<arrow::Array>> GetPermutedNodeProperty(
+      const PGView& view, const std::string& name) noexcept {
+    return pg_view_cache_.BuildOrGetPermutedNodeProperty(
+        this, typeid(PGView), view.topology_id(), name, view.num_nodes(),
+        [&view](uint64_t n) { return view.node_property_index(n); });
   }
+
+  /// \returns a copy of edge property name in the order of the edges of
+  /// view, see GetPermutedNodeProperty
+  template <typename PGView>
+  Result<std::shared_ptr<arrow::Array>> GetPermutedEdgeProperty(
+      const PGView& view, const std::string& name) noexcept {
+    return pg_view_cache_.BuildOrGetPermutedEdgeProperty(
+        this, typeid(PGView), view.topology_id(), name, view.num_edges(),
+        [&view](uint64_t e) { return view.edge_property_index(e); });
+  }
+
   /// Make a property graph from a constructed RDG. Take ownership of the RDG
   /// and its underlying resources.
   static Result<std::unique_ptr<PropertyGraph>> Make(
@@ -610,7 +690,27 @@ public:
     return MakeResult(std::move(array));
   }
 
-  const GraphTopology& topology() const noexcept { return topology_; }
+  /// Whether the graph was loaded from a compressed topology file (and its
+  /// topology has not been made mutable since). Such graphs are cheaper to
+  /// traverse through PropertyGraphViews::Compressed than through
+  /// topology(), which decodes the CSR.
+  bool has_compressed_topology() const noexcept {
+    return compressed_topology_ != nullptr;
+  }
+
+  /// The CSR topology. For a graph loaded from a compressed topology file it
+  /// is decoded on the first call.
+  const GraphTopology& topology() const noexcept {
+    if (compressed_topology_) {
+      DecodeTopology();
+    }
+    return topology_;
+  }
+
+  /// Copy a topology that borrows a mapped topology file into private memory
+  /// so that it may be modified in place. Cached topologies derived from it
+  /// are dropped.
+  void MakeTopologyMutable() noexcept;
 
   const EntityTypeManager& node_entity_type_manager() const noexcept {
     return node_entity_type_manager_;
@@ -659,6 +759,21 @@ public:
   /// the table do nothing otherwise
   Result<void> EnsureEdgePropertyLoaded(const std::string& name);
 
+  /// Store a node property in this format from now on. Arrow IPC
+  /// properties load without decoding and are shared through the page cache,
+  /// see tsuba::RDG::SetNodePropertyFormat
+  Result<void> SetNodePropertyFormat(
+      const std::string& name, tsuba::PropertyFormat format) {
+    return rdg_.SetNodePropertyFormat(name, format);
+  }
+
+  /// Store an edge property in this format from now on, see
+  /// SetNodePropertyFormat
+  Result<void> SetEdgePropertyFormat(
+      const std::string& name, tsuba::PropertyFormat format) {
+    return rdg_.SetEdgePropertyFormat(name, format);
+  }
+
   std::vector<std::string> ListNodeProperties() const;
   std::vector<std::string> ListEdgeProperties() const;
 
@@ -732,15 +847,21 @@ public:
   node_iterator end() const { return topology().end(); }
 
   /// Return the number of local nodes
-  size_t size() const { return topology().size(); }
+  size_t size() const { return num_nodes(); }
 
-  bool empty() const { return topology().empty(); }
+  bool empty() const { return num_nodes() == 0; }
 
   /// Return the number of local nodes
   ///  num_nodes in repartitioner is of type LocalNodeID
-  uint64_t num_nodes() const { return topology().num_nodes(); }
+  uint64_t num_nodes() const {
+    return compressed_topology_ ? compressed_topology_->num_nodes()
+                                : topology_.num_nodes();
+  }
   /// Return the number of local edges
-  uint64_t num_edges() const { return topology().num_edges(); }
+  uint64_t num_edges() const {
+    return compressed_topology_ ? compressed_topology_->num_edges()
+                                : topology_.num_edges();
+  }
 
   /// Gets the edge range of some node.
   ///
@@ -814,6 +935,18 @@ KATANA_EXPORT GraphTopology::Edge FindEdgeSortedByDest(
 // TODO(amber): this method should return a new sorted topology
 KATANA_EXPORT Result<void> SortNodesByDegree(PropertyGraph* pg);
 
+/// Creates a copy of a graph with its nodes renumbered to improve the
+/// locality of traversals, see katana/NodeOrdering.h.
+///
+/// Unlike PropertyGraphViews::NodesReordered, which is a view of the original
+/// graph, node and edge types and loaded properties are permuted along with
+/// the topology, so the result can be written out as a new RDG.
+/// \param pg The original property graph
+/// \param node_sort_kind The ordering of the new graph
+/// \return The new reordered property graph
+KATANA_EXPORT Result<std::unique_ptr<PropertyGraph>> CreateReorderedGraph(
+    const PropertyGraph* pg, ShuffleTopology::NodeSortKind node_sort_kind);
+
 /// Creates in-memory symmetric (or undirected) graph.
 ///
 /// This function creates an symmetric or undirected version of the
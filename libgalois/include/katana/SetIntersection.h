@@ -0,0 +1,406 @@
+#ifndef KATANA_LIBGALOIS_KATANA_SETINTERSECTION_H_
+#define KATANA_LIBGALOIS_KATANA_SETINTERSECTION_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "katana/config.h"
+
+/// Intersection of sorted sets, e.g., of the neighbors of two nodes of a
+/// topology whose edges are sorted by destination.
+///
+/// Sets are arrays in strictly increasing order. There are three kernels:
+///
+/// - merge: a scalar merge, linear in the size of both sets
+/// - galloping: exponential search of the larger set for each element of the
+///   smaller one, for sets of very different sizes
+/// - block: compare blocks of both sets at once with AVX-512, AVX2 or SSE2,
+///   whichever the build enables, for sets of similar size. Only 32-bit
+///   elements have a block kernel; other sets merge instead.
+///
+/// The functions without an IntersectionKind pick the kernel from the ratio
+/// of the set sizes (see ChooseIntersection). For one set that is
+/// intersected with many others, e.g., the neighbors of a hub, a SetBitmap
+/// replaces the kernels with one bit test per element of the other set.
+
+namespace katana {
+
+enum class IntersectionKind { kMerge, kGalloping, kBlock };
+
+/// Ratio of the size of the larger set to the size of the smaller one from
+/// which galloping beats merging
+constexpr size_t kGallopingRatio = 32;
+
+namespace internal {
+
+#if defined(__AVX512F__)
+
+constexpr size_t kIntersectionBlockSize = 16;
+
+/// A mask of the elements of a[0, kIntersectionBlockSize) that are in
+/// b[0, kIntersectionBlockSize)
+inline uint32_t
+IntersectionBlockMask(const uint32_t* a, const uint32_t* b) {
+  const __m512i rotate = _mm512_set_epi32(
+      0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+  __m512i va = _mm512_loadu_si512(a);
+  __m512i vb = _mm512_loadu_si512(b);
+  __mmask16 mask = _mm512_cmpeq_epi32_mask(va, vb);
+  for (size_t r = 1; r < kIntersectionBlockSize; ++r) {
+    // The masked form avoids a spurious uninitialized warning from GCC
+    vb = _mm512_maskz_permutexvar_epi32(0xffff, rotate, vb);
+    mask |= _mm512_cmpeq_epi32_mask(va, vb);
+  }
+  return mask;
+}
+
+#elif defined(__AVX2__)
+
+constexpr size_t kIntersectionBlockSize = 8;
+
+inline uint32_t
+IntersectionBlockMask(const uint32_t* a, const uint32_t* b) {
+  const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+  __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+  __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+  __m256i match = _mm256_cmpeq_epi32(va, vb);
+  for (size_t r = 1; r < kIntersectionBlockSize; ++r) {
+    vb = _mm256_permutevar8x32_epi32(vb, rotate);
+    match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+  }
+  return _mm256_movemask_ps(_mm256_castsi256_ps(match));
+}
+
+#elif defined(__SSE2__)
+
+constexpr size_t kIntersectionBlockSize = 4;
+
+inline uint32_t
+IntersectionBlockMask(const uint32_t* a, const uint32_t* b) {
+  __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+  __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+  __m128i match = _mm_cmpeq_epi32(va, vb);
+  vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+  match = _mm_or_si128(match, _mm_cmpeq_epi32(va, vb));
+  vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+  match = _mm_or_si128(match, _mm_cmpeq_epi32(va, vb));
+  vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+  match = _mm_or_si128(match, _mm_cmpeq_epi32(va, vb));
+  return _mm_movemask_ps(_mm_castsi128_ps(match));
+}
+
+#else
+
+/// No block kernel in this build
+constexpr size_t kIntersectionBlockSize = 0;
+
+inline uint32_t
+IntersectionBlockMask(const uint32_t*, const uint32_t*) {
+  return 0;
+}
+
+#endif
+
+template <typename T>
+constexpr bool kHasIntersectionBlock =
+    kIntersectionBlockSize > 0 && std::is_integral_v<T> && sizeof(T) == 4;
+
+/// Intersect a and b a block at a time while both have a full block left,
+/// calling on_mask(i, mask) with the mask of the elements of a[i, i + block
+/// size) that are in b. Each element of a is reported at most once.
+/// @returns the positions in a and b where blocks stopped
+template <typename T, typename F>
+std::pair<size_t, size_t>
+IntersectBlocks(const T* a, size_t na, const T* b, size_t nb, F on_mask) {
+  constexpr size_t kBlock = kIntersectionBlockSize;
+  size_t i = 0;
+  size_t j = 0;
+  while (i + kBlock <= na && j + kBlock <= nb) {
+    uint32_t mask = IntersectionBlockMask(
+        reinterpret_cast<const uint32_t*>(a + i),
+        reinterpret_cast<const uint32_t*>(b + j));
+    if (mask != 0) {
+      on_mask(i, mask);
+    }
+    T a_max = a[i + kBlock - 1];
+    T b_max = b[j + kBlock - 1];
+    if (a_max <= b_max) {
+      i += kBlock;
+    }
+    if (b_max <= a_max) {
+      j += kBlock;
+    }
+  }
+  return {i, j};
+}
+
+/// The first position in [j, nb) whose element is not less than x
+template <typename T>
+size_t
+GallopTo(const T* b, size_t nb, size_t j, T x) {
+  size_t hi = j;
+  for (size_t step = 1; hi < nb && b[hi] < x; step *= 2) {
+    j = hi + 1;
+    hi += step;
+  }
+  return std::lower_bound(b + j, b + std::min(hi, nb), x) - b;
+}
+
+/// ForEachCommonPositionUntil for na <= nb, galloping or merging
+template <typename T, typename F>
+bool
+ForEachCommonPositionOrderedUntil(
+    const T* a, size_t na, const T* b, size_t nb, bool gallop, F fn) {
+  if (gallop) {
+    size_t j = 0;
+    for (size_t i = 0; i < na && j < nb; ++i) {
+      j = GallopTo(b, nb, j, a[i]);
+      if (j < nb && b[j] == a[i]) {
+        if (fn(i, j)) {
+          return true;
+        }
+        ++j;
+      }
+    }
+    return false;
+  }
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      if (fn(i, j)) {
+        return true;
+      }
+      ++i;
+      ++j;
+    }
+  }
+  return false;
+}
+
+/// ForEachCommonPosition for na <= nb, galloping or merging
+template <typename T, typename F>
+void
+ForEachCommonPositionOrdered(
+    const T* a, size_t na, const T* b, size_t nb, bool gallop, F fn) {
+  ForEachCommonPositionOrderedUntil(
+      a, na, b, nb, gallop, [&fn](size_t i, size_t j) {
+        fn(i, j);
+        return false;
+      });
+}
+
+}  // namespace internal
+
+/// The kernel to intersect sets of sizes na and nb with
+inline IntersectionKind
+ChooseIntersection(size_t na, size_t nb) {
+  size_t small = std::min(na, nb);
+  size_t large = std::max(na, nb);
+  if (large >= kGallopingRatio * small) {
+    return IntersectionKind::kGalloping;
+  }
+  if (internal::kIntersectionBlockSize > 0 &&
+      small >= internal::kIntersectionBlockSize) {
+    return IntersectionKind::kBlock;
+  }
+  return IntersectionKind::kMerge;
+}
+
+/// Call fn(i, j) for each a[i] == b[j], in increasing order. Intersections
+/// that need the positions of common elements, e.g., to read edge data, use
+/// this instead of ForEachCommon; it merges or gallops but has no block
+/// kernel.
+template <typename T, typename F>
+void
+ForEachCommonPosition(const T* a, size_t na, const T* b, size_t nb, F fn) {
+  bool gallop = ChooseIntersection(na, nb) == IntersectionKind::kGalloping;
+  if (na <= nb) {
+    internal::ForEachCommonPositionOrdered(a, na, b, nb, gallop, fn);
+  } else {
+    internal::ForEachCommonPositionOrdered(
+        b, nb, a, na, gallop, [&fn](size_t j, size_t i) { fn(i, j); });
+  }
+}
+
+/// Like ForEachCommonPosition, but stop at the first call for which fn(i, j)
+/// returns true, e.g., once a count reaches a bound.
+///
+/// @returns true if fn stopped the intersection
+template <typename T, typename F>
+bool
+ForEachCommonPositionUntil(const T* a, size_t na, const T* b, size_t nb, F fn) {
+  bool gallop = ChooseIntersection(na, nb) == IntersectionKind::kGalloping;
+  if (na <= nb) {
+    return internal::ForEachCommonPositionOrderedUntil(
+        a, na, b, nb, gallop, fn);
+  }
+  return internal::ForEachCommonPositionOrderedUntil(
+      b, nb, a, na, gallop, [&fn](size_t j, size_t i) { return fn(i, j); });
+}
+
+/// Call fn(x) for each x in both a and b, in increasing order
+template <typename T, typename F>
+void
+ForEachCommon(
+    const T* a, size_t na, const T* b, size_t nb, IntersectionKind kind,
+    F fn) {
+  if (kind == IntersectionKind::kBlock) {
+    if constexpr (internal::kHasIntersectionBlock<T>) {
+      auto on_mask = [&](size_t block, uint32_t mask) {
+        for (; mask != 0; mask &= mask - 1) {
+          fn(a[block + __builtin_ctz(mask)]);
+        }
+      };
+      auto [i, j] = internal::IntersectBlocks(a, na, b, nb, on_mask);
+      ForEachCommon(
+          a + i, na - i, b + j, nb - j, IntersectionKind::kMerge, fn);
+      return;
+    }
+  }
+
+  if (kind == IntersectionKind::kGalloping) {
+    if (na <= nb) {
+      internal::ForEachCommonPositionOrdered(
+          a, na, b, nb, true, [&](size_t i, size_t) { fn(a[i]); });
+    } else {
+      internal::ForEachCommonPositionOrdered(
+          b, nb, a, na, true, [&](size_t j, size_t) { fn(b[j]); });
+    }
+    return;
+  }
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      fn(a[i]);
+      ++i;
+      ++j;
+    }
+  }
+}
+
+template <typename T, typename F>
+void
+ForEachCommon(const T* a, size_t na, const T* b, size_t nb, F fn) {
+  ForEachCommon(a, na, b, nb, ChooseIntersection(na, nb), fn);
+}
+
+/// @returns the number of elements in both a and b
+template <typename T>
+size_t
+IntersectCount(
+    const T* a, size_t na, const T* b, size_t nb, IntersectionKind kind) {
+  size_t count = 0;
+  if (kind == IntersectionKind::kBlock) {
+    if constexpr (internal::kHasIntersectionBlock<T>) {
+      auto [i, j] = internal::IntersectBlocks(
+          a, na, b, nb,
+          [&](size_t, uint32_t mask) { count += __builtin_popcount(mask); });
+      return count + IntersectCount(
+                         a + i, na - i, b + j, nb - j,
+                         IntersectionKind::kMerge);
+    }
+  }
+
+  ForEachCommon(a, na, b, nb, kind, [&count](const T&) { ++count; });
+  return count;
+}
+
+template <typename T>
+size_t
+IntersectCount(const T* a, size_t na, const T* b, size_t nb) {
+  return IntersectCount(a, na, b, nb, ChooseIntersection(na, nb));
+}
+
+/// Write the elements in both a and b to out, which must have room for the
+/// smaller of them, in increasing order
+/// @returns the number of elements written
+template <typename T>
+size_t
+IntersectInto(const T* a, size_t na, const T* b, size_t nb, T* out) {
+  size_t count = 0;
+  ForEachCommon(a, na, b, nb, [&](const T& x) { out[count++] = x; });
+  return count;
+}
+
+/// A set of integers in [0, universe) as a bitmap, for intersecting one set
+/// with many others: each element of another set costs one bit test
+/// regardless of the size of this set, and the other sets need not be
+/// sorted. Insert and Erase only touch the bits of their elements, so a
+/// bitmap (e.g., one per thread) can be reused for many sets in time
+/// proportional to their size.
+class SetBitmap {
+public:
+  explicit SetBitmap(size_t universe = 0) : words_((universe + 63) / 64) {}
+
+  /// Make room for elements in [0, universe)
+  void resize(size_t universe) { words_.resize((universe + 63) / 64); }
+
+  size_t universe() const noexcept { return words_.size() * 64; }
+
+  bool contains(uint64_t x) const noexcept {
+    return (words_[x / 64] >> (x % 64)) & 1;
+  }
+
+  template <typename T>
+  void Insert(const T* a, size_t na) noexcept {
+    for (size_t i = 0; i < na; ++i) {
+      words_[a[i] / 64] |= uint64_t{1} << (a[i] % 64);
+    }
+  }
+
+  /// Remove the elements of a, which leaves the bitmap empty if a is the set
+  /// that was inserted
+  template <typename T>
+  void Erase(const T* a, size_t na) noexcept {
+    for (size_t i = 0; i < na; ++i) {
+      words_[a[i] / 64] &= ~(uint64_t{1} << (a[i] % 64));
+    }
+  }
+
+  /// Call fn(x) for each x of b in this set, in the order of b
+  template <typename T, typename F>
+  void ForEachCommon(const T* b, size_t nb, F fn) const {
+    for (size_t j = 0; j < nb; ++j) {
+      if (contains(b[j])) {
+        fn(b[j]);
+      }
+    }
+  }
+
+  /// @returns the number of elements of b in this set
+  template <typename T>
+  size_t Count(const T* b, size_t nb) const noexcept {
+    size_t count = 0;
+    for (size_t j = 0; j < nb; ++j) {
+      count += contains(b[j]);
+    }
+    return count;
+  }
+
+private:
+  std::vector<uint64_t> words_;
+};
+
+}  // namespace katana
+
+#endif
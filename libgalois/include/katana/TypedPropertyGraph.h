@@ -1,7 +1,12 @@
 #ifndef KATANA_LIBGALOIS_KATANA_TYPEDPROPERTYGRAPH_H_
 #define KATANA_LIBGALOIS_KATANA_TYPEDPROPERTYGRAPH_H_
 
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
 #include <tuple>
+#include <vector>
 
 #include <arrow/type_fwd.h>
 #include <boost/iterator/counting_iterator.hpp>
@@ -134,6 +139,17 @@ public:
     return pg_->GetEdgeDest(edge);
   }
 
+  /**
+   * Gets the destination for an edge, like the edge_dest of views, so that
+   * code can be written for both.
+   *
+   * @param edge edge to get the destination of
+   * @returns the edge destination
+   */
+  Node edge_dest(const Edge& edge) const {
+    return pg_->topology().edge_dest(edge);
+  }
+
   uint64_t num_nodes() const { return pg_->num_nodes(); }
   uint64_t num_edges() const { return pg_->num_edges(); }
 
@@ -189,19 +205,41 @@ public:
       PropertyGraph* pg);
 };
 
+/// Properties that a TypedPropertyGraphView reads from read-only copies in
+/// the order of its nodes and edges, see
+/// PropertyGraph::GetPermutedNodeProperty
+struct PermutedProperties {
+  std::vector<std::string> node_properties;
+  std::vector<std::string> edge_properties;
+};
+
 template <typename PGView, typename NodeProps, typename EdgeProps>
 class TypedPropertyGraphView : public PGView {
   using NodeView = PropertyViewTuple<NodeProps>;
   using EdgeView = PropertyViewTuple<EdgeProps>;
+  using NodePermuted = std::array<bool, std::tuple_size_v<NodeProps>>;
+  using EdgePermuted = std::array<bool, std::tuple_size_v<EdgeProps>>;
 
   NodeView node_view_;
   EdgeView edge_view_;
+  /// Whether each property is a copy in the order of the nodes or edges of
+  /// the view, rather than reached through the view's property index
+  NodePermuted node_permuted_;
+  EdgePermuted edge_permuted_;
+  /// The shared copies that node_view_ and edge_view_ point into for
+  /// permuted properties
+  std::vector<std::shared_ptr<arrow::Array>> permuted_arrays_;
 
   TypedPropertyGraphView(
-      const PGView& pg_view, NodeView&& node_view, EdgeView&& edge_view)
+      const PGView& pg_view, NodeView&& node_view, EdgeView&& edge_view,
+      const NodePermuted& node_permuted, const EdgePermuted& edge_permuted,
+      std::vector<std::shared_ptr<arrow::Array>>&& permuted_arrays)
       : PGView(pg_view),
         node_view_(std::move(node_view)),
-        edge_view_(std::move(edge_view)) {}
+        edge_view_(std::move(edge_view)),
+        node_permuted_(node_permuted),
+        edge_permuted_(edge_permuted),
+        permuted_arrays_(std::move(permuted_arrays)) {}
 
 public:
   using node_properties = NodeProps;
@@ -223,7 +261,7 @@ public:
   PropertyReferenceType<NodeIndex> GetData(const Node& node) {
     constexpr size_t prop_col_index = find_trait<NodeIndex, NodeProps>();
     return std::get<prop_col_index>(node_view_)
-        .GetValue(PGView::node_property_index(node));
+        .GetValue(NodePropertyRow(node, prop_col_index));
   }
 
   /**
@@ -236,7 +274,7 @@ public:
   PropertyConstReferenceType<NodeIndex> GetData(const Node& node) const {
     constexpr size_t prop_col_index = find_trait<NodeIndex, NodeProps>();
     return std::get<prop_col_index>(node_view_)
-        .GetValue(PGView::node_property_index(node));
+        .GetValue(NodePropertyRow(node, prop_col_index));
   }
 
   /**
@@ -249,7 +287,7 @@ public:
   PropertyReferenceType<EdgeIndex> GetEdgeData(const Edge& edge) {
     constexpr size_t prop_col_index = find_trait<EdgeIndex, EdgeProps>();
     return std::get<prop_col_index>(edge_view_)
-        .GetValue(PGView::edge_property_index(edge));
+        .GetValue(EdgePropertyRow(edge, prop_col_index));
   }
 
   /**
@@ -262,7 +300,7 @@ public:
   PropertyConstReferenceType<EdgeIndex> GetEdgeData(const Edge& edge) const {
     constexpr size_t prop_col_index = find_trait<EdgeIndex, EdgeProps>();
     return std::get<prop_col_index>(edge_view_)
-        .GetValue(PGView::edge_property_index(edge));
+        .GetValue(EdgePropertyRow(edge, prop_col_index));
   }
 
   static Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>> Make(
@@ -270,6 +308,39 @@ public:
       const std::vector<std::string>& edge_properties);
   static Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>> Make(
       PropertyGraph* pg);
+
+  /// Make a view that reads the properties in permuted from copies in the
+  /// order of its nodes and edges, e.g., so that a loop over sorted edges
+  /// streams through edge weights instead of gathering them. The copies are
+  /// cached by pg and shared with other views in the same order, so
+  /// permuted properties are read-only: write output properties through the
+  /// property index instead. The view keeps its copies alive, so it reads
+  /// the values it was made with even if pg's properties change.
+  static Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>> Make(
+      PropertyGraph* pg, const std::vector<std::string>& node_properties,
+      const std::vector<std::string>& edge_properties,
+      const PermutedProperties& permuted);
+
+  /// Make a view over pg_view, which must be a view of pg, e.g., for views
+  /// that take arguments to build like PropertyGraphViews::NodesReordered
+  static Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>> Make(
+      PropertyGraph* pg, const PGView& pg_view,
+      const std::vector<std::string>& node_properties,
+      const std::vector<std::string>& edge_properties,
+      const PermutedProperties& permuted);
+
+private:
+  auto NodePropertyRow(const Node& node, size_t prop_col_index) const {
+    return node_permuted_[prop_col_index]
+               ? node
+               : PGView::node_property_index(node);
+  }
+
+  auto EdgePropertyRow(const Edge& edge, size_t prop_col_index) const {
+    return edge_permuted_[prop_col_index]
+               ? edge
+               : PGView::edge_property_index(edge);
+  }
 };
 
 /**
@@ -325,33 +396,80 @@ Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>>
 TypedPropertyGraphView<PGView, NodeProps, EdgeProps>::Make(
     PropertyGraph* pg, const std::vector<std::string>& node_properties,
     const std::vector<std::string>& edge_properties) {
-  auto pg_view = pg->BuildView<PGView>();
-  KATANA_LOG_DEBUG_ASSERT(pg);
-  auto node_view_result =
-      internal::MakeNodePropertyViews<NodeProps>(pg, node_properties);
-  if (!node_view_result) {
-    return node_view_result.error();
-  }
-
-  auto edge_view_result =
-      internal::MakeEdgePropertyViews<EdgeProps>(pg, edge_properties);
-  if (!edge_view_result) {
-    return edge_view_result.error();
-  }
-
-  return TypedPropertyGraphView(
-      pg_view, std::move(node_view_result.value()),
-      std::move(edge_view_result.value()));
+  return Make(pg, node_properties, edge_properties, PermutedProperties{});
 }
 
 template <typename PGView, typename NodeProps, typename EdgeProps>
 Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>>
 TypedPropertyGraphView<PGView, NodeProps, EdgeProps>::Make(PropertyGraph* pg) {
-  auto pg_view = pg->BuildView<PGView>();
   return TypedPropertyGraphView<PGView, NodeProps, EdgeProps>::Make(
-      pg_view, pg->loaded_node_schema()->field_names(),
+      pg, pg->loaded_node_schema()->field_names(),
       pg->loaded_edge_schema()->field_names());
 }
+
+template <typename PGView, typename NodeProps, typename EdgeProps>
+Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>>
+TypedPropertyGraphView<PGView, NodeProps, EdgeProps>::Make(
+    PropertyGraph* pg, const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties,
+    const PermutedProperties& permuted) {
+  KATANA_LOG_DEBUG_ASSERT(pg);
+  return Make(
+      pg, pg->BuildView<PGView>(), node_properties, edge_properties, permuted);
+}
+
+template <typename PGView, typename NodeProps, typename EdgeProps>
+Result<TypedPropertyGraphView<PGView, NodeProps, EdgeProps>>
+TypedPropertyGraphView<PGView, NodeProps, EdgeProps>::Make(
+    PropertyGraph* pg, const PGView& pg_view,
+    const std::vector<std::string>& node_properties,
+    const std::vector<std::string>& edge_properties,
+    const PermutedProperties& permuted) {
+  KATANA_LOG_DEBUG_ASSERT(pg);
+  KATANA_LOG_DEBUG_ASSERT(&pg_view.property_graph() == pg);
+
+  auto contains = [](const std::vector<std::string>& names,
+                     const std::string& name) {
+    return std::find(names.begin(), names.end(), name) != names.end();
+  };
+
+  std::vector<std::shared_ptr<arrow::Array>> permuted_arrays;
+
+  NodePermuted node_permuted{};
+  auto node_arrays = KATANA_CHECKED(internal::ExtractArrays(
+      pg->NodeReadOnlyPropertyView(), node_properties));
+  for (size_t i = 0; i < node_permuted.size() && i < node_arrays.size(); ++i) {
+    if (contains(permuted.node_properties, node_properties[i])) {
+      auto copy = KATANA_CHECKED(
+          pg->GetPermutedNodeProperty(pg_view, node_properties[i]));
+      node_arrays[i] = copy.get();
+      node_permuted[i] = true;
+      permuted_arrays.emplace_back(std::move(copy));
+    }
+  }
+
+  EdgePermuted edge_permuted{};
+  auto edge_arrays = KATANA_CHECKED(internal::ExtractArrays(
+      pg->EdgeReadOnlyPropertyView(), edge_properties));
+  for (size_t i = 0; i < edge_permuted.size() && i < edge_arrays.size(); ++i) {
+    if (contains(permuted.edge_properties, edge_properties[i])) {
+      auto copy = KATANA_CHECKED(
+          pg->GetPermutedEdgeProperty(pg_view, edge_properties[i]));
+      edge_arrays[i] = copy.get();
+      edge_permuted[i] = true;
+      permuted_arrays.emplace_back(std::move(copy));
+    }
+  }
+
+  auto node_view =
+      KATANA_CHECKED(internal::PropertyViewsFromArrays<NodeProps>(node_arrays));
+  auto edge_view =
+      KATANA_CHECKED(internal::PropertyViewsFromArrays<EdgeProps>(edge_arrays));
+
+  return TypedPropertyGraphView(
+      pg_view, std::move(node_view), std::move(edge_view), node_permuted,
+      edge_permuted, std::move(permuted_arrays));
+}
 }  // namespace katana
 
 #endif
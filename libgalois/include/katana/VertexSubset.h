@@ -0,0 +1,249 @@
+#ifndef KATANA_LIBGALOIS_KATANA_VERTEXSUBSET_H_
+#define KATANA_LIBGALOIS_KATANA_VERTEXSUBSET_H_
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/Reduction.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A subset of the nodes of a graph, e.g., the frontier of a traversal.
+///
+/// A subset is either sparse, a bag of its nodes, or dense, a bitset over all
+/// nodes. Sparse subsets cost time and space proportional to their size,
+/// which suits small frontiers that push to their neighbors. Dense subsets
+/// answer membership in constant time, which nodes pulling from a large
+/// frontier need. EdgeMap converts its input to whichever one it needs.
+class KATANA_EXPORT VertexSubset {
+public:
+  using Node = GraphTopologyTypes::Node;
+
+  /// An empty sparse subset of the nodes [0, num_nodes)
+  explicit VertexSubset(uint64_t num_nodes = 0) : num_nodes_(num_nodes) {}
+
+  /// An empty dense subset of the nodes [0, num_nodes)
+  static VertexSubset MakeDense(uint64_t num_nodes);
+
+  VertexSubset(VertexSubset&&) = default;
+  VertexSubset& operator=(VertexSubset&&) = default;
+
+  uint64_t num_nodes() const noexcept { return num_nodes_; }
+
+  bool IsDense() const noexcept { return is_dense_; }
+
+  /// Add a node. Concurrent pushes are safe, but a sparse subset keeps
+  /// duplicates, so each node should be pushed at most once.
+  void push(Node node) {
+    if (is_dense_) {
+      dense_.set(node);
+    } else {
+      sparse_.push(node);
+    }
+  }
+
+  /// Membership test; only dense subsets support it
+  bool contains(Node node) const {
+    KATANA_LOG_DEBUG_ASSERT(is_dense_);
+    return dense_.test(node);
+  }
+
+  bool empty() const;
+
+  /// @returns the number of nodes in the subset, which takes a parallel pass
+  /// over it
+  uint64_t size() const;
+
+  /// Remove every node, keeping the representation
+  void clear();
+
+  /// Convert to a bitset; this is a no-op for dense subsets
+  void ToDense();
+
+  /// Convert to a bag; this is a no-op for sparse subsets
+  void ToSparse();
+
+  /// The nodes of a sparse subset
+  const InsertBag<Node>& sparse() const {
+    KATANA_LOG_DEBUG_ASSERT(!is_dense_);
+    return sparse_;
+  }
+
+  /// The nodes of a dense subset
+  const DynamicBitset& dense() const {
+    KATANA_LOG_DEBUG_ASSERT(is_dense_);
+    return dense_;
+  }
+
+  /// Call fn(node) for every node of the subset, in parallel
+  template <typename F>
+  void ForEach(const F& fn) const {
+    if (!is_dense_) {
+      katana::do_all(
+          katana::iterate(sparse_), fn, katana::steal(), katana::no_stats());
+      return;
+    }
+    const auto& words = dense_.get_vec();
+    katana::do_all(
+        katana::iterate(uint64_t{0}, static_cast<uint64_t>(words.size())),
+        [&](uint64_t w) {
+          uint64_t bits = words[w];
+          for (; bits != 0; bits &= bits - 1) {
+            fn(static_cast<Node>(
+                w * DynamicBitset::kNumBitsInUint64 + __builtin_ctzll(bits)));
+          }
+        },
+        katana::steal(), katana::no_stats());
+  }
+
+private:
+  uint64_t num_nodes_{0};
+  bool is_dense_{false};
+  InsertBag<Node> sparse_;
+  DynamicBitset dense_;
+};
+
+enum class EdgeMapDirection {
+  /// Pick push or pull from the number of edges of the frontier
+  kAuto,
+  /// Each frontier node updates its out neighbors
+  kPush,
+  /// Each node that can be updated looks for in neighbors in the frontier
+  kPull,
+};
+
+struct EdgeMapOptions {
+  EdgeMapDirection direction{EdgeMapDirection::kAuto};
+
+  /// kAuto pulls when the frontier and its out edges number more than
+  /// num_edges / dense_threshold
+  uint64_t dense_threshold{20};
+
+  /// The graph is symmetric, so pulling can use out edges if the graph has
+  /// no in edges
+  bool symmetric{false};
+
+  const char* loopname{"EdgeMap"};
+};
+
+namespace internal {
+
+template <typename Graph, typename = void>
+struct HasInEdges : std::false_type {};
+
+template <typename Graph>
+struct HasInEdges<
+    Graph, std::void_t<decltype(std::declval<const Graph&>().in_edges(
+               std::declval<typename Graph::Node>()))>> : std::true_type {};
+
+template <typename Graph, typename F>
+void
+EdgeMapPush(
+    const Graph& graph, const VertexSubset& frontier, F& fn,
+    VertexSubset* next, const char* loopname) {
+  katana::do_all(
+      katana::iterate(frontier.sparse()),
+      [&](typename Graph::Node src) {
+        for (auto e : graph.edges(src)) {
+          auto dst = graph.edge_dest(e);
+          if (fn.Cond(dst) && fn.UpdateAtomic(src, dst)) {
+            next->push(dst);
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<64>(), katana::loopname(loopname));
+}
+
+template <typename Graph, typename F>
+void
+EdgeMapPull(
+    const Graph& graph, const VertexSubset& frontier, F& fn,
+    VertexSubset* next, const char* loopname) {
+  katana::do_all(
+      katana::iterate(graph.all_nodes()),
+      [&](typename Graph::Node dst) {
+        if (!fn.Cond(dst)) {
+          return;
+        }
+        auto pull = [&](auto src) {
+          if (frontier.contains(src) && fn.Update(src, dst)) {
+            next->push(dst);
+          }
+          return fn.Cond(dst);
+        };
+        if constexpr (HasInEdges<Graph>::value) {
+          for (auto e : graph.in_edges(dst)) {
+            if (!pull(graph.in_edge_dest(e))) {
+              break;
+            }
+          }
+        } else {
+          for (auto e : graph.edges(dst)) {
+            if (!pull(graph.edge_dest(e))) {
+              break;
+            }
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<64>(), katana::loopname(loopname));
+}
+
+}  // namespace internal
+
+/// Apply fn to the edges out of frontier and return the nodes it updated,
+/// the next frontier. fn provides
+///
+///     bool Cond(Node dst);  // whether dst can still be updated
+///     bool Update(Node src, Node dst);  // pull: dst is updated by one thread
+///     bool UpdateAtomic(Node src, Node dst);  // push: concurrent updates
+///
+/// where the updates return whether dst joins the next frontier.
+/// UpdateAtomic should return true at most once per node per call, e.g., only
+/// for the winner of a compare-and-swap, since a sparse frontier keeps
+/// duplicates.
+///
+/// By default, EdgeMap pushes from small frontiers and pulls into large ones,
+/// converting frontier to match. Pushing returns a sparse frontier and
+/// pulling a dense one. Pulling needs a graph with in edges, e.g., a
+/// bidirectional view, or a symmetric graph; other graphs always push.
+template <typename Graph, typename F>
+VertexSubset
+EdgeMap(
+    const Graph& graph, VertexSubset* frontier, F fn,
+    const EdgeMapOptions& options = EdgeMapOptions()) {
+  KATANA_LOG_DEBUG_ASSERT(frontier->num_nodes() == graph.num_nodes());
+
+  bool can_pull = internal::HasInEdges<Graph>::value || options.symmetric;
+  bool pull = false;
+  if (can_pull && options.direction == EdgeMapDirection::kPull) {
+    pull = true;
+  } else if (can_pull && options.direction == EdgeMapDirection::kAuto) {
+    GAccumulator<uint64_t> work;
+    frontier->ForEach(
+        [&](VertexSubset::Node n) { work += 1 + graph.degree(n); });
+    pull = work.reduce() > graph.num_edges() / options.dense_threshold;
+  }
+
+  if (pull) {
+    frontier->ToDense();
+    VertexSubset next = VertexSubset::MakeDense(graph.num_nodes());
+    internal::EdgeMapPull(graph, *frontier, fn, &next, options.loopname);
+    return next;
+  }
+
+  frontier->ToSparse();
+  VertexSubset next(graph.num_nodes());
+  internal::EdgeMapPush(graph, *frontier, fn, &next, options.loopname);
+  return next;
+}
+
+}  // namespace katana
+
+#endif
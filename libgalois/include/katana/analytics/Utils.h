@@ -24,7 +24,7 @@ class KATANA_EXPORT SourcePicker {
 public:
   explicit SourcePicker(const PropertyGraph& g) : graph(g) {}
 
-  uint32_t PickNext();
+  PropertyGraph::Node PickNext();
 };
 
 //! Used to determine if a graph has power-law degree distribution or not
@@ -62,7 +62,7 @@ public:
 
 /// Either a vector of node IDs or a number of nodes to use as sources.
 using BetweennessCentralitySources =
-    std::variant<std::vector<uint32_t>, uint32_t>;
+    std::variant<std::vector<PropertyGraph::Node>, uint32_t>;
 
 /// Use all sources instead of a subset.
 KATANA_EXPORT extern const BetweennessCentralitySources
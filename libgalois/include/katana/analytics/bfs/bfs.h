@@ -2,6 +2,8 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_BFS_BFS_H_
 
 #include <iostream>
+#include <limits>
+#include <vector>
 
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
@@ -76,7 +78,31 @@ public:
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
 KATANA_EXPORT Result<void> Bfs(
-    PropertyGraph* pg, uint32_t start_node,
+    PropertyGraph* pg, PropertyGraph::Node start_node,
+    const std::string& output_property_name, BfsPlan algo = {});
+
+/// The number of sources that MultiSourceBfs traverses together
+constexpr uint32_t kMultiSourceBfsBatchSize = 512;
+
+/// The distance that MultiSourceBfs gives nodes unreachable from a source
+constexpr uint32_t kMultiSourceBfsUnreachable =
+    std::numeric_limits<uint32_t>::max();
+
+/// Compute the BFS distances of the nodes of pg from each of sources. Batches
+/// of kMultiSourceBfsBatchSize sources are traversed together: each node
+/// keeps a bit per source of the batch, so a round reads each edge once for
+/// the batch instead of once per source.
+///
+/// The result is stored in a property named by output_property_name, a
+/// fixed size list of uint32 with the distance of the node from each source,
+/// in the order of sources, or kMultiSourceBfsUnreachable. The property is
+/// created by this function and may not exist before the call.
+///
+/// A kSynchronousDirectOpt plan switches between pushing to and pulling from
+/// the neighbors of the frontier with the alpha and beta of the plan, as Bfs
+/// does; a kSynchronous plan always pushes. Other plans are not supported.
+KATANA_EXPORT Result<void> MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<PropertyGraph::Node>& sources,
     const std::string& output_property_name, BfsPlan algo = {});
 
 /// Do a quick validation of the results of a BFS computation where the results
@@ -84,7 +110,8 @@ KATANA_EXPORT Result<void> Bfs(
 /// @return a failure if the BFS results do not pass validation or if there is a
 ///     failure during checking.
 KATANA_EXPORT Result<void> BfsAssertValid(
-    PropertyGraph* pg, uint32_t source, const std::string& property_name);
+    PropertyGraph* pg, PropertyGraph::Node source,
+    const std::string& property_name);
 
 /// Statistics about a graph that can be extracted from the results of BFS.
 struct KATANA_EXPORT BfsStatistics {
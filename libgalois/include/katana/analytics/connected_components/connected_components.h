@@ -71,7 +71,9 @@ public:
 
   /// Label propagation push-style algorithm. Initially, all nodes are in
   /// their own component IDs (same as their node IDs). Then, the component
-  /// IDs are set to the minimum component ID in their neighborhood.
+  /// IDs are set to the minimum component ID in their neighborhood. On a
+  /// graph loaded from a compressed topology file, this runs on
+  /// PropertyGraphViews::Compressed without decoding the CSR.
   static ConnectedComponentsPlan LabelProp() {
     return {kCPU, kLabelProp, 0, 0, 0};
   }
@@ -58,11 +58,12 @@ using JaccardSimilarity = katana::PODProperty<double>;
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
 KATANA_EXPORT Result<void> Jaccard(
-    PropertyGraph* pg, uint32_t compare_node,
+    PropertyGraph* pg, PropertyGraph::Node compare_node,
     const std::string& output_property_name, JaccardPlan plan = {});
 
 KATANA_EXPORT Result<void> JaccardAssertValid(
-    PropertyGraph* pg, uint32_t compare_node, const std::string& property_name);
+    PropertyGraph* pg, PropertyGraph::Node compare_node,
+    const std::string& property_name);
 
 struct KATANA_EXPORT JaccardStatistics {
   /// The maximum similarity excluding the comparison node.
@@ -76,7 +77,7 @@ struct KATANA_EXPORT JaccardStatistics {
   void Print(std::ostream& os = std::cout);
 
   static katana::Result<JaccardStatistics> Compute(
-      katana::PropertyGraph* pg, uint32_t compare_node,
+      katana::PropertyGraph* pg, katana::PropertyGraph::Node compare_node,
       const std::string& property_name);
 };
 
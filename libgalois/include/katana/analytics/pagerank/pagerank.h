@@ -2,6 +2,8 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_PAGERANK_PAGERANK_H_
 
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
@@ -112,6 +114,33 @@ KATANA_EXPORT Result<void> Pagerank(
     PropertyGraph* pg, const std::string& output_property_name,
     PagerankPlan plan = {});
 
+/// Compute the Page Rank of each node starting from the ranks in the float
+/// property initial_rank_property_name, e.g., those of an earlier run on the
+/// graph before it changed. Only the difference between the initial ranks
+/// and the ranks of the current graph is pushed, which takes far fewer
+/// rounds than starting from scratch when the graph changed little. Ranks
+/// are scaled as the residual and push algorithms scale them, where a node
+/// without in edges has rank 1 - alpha, not as PullTopological does. Only
+/// the tolerance and alpha of plan are used. The property named
+/// output_property_name is created by this function and may not exist before
+/// the call.
+KATANA_EXPORT Result<void> PagerankWarmStart(
+    PropertyGraph* pg, const std::string& initial_rank_property_name,
+    const std::string& output_property_name, PagerankPlan plan = {});
+
+/// Update the ranks that Pagerank wrote to output_property_name after the
+/// edges from srcs[i] to dests[i] were inserted or deleted. Residuals are
+/// only computed for the endpoints of those edges and the out neighbors of
+/// srcs, the only nodes whose rank equation changed, and pushed from there;
+/// the rest of the graph is visited only as far as the change spreads. The
+/// ranks must be scaled as the residual and push algorithms scale them (see
+/// PagerankWarmStart), so the output of PullTopological is not supported.
+/// Only the tolerance and alpha of plan are used.
+KATANA_EXPORT Result<void> IncrementalPagerank(
+    PropertyGraph* pg, const std::vector<PropertyGraph::Node>& srcs,
+    const std::vector<PropertyGraph::Node>& dests,
+    const std::string& output_property_name, PagerankPlan plan = {});
+
 KATANA_EXPORT Result<void> PagerankAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
@@ -130,6 +159,86 @@ struct KATANA_EXPORT PagerankStatistics {
       katana::PropertyGraph* pg, const std::string& property_name);
 };
 
+/// A computational plan for Personalized Page Rank, the stationary
+/// distribution of a random walk that restarts at a set of seed nodes.
+class PersonalizedPagerankPlan : public Plan {
+public:
+  enum Algorithm {
+    kForwardPush,
+  };
+
+  static constexpr double kDefaultAlpha = 0.85;
+  static constexpr double kDefaultEpsilon = 1.0e-5;
+  static const uint32_t kDefaultTopK = 100;
+
+private:
+  Algorithm algorithm_;
+  float alpha_;
+  float epsilon_;
+  uint32_t top_k_;
+
+  PersonalizedPagerankPlan(
+      Architecture architecture, Algorithm algorithm, float alpha,
+      float epsilon, uint32_t top_k)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        alpha_(alpha),
+        epsilon_(epsilon),
+        top_k_(top_k) {}
+
+public:
+  PersonalizedPagerankPlan()
+      : PersonalizedPagerankPlan(
+            kCPU, kForwardPush, kDefaultAlpha, kDefaultEpsilon, kDefaultTopK) {
+  }
+
+  Algorithm algorithm() const { return algorithm_; }
+  /// The probability that the walk follows an edge rather than restarting
+  float alpha() const { return alpha_; }
+  /// The residual per out edge below which a node is not pushed
+  float epsilon() const { return epsilon_; }
+  /// The number of nodes in a result
+  uint32_t top_k() const { return top_k_; }
+
+  /// Forward push algorithm
+  ///
+  /// Rank moves from a node to its out neighbors only while the node holds
+  /// more than epsilon residual per out edge, so a query reads the
+  /// neighborhood of its seeds rather than the whole graph: the work is
+  /// O(1 / (epsilon * (1 - alpha))) whatever the size of the graph. Ranks
+  /// are underestimated by at most epsilon times the out degree of a node.
+  ///
+  /// ANDERSEN, Reid; CHUNG, Fan; LANG, Kevin. Local graph partitioning using
+  /// PageRank vectors. In: 47th Annual IEEE Symposium on Foundations of
+  /// Computer Science (FOCS'06). IEEE, 2006. p. 475-486.
+  static PersonalizedPagerankPlan ForwardPush(
+      float alpha = kDefaultAlpha, float epsilon = kDefaultEpsilon,
+      uint32_t top_k = kDefaultTopK) {
+    return {kCPU, kForwardPush, alpha, epsilon, top_k};
+  }
+};
+
+/// The highest ranked nodes of a Personalized Page Rank query and their
+/// ranks, in decreasing order of rank
+using PersonalizedPagerankTopK =
+    std::vector<std::pair<PropertyGraph::Node, float>>;
+
+/// Compute the Personalized Page Rank of the nodes of pg for a walk that
+/// restarts at one of seeds, chosen uniformly, and return the plan.top_k()
+/// nodes of highest rank. Walks that reach a node without out edges restart
+/// too. A query runs on the calling thread and touches only the nodes near
+/// the seeds.
+KATANA_EXPORT Result<PersonalizedPagerankTopK> PersonalizedPagerank(
+    PropertyGraph* pg, const std::vector<PropertyGraph::Node>& seeds,
+    PersonalizedPagerankPlan plan = {});
+
+/// Run a PersonalizedPagerank query for each node of seeds, in parallel.
+/// Element i of the result is the query for seeds[i].
+KATANA_EXPORT Result<std::vector<PersonalizedPagerankTopK>>
+PersonalizedPagerankBatch(
+    PropertyGraph* pg, const std::vector<PropertyGraph::Node>& seeds,
+    PersonalizedPagerankPlan plan = {});
+
 }  // namespace katana::analytics
 
 #endif
@@ -2,7 +2,11 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
+#include <arrow/type_fwd.h>
 #include <katana/analytics/Plan.h>
 
 #include "katana/AtomicHelpers.h"
@@ -136,9 +140,28 @@ public:
 /// Compute the random-walks for pg. The pg is expected to be symmetric. The
 /// parameters can be specified, but have reasonable defaults. Not all
 /// parameters are used by the algorithms. The generated random-walks generated
-/// are returned as a vector of vectors.
-KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
-    PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
+/// are returned as a vector of vectors. Node2Vec walks end early at nodes
+/// without edges; Edge2Vec walks that reach such a node are dropped.
+KATANA_EXPORT Result<std::vector<std::vector<PropertyGraph::Node>>>
+RandomWalks(PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
+
+/// Compute the random-walks for pg like RandomWalks, and return them as a
+/// list array of node ids, as wide as PropertyGraph::Node. Walk i starts at
+/// node i % pg->num_nodes() and is empty if that node has no edges; for
+/// Edge2Vec, the walks of each iteration follow those of the previous one.
+/// Walks that reach a node without edges end there, for both algorithms, and
+/// Edge2Vec leaves them out when it updates its transition matrix. Walks are
+/// written in place to a buffer allocated up front, which becomes the values
+/// of the array without a copy unless some walk ends early.
+///
+/// If edge_weight_property_name is not empty, a walk leaves a node by an
+/// edge with probability proportional to the weight of the edge before the
+/// node2vec bias. Edges are drawn in constant time from alias tables built
+/// once, in parallel. Weights must be numeric and non-negative.
+KATANA_EXPORT Result<std::shared_ptr<arrow::LargeListArray>>
+RandomWalksAsArrow(
+    PropertyGraph* pg, const std::string& edge_weight_property_name = "",
+    RandomWalksPlan plan = RandomWalksPlan());
 
 KATANA_EXPORT Result<void> RandomWalksAssertValid(PropertyGraph* pg);
 
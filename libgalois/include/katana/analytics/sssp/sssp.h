@@ -2,6 +2,7 @@
 #define KATANA_LIBGALOIS_KATANA_ANALYTICS_SSSP_SSSP_H_
 
 #include <iostream>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
@@ -126,6 +127,37 @@ KATANA_EXPORT Result<void> Sssp(
     const std::string& edge_weight_property_name,
     const std::string& output_property_name, SsspPlan plan = {});
 
+/// Compute the shortest path lengths of the nodes of pg from each of sources.
+/// The sources share one delta-stepping worklist, so a bucket holds the
+/// pending updates of every source at that distance and the sources advance
+/// together instead of one after another. The edge weights are taken from
+/// the property named edge_weight_property_name, as for Sssp, and the path
+/// lengths are stored in the property named output_property_name: a fixed
+/// size list per node with the length from each source, in the order of
+/// sources, of the type of the edge weights. Unreachable nodes have the
+/// length std::numeric_limits<Weight>::max() / 4, as for Sssp.
+///
+/// Only the kDeltaStep, kDeltaStepBarrier and kAutomatic plans are supported.
+KATANA_EXPORT Result<void> MultiSourceSssp(
+    PropertyGraph* pg, const std::vector<PropertyGraph::Node>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, SsspPlan plan = {});
+
+/// Update the path lengths that Sssp stored in the property named
+/// output_property_name after the weights of the edges srcs[i] -> dests[i]
+/// decreased or those edges were inserted. Only the nodes whose path length
+/// shrinks are visited. The weights must be of the same type as the path
+/// lengths.
+///
+/// Path lengths never grow here, so weight increases and deleted edges need
+/// a new Sssp. Only the delta of the plan is used; plans without one use
+/// SsspPlan::kDefaultDelta.
+KATANA_EXPORT Result<void> IncrementalSssp(
+    PropertyGraph* pg, const std::vector<PropertyGraph::Node>& srcs,
+    const std::vector<PropertyGraph::Node>& dests,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, SsspPlan plan = {});
+
 KATANA_EXPORT Result<void> SsspAssertValid(
     PropertyGraph* pg, size_t start_node,
     const std::string& edge_weight_property_name,
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "katana/GraphTopology.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+#include "tsuba/CSRTopology.h"
+
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+
+/// The zigzag code of dest - base, so that small negative deltas (from
+/// unsorted edges) also get short codes
+uint64_t
+ZigzagDelta(Node base, Node dest) {
+  auto delta = static_cast<int64_t>(dest) - static_cast<int64_t>(base);
+  return (static_cast<uint64_t>(delta) << 1) ^
+         static_cast<uint64_t>(delta >> 63);
+}
+
+/// Bytes of the variable-byte code of code
+uint64_t
+CodeSize(uint64_t code) {
+  uint64_t size = 1;
+  for (; code >= 0x80; code >>= 7) {
+    ++size;
+  }
+  return size;
+}
+
+uint8_t*
+EncodeCode(uint64_t code, uint8_t* out) {
+  for (; code >= 0x80; code >>= 7) {
+    *out++ = static_cast<uint8_t>(code | 0x80);
+  }
+  *out++ = static_cast<uint8_t>(code);
+  return out;
+}
+
+/// Bytes of the code of the destinations [begin, end) of node n
+uint64_t
+NeighborsCodeSize(Node n, const Node* begin, const Node* end) {
+  uint64_t size = 0;
+  Node base = n;
+  for (const Node* dest = begin; dest != end; ++dest) {
+    size += CodeSize(ZigzagDelta(base, *dest));
+    base = *dest;
+  }
+  return size;
+}
+
+/// Encode the destinations [begin, end) of node n at out
+/// @returns the end of the code
+uint8_t*
+EncodeNeighbors(Node n, const Node* begin, const Node* end, uint8_t* out) {
+  Node base = n;
+  for (const Node* dest = begin; dest != end; ++dest) {
+    out = EncodeCode(ZigzagDelta(base, *dest), out);
+    base = *dest;
+  }
+  return out;
+}
+
+}  // namespace
+
+katana::CompressedTopology
+katana::CompressedTopology::Make(const GraphTopology& topo) noexcept {
+  CompressedTopology ret;
+  ret.adj_indices_.allocateInterleaved(topo.num_nodes());
+  ret.byte_offsets_.allocateInterleaved(topo.num_nodes());
+  katana::ParallelSTL::copy(
+      topo.adj_data(), topo.adj_data() + topo.num_nodes(),
+      ret.adj_indices_.begin());
+
+  // Size the code of each node, then encode each node at the prefix sum of
+  // the sizes
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        ret.byte_offsets_[n] = NeighborsCodeSize(
+            n, topo.dest_data() + *topo.edges(n).begin(),
+            topo.dest_data() + *topo.edges(n).end());
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::ParallelSTL::partial_sum(
+      ret.byte_offsets_.begin(), ret.byte_offsets_.end(),
+      ret.byte_offsets_.begin());
+
+  uint64_t num_bytes =
+      ret.byte_offsets_.empty() ? 0 : ret.byte_offsets_[topo.num_nodes() - 1];
+  ret.bytes_.allocateInterleaved(num_bytes);
+
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        uint8_t* out = ret.bytes_.data() +
+                       (n > 0 ? ret.byte_offsets_[n - 1] : uint64_t{0});
+        out = EncodeNeighbors(
+            n, topo.dest_data() + *topo.edges(n).begin(),
+            topo.dest_data() + *topo.edges(n).end(), out);
+        KATANA_LOG_DEBUG_ASSERT(
+            out == ret.bytes_.data() + ret.byte_offsets_[n]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return ret;
+}
+
+katana::Result<katana::CompressedTopology>
+katana::CompressedTopology::Make(
+    const tsuba::CompressedCSRView& view) noexcept {
+  const uint64_t num_nodes = view.header().num_nodes;
+  const uint64_t num_blocks = view.num_blocks();
+
+  CompressedTopology ret;
+  ret.adj_indices_.allocateInterleaved(num_nodes);
+  ret.byte_offsets_.allocateInterleaved(num_nodes);
+
+  // Decode block into a buffer of its edges and call fn(n, begin, end) with
+  // the destinations of each of its nodes. The file's block index gives the
+  // edge range of the block, so only the buffer is ever decoded.
+  std::atomic<uint64_t> bad_block = num_blocks;
+  auto for_each_node_of_block = [&](uint64_t block, auto fn) {
+    const uint64_t first_edge = view.block_first_edge(block);
+    std::vector<Node> dests(view.block_first_edge(block + 1) - first_edge);
+    if (!view.DecodeBlockLocal(
+            block, ret.adj_indices_.data(), dests.data())) {
+      bad_block = block;
+      return;
+    }
+    const uint64_t first_node = block * view.nodes_per_block();
+    const uint64_t last_node =
+        std::min(first_node + view.nodes_per_block(), num_nodes);
+    const Node* begin = dests.data();
+    for (uint64_t n = first_node; n < last_node; ++n) {
+      const Node* end = dests.data() + (ret.adj_indices_[n] - first_edge);
+      fn(static_cast<Node>(n), begin, end);
+      begin = end;
+    }
+  };
+
+  // As in Make(GraphTopology), size the code of each node, then encode each
+  // node at the prefix sum of the sizes
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        for_each_node_of_block(
+            block, [&](Node n, const Node* begin, const Node* end) {
+              ret.byte_offsets_[n] = NeighborsCodeSize(n, begin, end);
+            });
+      },
+      katana::steal(), katana::no_stats());
+
+  if (uint64_t block = bad_block; block != num_blocks) {
+    // Decode the block again to recover its error
+    std::vector<Node> dests(
+        view.block_first_edge(block + 1) - view.block_first_edge(block));
+    KATANA_CHECKED(
+        view.DecodeBlockLocal(block, ret.adj_indices_.data(), dests.data()));
+  }
+
+  katana::ParallelSTL::partial_sum(
+      ret.byte_offsets_.begin(), ret.byte_offsets_.end(),
+      ret.byte_offsets_.begin());
+
+  uint64_t num_bytes =
+      ret.byte_offsets_.empty() ? 0 : ret.byte_offsets_[num_nodes - 1];
+  ret.bytes_.allocateInterleaved(num_bytes);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        for_each_node_of_block(
+            block, [&](Node n, const Node* begin, const Node* end) {
+              uint8_t* out = ret.bytes_.data() +
+                             (n > 0 ? ret.byte_offsets_[n - 1] : uint64_t{0});
+              out = EncodeNeighbors(n, begin, end, out);
+              KATANA_LOG_DEBUG_ASSERT(
+                  out == ret.bytes_.data() + ret.byte_offsets_[n]);
+            });
+      },
+      katana::steal(), katana::no_stats());
+
+  return MakeResult(std::move(ret));
+}
+
+katana::GraphTopology
+katana::CompressedTopology::Decompress() const noexcept {
+  GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes());
+  katana::ParallelSTL::copy(
+      adj_indices_.begin(), adj_indices_.end(), adj_indices.begin());
+
+  GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges());
+  katana::do_all(
+      katana::iterate(all_nodes()),
+      [&](Node n) { DecodeNeighbors(n, dests.data() + edge_begin(n)); },
+      katana::steal(), katana::no_stats());
+
+  return GraphTopology(std::move(adj_indices), std::move(dests));
+}
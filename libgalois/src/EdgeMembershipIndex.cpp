@@ -0,0 +1,75 @@
+#include "katana/GraphTopology.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+
+/// Slots of the hash set of a node with degree edges; zero if the node is
+/// searched in its edges instead
+uint64_t
+TableCapacity(uint64_t degree, uint64_t hash_degree) {
+  if (degree < hash_degree || degree == 0) {
+    return 0;
+  }
+  // The smallest power of two that keeps the table at most half full
+  uint64_t capacity = 1;
+  while (capacity < 2 * degree) {
+    capacity <<= 1;
+  }
+  return capacity;
+}
+
+}  // namespace
+
+katana::EdgeMembershipIndex
+katana::EdgeMembershipIndex::Make(
+    const EdgeShuffleTopology* topo, uint64_t hash_degree) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(topo->has_edges_sorted_by(
+      EdgeShuffleTopology::EdgeSortKind::kSortedByDestID));
+
+  EdgeMembershipIndex ret;
+  ret.topo_ = topo;
+  ret.hash_degree_ = hash_degree;
+  ret.table_ends_.allocateInterleaved(topo->num_nodes());
+
+  katana::do_all(
+      katana::iterate(topo->all_nodes()),
+      [&](Node n) {
+        ret.table_ends_[n] = TableCapacity(topo->degree(n), hash_degree);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      ret.table_ends_.begin(), ret.table_ends_.end(), ret.table_ends_.begin());
+
+  uint64_t num_slots =
+      ret.table_ends_.empty() ? 0 : ret.table_ends_[topo->num_nodes() - 1];
+  ret.slots_.allocateInterleaved(num_slots);
+  katana::ParallelSTL::fill(ret.slots_.begin(), ret.slots_.end(), kEmptySlot);
+
+  // Only hubs have tables, so steal to balance their large degrees
+  katana::do_all(
+      katana::iterate(topo->all_nodes()),
+      [&](Node n) {
+        uint64_t begin = n > 0 ? ret.table_ends_[n - 1] : 0;
+        uint64_t capacity = ret.table_ends_[n] - begin;
+        if (capacity == 0) {
+          return;
+        }
+        uint64_t mask = capacity - 1;
+        for (auto e : topo->edges(n)) {
+          Node dest = topo->edge_dest(e);
+          uint64_t slot = Hash(dest) & mask;
+          // Parallel edges are stored once
+          while (ret.slots_[begin + slot] != kEmptySlot &&
+                 ret.slots_[begin + slot] != dest) {
+            slot = (slot + 1) & mask;
+          }
+          ret.slots_[begin + slot] = dest;
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return ret;
+}
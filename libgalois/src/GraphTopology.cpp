@@ -1,10 +1,23 @@
 #include "katana/GraphTopology.h"
 
+#include <algorithm>
 #include <iostream>
+#include <set>
 
+#include <arrow/buffer.h>
+#include <arrow/compute/api_vector.h>
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
 #include "katana/Logging.h"
+#include "katana/NodeOrdering.h"
 #include "katana/PropertyGraph.h"
 #include "katana/Random.h"
+#include "katana/Reduction.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/FileView.h"
+#include "tsuba/RDG.h"
 
 void
 katana::GraphTopology::Print() const noexcept {
@@ -38,6 +51,47 @@ katana::GraphTopology::Copy(const GraphTopology& that) noexcept {
       that.dests_.size());
 }
 
+katana::GraphTopology
+katana::GraphTopology::MakeBorrowed(
+    const Edge* adj_indices, size_t num_nodes, const Node* dests,
+    size_t num_edges, std::shared_ptr<const void> owner) noexcept {
+  // NUMAArrays that wrap a buffer do not free it
+  GraphTopology topo{
+      NUMAArray<Edge>(const_cast<Edge*>(adj_indices), num_nodes),
+      NUMAArray<Node>(const_cast<Node*>(dests), num_edges)};
+  topo.borrowed_ = true;
+  topo.borrowed_owner_ = std::move(owner);
+  return topo;
+}
+
+void
+katana::GraphTopology::MakeMutable() noexcept {
+  if (!borrowed_) {
+    return;
+  }
+  *this = Copy(*this);
+  KATANA_LOG_DEBUG_ASSERT(!borrowed_);
+}
+
+void
+katana::GraphTopology::PageInInterleaved() const noexcept {
+  if (!borrowed_) {
+    return;
+  }
+  constexpr size_t kPageSize = 4096;
+  auto page_in = [](const void* ptr, size_t length) {
+    katana::on_each([&](unsigned tid, unsigned num_threads) {
+      const volatile char* cptr = static_cast<const volatile char*>(ptr);
+      for (size_t x = kPageSize * tid; x < length;
+           x += kPageSize * num_threads) {
+        cptr[x];
+      }
+    });
+  };
+  page_in(adj_indices_.data(), adj_indices_.size() * sizeof(Edge));
+  page_in(dests_.data(), dests_.size() * sizeof(Node));
+}
+
 std::unique_ptr<katana::ShuffleTopology>
 katana::ShuffleTopology::MakeFrom(
     const PropertyGraph*, const katana::EdgeShuffleTopology&) noexcept {
@@ -330,6 +384,95 @@ katana::ShuffleTopology::MakeSortedByNodeType(
   return MakeNodeSortedTopo(seed_topo, cmp, NodeSortKind::kSortedByNodeType);
 }
 
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeReorderedForLocality(
+    const katana::EdgeShuffleTopology& seed_topo,
+    const NodeSortKind& node_sort_todo) noexcept {
+  PropIndexVec node_prop_indices;
+  switch (node_sort_todo) {
+  case NodeSortKind::kReverseCuthillMcKee:
+    node_prop_indices = ReverseCuthillMcKeeOrder(seed_topo);
+    break;
+  case NodeSortKind::kHubSorted:
+    node_prop_indices = HubSortOrder(seed_topo);
+    break;
+  case NodeSortKind::kHubClustered:
+    node_prop_indices = HubClusterOrder(seed_topo);
+    break;
+  case NodeSortKind::kGorder:
+    node_prop_indices = GorderOrder(seed_topo);
+    break;
+  case NodeSortKind::kRabbitOrder:
+    node_prop_indices = RabbitOrder(seed_topo);
+    break;
+  default:
+    KATANA_LOG_FATAL(
+        "not a locality ordering: {}", static_cast<int>(node_sort_todo));
+  }
+
+  return MakeNodePermutedTopo(
+      seed_topo, std::move(node_prop_indices), node_sort_todo);
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::ShuffleTopology::MakeNodePermutedTopo(
+    const katana::EdgeShuffleTopology& seed_topo,
+    PropIndexVec&& node_prop_indices,
+    const NodeSortKind& node_sort_todo) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(node_prop_indices.size() == seed_topo.num_nodes());
+
+  GraphTopology::AdjIndexVec degrees;
+  degrees.allocateInterleaved(seed_topo.num_nodes());
+
+  katana::NUMAArray<GraphTopologyTypes::Node> old_to_new_map;
+  old_to_new_map.allocateInterleaved(seed_topo.num_nodes());
+  katana::do_all(
+      katana::iterate(size_t{0}, node_prop_indices.size()),
+      [&](auto i) {
+        // node_prop_indices[i] gives old node id
+        old_to_new_map[node_prop_indices[i]] = i;
+        degrees[i] = seed_topo.degree(node_prop_indices[i]);
+      },
+      katana::no_stats());
+
+  katana::ParallelSTL::partial_sum(
+      degrees.begin(), degrees.end(), degrees.begin());
+
+  GraphTopologyTypes::EdgeDestVec new_dest_vec;
+  new_dest_vec.allocateInterleaved(seed_topo.num_edges());
+
+  GraphTopologyTypes::PropIndexVec edge_prop_indices;
+  edge_prop_indices.allocateInterleaved(seed_topo.num_edges());
+
+  katana::do_all(
+      katana::iterate(seed_topo.all_nodes()),
+      [&](auto old_src_id) {
+        auto new_srd_id = old_to_new_map[old_src_id];
+        auto new_out_index = new_srd_id > 0 ? degrees[new_srd_id - 1] : 0;
+
+        for (auto e : seed_topo.edges(old_src_id)) {
+          auto new_edge_dest = old_to_new_map[seed_topo.edge_dest(e)];
+          KATANA_LOG_DEBUG_ASSERT(new_edge_dest < seed_topo.num_nodes());
+
+          auto new_edge_id = new_out_index;
+          ++new_out_index;
+          KATANA_LOG_DEBUG_ASSERT(new_out_index <= degrees[new_srd_id]);
+
+          new_dest_vec[new_edge_id] = new_edge_dest;
+
+          // copy over edge_property_index mapping from old edge to new edge
+          edge_prop_indices[new_edge_id] = seed_topo.edge_property_index(e);
+        }
+        KATANA_LOG_DEBUG_ASSERT(new_out_index == degrees[new_srd_id]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return std::make_unique<ShuffleTopology>(ShuffleTopology{
+      seed_topo.transpose_state(), node_sort_todo, seed_topo.edge_sort_state(),
+      std::move(degrees), std::move(node_prop_indices), std::move(new_dest_vec),
+      std::move(edge_prop_indices)});
+}
+
 std::unique_ptr<katana::CondensedTypeIDMap>
 katana::CondensedTypeIDMap::MakeFromEdgeTypes(
     const katana::PropertyGraph* pg) noexcept {
@@ -442,7 +585,7 @@ katana::EdgeTypeAwareTopology::MakeFrom(
 
 std::unique_ptr<katana::ProjectedTopology>
 katana::ProjectedTopology::CreateEmptyEdgeProjectedTopology(
-    const katana::PropertyGraph* pg, uint32_t num_new_nodes) {
+    const katana::PropertyGraph* pg, Node num_new_nodes) {
   const auto& topology = pg->topology();
 
   katana::NUMAArray<Edge> out_indices;
@@ -481,6 +624,92 @@ katana::ProjectedTopology::CreateEmptyProjectedTopology(
   return CreateEmptyEdgeProjectedTopology(pg, 0);
 }
 
+katana::MaskedTopology::MaskedTopology(
+    const GraphTopology* topo, std::shared_ptr<DynamicBitset> node_mask,
+    std::shared_ptr<DynamicBitset> edge_mask) noexcept
+    : topo_(topo),
+      node_mask_(std::move(node_mask)),
+      edge_mask_(std::move(edge_mask)) {
+  KATANA_LOG_DEBUG_ASSERT(node_mask_->size() == topo_->num_nodes());
+  KATANA_LOG_DEBUG_ASSERT(edge_mask_->size() == topo_->num_edges());
+  num_selected_nodes_ = node_mask_->count();
+  num_selected_edges_ = edge_mask_->count();
+}
+
+katana::MaskedTopology
+katana::MaskedTopology::MakeTypeMasked(
+    const katana::PropertyGraph* pg, const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types) noexcept {
+  KATANA_LOG_DEBUG_ASSERT(pg);
+  const auto& topology = pg->topology();
+
+  std::set<katana::EntityTypeID> node_entity_type_ids;
+  for (const auto& node_type : node_types) {
+    node_entity_type_ids.insert(pg->GetNodeEntityTypeID(node_type));
+  }
+  std::set<katana::EntityTypeID> edge_entity_type_ids;
+  for (const auto& edge_type : edge_types) {
+    edge_entity_type_ids.insert(pg->GetEdgeEntityTypeID(edge_type));
+  }
+
+  auto node_mask = std::make_shared<katana::DynamicBitset>();
+  node_mask->resize(topology.num_nodes());
+  auto edge_mask = std::make_shared<katana::DynamicBitset>();
+  edge_mask->resize(topology.num_edges());
+
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto n) {
+        if (node_entity_type_ids.empty()) {
+          node_mask->set(n);
+          return;
+        }
+        for (auto type : node_entity_type_ids) {
+          if (pg->DoesNodeHaveType(n, type)) {
+            node_mask->set(n);
+            return;
+          }
+        }
+      },
+      katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(topology.all_nodes()),
+      [&](auto src) {
+        if (!node_mask->test(src)) {
+          return;
+        }
+        for (Edge e : topology.edges(src)) {
+          if (!node_mask->test(topology.edge_dest(e))) {
+            continue;
+          }
+          if (edge_entity_type_ids.empty()) {
+            edge_mask->set(e);
+            continue;
+          }
+          for (auto type : edge_entity_type_ids) {
+            if (pg->DoesEdgeHaveType(e, type)) {
+              edge_mask->set(e);
+              break;
+            }
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return MaskedTopology(&topology, std::move(node_mask), std::move(edge_mask));
+}
+
+size_t
+katana::ProjectedTopology::num_bytes() const noexcept {
+  return (adj_indices_.size() + original_to_projected_edges_mapping_.size() +
+          projected_to_original_edges_mapping_.size()) *
+             sizeof(Edge) +
+         (dests_.size() + original_to_projected_nodes_mapping_.size() +
+          projected_to_original_nodes_mapping_.size()) *
+             sizeof(Node);
+}
+
 std::unique_ptr<katana::ProjectedTopology>
 katana::ProjectedTopology::MakeTypeProjectedTopology(
     const katana::PropertyGraph* pg, const std::vector<std::string>& node_types,
@@ -493,8 +722,8 @@ katana::ProjectedTopology::MakeTypeProjectedTopology(
   }
 
   // calculate number of new nodes
-  uint32_t num_new_nodes = 0;
-  uint32_t num_new_edges = 0;
+  Node num_new_nodes = 0;
+  uint64_t num_new_edges = 0;
 
   katana::DynamicBitset bitset_nodes;
   bitset_nodes.resize(topology.num_nodes());
@@ -521,7 +750,7 @@ katana::ProjectedTopology::MakeTypeProjectedTopology(
       node_entity_type_ids.insert(entity_type_id);
     }
 
-    katana::GAccumulator<uint32_t> accum_num_new_nodes;
+    katana::GAccumulator<Node> accum_num_new_nodes;
     katana::GAccumulator<uint64_t> accum_num_new_edges;
 
     katana::do_all(katana::iterate(topology.all_nodes()), [&](auto src) {
@@ -602,7 +831,7 @@ katana::ProjectedTopology::MakeTypeProjectedTopology(
       edge_entity_type_ids.insert(entity_type_id);
     }
 
-    katana::GAccumulator<uint32_t> accum_num_new_edges;
+    katana::GAccumulator<uint64_t> accum_num_new_edges;
 
     katana::do_all(
         katana::iterate(Node{0}, Node{num_new_nodes}),
@@ -637,6 +866,9 @@ katana::ProjectedTopology::MakeTypeProjectedTopology(
   // Prefix sum calculation of the edge index array
   katana::ParallelSTL::partial_sum(
       out_indices.begin(), out_indices.end(), out_indices.begin());
+  // Without edge types, num_new_edges is unset (all node types) or counts
+  // edges to unselected nodes too
+  num_new_edges = out_indices[num_new_nodes - 1];
 
   NUMAArray<Edge> out_dests_offset;
   out_dests_offset.allocateInterleaved(num_new_nodes);
@@ -692,6 +924,164 @@ katana::ProjectedTopology::MakeTypeProjectedTopology(
       std::move(original_to_projected_edges_mapping),
       std::move(projected_to_original_edges_mapping)});
 }
+
+namespace {
+
+/// node_sort_kind tag of derived topologies that only shuffle edges, i.e.,
+/// EdgeShuffleTopology as opposed to ShuffleTopology
+constexpr int32_t kEdgeShuffleOnly = -1;
+
+/// Destinations are stored as GraphTopology::Node, so builds with different
+/// node id widths use different versions and never read each other's files
+constexpr uint64_t kDerivedTopologyVersion =
+    sizeof(katana::GraphTopology::Node) == sizeof(uint64_t) ? 2 : 1;
+
+/// A derived topology file starts with this header, followed by
+/// adj_indices[num_nodes], edge_prop_indices[num_edges],
+/// node_prop_indices[num_nodes] (only if has_node_prop_indices) and
+/// dests[num_edges], so that all 64-bit arrays are 8-byte aligned
+struct DerivedTopologyHeader {
+  uint64_t version;
+  uint64_t num_nodes;
+  uint64_t num_edges;
+  uint64_t has_node_prop_indices;
+};
+
+struct DerivedTopologyArrays {
+  katana::GraphTopologyTypes::AdjIndexVec adj_indices;
+  katana::GraphTopologyTypes::EdgeDestVec dests;
+  katana::GraphTopologyTypes::PropIndexVec edge_prop_indices;
+  katana::GraphTopologyTypes::PropIndexVec node_prop_indices;
+};
+
+tsuba::DerivedTopologyKind
+MakeDerivedTopologyKind(
+    katana::EdgeShuffleTopology::TransposeKind tpose_kind,
+    katana::EdgeShuffleTopology::EdgeSortKind edge_sort_kind,
+    int32_t node_sort_kind) {
+  return tsuba::DerivedTopologyKind{
+      .transpose_kind = static_cast<int32_t>(tpose_kind),
+      .edge_sort_kind = static_cast<int32_t>(edge_sort_kind),
+      .node_sort_kind = node_sort_kind,
+  };
+}
+
+template <typename T>
+katana::Result<void>
+WriteArray(tsuba::FileFrame* ff, const T* data, uint64_t size) {
+  if (size == 0) {
+    return katana::ResultSuccess();
+  }
+  auto buf = arrow::Buffer::Wrap(data, size);
+  if (arrow::Status aro_sts = ff->Write(buf); !aro_sts.ok()) {
+    return tsuba::ArrowToTsuba(aro_sts.code());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::unique_ptr<tsuba::FileFrame>>
+WriteDerivedTopology(
+    const katana::GraphTopology& topo,
+    const katana::GraphTopologyTypes::PropIndexVec& edge_prop_indices,
+    const katana::GraphTopologyTypes::PropIndexVec* node_prop_indices) {
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  KATANA_CHECKED(ff->Init());
+
+  DerivedTopologyHeader header{
+      .version = kDerivedTopologyVersion,
+      .num_nodes = topo.num_nodes(),
+      .num_edges = topo.num_edges(),
+      .has_node_prop_indices = node_prop_indices != nullptr,
+  };
+  KATANA_CHECKED(WriteArray(ff.get(), &header, 1));
+  KATANA_CHECKED(WriteArray(ff.get(), topo.adj_data(), header.num_nodes));
+  KATANA_CHECKED(
+      WriteArray(ff.get(), edge_prop_indices.data(), header.num_edges));
+  if (node_prop_indices) {
+    KATANA_CHECKED(
+        WriteArray(ff.get(), node_prop_indices->data(), header.num_nodes));
+  }
+  KATANA_CHECKED(WriteArray(ff.get(), topo.dest_data(), header.num_edges));
+
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
+}
+
+template <typename T>
+const uint8_t*
+CopyArray(const uint8_t* src, uint64_t size, katana::NUMAArray<T>* dst) {
+  dst->allocateInterleaved(size);
+  const auto* begin = reinterpret_cast<const T*>(src);  // NOLINT
+  katana::ParallelSTL::copy(begin, begin + size, dst->begin());
+  return src + size * sizeof(T);
+}
+
+/// Read the derived topology of this kind stored with rdg. Returns nullptr if
+/// there is none.
+katana::Result<std::unique_ptr<DerivedTopologyArrays>>
+ReadDerivedTopology(
+    const tsuba::RDG& rdg, const tsuba::DerivedTopologyKind& kind,
+    const katana::PropertyGraph* pg, bool has_node_prop_indices) {
+  std::unique_ptr<tsuba::FileView> fv =
+      KATANA_CHECKED(rdg.LoadDerivedTopology(kind));
+  if (!fv) {
+    return std::unique_ptr<DerivedTopologyArrays>();
+  }
+
+  if (fv->size() < sizeof(DerivedTopologyHeader)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "derived topology file is too small: {} bytes", fv->size());
+  }
+  const auto* header = fv->ptr<DerivedTopologyHeader>();
+  if (header->version != kDerivedTopologyVersion) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "unknown derived topology version: {}", header->version);
+  }
+  if (header->num_nodes != pg->num_nodes() ||
+      header->num_edges != pg->num_edges()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "derived topology has {} nodes and {} edges, graph has {} and {}",
+        header->num_nodes, header->num_edges, pg->num_nodes(),
+        pg->num_edges());
+  }
+  if ((header->has_node_prop_indices != 0) != has_node_prop_indices) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "derived topology node shuffle does not match its kind");
+  }
+
+  uint64_t num_nodes = header->num_nodes;
+  uint64_t num_edges = header->num_edges;
+  uint64_t expected_size = sizeof(DerivedTopologyHeader) +
+                           num_nodes * sizeof(katana::GraphTopology::Edge) +
+                           num_edges * sizeof(katana::GraphTopology::Node) +
+                           num_edges * sizeof(katana::GraphTopology::Edge);
+  if (has_node_prop_indices) {
+    expected_size += num_nodes * sizeof(katana::GraphTopology::PropertyIndex);
+  }
+  if (fv->size() < expected_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "derived topology file is truncated: {} bytes, expected {}",
+        fv->size(), expected_size);
+  }
+
+  auto arrays = std::make_unique<DerivedTopologyArrays>();
+  const auto* cursor = fv->ptr<uint8_t>() + sizeof(DerivedTopologyHeader);
+  cursor = CopyArray(cursor, num_nodes, &arrays->adj_indices);
+  cursor = CopyArray(cursor, num_edges, &arrays->edge_prop_indices);
+  if (has_node_prop_indices) {
+    cursor = CopyArray(cursor, num_nodes, &arrays->node_prop_indices);
+  }
+  CopyArray(cursor, num_edges, &arrays->dests);
+
+  return std::unique_ptr<DerivedTopologyArrays>(std::move(arrays));
+}
+
+}  // namespace
+
 const katana::GraphTopology*
 katana::PGViewCache::GetOriginalTopology(
     const PropertyGraph* pg) const noexcept {
@@ -732,6 +1122,9 @@ katana::PGViewCache::BuildOrGetEdgeShuffTopo(
   if (it != edge_shuff_topos_.end()) {
     KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
     return it->get();
+  } else if (auto loaded = LoadEdgeShuffTopo(pg, tpose_kind, sort_kind)) {
+    edge_shuff_topos_.emplace_back(std::move(loaded));
+    return edge_shuff_topos_.back().get();
   } else {
     edge_shuff_topos_.emplace_back(
         EdgeShuffleTopology::Make(pg, tpose_kind, sort_kind));
@@ -758,6 +1151,10 @@ katana::PGViewCache::BuildOrGetShuffTopo(
   if (it != fully_shuff_topos_.end()) {
     KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, it->get()));
     return it->get();
+  } else if (auto loaded = LoadShuffTopo(
+                 pg, tpose_kind, node_sort_todo, edge_sort_todo)) {
+    fully_shuff_topos_.emplace_back(std::move(loaded));
+    return fully_shuff_topos_.back().get();
   } else {
     // EdgeShuffleTopology e_topo below is going to serve as a seed for
     // ShuffleTopology, so we only care about transpose state, and not the sort
@@ -775,6 +1172,77 @@ katana::PGViewCache::BuildOrGetShuffTopo(
   }
 }
 
+std::unique_ptr<katana::EdgeShuffleTopology>
+katana::PGViewCache::LoadEdgeShuffTopo(
+    const katana::PropertyGraph* pg,
+    const katana::EdgeShuffleTopology::TransposeKind& tpose_kind,
+    const katana::EdgeShuffleTopology::EdgeSortKind& sort_kind) const noexcept {
+  auto kind = MakeDerivedTopologyKind(tpose_kind, sort_kind, kEdgeShuffleOnly);
+  auto res = ReadDerivedTopology(pg->rdg_, kind, pg, false);
+  if (!res) {
+    KATANA_LOG_WARN("rebuilding edge shuffled topology: {}", res.error());
+    return nullptr;
+  }
+  std::unique_ptr<DerivedTopologyArrays> arrays = std::move(res.value());
+  if (!arrays) {
+    return nullptr;
+  }
+  return std::make_unique<EdgeShuffleTopology>(EdgeShuffleTopology{
+      tpose_kind, sort_kind, std::move(arrays->adj_indices),
+      std::move(arrays->dests), std::move(arrays->edge_prop_indices)});
+}
+
+std::unique_ptr<katana::ShuffleTopology>
+katana::PGViewCache::LoadShuffTopo(
+    const katana::PropertyGraph* pg,
+    const katana::EdgeShuffleTopology::TransposeKind& tpose_kind,
+    const katana::ShuffleTopology::NodeSortKind& node_sort_todo,
+    const katana::EdgeShuffleTopology::EdgeSortKind& edge_sort_todo)
+    const noexcept {
+  auto kind = MakeDerivedTopologyKind(
+      tpose_kind, edge_sort_todo, static_cast<int32_t>(node_sort_todo));
+  auto res = ReadDerivedTopology(pg->rdg_, kind, pg, true);
+  if (!res) {
+    KATANA_LOG_WARN("rebuilding shuffled topology: {}", res.error());
+    return nullptr;
+  }
+  std::unique_ptr<DerivedTopologyArrays> arrays = std::move(res.value());
+  if (!arrays) {
+    return nullptr;
+  }
+  return std::make_unique<ShuffleTopology>(ShuffleTopology{
+      tpose_kind, node_sort_todo, edge_sort_todo,
+      std::move(arrays->adj_indices), std::move(arrays->node_prop_indices),
+      std::move(arrays->dests), std::move(arrays->edge_prop_indices)});
+}
+
+katana::Result<void>
+katana::PGViewCache::PersistDerivedTopologies(
+    tsuba::RDG* rdg) const noexcept {
+  for (const auto& topo : edge_shuff_topos_) {
+    auto kind = MakeDerivedTopologyKind(
+        topo->transpose_state(), topo->edge_sort_state(), kEdgeShuffleOnly);
+    if (!topo->is_valid() || rdg->HasDerivedTopology(kind)) {
+      continue;
+    }
+    std::unique_ptr<tsuba::FileFrame> ff = KATANA_CHECKED(
+        WriteDerivedTopology(*topo, topo->edge_prop_indices_, nullptr));
+    rdg->AddDerivedTopology(kind, std::move(ff));
+  }
+  for (const auto& topo : fully_shuff_topos_) {
+    auto kind = MakeDerivedTopologyKind(
+        topo->transpose_state(), topo->edge_sort_state(),
+        static_cast<int32_t>(topo->node_sort_state_));
+    if (!topo->is_valid() || rdg->HasDerivedTopology(kind)) {
+      continue;
+    }
+    std::unique_ptr<tsuba::FileFrame> ff = KATANA_CHECKED(WriteDerivedTopology(
+        *topo, topo->edge_prop_indices_, &topo->node_prop_indices_));
+    rdg->AddDerivedTopology(kind, std::move(ff));
+  }
+  return katana::ResultSuccess();
+}
+
 katana::EdgeTypeAwareTopology*
 katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
     const katana::PropertyGraph* pg,
@@ -801,18 +1269,340 @@ katana::PGViewCache::BuildOrGetEdgeTypeAwareTopo(
   }
 }
 
-katana::ProjectedTopology*
+std::shared_ptr<const katana::CompressedTopology>
+katana::PGViewCache::BuildOrGetCompressedTopo(
+    const katana::PropertyGraph* pg) noexcept {
+  if (!compressed_topo_) {
+    if (pg->compressed_topology_) {
+      compressed_topo_ = pg->compressed_topology_;
+    } else {
+      compressed_topo_ = std::make_shared<CompressedTopology>(
+          CompressedTopology::Make(pg->topology()));
+    }
+  }
+  KATANA_LOG_DEBUG_ASSERT(CheckTopology(pg, compressed_topo_.get()));
+  return compressed_topo_;
+}
+
+void
+katana::PGViewCache::DropTopologies() noexcept {
+  // Views hold raw pointers to shuffled topologies, so those are only
+  // invalidated
+  for (auto& topo : edge_shuff_topos_) {
+    topo->invalidate();
+  }
+  for (auto& topo : fully_shuff_topos_) {
+    topo->invalidate();
+  }
+  compressed_topo_.reset();
+  // The index is keyed by the address of its sorted topology, which
+  // survives invalidation
+  membership_index_.reset();
+
+  std::lock_guard<std::mutex> lock(*lru_mutex_);
+  projected_topos_.clear();
+  projected_topos_bytes_ = 0;
+  // Permuted copies are keyed by the address of the topology they follow,
+  // which a rebuilt topology may reuse
+  permuted_props_.clear();
+  permuted_props_bytes_ = 0;
+}
+
+katana::EdgeMembershipIndex*
+katana::PGViewCache::BuildOrGetMembershipIndex(
+    const katana::EdgeShuffleTopology* sorted_topo) noexcept {
+  if (!membership_index_ || membership_index_->topology() != sorted_topo) {
+    membership_index_ = std::make_unique<EdgeMembershipIndex>(
+        EdgeMembershipIndex::Make(sorted_topo));
+  }
+  return membership_index_.get();
+}
+
+namespace {
+
+constexpr const char* kProjectedTopologyCacheEnv =
+    "KATANA_PROJECTED_TOPOLOGY_CACHE_MB";
+constexpr size_t kDefaultProjectedTopologyCacheMB = 4096;
+constexpr const char* kPermutedPropertyCacheEnv =
+    "KATANA_PERMUTED_PROPERTY_CACHE_MB";
+constexpr size_t kDefaultPermutedPropertyCacheMB = 1024;
+
+/// The budget in bytes given in MB by env_var, or default_mb if it is not set
+size_t
+CacheBudgetFromEnv(const char* env_var, size_t default_mb) {
+  size_t mb = default_mb;
+  if (int val = 0; katana::GetEnv(env_var, &val) && val >= 0) {
+    mb = val;
+  }
+  return mb << 20;
+}
+
+std::vector<std::string>
+CanonicalTypes(const std::vector<std::string>& types) {
+  std::vector<std::string> ret(types);
+  std::sort(ret.begin(), ret.end());
+  ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+  return ret;
+}
+
+/// An upper bound on the fraction of the edges of pg that MakeTypeMasked
+/// selects for node_types and edge_types, from counting the nodes and edges
+/// of those types. Cheaper than building the masks: it reads the type ids
+/// and edge indices but neither the edge destinations nor any mask.
+double
+MaxTypeSelectivity(
+    const katana::PropertyGraph* pg, const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types) {
+  const auto& topology = pg->topology();
+  if (topology.num_edges() == 0) {
+    return 1.0;
+  }
+
+  // Whether each most specific type has one of the given types
+  std::vector<uint8_t> node_type_selected(pg->GetNumNodeEntityTypes());
+  for (const auto& node_type : node_types) {
+    katana::EntityTypeID type = pg->GetNodeEntityTypeID(node_type);
+    for (size_t t = 0; t < node_type_selected.size(); ++t) {
+      node_type_selected[t] |= pg->IsNodeSubtypeOf(
+          type, static_cast<katana::EntityTypeID>(t));
+    }
+  }
+  std::vector<uint8_t> edge_type_selected(pg->GetNumEdgeEntityTypes());
+  for (const auto& edge_type : edge_types) {
+    katana::EntityTypeID type = pg->GetEdgeEntityTypeID(edge_type);
+    for (size_t t = 0; t < edge_type_selected.size(); ++t) {
+      edge_type_selected[t] |= pg->IsEdgeSubtypeOf(
+          type, static_cast<katana::EntityTypeID>(t));
+    }
+  }
+
+  // Selected edges leave a selected node and have a selected type
+  uint64_t max_selected = topology.num_edges();
+  if (!node_types.empty()) {
+    katana::GAccumulator<uint64_t> accum_out_edges;
+    katana::do_all(
+        katana::iterate(topology.all_nodes()),
+        [&](auto n) {
+          if (node_type_selected[pg->GetTypeOfNode(n)]) {
+            accum_out_edges += topology.degree(n);
+          }
+        },
+        katana::no_stats());
+    max_selected = std::min(max_selected, accum_out_edges.reduce());
+  }
+  if (!edge_types.empty()) {
+    katana::GAccumulator<uint64_t> accum_typed_edges;
+    katana::do_all(
+        katana::iterate(topology.all_edges()),
+        [&](auto e) {
+          if (edge_type_selected[pg->GetTypeOfEdge(e)]) {
+            accum_typed_edges += 1;
+          }
+        },
+        katana::no_stats());
+    max_selected = std::min(max_selected, accum_typed_edges.reduce());
+  }
+
+  return static_cast<double>(max_selected) /
+         static_cast<double>(topology.num_edges());
+}
+
+/// Gather the rows of property given by property_index(i) for i in
+/// [0, num_rows)
+katana::Result<std::shared_ptr<arrow::Array>>
+PermuteProperty(
+    const arrow::ChunkedArray& property, uint64_t num_rows,
+    const std::function<katana::GraphTopologyTypes::PropertyIndex(uint64_t)>&
+        property_index) {
+  if (property.num_chunks() != 1) {
+    // Katana form graphs only contain single chunk property columns.
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "property is in the wrong format");
+  }
+
+  katana::NUMAArray<uint64_t> rows;
+  rows.allocateInterleaved(num_rows);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_rows),
+      [&](uint64_t i) { rows[i] = property_index(i); }, katana::no_stats());
+
+  std::shared_ptr<arrow::Array> indices =
+      katana::ProjectAsArrowArray(rows.data(), rows.size());
+  arrow::Datum permuted = KATANA_CHECKED_CONTEXT(
+      arrow::compute::Take(
+          arrow::Datum(property.chunk(0)), arrow::Datum(indices)),
+      "permuting property");
+  return permuted.make_array();
+}
+
+}  // namespace
+
+katana::PGViewCache::PGViewCache()
+    : projected_topos_budget_(CacheBudgetFromEnv(
+          kProjectedTopologyCacheEnv, kDefaultProjectedTopologyCacheMB)),
+      permuted_props_budget_(CacheBudgetFromEnv(
+          kPermutedPropertyCacheEnv, kDefaultPermutedPropertyCacheMB)) {}
+
+std::shared_ptr<katana::ProjectedTopology>
+katana::PGViewCache::GetCachedProjectedTopo(
+    const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types) noexcept {
+  auto it = std::find_if(
+      projected_topos_.begin(), projected_topos_.end(), [&](const auto& e) {
+        return e.node_types == node_types && e.edge_types == edge_types;
+      });
+  if (it == projected_topos_.end()) {
+    return nullptr;
+  }
+  projected_topos_.splice(projected_topos_.begin(), projected_topos_, it);
+  return projected_topos_.front().topo;
+}
+
+std::shared_ptr<katana::ProjectedTopology>
 katana::PGViewCache::BuildOrGetProjectedGraphTopo(
     const PropertyGraph* pg, const std::vector<std::string>& node_types,
     const std::vector<std::string>& edge_types) noexcept {
-  if (projected_topos_) {
-    return projected_topos_.get();
+  std::vector<std::string> node_key = CanonicalTypes(node_types);
+  std::vector<std::string> edge_key = CanonicalTypes(edge_types);
+
+  // Held while building, so that concurrent requests for one projection
+  // build it once
+  std::lock_guard<std::mutex> lock(*lru_mutex_);
+  if (auto cached = GetCachedProjectedTopo(node_key, edge_key)) {
+    return cached;
+  }
+
+  std::shared_ptr<ProjectedTopology> topo =
+      ProjectedTopology::MakeTypeProjectedTopology(pg, node_key, edge_key);
+  KATANA_LOG_DEBUG_ASSERT(topo);
+  projected_topos_bytes_ += topo->num_bytes();
+  projected_topos_.emplace_front(ProjectedTopologyEntry{
+      std::move(node_key), std::move(edge_key), topo});
+  EvictProjectedTopologies();
+  return topo;
+}
+
+katana::FilteredTopology
+katana::PGViewCache::BuildOrGetFilteredTopo(
+    const PropertyGraph* pg, const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types,
+    double min_masked_selectivity) noexcept {
+  std::shared_ptr<ProjectedTopology> cached;
+  {
+    std::lock_guard<std::mutex> lock(*lru_mutex_);
+    cached = GetCachedProjectedTopo(
+        CanonicalTypes(node_types), CanonicalTypes(edge_types));
+  }
+  if (cached) {
+    return FilteredTopology(std::move(cached));
+  }
+
+  // Only pay for the masks if the filter may select enough to keep them
+  if (MaxTypeSelectivity(pg, node_types, edge_types) >=
+      min_masked_selectivity) {
+    MaskedTopology masked =
+        MaskedTopology::MakeTypeMasked(pg, node_types, edge_types);
+    if (masked.selectivity() >= min_masked_selectivity) {
+      return FilteredTopology(std::move(masked));
+    }
+  }
+  return FilteredTopology(
+      BuildOrGetProjectedGraphTopo(pg, node_types, edge_types));
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::PGViewCache::BuildOrGetPermutedProperty(
+    const PropertyGraph* pg, bool is_node, std::type_index view_type,
+    const void* topology_id, const std::string& name, uint64_t num_rows,
+    const std::function<PropertyIndex(uint64_t)>& property_index) noexcept {
+  std::lock_guard<std::mutex> lock(*lru_mutex_);
+  auto it = std::find_if(
+      permuted_props_.begin(), permuted_props_.end(), [&](const auto& e) {
+        return e.is_node == is_node && e.view_type == view_type &&
+               e.topology_id == topology_id && e.name == name;
+      });
+  if (it != permuted_props_.end()) {
+    permuted_props_.splice(permuted_props_.begin(), permuted_props_, it);
+    return permuted_props_.front().array;
+  }
+
+  std::shared_ptr<arrow::ChunkedArray> property;
+  if (is_node) {
+    property = KATANA_CHECKED(pg->GetNodeProperty(name));
+  } else {
+    property = KATANA_CHECKED(pg->GetEdgeProperty(name));
   }
+  auto permuted =
+      KATANA_CHECKED(PermuteProperty(*property, num_rows, property_index));
+  size_t num_bytes = ApproxArrayMemUse(permuted);
+  permuted_props_bytes_ += num_bytes;
+  permuted_props_.emplace_front(PermutedPropertyEntry{
+      is_node, view_type, topology_id, name, permuted, num_bytes});
+  EvictPermutedProperties();
+  return permuted;
+}
 
-  projected_topos_ =
-      ProjectedTopology::MakeTypeProjectedTopology(pg, node_types, edge_types);
-  KATANA_LOG_DEBUG_ASSERT(projected_topos_);
-  return projected_topos_.get();
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::PGViewCache::BuildOrGetPermutedNodeProperty(
+    const PropertyGraph* pg, std::type_index view_type,
+    const void* topology_id, const std::string& name, uint64_t num_nodes,
+    const std::function<PropertyIndex(uint64_t)>& property_index) noexcept {
+  return BuildOrGetPermutedProperty(
+      pg, true, view_type, topology_id, name, num_nodes, property_index);
+}
+
+katana::Result<std::shared_ptr<arrow::Array>>
+katana::PGViewCache::BuildOrGetPermutedEdgeProperty(
+    const PropertyGraph* pg, std::type_index view_type,
+    const void* topology_id, const std::string& name, uint64_t num_edges,
+    const std::function<PropertyIndex(uint64_t)>& property_index) noexcept {
+  return BuildOrGetPermutedProperty(
+      pg, false, view_type, topology_id, name, num_edges, property_index);
+}
+
+void
+katana::PGViewCache::set_permuted_property_budget(size_t bytes) noexcept {
+  std::lock_guard<std::mutex> lock(*lru_mutex_);
+  permuted_props_budget_ = bytes;
+  EvictPermutedProperties();
+}
+
+void
+katana::PGViewCache::EvictPermutedProperties() noexcept {
+  while (permuted_props_bytes_ > permuted_props_budget_ &&
+         !permuted_props_.empty()) {
+    permuted_props_bytes_ -= permuted_props_.back().num_bytes;
+    permuted_props_.pop_back();
+  }
+}
+
+void
+katana::PGViewCache::DropPermutedProperties(bool is_node) noexcept {
+  std::lock_guard<std::mutex> lock(*lru_mutex_);
+  for (auto it = permuted_props_.begin(); it != permuted_props_.end();) {
+    if (it->is_node == is_node) {
+      permuted_props_bytes_ -= it->num_bytes;
+      it = permuted_props_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void
+katana::PGViewCache::set_projected_topology_budget(size_t bytes) noexcept {
+  std::lock_guard<std::mutex> lock(*lru_mutex_);
+  projected_topos_budget_ = bytes;
+  EvictProjectedTopologies();
+}
+
+void
+katana::PGViewCache::EvictProjectedTopologies() noexcept {
+  while (projected_topos_bytes_ > projected_topos_budget_ &&
+         projected_topos_.size() > 1) {
+    projected_topos_bytes_ -= projected_topos_.back().topo->num_bytes();
+    projected_topos_.pop_back();
+  }
 }
 
 katana::GraphTopology
@@ -0,0 +1,393 @@
+#include "katana/MutablePropertyGraph.h"
+
+#include <numeric>
+
+#include <arrow/array.h>
+#include <arrow/compute/api_vector.h>
+#include <arrow/table.h>
+
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+
+namespace {
+
+/// Rows of table in the order given by rows
+katana::Result<std::shared_ptr<arrow::Table>>
+TakeRows(
+    const std::shared_ptr<arrow::Table>& table, const uint64_t* rows,
+    uint64_t num_rows) {
+  std::shared_ptr<arrow::Array> indices =
+      katana::ProjectAsArrowArray(rows, num_rows);
+  arrow::Datum taken = KATANA_CHECKED_CONTEXT(
+      arrow::compute::Take(arrow::Datum(table), arrow::Datum(indices)),
+      "permuting edge properties");
+  return taken.table();
+}
+
+/// Snapshots are built from the loaded properties of the previous one, so a
+/// property that is not loaded would be lost
+katana::Result<void>
+CheckPropertiesLoaded(const katana::PropertyGraph& pg) {
+  if (pg.full_node_schema()->num_fields() !=
+          pg.loaded_node_schema()->num_fields() ||
+      pg.full_edge_schema()->num_fields() !=
+          pg.loaded_edge_schema()->num_fields()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "graph has unloaded properties; load them first");
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::MutablePropertyGraph::MutablePropertyGraph(
+    std::shared_ptr<PropertyGraph> pg) noexcept
+    : snapshot_(std::move(pg)) {
+  snapshot_deleted_.resize(snapshot_->num_edges());
+}
+
+katana::Result<std::unique_ptr<katana::MutablePropertyGraph>>
+katana::MutablePropertyGraph::Make(std::shared_ptr<PropertyGraph> pg) noexcept {
+  if (!pg) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "property graph is null");
+  }
+  KATANA_CHECKED(CheckPropertiesLoaded(*pg));
+  return std::unique_ptr<MutablePropertyGraph>(
+      new MutablePropertyGraph(std::move(pg)));
+}
+
+katana::MutablePropertyGraph::DeltaBlock
+katana::MutablePropertyGraph::MakeDeltaBlock(
+    const std::vector<DeltaEdge>& edges) {
+  DeltaBlock block;
+  block.dests.resize(edges.size());
+  block.rows.resize(edges.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, edges.size()),
+      [&](size_t i) {
+        block.dests[i] = std::get<1>(edges[i]);
+        block.rows[i] = std::get<2>(edges[i]);
+      },
+      katana::no_stats());
+
+  for (size_t i = 0; i < edges.size(); ++i) {
+    Node src = std::get<0>(edges[i]);
+    if (block.srcs.empty() || block.srcs.back() != src) {
+      block.srcs.emplace_back(src);
+      block.ends.emplace_back(i);
+    }
+    ++block.ends.back();
+  }
+  block.deleted.resize(edges.size());
+  return block;
+}
+
+katana::Result<void>
+katana::MutablePropertyGraph::InsertEdges(
+    const std::vector<Node>& srcs, const std::vector<Node>& dests,
+    const std::shared_ptr<arrow::Table>& properties) noexcept {
+  if (srcs.size() != dests.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "sources and destinations differ in length: {} != {}", srcs.size(),
+        dests.size());
+  }
+  if (srcs.empty()) {
+    return katana::ResultSuccess();
+  }
+
+  katana::GReduceLogicalOr out_of_range;
+  katana::do_all(
+      katana::iterate(size_t{0}, srcs.size()),
+      [&](size_t i) {
+        if (srcs[i] >= num_nodes() || dests[i] >= num_nodes()) {
+          out_of_range.update(true);
+        }
+      },
+      katana::no_stats());
+  if (out_of_range.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge endpoint out of range: graph has {} nodes", num_nodes());
+  }
+
+  if (snapshot_->GetNumEdgeProperties() > 0) {
+    if (!properties) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "graph has edge properties but none were given for new edges");
+    }
+    if (!properties->schema()->Equals(*snapshot_->loaded_edge_schema())) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge property schema differs from the graph: {} != {}",
+          properties->schema()->ToString(),
+          snapshot_->loaded_edge_schema()->ToString());
+    }
+    if (static_cast<uint64_t>(properties->num_rows()) != srcs.size()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge properties have {} rows for {} edges", properties->num_rows(),
+          srcs.size());
+    }
+  } else if (properties && properties->num_columns() > 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "graph has no edge properties but some were given for new edges");
+  }
+
+  std::vector<DeltaEdge> edges(srcs.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, srcs.size()),
+      [&](size_t i) { edges[i] = DeltaEdge{srcs[i], dests[i], i}; },
+      katana::no_stats());
+  katana::ParallelSTL::sort(edges.begin(), edges.end());
+
+  DeltaBlock block = MakeDeltaBlock(edges);
+  if (snapshot_->GetNumEdgeProperties() > 0) {
+    block.properties = properties;
+  }
+  deltas_.emplace_back(std::move(block));
+  num_delta_edges_ += srcs.size();
+
+  if (deltas_.size() > kMaxDeltaBlocks) {
+    KATANA_CHECKED(MergeDeltaBlocks());
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<uint64_t>
+katana::MutablePropertyGraph::DeleteEdges(
+    const std::vector<Node>& srcs, const std::vector<Node>& dests) noexcept {
+  if (srcs.size() != dests.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "sources and destinations differ in length: {} != {}", srcs.size(),
+        dests.size());
+  }
+
+  const GraphTopology& topo = snapshot_->topology();
+  katana::GAccumulator<uint64_t> snapshot_deleted;
+  katana::GAccumulator<uint64_t> delta_deleted;
+
+  // Tombstones are set atomically and counted only by the thread that set
+  // them, so repeated pairs in a batch are deleted once
+  katana::do_all(
+      katana::iterate(size_t{0}, srcs.size()),
+      [&](size_t i) {
+        Node src = srcs[i];
+        Node dst = dests[i];
+        if (src >= num_nodes()) {
+          return;
+        }
+        for (auto e : topo.edges(src)) {
+          if (topo.edge_dest(e) == dst && !snapshot_deleted_.set(e)) {
+            snapshot_deleted += 1;
+          }
+        }
+        for (auto& block : deltas_) {
+          auto [begin, end] = block.edges(src);
+          auto first = block.dests.begin() + begin;
+          auto last = block.dests.begin() + end;
+          auto [lo, hi] = std::equal_range(first, last, dst);
+          for (auto it = lo; it != hi; ++it) {
+            if (!block.deleted.set(it - block.dests.begin())) {
+              delta_deleted += 1;
+            }
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  num_deleted_snapshot_edges_ += snapshot_deleted.reduce();
+  num_delta_edges_ -= delta_deleted.reduce();
+  return snapshot_deleted.reduce() + delta_deleted.reduce();
+}
+
+bool
+katana::MutablePropertyGraph::has_edge(Node src, Node dst) const noexcept {
+  const GraphTopology& topo = snapshot_->topology();
+  for (auto e : topo.edges(src)) {
+    if (topo.edge_dest(e) == dst && !snapshot_deleted_.test(e)) {
+      return true;
+    }
+  }
+  for (const auto& block : deltas_) {
+    auto [begin, end] = block.edges(src);
+    auto first = block.dests.begin() + begin;
+    auto last = block.dests.begin() + end;
+    auto [lo, hi] = std::equal_range(first, last, dst);
+    for (auto it = lo; it != hi; ++it) {
+      if (!block.deleted.test(it - block.dests.begin())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+katana::Result<void>
+katana::MutablePropertyGraph::MergeDeltaBlocks() noexcept {
+  // Rows of the live edges in the concatenation of the block properties
+  std::vector<DeltaEdge> edges;
+  edges.reserve(num_delta_edges_);
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  uint64_t row_offset = 0;
+  for (const auto& block : deltas_) {
+    for (size_t i = 0; i < block.srcs.size(); ++i) {
+      for (uint64_t j = i > 0 ? block.ends[i - 1] : 0; j < block.ends[i];
+           ++j) {
+        if (!block.deleted.test(j)) {
+          edges.emplace_back(
+              block.srcs[i], block.dests[j], row_offset + block.rows[j]);
+        }
+      }
+    }
+    if (block.properties) {
+      tables.emplace_back(block.properties);
+      row_offset += block.properties->num_rows();
+    }
+  }
+  katana::ParallelSTL::sort(edges.begin(), edges.end());
+
+  DeltaBlock merged = MakeDeltaBlock(edges);
+  if (!tables.empty()) {
+    auto concatenated = KATANA_CHECKED_CONTEXT(
+        arrow::ConcatenateTables(tables), "concatenating edge properties");
+    // Keep only the rows of live edges, in block order
+    merged.properties = KATANA_CHECKED(
+        TakeRows(concatenated, merged.rows.data(), merged.rows.size()));
+    std::iota(merged.rows.begin(), merged.rows.end(), uint64_t{0});
+  }
+
+  deltas_.clear();
+  deltas_.emplace_back(std::move(merged));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::MutablePropertyGraph::Compact() noexcept {
+  KATANA_CHECKED(CheckPropertiesLoaded(*snapshot_));
+
+  const GraphTopology& topo = snapshot_->topology();
+  uint64_t num_nodes = topo.num_nodes();
+
+  // Property rows of inserted edges follow those of the snapshot, in the
+  // order of their blocks
+  std::vector<uint64_t> block_row_offsets;
+  uint64_t row_offset = topo.num_edges();
+  for (const auto& block : deltas_) {
+    block_row_offsets.emplace_back(row_offset);
+    if (block.properties) {
+      row_offset += block.properties->num_rows();
+    }
+  }
+
+  katana::NUMAArray<Edge> adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) {
+        uint64_t degree = 0;
+        for (auto e : topo.edges(n)) {
+          degree += !snapshot_deleted_.test(e);
+        }
+        for (const auto& block : deltas_) {
+          auto [begin, end] = block.edges(n);
+          for (uint64_t i = begin; i < end; ++i) {
+            degree += !block.deleted.test(i);
+          }
+        }
+        adj_indices[n] = degree;
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+
+  uint64_t num_edges = num_nodes > 0 ? adj_indices[num_nodes - 1] : 0;
+  katana::NUMAArray<Node> dests;
+  katana::NUMAArray<uint64_t> edge_rows;
+  PropertyGraph::EntityTypeIDArray edge_type_ids;
+  dests.allocateInterleaved(num_edges);
+  edge_rows.allocateInterleaved(num_edges);
+  edge_type_ids.allocateInterleaved(num_edges);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) {
+        uint64_t out = n > 0 ? adj_indices[n - 1] : 0;
+        for (auto e : topo.edges(n)) {
+          if (!snapshot_deleted_.test(e)) {
+            dests[out] = topo.edge_dest(e);
+            edge_rows[out] = e;
+            edge_type_ids[out] = snapshot_->GetTypeOfEdge(e);
+            ++out;
+          }
+        }
+        for (size_t b = 0; b < deltas_.size(); ++b) {
+          const DeltaBlock& block = deltas_[b];
+          auto [begin, end] = block.edges(n);
+          for (uint64_t i = begin; i < end; ++i) {
+            if (!block.deleted.test(i)) {
+              dests[out] = block.dests[i];
+              edge_rows[out] = block_row_offsets[b] + block.rows[i];
+              edge_type_ids[out] = katana::kUnknownEntityType;
+              ++out;
+            }
+          }
+        }
+        KATANA_LOG_DEBUG_ASSERT(out == adj_indices[n]);
+      },
+      katana::steal(), katana::no_stats());
+
+  PropertyGraph::EntityTypeIDArray node_type_ids;
+  node_type_ids.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](Node n) { node_type_ids[n] = snapshot_->GetTypeOfNode(n); },
+      katana::no_stats());
+
+  std::unique_ptr<PropertyGraph> compacted =
+      KATANA_CHECKED(PropertyGraph::Make(
+          GraphTopology(std::move(adj_indices), std::move(dests)),
+          std::move(node_type_ids), std::move(edge_type_ids),
+          EntityTypeManager{snapshot_->GetNodeTypeManager()},
+          EntityTypeManager{snapshot_->GetEdgeTypeManager()}));
+
+  if (snapshot_->GetNumNodeProperties() > 0) {
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> node_columns;
+    for (int32_t i = 0; i < snapshot_->GetNumNodeProperties(); ++i) {
+      node_columns.emplace_back(snapshot_->GetNodeProperty(i));
+    }
+    KATANA_CHECKED(compacted->AddNodeProperties(arrow::Table::Make(
+        snapshot_->loaded_node_schema(), std::move(node_columns))));
+  }
+
+  if (snapshot_->GetNumEdgeProperties() > 0) {
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> edge_columns;
+    for (int32_t i = 0; i < snapshot_->GetNumEdgeProperties(); ++i) {
+      edge_columns.emplace_back(snapshot_->GetEdgeProperty(i));
+    }
+    std::vector<std::shared_ptr<arrow::Table>> tables{arrow::Table::Make(
+        snapshot_->loaded_edge_schema(), std::move(edge_columns))};
+    for (const auto& block : deltas_) {
+      tables.emplace_back(block.properties);
+    }
+    auto concatenated = KATANA_CHECKED_CONTEXT(
+        arrow::ConcatenateTables(tables), "concatenating edge properties");
+    KATANA_CHECKED(compacted->AddEdgeProperties(KATANA_CHECKED(
+        TakeRows(concatenated, edge_rows.data(), edge_rows.size()))));
+  }
+
+  snapshot_ = std::move(compacted);
+  snapshot_deleted_.clear();
+  snapshot_deleted_.resize(snapshot_->num_edges());
+  num_deleted_snapshot_edges_ = 0;
+  deltas_.clear();
+  num_delta_edges_ = 0;
+  return katana::ResultSuccess();
+}
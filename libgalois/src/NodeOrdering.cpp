@@ -0,0 +1,607 @@
+#include "katana/NodeOrdering.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "katana/Bag.h"
+#include "katana/DynamicBitset.h"
+#include "katana/Logging.h"
+#include "katana/Loops.h"
+#include "katana/NUMAArray.h"
+#include "katana/ParallelSTL.h"
+
+namespace {
+
+using Node = katana::GraphTopologyTypes::Node;
+using PropIndexVec = katana::GraphTopologyTypes::PropIndexVec;
+
+/// Below this many items, loops over a BFS level run serially; the cost of
+/// starting a parallel loop would dominate
+constexpr uint64_t kSerialLoopSize = 1024;
+
+/// Nodes per block ordered independently by GorderOrder
+constexpr uint64_t kGorderBlockSize = uint64_t{1} << 16;
+
+/// The neighbors of every node regardless of edge direction, without self
+/// loops and in increasing order of id. Orderings that group related nodes
+/// use this so that the result does not depend on edge direction or on the
+/// order of edges.
+struct UndirectedAdjacency {
+  /// adj_indices[n] is the end of the neighbors of n in dests
+  katana::NUMAArray<uint64_t> adj_indices;
+  katana::NUMAArray<Node> dests;
+
+  uint64_t begin(Node n) const { return n == 0 ? 0 : adj_indices[n - 1]; }
+  uint64_t end(Node n) const { return adj_indices[n]; }
+  uint64_t degree(Node n) const { return end(n) - begin(n); }
+  uint64_t num_neighbors() const {
+    return adj_indices.empty() ? 0 : adj_indices[adj_indices.size() - 1];
+  }
+};
+
+UndirectedAdjacency
+MakeUndirectedAdjacency(const katana::GraphTopology& topo) {
+  uint64_t num_nodes = topo.num_nodes();
+  UndirectedAdjacency adj;
+  adj.adj_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(
+      adj.adj_indices.begin(), adj.adj_indices.end(), uint64_t{0});
+
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        for (auto e : topo.edges(n)) {
+          Node dest = topo.edge_dest(e);
+          if (dest != n) {
+            __sync_fetch_and_add(&adj.adj_indices[n], 1);
+            __sync_fetch_and_add(&adj.adj_indices[dest], 1);
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::ParallelSTL::partial_sum(
+      adj.adj_indices.begin(), adj.adj_indices.end(), adj.adj_indices.begin());
+
+  katana::NUMAArray<uint64_t> offsets;
+  offsets.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) { offsets[n] = adj.begin(n); }, katana::no_stats());
+
+  adj.dests.allocateInterleaved(adj.num_neighbors());
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        for (auto e : topo.edges(n)) {
+          Node dest = topo.edge_dest(e);
+          if (dest != n) {
+            adj.dests[__sync_fetch_and_add(&offsets[n], 1)] = dest;
+            adj.dests[__sync_fetch_and_add(&offsets[dest], 1)] = n;
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        std::sort(
+            adj.dests.begin() + adj.begin(n), adj.dests.begin() + adj.end(n));
+      },
+      katana::steal(), katana::no_stats());
+
+  return adj;
+}
+
+/// Call fn on every index in [begin, end), in parallel if there are enough
+template <typename Fn>
+void
+ForEachIndex(uint64_t begin, uint64_t end, const Fn& fn) {
+  if (end - begin < kSerialLoopSize) {
+    for (uint64_t i = begin; i < end; ++i) {
+      fn(i);
+    }
+    return;
+  }
+  katana::do_all(
+      katana::iterate(begin, end), fn, katana::steal(), katana::no_stats());
+}
+
+/// \returns the nodes of adj in increasing order of degree and then id
+katana::NUMAArray<Node>
+NodesByDegree(const UndirectedAdjacency& adj) {
+  katana::NUMAArray<Node> nodes;
+  nodes.allocateInterleaved(adj.adj_indices.size());
+  katana::ParallelSTL::iota(nodes.begin(), nodes.end(), Node{0});
+  katana::ParallelSTL::sort(nodes.begin(), nodes.end(), [&](Node a, Node b) {
+    uint64_t degree_a = adj.degree(a);
+    uint64_t degree_b = adj.degree(b);
+    return degree_a < degree_b || (degree_a == degree_b && a < b);
+  });
+  return nodes;
+}
+
+PropIndexVec
+HubOrder(const katana::GraphTopology& topo, bool sort_hubs) {
+  uint64_t num_nodes = topo.num_nodes();
+  PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  if (num_nodes == 0) {
+    return order;
+  }
+
+  double average_degree = static_cast<double>(topo.num_edges()) / num_nodes;
+  auto is_hub = [&](Node n) { return topo.degree(n) > average_degree; };
+
+  // hub_rank[n] is the number of hubs up to and including n
+  katana::NUMAArray<uint64_t> hub_rank;
+  hub_rank.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) { hub_rank[n] = is_hub(n) ? 1 : 0; }, katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      hub_rank.begin(), hub_rank.end(), hub_rank.begin());
+  uint64_t num_hubs = hub_rank[num_nodes - 1];
+
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        if (is_hub(n)) {
+          order[hub_rank[n] - 1] = n;
+        } else {
+          order[num_hubs + n - hub_rank[n]] = n;
+        }
+      },
+      katana::no_stats());
+
+  if (sort_hubs) {
+    katana::ParallelSTL::sort(
+        order.begin(), order.begin() + num_hubs, [&](auto a, auto b) {
+          uint64_t degree_a = topo.degree(a);
+          uint64_t degree_b = topo.degree(b);
+          return degree_a > degree_b || (degree_a == degree_b && a < b);
+        });
+  }
+
+  return order;
+}
+
+/// The priority queue of Gorder: a bucket per key, where keys only change by
+/// one, so that every operation takes constant (amortized) time.
+class UnitHeap {
+public:
+  explicit UnitHeap(uint64_t size)
+      : key_(size, 0), prev_(size), next_(size), removed_(size, false) {
+    heads_.push_back(kNone);
+    // Link in reverse so that ties are broken by smallest index
+    for (uint64_t i = size; i > 0; --i) {
+      Link(i - 1);
+    }
+  }
+
+  void Increment(uint64_t i) {
+    if (removed_[i]) {
+      return;
+    }
+    Unlink(i);
+    ++key_[i];
+    Link(i);
+  }
+
+  void Decrement(uint64_t i) {
+    if (removed_[i]) {
+      return;
+    }
+    KATANA_LOG_DEBUG_ASSERT(key_[i] > 0);
+    Unlink(i);
+    --key_[i];
+    Link(i);
+  }
+
+  void Remove(uint64_t i) {
+    KATANA_LOG_DEBUG_ASSERT(!removed_[i]);
+    Unlink(i);
+    removed_[i] = true;
+  }
+
+  /// Remove and return an index with the largest key; the heap must not be
+  /// empty
+  uint64_t PopMax() {
+    while (heads_[max_key_] == kNone) {
+      KATANA_LOG_DEBUG_ASSERT(max_key_ > 0);
+      --max_key_;
+    }
+    uint64_t i = heads_[max_key_];
+    Remove(i);
+    return i;
+  }
+
+private:
+  static constexpr uint64_t kNone = std::numeric_limits<uint64_t>::max();
+
+  void Link(uint64_t i) {
+    uint64_t key = key_[i];
+    if (key == heads_.size()) {
+      heads_.push_back(kNone);
+    }
+    prev_[i] = kNone;
+    next_[i] = heads_[key];
+    if (next_[i] != kNone) {
+      prev_[next_[i]] = i;
+    }
+    heads_[key] = i;
+    max_key_ = std::max(max_key_, key);
+  }
+
+  void Unlink(uint64_t i) {
+    if (prev_[i] != kNone) {
+      next_[prev_[i]] = next_[i];
+    } else {
+      heads_[key_[i]] = next_[i];
+    }
+    if (next_[i] != kNone) {
+      prev_[next_[i]] = prev_[i];
+    }
+  }
+
+  std::vector<uint64_t> key_;
+  std::vector<uint64_t> prev_;
+  std::vector<uint64_t> next_;
+  std::vector<bool> removed_;
+  std::vector<uint64_t> heads_;
+  uint64_t max_key_{0};
+};
+
+/// Order the nodes [begin, end) by Gorder, only scoring relations between
+/// nodes of the block
+void
+GorderBlock(
+    const UndirectedAdjacency& adj, Node begin, Node end, uint32_t window,
+    uint64_t max_sibling_degree, PropIndexVec* order) {
+  UnitHeap heap(end - begin);
+
+  // The score of u is the number of nodes in the window that are neighbors
+  // of u plus the number of common neighbors they have with u. Common
+  // neighbors through a hub are not counted; they are both too common to be
+  // informative and too expensive to enumerate.
+  auto update = [&](Node v, bool entering) {
+    auto adjust = [&](Node u) {
+      if (u < begin || u >= end) {
+        return;
+      }
+      if (entering) {
+        heap.Increment(u - begin);
+      } else {
+        heap.Decrement(u - begin);
+      }
+    };
+    for (uint64_t e = adj.begin(v); e < adj.end(v); ++e) {
+      Node x = adj.dests[e];
+      adjust(x);
+      if (adj.degree(x) > max_sibling_degree) {
+        continue;
+      }
+      for (uint64_t f = adj.begin(x); f < adj.end(x); ++f) {
+        if (adj.dests[f] != v) {
+          adjust(adj.dests[f]);
+        }
+      }
+    }
+  };
+
+  Node first = begin;
+  for (Node n = begin; n < end; ++n) {
+    if (adj.degree(n) > adj.degree(first)) {
+      first = n;
+    }
+  }
+  heap.Remove(first - begin);
+  (*order)[begin] = first;
+  update(first, true);
+
+  for (uint64_t i = 1; i < end - begin; ++i) {
+    if (i > window) {
+      update((*order)[begin + i - window - 1], false);
+    }
+    Node next = begin + heap.PopMax();
+    (*order)[begin + i] = next;
+    update(next, true);
+  }
+}
+
+}  // namespace
+
+katana::GraphTopologyTypes::PropIndexVec
+katana::ReverseCuthillMcKeeOrder(const GraphTopology& topo) {
+  uint64_t num_nodes = topo.num_nodes();
+  PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  if (num_nodes == 0) {
+    return order;
+  }
+
+  UndirectedAdjacency adj = MakeUndirectedAdjacency(topo);
+  katana::NUMAArray<Node> by_degree = NodesByDegree(adj);
+
+  // Isolated nodes come first in by_degree and are components of their own
+  auto first_connected = std::partition_point(
+      by_degree.begin(), by_degree.end(),
+      [&](Node n) { return adj.degree(n) == 0; });
+  uint64_t num_placed = first_connected - by_degree.begin();
+  katana::ParallelSTL::copy(by_degree.begin(), first_connected, order.begin());
+
+  katana::DynamicBitset placed;
+  placed.resize(num_nodes);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_placed),
+      [&](uint64_t i) { placed.set(order[i]); }, katana::no_stats());
+
+  // While a node waits to be placed, parent[n] is the smallest position of a
+  // placed neighbor. Cuthill-McKee places children in the order of their
+  // parents and then by increasing degree, which the level-synchronous
+  // traversal below reproduces by sorting each new level.
+  constexpr uint64_t kNoParent = std::numeric_limits<uint64_t>::max();
+  katana::NUMAArray<uint64_t> parent;
+  parent.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::fill(parent.begin(), parent.end(), kNoParent);
+
+  katana::InsertBag<Node> next;
+  std::vector<Node> level;
+  auto claim_children = [&](uint64_t i) {
+    Node u = order[i];
+    for (uint64_t e = adj.begin(u); e < adj.end(u); ++e) {
+      Node v = adj.dests[e];
+      if (placed.test(v)) {
+        continue;
+      }
+      uint64_t old = __atomic_load_n(&parent[v], __ATOMIC_RELAXED);
+      while (i < old) {
+        if (__atomic_compare_exchange_n(
+                &parent[v], &old, i, false, __ATOMIC_RELAXED,
+                __ATOMIC_RELAXED)) {
+          if (old == kNoParent) {
+            next.push(v);
+          }
+          break;
+        }
+      }
+    }
+  };
+  auto level_order = [&](Node a, Node b) {
+    if (parent[a] != parent[b]) {
+      return parent[a] < parent[b];
+    }
+    uint64_t degree_a = adj.degree(a);
+    uint64_t degree_b = adj.degree(b);
+    return degree_a < degree_b || (degree_a == degree_b && a < b);
+  };
+
+  auto start = first_connected;
+  while (num_placed < num_nodes) {
+    while (placed.test(*start)) {
+      ++start;
+    }
+    order[num_placed] = *start;
+    placed.set(*start);
+
+    uint64_t level_begin = num_placed;
+    uint64_t level_end = ++num_placed;
+    while (level_begin < level_end) {
+      ForEachIndex(level_begin, level_end, claim_children);
+
+      level.assign(next.begin(), next.end());
+      next.clear();
+      if (level.size() < kSerialLoopSize) {
+        std::sort(level.begin(), level.end(), level_order);
+      } else {
+        katana::ParallelSTL::sort(level.begin(), level.end(), level_order);
+      }
+      ForEachIndex(0, level.size(), [&](uint64_t i) {
+        order[level_end + i] = level[i];
+        placed.set(level[i]);
+      });
+
+      level_begin = level_end;
+      level_end += level.size();
+    }
+    num_placed = level_end;
+  }
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes / 2),
+      [&](uint64_t i) { std::swap(order[i], order[num_nodes - 1 - i]); },
+      katana::no_stats());
+
+  return order;
+}
+
+katana::GraphTopologyTypes::PropIndexVec
+katana::HubSortOrder(const GraphTopology& topo) {
+  return HubOrder(topo, true);
+}
+
+katana::GraphTopologyTypes::PropIndexVec
+katana::HubClusterOrder(const GraphTopology& topo) {
+  return HubOrder(topo, false);
+}
+
+katana::GraphTopologyTypes::PropIndexVec
+katana::GorderOrder(const GraphTopology& topo, uint32_t window) {
+  uint64_t num_nodes = topo.num_nodes();
+  PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  if (num_nodes == 0) {
+    return order;
+  }
+
+  UndirectedAdjacency adj = MakeUndirectedAdjacency(topo);
+
+  // Gorder's threshold for hubs
+  auto max_sibling_degree =
+      static_cast<uint64_t>(std::sqrt(static_cast<double>(num_nodes)));
+
+  uint64_t num_blocks = (num_nodes + kGorderBlockSize - 1) / kGorderBlockSize;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_blocks),
+      [&](uint64_t block) {
+        Node begin = block * kGorderBlockSize;
+        Node end = std::min(num_nodes, (block + 1) * kGorderBlockSize);
+        GorderBlock(adj, begin, end, window, max_sibling_degree, &order);
+      },
+      katana::steal(), katana::no_stats());
+
+  return order;
+}
+
+katana::GraphTopologyTypes::PropIndexVec
+katana::RabbitOrder(const GraphTopology& topo) {
+  uint64_t num_nodes = topo.num_nodes();
+  PropIndexVec order;
+  order.allocateInterleaved(num_nodes);
+  if (num_nodes == 0) {
+    return order;
+  }
+
+  UndirectedAdjacency adj = MakeUndirectedAdjacency(topo);
+  katana::NUMAArray<Node> by_degree = NodesByDegree(adj);
+  double total_weight = adj.num_neighbors();
+
+  constexpr Node kNone = std::numeric_limits<Node>::max();
+  // Communities are trees of merged nodes. The root of each tree represents
+  // the community: community_weight is its total degree, and absorbed holds
+  // the edges of nodes merged into it that it has not aggregated yet.
+  // Community membership is looked up through a union-find forest (leader),
+  // while the merge trees (first_child and next_sibling) define the order.
+  katana::NUMAArray<Node> leader;
+  katana::NUMAArray<uint64_t> community_weight;
+  katana::NUMAArray<uint64_t> tree_size;
+  katana::NUMAArray<Node> first_child;
+  katana::NUMAArray<Node> next_sibling;
+  leader.allocateInterleaved(num_nodes);
+  community_weight.allocateInterleaved(num_nodes);
+  tree_size.allocateInterleaved(num_nodes);
+  first_child.allocateInterleaved(num_nodes);
+  next_sibling.allocateInterleaved(num_nodes);
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        leader[n] = n;
+        community_weight[n] = adj.degree(n);
+        tree_size[n] = 1;
+        first_child[n] = kNone;
+        next_sibling[n] = kNone;
+      },
+      katana::no_stats());
+
+  using WeightedNeighbor = std::pair<Node, uint64_t>;
+  std::vector<std::vector<WeightedNeighbor>> absorbed(num_nodes);
+  katana::DynamicBitset visited;
+  visited.resize(num_nodes);
+
+  auto find = [&](Node n) {
+    Node root = n;
+    while (leader[root] != root) {
+      root = leader[root];
+    }
+    while (leader[n] != root) {
+      Node up = leader[n];
+      leader[n] = root;
+      n = up;
+    }
+    return root;
+  };
+
+  // Merging depends on the result of every previous merge, so it is serial
+  std::vector<Node> roots;
+  std::vector<WeightedNeighbor> neighbors;
+  for (Node u : by_degree) {
+    visited.set(u);
+
+    neighbors.clear();
+    for (uint64_t e = adj.begin(u); e < adj.end(u); ++e) {
+      neighbors.emplace_back(find(adj.dests[e]), 1);
+    }
+    for (const auto& [v, weight] : absorbed[u]) {
+      neighbors.emplace_back(find(v), weight);
+    }
+    std::vector<WeightedNeighbor>().swap(absorbed[u]);
+
+    std::sort(neighbors.begin(), neighbors.end());
+    uint64_t num_communities = 0;
+    for (uint64_t i = 0; i < neighbors.size(); ++i) {
+      if (neighbors[i].first == u) {
+        continue;
+      }
+      if (num_communities > 0 &&
+          neighbors[num_communities - 1].first == neighbors[i].first) {
+        neighbors[num_communities - 1].second += neighbors[i].second;
+      } else {
+        neighbors[num_communities++] = neighbors[i];
+      }
+    }
+    neighbors.resize(num_communities);
+
+    // Modularity gain of merging u into v, up to a constant factor
+    Node best = kNone;
+    double best_gain = 0;
+    for (const auto& [v, weight] : neighbors) {
+      double gain = weight / total_weight -
+                    static_cast<double>(community_weight[u]) *
+                        community_weight[v] / (total_weight * total_weight);
+      if (gain > best_gain) {
+        best = v;
+        best_gain = gain;
+      }
+    }
+
+    if (best == kNone) {
+      roots.emplace_back(u);
+      continue;
+    }
+    leader[u] = best;
+    community_weight[best] += community_weight[u];
+    tree_size[best] += tree_size[u];
+    next_sibling[u] = first_child[best];
+    first_child[best] = u;
+    // Only communities that will still look for a merge need u's edges
+    if (!visited.test(best)) {
+      absorbed[best].insert(
+          absorbed[best].end(), neighbors.begin(), neighbors.end());
+    }
+  }
+
+  katana::NUMAArray<uint64_t> offsets;
+  offsets.allocateInterleaved(roots.size());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, roots.size()),
+      [&](uint64_t i) { offsets[i] = tree_size[roots[i]]; },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      offsets.begin(), offsets.end(), offsets.begin());
+  KATANA_LOG_DEBUG_ASSERT(offsets[roots.size() - 1] == num_nodes);
+
+  // Number each community by a preorder traversal of its merge tree, visiting
+  // children in the order they were merged
+  katana::do_all(
+      katana::iterate(uint64_t{0}, roots.size()),
+      [&](uint64_t i) {
+        uint64_t position = offsets[i] - tree_size[roots[i]];
+        std::vector<Node> stack{roots[i]};
+        while (!stack.empty()) {
+          Node n = stack.back();
+          stack.pop_back();
+          order[position++] = n;
+          for (Node c = first_child[n]; c != kNone; c = next_sibling[c]) {
+            stack.emplace_back(c);
+          }
+        }
+        KATANA_LOG_DEBUG_ASSERT(position == offsets[i]);
+      },
+      katana::steal(), katana::no_stats());
+
+  return order;
+}
@@ -3,12 +3,17 @@
 #include <stdio.h>
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include <arrow/array.h>
+#include <arrow/compute/api_vector.h>
 
 #include "katana/ArrowInterchange.h"
+#include "katana/Env.h"
 #include "katana/Iterators.h"
 #include "katana/Logging.h"
 #include "katana/Loops.h"
@@ -17,6 +22,7 @@
 #include "katana/Platform.h"
 #include "katana/Properties.h"
 #include "katana/Result.h"
+#include "tsuba/CSRTopology.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/RDG.h"
@@ -25,19 +31,39 @@
 
 namespace {
 
+constexpr const char* kDoNotPersistDerivedTopologiesEnv =
+    "KATANA_DO_NOT_PERSIST_DERIVED_TOPOLOGIES";
+constexpr const char* kCompressTopologyEnv = "KATANA_COMPRESS_TOPOLOGY";
+
+/// Nodes per block of compressed topology files. Blocks are the unit of
+/// parallel decoding.
+constexpr uint64_t kCompressedTopologyNodesPerBlock = 4096;
+
+/// Topology file version with uint32_t edge destinations
+constexpr uint64_t kCSRVersion32 = 1;
+/// Topology file version with uint64_t edge destinations
+constexpr uint64_t kCSRVersion64 = 2;
+
+/// The version of topology files whose destinations can be used as
+/// GraphTopology::Node without conversion
+constexpr uint64_t kNativeCSRVersion =
+    sizeof(katana::GraphTopology::Node) == sizeof(uint64_t) ? kCSRVersion64
+                                                            : kCSRVersion32;
+
 constexpr uint64_t
-GetGraphSize(uint64_t num_nodes, uint64_t num_edges) {
+GetGraphSize(uint64_t num_nodes, uint64_t num_edges, uint64_t dest_size) {
   /// version, sizeof_edge_data, num_nodes, num_edges
   constexpr int mandatory_fields = 4;
 
   return (mandatory_fields + num_nodes) * sizeof(uint64_t) +
-         (num_edges * sizeof(uint32_t));
+         (num_edges * dest_size);
 }
 
+template <typename Dest>
 [[maybe_unused]] bool
 CheckTopology(
     const uint64_t* out_indices, const uint64_t num_nodes,
-    const uint32_t* out_dests, const uint64_t num_edges) {
+    const Dest* out_dests, const uint64_t num_edges) {
   bool has_bad_adj = false;
 
   katana::do_all(
@@ -62,37 +88,86 @@ CheckTopology(
   return !has_bad_adj && !has_bad_dest;
 }
 
+/// Build the compressed topology of a compressed topology file (see
+/// tsuba::CSRCompressedHeader) without decoding it to CSR
+katana::Result<katana::CompressedTopology>
+LoadCompressedTopology(const tsuba::FileView& file_view) {
+  tsuba::CompressedCSRView view = KATANA_CHECKED(tsuba::CompressedCSRView::Make(
+      file_view.ptr<uint8_t>(), file_view.size()));
+
+  if (view.header().num_nodes >
+      uint64_t{std::numeric_limits<katana::GraphTopology::Node>::max()}) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "{} nodes do not fit in {}-bit node ids; rebuild with "
+        "KATANA_NODE_ID_64",
+        view.header().num_nodes, sizeof(katana::GraphTopology::Node) * 8);
+  }
+
+  return katana::CompressedTopology::Make(view);
+}
+
+bool
+IsCompressedTopologyFile(const tsuba::FileView& file_view) {
+  return file_view.size() >= sizeof(tsuba::CSRTopologyHeader) &&
+         file_view.ptr<tsuba::CSRTopologyHeader>()->version ==
+             tsuba::kCompressedCSRVersion;
+}
+
 /// MapTopology takes a file buffer of a topology file and extracts the
 /// topology files.
 ///
 /// Format of a topology file (borrowed from the original FileGraph.cpp:
 ///
-///   uint64_t version: 1
+///   uint64_t version: 1 or 2
 ///   uint64_t sizeof_edge_data: size of edge data element
 ///   uint64_t num_nodes: number of nodes
 ///   uint64_t num_edges: number of edges
 ///   uint64_t[num_nodes] out_indices: start and end of the edges for a node
 ///   uint32_t[num_edges] out_dests: destinations (node indexes) of each edge
-///   uint32_t padding if num_edges is odd
+///     (uint64_t in version 2)
+///   uint32_t padding if num_edges is odd (version 1 only)
 ///   void*[num_edges] edge_data: edge data
 ///
 /// Since property graphs store their edge data separately, we will
 /// ignore the size_of_edge_data (data[1]).
+///
+/// If the width of the destinations in the file matches
+/// GraphTopology::Node and file_view is a mapping of the file itself, the
+/// topology borrows the mapped arrays rather than copying them and keeps the
+/// mapping alive. Otherwise the
+/// destinations are converted in parallel; files with more nodes than Node
+/// can represent are rejected.
+///
+/// Compressed topology files (version tsuba::kCompressedCSRVersion) are
+/// loaded with LoadCompressedTopology instead.
 katana::Result<katana::GraphTopology>
 MapTopology(const tsuba::FileView& file_view) {
   const auto* data = file_view.ptr<uint64_t>();
-  if (file_view.size() < 4) {
-    return katana::ErrorCode::InvalidArgument;
-  }
-
-  if (data[0] != 1) {
+  if (file_view.size() < 4 * sizeof(uint64_t)) {
     return katana::ErrorCode::InvalidArgument;
   }
 
+  // all versions share the header layout
   const uint64_t num_nodes = data[2];
   const uint64_t num_edges = data[3];
 
-  uint64_t expected_size = GetGraphSize(num_nodes, num_edges);
+  if (num_nodes >
+      uint64_t{std::numeric_limits<katana::GraphTopology::Node>::max()}) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented,
+        "{} nodes do not fit in {}-bit node ids; rebuild with "
+        "KATANA_NODE_ID_64",
+        num_nodes, sizeof(katana::GraphTopology::Node) * 8);
+  }
+
+  if (data[0] != kCSRVersion32 && data[0] != kCSRVersion64) {
+    return katana::ErrorCode::InvalidArgument;
+  }
+
+  const uint64_t dest_size =
+      data[0] == kCSRVersion64 ? sizeof(uint64_t) : sizeof(uint32_t);
+  uint64_t expected_size = GetGraphSize(num_nodes, num_edges, dest_size);
 
   if (file_view.size() < expected_size) {
     return KATANA_ERROR(
@@ -101,16 +176,105 @@ MapTopology(const tsuba::FileView& file_view) {
   }
 
   const uint64_t* out_indices = &data[4];
-  const uint32_t* out_dests =
-      reinterpret_cast<const uint32_t*>(out_indices + num_nodes);
 
-  KATANA_LOG_DEBUG_ASSERT(
-      CheckTopology(out_indices, num_nodes, out_dests, num_edges));
-  return katana::GraphTopology(out_indices, num_nodes, out_dests, num_edges);
+  if (data[0] == kNativeCSRVersion) {
+    const auto* out_dests =
+        reinterpret_cast<const katana::GraphTopology::Node*>(
+            out_indices + num_nodes);
+    KATANA_LOG_DEBUG_ASSERT(
+        CheckTopology(out_indices, num_nodes, out_dests, num_edges));
+    if (file_view.mapped()) {
+      // Hold the mapping so that the topology stays valid if the RDG
+      // unbinds or rebinds its topology file
+      return katana::GraphTopology::MakeBorrowed(
+          out_indices, num_nodes, out_dests, num_edges, file_view.mapping());
+    }
+    return katana::GraphTopology(out_indices, num_nodes, out_dests, num_edges);
+  }
+
+  katana::GraphTopology::AdjIndexVec adj_indices;
+  adj_indices.allocateInterleaved(num_nodes);
+  katana::ParallelSTL::copy(
+      out_indices, out_indices + num_nodes, adj_indices.begin());
+
+  katana::GraphTopology::EdgeDestVec dests;
+  dests.allocateInterleaved(num_edges);
+  auto convert = [&](const auto* file_dests) {
+    KATANA_LOG_DEBUG_ASSERT(
+        CheckTopology(out_indices, num_nodes, file_dests, num_edges));
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_edges),
+        [&](uint64_t e) {
+          dests[e] = static_cast<katana::GraphTopology::Node>(file_dests[e]);
+        },
+        katana::no_stats());
+  };
+  if (data[0] == kCSRVersion64) {
+    convert(reinterpret_cast<const uint64_t*>(out_indices + num_nodes));
+  } else {
+    convert(reinterpret_cast<const uint32_t*>(out_indices + num_nodes));
+  }
+
+  return katana::GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
+/// Write topology as a compressed topology file, encoding one block per task
+katana::Result<std::unique_ptr<tsuba::FileFrame>>
+WriteCompressedTopology(const katana::GraphTopology& topology) {
+  auto ff = std::make_unique<tsuba::FileFrame>();
+  KATANA_CHECKED(ff->Init());
+
+  const uint64_t num_nodes = topology.num_nodes();
+  tsuba::CSRTopologyHeader header{
+      .version = tsuba::kCompressedCSRVersion,
+      .edge_type_size = 0,
+      .num_nodes = num_nodes,
+      .num_edges = topology.num_edges(),
+  };
+  tsuba::CSRCompressedHeader compressed_header{
+      .nodes_per_block = kCompressedTopologyNodesPerBlock,
+      .num_blocks = (num_nodes + kCompressedTopologyNodesPerBlock - 1) /
+                    kCompressedTopologyNodesPerBlock,
+  };
+
+  std::vector<std::vector<uint8_t>> blocks(compressed_header.num_blocks);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, compressed_header.num_blocks),
+      [&](uint64_t block) {
+        uint64_t first = block * kCompressedTopologyNodesPerBlock;
+        uint64_t last =
+            std::min(first + kCompressedTopologyNodesPerBlock, num_nodes);
+        tsuba::EncodeCSRBlock(
+            topology.adj_data(), topology.dest_data(), first, last,
+            &blocks[block]);
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<tsuba::CSRBlockIndexEntry> index(blocks.size() + 1);
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    uint64_t last_node =
+        std::min((i + 1) * kCompressedTopologyNodesPerBlock, num_nodes);
+    index[i + 1].data_offset = index[i].data_offset + blocks[i].size();
+    index[i + 1].first_edge = topology.adj_data()[last_node - 1];
+  }
+
+  KATANA_CHECKED(ff->Write(&header, sizeof(header)));
+  KATANA_CHECKED(ff->Write(&compressed_header, sizeof(compressed_header)));
+  KATANA_CHECKED(ff->Write(
+      index.data(), index.size() * sizeof(tsuba::CSRBlockIndexEntry)));
+  for (const auto& block : blocks) {
+    KATANA_CHECKED(ff->Write(block.data(), block.size()));
+  }
+
+  return std::unique_ptr<tsuba::FileFrame>(std::move(ff));
 }
 
 katana::Result<std::unique_ptr<tsuba::FileFrame>>
 WriteTopology(const katana::GraphTopology& topology) {
+  if (katana::GetEnv(kCompressTopologyEnv)) {
+    return WriteCompressedTopology(topology);
+  }
+
   auto ff = std::make_unique<tsuba::FileFrame>();
   if (auto res = ff->Init(); !res) {
     return res.error();
@@ -118,7 +282,7 @@ WriteTopology(const katana::GraphTopology& topology) {
   const uint64_t num_nodes = topology.num_nodes();
   const uint64_t num_edges = topology.num_edges();
 
-  uint64_t data[4] = {1, 0, num_nodes, num_edges};
+  uint64_t data[4] = {kNativeCSRVersion, 0, num_nodes, num_edges};
   arrow::Status aro_sts = ff->Write(&data, 4 * sizeof(uint64_t));
   if (!aro_sts.ok()) {
     return tsuba::ArrowToTsuba(aro_sts.code());
@@ -136,7 +300,8 @@ WriteTopology(const katana::GraphTopology& topology) {
 
   if (num_edges) {
     const auto* raw = topology.dest_data();
-    static_assert(std::is_same_v<std::decay_t<decltype(*raw)>, uint32_t>);
+    static_assert(std::is_same_v<
+                  std::decay_t<decltype(*raw)>, katana::GraphTopology::Node>);
     auto buf = arrow::Buffer::Wrap(raw, num_edges);
     aro_sts = ff->Write(buf);
     if (!aro_sts.ok()) {
@@ -216,8 +381,19 @@ MakeDefaultEntityTypeIDArray(size_t vec_sz) {
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Make(
     std::unique_ptr<tsuba::RDGFile> rdg_file, tsuba::RDG&& rdg) {
-  katana::GraphTopology topo =
-      KATANA_CHECKED(MapTopology(rdg.topology_file_storage()));
+  // A compressed topology stays compressed until something needs the CSR
+  katana::GraphTopology topo;
+  std::shared_ptr<const CompressedTopology> compressed_topo;
+  if (IsCompressedTopologyFile(rdg.topology_file_storage())) {
+    compressed_topo = std::make_shared<CompressedTopology>(
+        KATANA_CHECKED(LoadCompressedTopology(rdg.topology_file_storage())));
+  } else {
+    topo = KATANA_CHECKED(MapTopology(rdg.topology_file_storage()));
+  }
+  const uint64_t num_nodes =
+      compressed_topo ? compressed_topo->num_nodes() : topo.num_nodes();
+  const uint64_t num_edges =
+      compressed_topo ? compressed_topo->num_edges() : topo.num_edges();
 
   if (rdg.IsEntityTypeIDsOutsideProperties()) {
     KATANA_LOG_DEBUG("loading EntityType data from outside properties");
@@ -228,8 +404,8 @@ katana::PropertyGraph::Make(
     EntityTypeIDArray edge_type_ids = KATANA_CHECKED(
         MapEntityTypeIDsArray(rdg.edge_entity_type_id_array_file_storage()));
 
-    KATANA_ASSERT(topo.num_nodes() == node_type_ids.size());
-    KATANA_ASSERT(topo.num_edges() == edge_type_ids.size());
+    KATANA_ASSERT(num_nodes == node_type_ids.size());
+    KATANA_ASSERT(num_edges == edge_type_ids.size());
 
     EntityTypeManager node_type_manager =
         KATANA_CHECKED(rdg.node_entity_type_manager());
@@ -239,16 +415,17 @@ katana::PropertyGraph::Make(
     return std::make_unique<PropertyGraph>(
         std::move(rdg_file), std::move(rdg), std::move(topo),
         std::move(node_type_ids), std::move(edge_type_ids),
-        std::move(node_type_manager), std::move(edge_type_manager));
+        std::move(node_type_manager), std::move(edge_type_manager),
+        std::move(compressed_topo));
 
   } else {
     // we must construct id_arrays and managers from properties
 
     auto pg = std::make_unique<PropertyGraph>(
         std::move(rdg_file), std::move(rdg), std::move(topo),
-        MakeDefaultEntityTypeIDArray(topo.num_nodes()),
-        MakeDefaultEntityTypeIDArray(topo.num_edges()), EntityTypeManager{},
-        EntityTypeManager{});
+        MakeDefaultEntityTypeIDArray(num_nodes),
+        MakeDefaultEntityTypeIDArray(num_edges), EntityTypeManager{},
+        EntityTypeManager{}, std::move(compressed_topo));
 
     KATANA_CHECKED(pg->ConstructEntityTypeIDs());
 
@@ -260,12 +437,7 @@ katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::PropertyGraph::Make(
     const std::string& rdg_name, const tsuba::RDGLoadOptions& opts) {
   tsuba::RDGManifest manifest = KATANA_CHECKED(tsuba::FindManifest(rdg_name));
-  tsuba::RDGFile rdg_file{
-      KATANA_CHECKED(tsuba::Open(std::move(manifest), tsuba::kReadWrite))};
-  tsuba::RDG rdg = KATANA_CHECKED(tsuba::RDG::Make(rdg_file, opts));
-
-  return katana::PropertyGraph::Make(
-      std::make_unique<tsuba::RDGFile>(std::move(rdg_file)), std::move(rdg));
+  return katana::PropertyGraph::Make(manifest, opts);
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -275,8 +447,17 @@ katana::PropertyGraph::Make(
       KATANA_CHECKED(tsuba::Open(std::move(rdg_manifest), tsuba::kReadWrite))};
   tsuba::RDG rdg = KATANA_CHECKED(tsuba::RDG::Make(rdg_file, opts));
 
-  return katana::PropertyGraph::Make(
-      std::make_unique<tsuba::RDGFile>(std::move(rdg_file)), std::move(rdg));
+  std::unique_ptr<PropertyGraph> pg =
+      KATANA_CHECKED(katana::PropertyGraph::Make(
+          std::make_unique<tsuba::RDGFile>(std::move(rdg_file)),
+          std::move(rdg)));
+
+  // Paging in a compressed topology would decode it
+  if (opts.interleave_topology && !pg->compressed_topology_) {
+    pg->topology().PageInInterleaved();
+  }
+
+  return MakeResult(std::move(pg));
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -322,6 +503,23 @@ katana::PropertyGraph::Copy(
   return Make(rdg_dir(), opts);
 }
 
+void
+katana::PropertyGraph::DecodeTopology() const noexcept {
+  std::call_once(*topology_decoded_, [this]() {
+    topology_ = compressed_topology_->Decompress();
+  });
+}
+
+void
+katana::PropertyGraph::MakeTopologyMutable() noexcept {
+  // The compressed topology would no longer match
+  topology();
+  compressed_topology_.reset();
+  topology_decoded_.reset();
+  topology_.MakeMutable();
+  pg_view_cache_.DropTopologies();
+}
+
 katana::Result<void>
 katana::PropertyGraph::Validate() {
   // TODO (thunt) check that arrow table sizes match topology
@@ -468,6 +666,12 @@ katana::PropertyGraph::DoWrite(
           ? KATANA_CHECKED(WriteEntityTypeIDsArray(edge_entity_type_ids_))
           : nullptr;
 
+  if (!katana::GetEnv(kDoNotPersistDerivedTopologiesEnv)) {
+    KATANA_CHECKED_CONTEXT(
+        pg_view_cache_.PersistDerivedTopologies(&rdg_),
+        "persisting derived topologies");
+  }
+
   return rdg_.Store(
       handle, command_line, versioning_action, std::move(topology_res),
       std::move(node_entity_type_id_array_res),
@@ -794,10 +998,10 @@ katana::PropertyGraph::AddNodeProperties(
     KATANA_LOG_DEBUG("adding empty node prop table");
     return ResultSuccess();
   }
-  if (topology().num_nodes() != static_cast<uint64_t>(props->num_rows())) {
+  if (num_nodes() != static_cast<uint64_t>(props->num_rows())) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
-        topology().num_nodes(), props->num_rows());
+        num_nodes(), props->num_rows());
   }
   return rdg_.AddNodeProperties(props);
 }
@@ -809,16 +1013,18 @@ katana::PropertyGraph::UpsertNodeProperties(
     KATANA_LOG_DEBUG("upsert empty node prop table");
     return ResultSuccess();
   }
-  if (topology().num_nodes() != static_cast<uint64_t>(props->num_rows())) {
+  if (num_nodes() != static_cast<uint64_t>(props->num_rows())) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
-        topology().num_nodes(), props->num_rows());
+        num_nodes(), props->num_rows());
   }
+  pg_view_cache_.DropPermutedNodeProperties();
   return rdg_.UpsertNodeProperties(props);
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(int i) {
+  pg_view_cache_.DropPermutedNodeProperties();
   return rdg_.RemoveNodeProperty(i);
 }
 
@@ -827,6 +1033,7 @@ katana::PropertyGraph::RemoveNodeProperty(const std::string& prop_name) {
   auto col_names = rdg_.node_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
+    pg_view_cache_.DropPermutedNodeProperties();
     return rdg_.RemoveNodeProperty(std::distance(col_names.cbegin(), pos));
   }
   return katana::ErrorCode::PropertyNotFound;
@@ -858,6 +1065,7 @@ katana::PropertyGraph::ListEdgeProperties() const {
 
 katana::Result<void>
 katana::PropertyGraph::UnloadNodeProperty(const std::string& prop_name) {
+  pg_view_cache_.DropPermutedNodeProperties();
   return rdg_.UnloadNodeProperty(prop_name);
 }
 
@@ -868,10 +1076,10 @@ katana::PropertyGraph::AddEdgeProperties(
     KATANA_LOG_DEBUG("adding empty edge prop table");
     return ResultSuccess();
   }
-  if (topology().num_edges() != static_cast<uint64_t>(props->num_rows())) {
+  if (num_edges() != static_cast<uint64_t>(props->num_rows())) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
-        topology().num_edges(), props->num_rows());
+        num_edges(), props->num_rows());
   }
   return rdg_.AddEdgeProperties(props);
 }
@@ -883,16 +1091,18 @@ katana::PropertyGraph::UpsertEdgeProperties(
     KATANA_LOG_DEBUG("upsert empty edge prop table");
     return ResultSuccess();
   }
-  if (topology().num_edges() != static_cast<uint64_t>(props->num_rows())) {
+  if (num_edges() != static_cast<uint64_t>(props->num_rows())) {
     return KATANA_ERROR(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
-        topology().num_edges(), props->num_rows());
+        num_edges(), props->num_rows());
   }
+  pg_view_cache_.DropPermutedEdgeProperties();
   return rdg_.UpsertEdgeProperties(props);
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(int i) {
+  pg_view_cache_.DropPermutedEdgeProperties();
   return rdg_.RemoveEdgeProperty(i);
 }
 
@@ -901,6 +1111,7 @@ katana::PropertyGraph::RemoveEdgeProperty(const std::string& prop_name) {
   auto col_names = rdg_.edge_properties()->ColumnNames();
   auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
   if (pos != col_names.cend()) {
+    pg_view_cache_.DropPermutedEdgeProperties();
     return rdg_.RemoveEdgeProperty(std::distance(col_names.cbegin(), pos));
   }
   return katana::ErrorCode::PropertyNotFound;
@@ -908,6 +1119,7 @@ katana::PropertyGraph::RemoveEdgeProperty(const std::string& prop_name) {
 
 katana::Result<void>
 katana::PropertyGraph::UnloadEdgeProperty(const std::string& prop_name) {
+  pg_view_cache_.DropPermutedEdgeProperties();
   return rdg_.UnloadEdgeProperty(prop_name);
 }
 
@@ -988,6 +1200,7 @@ katana::Result<std::unique_ptr<katana::NUMAArray<uint64_t>>>
 katana::SortAllEdgesByDest(katana::PropertyGraph* pg) {
   // TODO(amber): This function will soon change so that it produces a new sorted
   // topology instead of modifying an existing one. The const_cast will go away
+  pg->MakeTopologyMutable();
   const auto& topo = pg->topology();
 
   auto permutation_vec = std::make_unique<katana::NUMAArray<uint64_t>>();
@@ -1054,12 +1267,13 @@ katana::FindEdgeSortedByDest(
 // TODO(amber): this method should return a new sorted topology
 katana::Result<void>
 katana::SortNodesByDegree(katana::PropertyGraph* pg) {
+  pg->MakeTopologyMutable();
   const auto& topo = pg->topology();
 
   uint64_t num_nodes = topo.num_nodes();
   uint64_t num_edges = topo.num_edges();
 
-  using DegreeNodePair = std::pair<uint64_t, uint32_t>;
+  using DegreeNodePair = std::pair<uint64_t, GraphTopology::Node>;
   katana::NUMAArray<DegreeNodePair> dn_pairs;
   dn_pairs.allocateInterleaved(num_nodes);
 
@@ -1073,7 +1287,7 @@ katana::SortNodesByDegree(katana::PropertyGraph* pg) {
       dn_pairs.begin(), dn_pairs.end(), std::greater<DegreeNodePair>());
 
   // create mapping, get degrees out to another vector to get prefix sum
-  katana::NUMAArray<uint32_t> old_to_new_mapping;
+  katana::NUMAArray<GraphTopology::Node> old_to_new_mapping;
   old_to_new_mapping.allocateInterleaved(num_nodes);
 
   katana::NUMAArray<uint64_t> new_prefix_sum;
@@ -1089,7 +1303,7 @@ katana::SortNodesByDegree(katana::PropertyGraph* pg) {
   katana::ParallelSTL::partial_sum(
       new_prefix_sum.begin(), new_prefix_sum.end(), new_prefix_sum.begin());
 
-  katana::NUMAArray<uint32_t> new_out_dest;
+  katana::NUMAArray<GraphTopology::Node> new_out_dest;
   new_out_dest.allocateInterleaved(num_edges);
 
   auto* out_dests_data = const_cast<GraphTopology::Node*>(topo.dest_data());
@@ -1098,7 +1312,7 @@ katana::SortNodesByDegree(katana::PropertyGraph* pg) {
   katana::do_all(
       katana::iterate(topo.all_nodes()),
       [&](auto old_node_id) {
-        uint32_t new_node_id = old_to_new_mapping[old_node_id];
+        GraphTopology::Node new_node_id = old_to_new_mapping[old_node_id];
 
         // get the start location of this reindex'd nodes edges
         uint64_t new_out_index =
@@ -1107,8 +1321,8 @@ katana::SortNodesByDegree(katana::PropertyGraph* pg) {
         // construct the graph, reindexing as it goes along
         for (auto e : topo.edges(old_node_id)) {
           // get destination, reindex
-          uint32_t old_edge_dest = out_dests_data[e];
-          uint32_t new_edge_dest = old_to_new_mapping[old_edge_dest];
+          GraphTopology::Node old_edge_dest = out_dests_data[e];
+          GraphTopology::Node new_edge_dest = old_to_new_mapping[old_edge_dest];
 
           new_out_dest[new_out_index] = new_edge_dest;
 
@@ -1133,6 +1347,83 @@ katana::SortNodesByDegree(katana::PropertyGraph* pg) {
   return katana::ResultSuccess();
 }
 
+katana::Result<std::unique_ptr<katana::PropertyGraph>>
+katana::CreateReorderedGraph(
+    const katana::PropertyGraph* pg,
+    katana::ShuffleTopology::NodeSortKind node_sort_kind) {
+  auto seed_topo = EdgeShuffleTopology::MakeOriginalCopy(pg);
+  auto reordered = ShuffleTopology::MakeFromTopo(
+      pg, *seed_topo, node_sort_kind, EdgeShuffleTopology::EdgeSortKind::kAny);
+
+  uint64_t num_nodes = reordered->num_nodes();
+  uint64_t num_edges = reordered->num_edges();
+
+  // Rows of the original graph in the order of the reordered graph
+  katana::NUMAArray<uint64_t> node_rows;
+  katana::NUMAArray<uint64_t> edge_rows;
+  node_rows.allocateInterleaved(num_nodes);
+  edge_rows.allocateInterleaved(num_edges);
+  PropertyGraph::EntityTypeIDArray node_type_ids;
+  PropertyGraph::EntityTypeIDArray edge_type_ids;
+  node_type_ids.allocateInterleaved(num_nodes);
+  edge_type_ids.allocateInterleaved(num_edges);
+
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        node_rows[n] = reordered->node_property_index(n);
+        node_type_ids[n] = pg->GetTypeOfNode(node_rows[n]);
+      },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_edges),
+      [&](uint64_t e) {
+        edge_rows[e] = reordered->edge_property_index(e);
+        edge_type_ids[e] = pg->GetTypeOfEdge(edge_rows[e]);
+      },
+      katana::no_stats());
+
+  auto permute = [](const std::shared_ptr<arrow::Schema>& schema,
+                    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns,
+                    const katana::NUMAArray<uint64_t>& rows)
+      -> katana::Result<std::shared_ptr<arrow::Table>> {
+    auto table = arrow::Table::Make(schema, std::move(columns));
+    std::shared_ptr<arrow::Array> indices =
+        katana::ProjectAsArrowArray(rows.data(), rows.size());
+    arrow::Datum permuted = KATANA_CHECKED_CONTEXT(
+        arrow::compute::Take(arrow::Datum(table), arrow::Datum(indices)),
+        "permuting properties");
+    return permuted.table();
+  };
+
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> node_columns;
+  for (int32_t i = 0; i < pg->GetNumNodeProperties(); ++i) {
+    node_columns.emplace_back(pg->GetNodeProperty(i));
+  }
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> edge_columns;
+  for (int32_t i = 0; i < pg->GetNumEdgeProperties(); ++i) {
+    edge_columns.emplace_back(pg->GetEdgeProperty(i));
+  }
+
+  std::unique_ptr<PropertyGraph> ret = KATANA_CHECKED(PropertyGraph::Make(
+      GraphTopology::Copy(*reordered), std::move(node_type_ids),
+      std::move(edge_type_ids), EntityTypeManager{pg->GetNodeTypeManager()},
+      EntityTypeManager{pg->GetEdgeTypeManager()}));
+
+  if (!node_columns.empty()) {
+    auto node_props = KATANA_CHECKED(permute(
+        pg->loaded_node_schema(), std::move(node_columns), node_rows));
+    KATANA_CHECKED(ret->AddNodeProperties(node_props));
+  }
+  if (!edge_columns.empty()) {
+    auto edge_props = KATANA_CHECKED(permute(
+        pg->loaded_edge_schema(), std::move(edge_columns), edge_rows));
+    KATANA_CHECKED(ret->AddEdgeProperties(edge_props));
+  }
+
+  return std::unique_ptr<PropertyGraph>(std::move(ret));
+}
+
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
 katana::CreateSymmetricGraph(katana::PropertyGraph* pg) {
   const GraphTopology& topology = pg->topology();
@@ -1142,7 +1433,7 @@ katana::CreateSymmetricGraph(katana::PropertyGraph* pg) {
 
   // New symmetric graph topology
   katana::NUMAArray<uint64_t> out_indices;
-  katana::NUMAArray<uint32_t> out_dests;
+  katana::NUMAArray<GraphTopology::Node> out_dests;
 
   out_indices.allocateInterleaved(topology.num_nodes());
   // Store the out-degree of nodes from original graph
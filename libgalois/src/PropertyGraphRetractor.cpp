@@ -16,5 +16,8 @@ katana::PropertyGraphRetractor::InformPath(const std::string& input_path) {
 Result<void>
 katana::PropertyGraphRetractor::DropTopologies() {
   pg_->topology_ = GraphTopology{};
+  pg_->compressed_topology_.reset();
+  pg_->topology_decoded_.reset();
+  pg_->pg_view_cache_.DropTopologies();
   return pg_->rdg_.DropTopology();
 }
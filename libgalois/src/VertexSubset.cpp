@@ -0,0 +1,75 @@
+#include "katana/VertexSubset.h"
+
+#include <algorithm>
+
+katana::VertexSubset
+katana::VertexSubset::MakeDense(uint64_t num_nodes) {
+  VertexSubset subset(num_nodes);
+  subset.dense_.resize(num_nodes);
+  subset.is_dense_ = true;
+  return subset;
+}
+
+bool
+katana::VertexSubset::empty() const {
+  if (!is_dense_) {
+    return sparse_.empty();
+  }
+  const auto& words = dense_.get_vec();
+  return std::all_of(
+      words.begin(), words.end(), [](uint64_t word) { return word == 0; });
+}
+
+uint64_t
+katana::VertexSubset::size() const {
+  if (is_dense_) {
+    return dense_.count();
+  }
+  katana::GAccumulator<uint64_t> size;
+  ForEach([&](Node) { size += 1; });
+  return size.reduce();
+}
+
+void
+katana::VertexSubset::clear() {
+  if (is_dense_) {
+    dense_.reset();
+  } else {
+    sparse_.clear();
+  }
+}
+
+void
+katana::VertexSubset::ToDense() {
+  if (is_dense_) {
+    return;
+  }
+  dense_.resize(num_nodes_);
+  dense_.reset();
+  katana::do_all(
+      katana::iterate(sparse_), [&](Node n) { dense_.set(n); },
+      katana::chunk_size<256>(), katana::loopname("VertexSubset-ToDense"));
+  sparse_.clear();
+  is_dense_ = true;
+}
+
+void
+katana::VertexSubset::ToSparse() {
+  if (!is_dense_) {
+    return;
+  }
+  sparse_.clear();
+  const auto& words = dense_.get_vec();
+  katana::do_all(
+      katana::iterate(uint64_t{0}, static_cast<uint64_t>(words.size())),
+      [&](uint64_t w) {
+        uint64_t bits = words[w];
+        for (; bits != 0; bits &= bits - 1) {
+          sparse_.push(static_cast<Node>(
+              w * DynamicBitset::kNumBitsInUint64 + __builtin_ctzll(bits)));
+        }
+      },
+      katana::steal(), katana::loopname("VertexSubset-ToSparse"));
+  dense_.clear();
+  is_dense_ = false;
+}
@@ -21,9 +21,9 @@
 
 #include "katana/Random.h"
 
-uint32_t
+katana::PropertyGraph::Node
 katana::analytics::SourcePicker::PickNext() {
-  uint32_t source;
+  PropertyGraph::Node source;
   auto& gen = GetGenerator();
   std::uniform_int_distribution dist({}, graph.size() - 1);
   do {
@@ -280,9 +280,10 @@ BetweennessCentralityLevel(
   katana::ReportPageAllocGuard page_alloc;
 
   // If particular set of sources was specified, use them
-  std::vector<uint32_t> source_vector;
-  if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
-    source_vector = std::get<std::vector<uint32_t>>(sources);
+  std::vector<katana::PropertyGraph::Node> source_vector;
+  if (std::holds_alternative<std::vector<katana::PropertyGraph::Node>>(
+          sources)) {
+    source_vector = std::get<std::vector<katana::PropertyGraph::Node>>(sources);
   }
 
   uint64_t loop_end;
@@ -262,7 +262,7 @@ BetweennessCentralityOuter(
   katana::ReportPageAllocGuard page_alloc;
 
   // vector of sources to process; initialized if doing outSources
-  std::vector<uint32_t> source_vector;
+  std::vector<katana::PropertyGraph::Node> source_vector;
   // preprocessing: find the nodes with out edges we will process and skip
   // over nodes with no out edges; only done if numOfSources isn't specified
   if (std::holds_alternative<uint32_t>(sources) &&
@@ -281,8 +281,9 @@ BetweennessCentralityOuter(
     for (auto node = begin; node != adjustedEnd; ++node) {
       source_vector.push_back(*node);
     }
-  } else if (std::holds_alternative<std::vector<uint32_t>>(sources)) {
-    source_vector = std::get<std::vector<uint32_t>>(sources);
+  } else if (std::holds_alternative<std::vector<katana::PropertyGraph::Node>>(
+                 sources)) {
+    source_vector = std::get<std::vector<katana::PropertyGraph::Node>>(sources);
   }
 
   // execute algorithm
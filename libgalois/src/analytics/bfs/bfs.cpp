@@ -22,11 +22,11 @@
 #include <deque>
 #include <type_traits>
 
-#include "katana/DynamicBitset.h"
 #include "katana/ErrorCode.h"
 #include "katana/Result.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/VertexSubset.h"
 #include "katana/analytics/BfsSsspImplementationBase.h"
 
 using namespace katana::analytics;
@@ -35,7 +35,7 @@ namespace {
 
 /// The tag for the output property of BFS in TypedPropertyGraphs.
 using BfsNodeDistance = katana::PODProperty<uint32_t>;
-using BfsNodeParent = katana::PODProperty<uint32_t>;
+using BfsNodeParent = katana::PODProperty<katana::GraphTopology::Node>;
 
 struct BfsImplementation
     : BfsSsspImplementationBase<
@@ -74,18 +74,6 @@ struct EdgeTileMaker {
   }
 };
 
-struct NodePushWrap {
-  template <typename C>
-  void operator()(C& cont, const GNode& n, const char* const /*tag*/) const {
-    (*this)(cont, n);
-  }
-
-  template <typename C>
-  void operator()(C& cont, const GNode& n) const {
-    cont.push(n);
-  }
-};
-
 struct EdgeTilePushWrap {
   Graph* graph;
   BfsImplementation& impl;
@@ -117,28 +105,6 @@ struct OneTilePushWrap {
   }
 };
 
-template <typename WL>
-void
-WlToBitset(const WL& wl, katana::DynamicBitset* bitset) {
-  katana::do_all(
-      katana::iterate(wl), [&](const GNode& src) { bitset->set(src); },
-      katana::chunk_size<kChunkSize>(), katana::loopname("WlToBitset"));
-}
-
-template <typename G, typename WL>
-void
-BitsetToWl(const G& graph, const katana::DynamicBitset& bitset, WL* wl) {
-  wl->clear();
-  katana::do_all(
-      katana::iterate(graph),
-      [&](const GNode& src) {
-        if (bitset.test(src)) {
-          wl->push(src);
-        }
-      },
-      katana::chunk_size<kChunkSize>(), katana::loopname("BitsetToWl"));
-}
-
 template <typename T, typename P, typename R>
 void
 AsynchronousAlgo(
@@ -217,36 +183,55 @@ AsynchronousAlgo(
   }
 }
 
-template <typename P>
+/// Assigns parents on the BFS path. Pushes count the degree of the nodes
+/// they visit and pulls count the nodes, the measures of work that
+/// SynchronousDirectOpt switches direction on.
+struct ParentUpdate {
+  katana::NUMAArray<GNode>* node_data;
+  const BiDirGraphView* bidir_view;
+  katana::GAccumulator<uint32_t>* work_items;
+
+  bool Cond(GNode dst) const {
+    return (*node_data)[dst] == BfsImplementation::kDistanceInfinity;
+  }
+
+  bool Update(GNode src, GNode dst) const {
+    (*node_data)[dst] = src;
+    *work_items += 1;
+    return true;
+  }
+
+  bool UpdateAtomic(GNode src, GNode dst) const {
+    if (__sync_bool_compare_and_swap(
+            &(*node_data)[dst], BfsImplementation::kDistanceInfinity, src)) {
+      *work_items += bidir_view->degree(dst);
+      return true;
+    }
+    return false;
+  }
+};
+
 void
 SynchronousDirectOpt(
     const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
-    const GNode source, const P& pushWrap, const uint32_t alpha,
-    const uint32_t beta) {
-  using Cont = katana::InsertBag<GNode>;
-  using Loop = katana::DoAll;
-
+    const GNode source, const uint32_t alpha, const uint32_t beta) {
   katana::GAccumulator<uint32_t> work_items;
-  katana::StatTimer bitset_to_wl_timer("Bitset_To_WL_Timer");
-  katana::StatTimer wl_to_bitset_timer("WL_To_Bitset_Timer");
-
-  Loop loop;
+  ParentUpdate update{node_data, &bidir_view, &work_items};
 
-  katana::DynamicBitset front_bitset;
-  katana::DynamicBitset next_bitset;
+  katana::EdgeMapOptions push_options;
+  push_options.direction = katana::EdgeMapDirection::kPush;
+  push_options.loopname = "SyncDO-push";
+  katana::EdgeMapOptions pull_options;
+  pull_options.direction = katana::EdgeMapDirection::kPull;
+  pull_options.loopname = "SyncDO-pull";
 
-  uint32_t num_nodes = bidir_view.num_nodes();
+  uint64_t num_nodes = bidir_view.num_nodes();
   uint64_t num_edges = bidir_view.num_edges();
 
-  front_bitset.resize(num_nodes);
-  next_bitset.resize(num_nodes);
-
-  auto frontier = std::make_unique<Cont>();
-  auto next_frontier = std::make_unique<Cont>();
+  katana::VertexSubset frontier(num_nodes);
 
   (*node_data)[source] = source;
-
-  pushWrap(*next_frontier, source, "parallel");
+  frontier.push(source);
 
   work_items += 1;
 
@@ -254,69 +239,19 @@ SynchronousDirectOpt(
   int64_t scout_count = bidir_view.degree(source);
   uint64_t old_num_work_items{0};
 
-  katana::GAccumulator<uint64_t> writes_pull;
-  katana::GAccumulator<uint64_t> writes_push;
-
-  while (!next_frontier->empty()) {
-    std::swap(frontier, next_frontier);
-    next_frontier->clear();
+  while (!frontier.empty()) {
     if (scout_count > edges_to_check / alpha) {
-      wl_to_bitset_timer.start();
-      WlToBitset(*frontier, &front_bitset);
-      wl_to_bitset_timer.stop();
       do {
         old_num_work_items = work_items.reduce();
         work_items.reset();
-
-        loop(
-            katana::iterate(bidir_view),
-            [&](const GNode& dst) {
-              GNode& ddata = (*node_data)[dst];
-              if (ddata == BfsImplementation::kDistanceInfinity) {
-                for (auto e : bidir_view.in_edges(dst)) {
-                  auto src = bidir_view.in_edge_dest(e);
-
-                  if (front_bitset.test(src)) {
-                    // assign parents on the bfs path.
-                    ddata = src;
-                    next_bitset.set(dst);
-                    work_items += 1;
-                    break;
-                  }
-                }
-              }
-            },
-            katana::steal(), katana::chunk_size<kChunkSize>(),
-            katana::loopname(std::string("SyncDO-pull").c_str()));
-        std::swap(front_bitset, next_bitset);
-        next_bitset.reset();
+        frontier = katana::EdgeMap(bidir_view, &frontier, update, pull_options);
       } while (work_items.reduce() >= old_num_work_items ||
                (work_items.reduce() > num_nodes / beta));
-      bitset_to_wl_timer.start();
-      BitsetToWl(bidir_view, front_bitset, next_frontier.get());
-      bitset_to_wl_timer.stop();
       scout_count = 1;
     } else {
       edges_to_check -= scout_count;
       work_items.reset();
-
-      loop(
-          katana::iterate(*frontier),
-          [&](const GNode& src) {
-            for (auto e : bidir_view.edges(src)) {
-              auto dst = bidir_view.edge_dest(e);
-              GNode& ddata = (*node_data)[dst];
-              if (ddata == BfsImplementation::kDistanceInfinity) {
-                GNode old_parent = ddata;
-                if (__sync_bool_compare_and_swap(&ddata, old_parent, src)) {
-                  next_frontier->push(dst);
-                  work_items += bidir_view.degree(dst);
-                }
-              }
-            }
-          },
-          katana::steal(), katana::chunk_size<kChunkSize>(),
-          katana::loopname(std::string("SyncDO-push").c_str()));
+      frontier = katana::EdgeMap(bidir_view, &frontier, update, push_options);
       scout_count = work_items.reduce();
     }
   }
@@ -384,8 +319,7 @@ RunAlgo(
 
     exec_time.start();
     SynchronousDirectOpt(
-        bidir_view, &node_data, source, NodePushWrap(), algo.alpha(),
-        algo.beta());
+        bidir_view, &node_data, source, algo.alpha(), algo.beta());
     exec_time.stop();
 
     UpdateGraphNodeData(graph, node_data);
@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <limits>
+
+#include <arrow/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/analytics/bfs/bfs.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+
+constexpr uint32_t kBitsPerWord = 64;
+
+/// The per-node source bits of one batch: bit s of node n is in word
+/// n * num_words + s / kBitsPerWord
+class SourceBits {
+public:
+  SourceBits(uint64_t num_nodes, uint32_t num_words) : num_words_(num_words) {
+    bits_.allocateInterleaved(num_nodes * num_words);
+    katana::ParallelSTL::fill(bits_.begin(), bits_.end(), uint64_t{0});
+  }
+
+  uint64_t* operator[](Node n) { return &bits_[uint64_t{n} * num_words_]; }
+  const uint64_t* operator[](Node n) const {
+    return &bits_[uint64_t{n} * num_words_];
+  }
+
+private:
+  uint32_t num_words_;
+  katana::NUMAArray<uint64_t> bits_;
+};
+
+/// Traversal of one batch of sources, which writes the distances from
+/// source i of the batch to column first_column + i of distances
+class BatchTraversal {
+public:
+  BatchTraversal(
+      const BiDirView& view, const Node* sources, uint32_t num_sources,
+      uint32_t first_column, uint32_t num_columns, uint32_t* distances)
+      : view_(view),
+        num_words_((num_sources + kBitsPerWord - 1) / kBitsPerWord),
+        seen_(view.num_nodes(), num_words_),
+        visit_(view.num_nodes(), num_words_),
+        next_(view.num_nodes(), num_words_),
+        first_column_(first_column),
+        num_columns_(num_columns),
+        distances_(distances) {
+    for (uint32_t i = 0; i < num_sources; ++i) {
+      Node source = sources[i];
+      seen_[source][i / kBitsPerWord] |= uint64_t{1} << (i % kBitsPerWord);
+      visit_[source][i / kBitsPerWord] |= uint64_t{1} << (i % kBitsPerWord);
+      distances_[uint64_t{source} * num_columns_ + first_column_ + i] = 0;
+    }
+    // Mark the bits past the last source as seen everywhere so that they are
+    // never visited
+    if (uint32_t used = num_sources % kBitsPerWord; used != 0) {
+      uint64_t unused = ~uint64_t{0} << used;
+      katana::do_all(
+          katana::iterate(view_.all_nodes()),
+          [&](Node n) { seen_[n][num_words_ - 1] |= unused; },
+          katana::no_stats());
+    }
+    for (uint32_t i = 0; i < num_sources; ++i) {
+      frontier_edges_ += view_.degree(sources[i]);
+    }
+    frontier_nodes_ = num_sources;
+  }
+
+  void Run(bool direction_opt, uint32_t alpha, uint32_t beta) {
+    uint64_t num_nodes = view_.num_nodes();
+    int64_t edges_to_check = view_.num_edges();
+    bool pull = false;
+
+    for (uint32_t level = 1; frontier_nodes_ > 0; ++level) {
+      if (direction_opt) {
+        // The thresholds of the direction-optimizing BFS, applied to the
+        // union of the frontiers of the batch
+        if (!pull && frontier_edges_ > edges_to_check / alpha) {
+          pull = true;
+        } else if (pull && frontier_nodes_ < num_nodes / beta) {
+          pull = false;
+        }
+      }
+      if (pull) {
+        Pull();
+      } else {
+        edges_to_check -= frontier_edges_;
+        Push();
+      }
+      Advance(level);
+    }
+  }
+
+private:
+  bool Any(const uint64_t* words) const {
+    for (uint32_t w = 0; w < num_words_; ++w) {
+      if (words[w] != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Each frontier node sends the sources that reached it to its out
+  /// neighbors that have not seen them
+  void Push() {
+    katana::do_all(
+        katana::iterate(view_.all_nodes()),
+        [&](Node src) {
+          const uint64_t* visit = visit_[src];
+          if (!Any(visit)) {
+            return;
+          }
+          for (auto e : view_.edges(src)) {
+            Node dst = view_.edge_dest(e);
+            const uint64_t* seen = seen_[dst];
+            uint64_t* next = next_[dst];
+            for (uint32_t w = 0; w < num_words_; ++w) {
+              uint64_t bits = visit[w] & ~seen[w] &
+                              ~__atomic_load_n(&next[w], __ATOMIC_RELAXED);
+              if (bits != 0) {
+                __atomic_fetch_or(&next[w], bits, __ATOMIC_RELAXED);
+              }
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<64>(),
+        katana::loopname("MultiSourceBfs-push"));
+  }
+
+  /// Each node gathers the unseen sources that reached its in neighbors,
+  /// stopping once it has all of them
+  void Pull() {
+    katana::do_all(
+        katana::iterate(view_.all_nodes()),
+        [&](Node dst) {
+          const uint64_t* seen = seen_[dst];
+          uint64_t* next = next_[dst];
+          uint64_t missing = 0;
+          for (uint32_t w = 0; w < num_words_; ++w) {
+            missing |= ~seen[w];
+          }
+          if (missing == 0) {
+            return;
+          }
+          for (auto e : view_.in_edges(dst)) {
+            const uint64_t* visit = visit_[view_.in_edge_dest(e)];
+            missing = 0;
+            for (uint32_t w = 0; w < num_words_; ++w) {
+              next[w] |= visit[w] & ~seen[w];
+              missing |= ~seen[w] & ~next[w];
+            }
+            if (missing == 0) {
+              break;
+            }
+          }
+        },
+        katana::steal(), katana::chunk_size<64>(),
+        katana::loopname("MultiSourceBfs-pull"));
+  }
+
+  /// Make the nodes reached in this round the next frontier and record their
+  /// distances
+  void Advance(uint32_t level) {
+    katana::GAccumulator<uint64_t> frontier_nodes;
+    katana::GAccumulator<uint64_t> frontier_edges;
+    katana::do_all(
+        katana::iterate(view_.all_nodes()),
+        [&](Node n) {
+          uint64_t* seen = seen_[n];
+          uint64_t* visit = visit_[n];
+          uint64_t* next = next_[n];
+          bool reached = false;
+          uint32_t* row = &distances_[uint64_t{n} * num_columns_];
+          for (uint32_t w = 0; w < num_words_; ++w) {
+            uint64_t bits = next[w] & ~seen[w];
+            seen[w] |= bits;
+            visit[w] = bits;
+            next[w] = 0;
+            reached |= bits != 0;
+            for (; bits != 0; bits &= bits - 1) {
+              uint32_t i = w * kBitsPerWord + __builtin_ctzll(bits);
+              row[first_column_ + i] = level;
+            }
+          }
+          if (reached) {
+            frontier_nodes += 1;
+            frontier_edges += view_.degree(n);
+          }
+        },
+        katana::no_stats());
+    frontier_nodes_ = frontier_nodes.reduce();
+    frontier_edges_ = frontier_edges.reduce();
+  }
+
+  const BiDirView& view_;
+  uint32_t num_words_;
+  SourceBits seen_;
+  SourceBits visit_;
+  SourceBits next_;
+  uint32_t first_column_;
+  uint32_t num_columns_;
+  uint32_t* distances_;
+  uint64_t frontier_nodes_{0};
+  int64_t frontier_edges_{0};
+};
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<PropertyGraph::Node>& sources,
+    const std::string& output_property_name, BfsPlan algo) {
+  if (sources.empty()) {
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "no sources");
+  }
+  if (sources.size() > std::numeric_limits<int32_t>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "too many sources: {}",
+        sources.size());
+  }
+  for (auto source : sources) {
+    if (source >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "source {} out of range: graph has {} nodes", source,
+          pg->num_nodes());
+    }
+  }
+  if (algo.algorithm() != BfsPlan::kSynchronousDirectOpt &&
+      algo.algorithm() != BfsPlan::kSynchronous) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "Unsupported algorithm: {}",
+        algo.algorithm());
+  }
+
+  auto view = pg->BuildView<BiDirView>();
+
+  uint32_t num_columns = sources.size();
+  uint64_t num_values = pg->num_nodes() * num_columns;
+  std::shared_ptr<arrow::Buffer> buffer = KATANA_CHECKED_CONTEXT(
+      arrow::AllocateBuffer(num_values * sizeof(uint32_t)),
+      "allocating distances");
+  auto* distances = reinterpret_cast<uint32_t*>(buffer->mutable_data());
+  katana::ParallelSTL::fill(
+      distances, distances + num_values, kMultiSourceBfsUnreachable);
+
+  katana::StatTimer exec_time("MultiSourceBfs");
+  exec_time.start();
+  for (uint32_t first = 0; first < num_columns;
+       first += kMultiSourceBfsBatchSize) {
+    uint32_t batch_size =
+        std::min(kMultiSourceBfsBatchSize, num_columns - first);
+    BatchTraversal traversal(
+        view, &sources[first], batch_size, first, num_columns, distances);
+    traversal.Run(
+        algo.algorithm() == BfsPlan::kSynchronousDirectOpt, algo.alpha(),
+        algo.beta());
+  }
+  exec_time.stop();
+
+  auto values = std::make_shared<arrow::UInt32Array>(num_values, buffer);
+  std::shared_ptr<arrow::Array> column = KATANA_CHECKED_CONTEXT(
+      arrow::FixedSizeListArray::FromArrays(values, num_columns),
+      "building distance lists");
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, column->type())}),
+      {column});
+  return pg->AddNodeProperties(table);
+}
@@ -93,13 +93,16 @@ struct ConnectedComponentsSerialAlgo {
   }
 };
 
+struct LabelPropComponent : public katana::AtomicPODProperty<uint64_t> {};
+
+/// Label propagation over Graph, which may be a TypedPropertyGraph or a
+/// TypedPropertyGraphView, e.g., of PropertyGraphViews::Compressed
+template <typename GraphType>
 struct ConnectedComponentsLabelPropAlgo {
   using ComponentType = uint64_t;
-  struct NodeComponent : public katana::AtomicPODProperty<ComponentType> {};
+  using NodeComponent = LabelPropComponent;
 
-  using NodeData = std::tuple<NodeComponent>;
-  using EdgeData = std::tuple<>;
-  typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+  using Graph = GraphType;
   typedef typename Graph::Node GNode;
 
   katana::NUMAArray<ComponentType> old_component_;
@@ -110,7 +113,7 @@ struct ConnectedComponentsLabelPropAlgo {
   void Initialize(Graph* graph) {
     old_component_.allocateBlocked(graph->size());
     katana::do_all(katana::iterate(*graph), [&](const GNode& node) {
-      graph->GetData<NodeComponent>(node).store(node);
+      graph->template GetData<NodeComponent>(node).store(node);
       old_component_[node] = kInfinity;
     });
   }
@@ -124,7 +127,8 @@ struct ConnectedComponentsLabelPropAlgo {
       katana::do_all(
           katana::iterate(*graph),
           [&](const GNode& src) {
-            auto& sdata_current_comp = graph->GetData<NodeComponent>(src);
+            auto& sdata_current_comp =
+                graph->template GetData<NodeComponent>(src);
             auto& sdata_old_comp = old_component_[src];
             if (sdata_old_comp > sdata_current_comp) {
               sdata_old_comp = sdata_current_comp;
@@ -132,8 +136,9 @@ struct ConnectedComponentsLabelPropAlgo {
               changed.update(true);
 
               for (auto e : graph->edges(src)) {
-                auto dest = graph->GetEdgeDest(e);
-                auto& ddata_current_comp = graph->GetData<NodeComponent>(dest);
+                auto dest = graph->edge_dest(e);
+                auto& ddata_current_comp =
+                    graph->template GetData<NodeComponent>(dest);
                 ComponentType label_new = sdata_current_comp;
                 katana::atomicMin(ddata_current_comp, label_new);
               }
@@ -145,6 +150,12 @@ struct ConnectedComponentsLabelPropAlgo {
   }
 };
 
+using LabelPropGraph = katana::TypedPropertyGraph<
+    std::tuple<LabelPropComponent>, std::tuple<>>;
+using CompressedLabelPropGraph = katana::TypedPropertyGraphView<
+    katana::PropertyGraphViews::Compressed, std::tuple<LabelPropComponent>,
+    std::tuple<>>;
+
 struct ConnectedComponentsSynchronousAlgo {
   using ComponentType = ConnectedComponentsNode*;
   struct NodeComponent : public katana::PODProperty<uint64_t, ComponentType> {};
@@ -1104,8 +1115,7 @@ ConnectedComponentsWithWrap(
     katana::PropertyGraph* pg, std::string output_property_name,
     ConnectedComponentsPlan plan) {
   katana::EnsurePreallocated(
-      2,
-      pg->topology().num_nodes() * sizeof(typename Algorithm::NodeComponent));
+      2, pg->num_nodes() * sizeof(typename Algorithm::NodeComponent));
   katana::ReportPageAllocGuard page_alloc;
 
   if (auto r = ConstructNodeProperties<
@@ -1144,7 +1154,14 @@ katana::analytics::ConnectedComponents(
     return ConnectedComponentsWithWrap<ConnectedComponentsSerialAlgo>(
         pg, output_property_name, plan);
   case ConnectedComponentsPlan::kLabelProp:
-    return ConnectedComponentsWithWrap<ConnectedComponentsLabelPropAlgo>(
+    if (pg->has_compressed_topology()) {
+      // Traverse the compressed topology rather than decoding the CSR
+      return ConnectedComponentsWithWrap<
+          ConnectedComponentsLabelPropAlgo<CompressedLabelPropGraph>>(
+          pg, output_property_name, plan);
+    }
+    return ConnectedComponentsWithWrap<
+        ConnectedComponentsLabelPropAlgo<LabelPropGraph>>(
         pg, output_property_name, plan);
   case ConnectedComponentsPlan::kSynchronous:
     return ConnectedComponentsWithWrap<ConnectedComponentsSynchronousAlgo>(
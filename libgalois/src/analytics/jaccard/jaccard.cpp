@@ -19,6 +19,7 @@
 
 #include "katana/analytics/jaccard/jaccard.h"
 
+#include "katana/SetIntersection.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 #include "katana/analytics/Utils.h"
@@ -33,63 +34,60 @@ typedef typename Graph::Node GNode;
 
 namespace {
 
+/// The destinations of the edges of n, in edge order
+const GNode*
+Dests(const Graph& graph, GNode n) {
+  return graph.GetPropertyGraph().topology().dest_data() +
+         *graph.edges(n).begin();
+}
+
+/// A base node with at least this many neighbors is a hub: its neighbors are
+/// put in a bitmap that the neighbors of every other node probe, rather than
+/// intersected with each of them
+constexpr static const size_t kHubDegree = 1024;
+
 struct IntersectWithSortedEdgeList {
 private:
   const GNode base_;
   const Graph& graph_;
+  katana::SetBitmap base_neighbors_;
+  bool use_bitmap_;
 
 public:
   IntersectWithSortedEdgeList(const Graph& graph, GNode base)
-      : base_(base), graph_(graph) {}
+      : base_(base),
+        graph_(graph),
+        use_bitmap_(graph.edges(base).size() >= kHubDegree) {
+    if (use_bitmap_) {
+      base_neighbors_.resize(graph.num_nodes());
+      base_neighbors_.Insert(Dests(graph, base), graph.edges(base).size());
+    }
+  }
 
   uint32_t operator()(GNode n2) {
-    uint32_t intersection_size = 0;
-    // Iterate over the edges of both n2 and base in sync, based on the
-    // assumption that edges lists are sorted.
-    auto edges_n2_iter = graph_.edge_begin(n2);
-    auto edges_n2_end = graph_.edge_end(n2);
-    auto edges_base_iter = graph_.edge_begin(base_);
-    auto edges_base_end = graph_.edge_end(base_);
-    while (edges_n2_iter != edges_n2_end && edges_base_iter != edges_base_end) {
-      auto edge_n2_dst = graph_.GetEdgeDest(*edges_n2_iter);
-      auto edge_base_dst = graph_.GetEdgeDest(*edges_base_iter);
-      if (edge_n2_dst == edge_base_dst) {
-        intersection_size++;
-        edges_n2_iter++;
-        edges_base_iter++;
-      } else if (edge_n2_dst > edge_base_dst) {
-        edges_base_iter++;
-      } else if (edge_n2_dst < edge_base_dst) {
-        edges_n2_iter++;
-      }
+    if (use_bitmap_) {
+      return base_neighbors_.Count(Dests(graph_, n2), graph_.edges(n2).size());
     }
-    return intersection_size;
+    return katana::IntersectCount(
+        Dests(graph_, n2), graph_.edges(n2).size(), Dests(graph_, base_),
+        graph_.edges(base_).size());
   }
 };
 
 struct IntersectWithUnsortedEdgeList {
 private:
-  std::unordered_set<GNode> base_neighbors;
+  katana::SetBitmap base_neighbors;
   const Graph& graph_;
 
 public:
   IntersectWithUnsortedEdgeList(const Graph& graph, GNode base)
-      : graph_(graph) {
-    // Collect all the neighbors of the base node into a hash set.
-    for (const auto& e : graph.edges(base)) {
-      auto dest = graph.GetEdgeDest(e);
-      base_neighbors.emplace(*dest);
-    }
+      : base_neighbors(graph.num_nodes()), graph_(graph) {
+    // Collect all the neighbors of the base node into a bitmap.
+    base_neighbors.Insert(Dests(graph, base), graph.edges(base).size());
   }
 
   uint32_t operator()(GNode n2) {
-    uint32_t intersection_size = 0;
-    for (const auto& e : graph_.edges(n2)) {
-      auto neighbor = graph_.GetEdgeDest(e);
-      if (base_neighbors.count(*neighbor) > 0)
-        intersection_size++;
-    }
-    return intersection_size;
+    return base_neighbors.Count(Dests(graph_, n2), graph_.edges(n2).size());
   }
 };
 
@@ -140,7 +138,7 @@ JaccardImpl(
 
 katana::Result<void>
 katana::analytics::Jaccard(
-    PropertyGraph* pg, uint32_t compare_node,
+    PropertyGraph* pg, PropertyGraph::Node compare_node,
     const std::string& output_property_name, JaccardPlan plan) {
   if (auto result =
           ConstructNodeProperties<NodeData>(pg, {output_property_name});
@@ -175,7 +173,7 @@ constexpr static const double EPSILON = 1e-6;
 
 katana::Result<void>
 katana::analytics::JaccardAssertValid(
-    katana::PropertyGraph* pg, uint32_t compare_node,
+    katana::PropertyGraph* pg, katana::PropertyGraph::Node compare_node,
     const std::string& property_name) {
   auto pg_result = katana::TypedPropertyGraph<NodeData, EdgeData>::Make(
       pg, {property_name}, {});
@@ -206,7 +204,7 @@ katana::analytics::JaccardAssertValid(
 
 katana::Result<JaccardStatistics>
 katana::analytics::JaccardStatistics::Compute(
-    katana::PropertyGraph* pg, uint32_t compare_node,
+    katana::PropertyGraph* pg, katana::PropertyGraph::Node compare_node,
     const std::string& property_name) {
   auto pg_result = katana::TypedPropertyGraph<NodeData, EdgeData>::Make(
       pg, {property_name}, {});
@@ -223,7 +221,7 @@ katana::analytics::JaccardStatistics::Compute(
       katana::iterate(graph),
       [&](const GNode& i) {
         double similarity = graph.GetData<JaccardSimilarity>(i);
-        if ((unsigned int)i != (unsigned int)compare_node) {
+        if (i != compare_node) {
           max_similarity.update(similarity);
           min_similarity.update(similarity);
           total_similarity += similarity;
@@ -20,6 +20,7 @@
 #include "katana/analytics/k_truss/k_truss.h"
 
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/SetIntersection.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -95,40 +96,25 @@ IsValidDegreeNoLessThanJ(const SortedGraphView& g, GNode n, unsigned int j) {
 bool
 IsSupportNoLessThanJ(
     const SortedGraphView& g, GNode src, GNode dest, unsigned int j) {
-  size_t numValidEqual = 0;
-  auto srcI = g.edges(src).begin(), srcE = g.edges(src).end(),
-       dstI = g.edges(dest).begin(), dstE = g.edges(dest).end();
-
-  while (true) {
-    //! Find the first valid edge.
-    while (srcI != srcE && (g.GetEdgeData<EdgeFlag>(*srcI) & removed)) {
-      ++srcI;
-    }
-    while (dstI != dstE && (g.GetEdgeData<EdgeFlag>(*dstI) & removed)) {
-      ++dstI;
-    }
-
-    if (srcI == srcE || dstI == dstE) {
-      return numValidEqual >= j;
-    }
-
-    //! Check for intersection.
-    auto sN = g.edge_dest(*srcI), dN = g.edge_dest(*dstI);
-    if (sN < dN) {
-      ++srcI;
-    } else if (dN < sN) {
-      ++dstI;
-    } else {
-      numValidEqual += 1;
-      if (numValidEqual >= j) {
-        return true;
-      }
-      ++srcI;
-      ++dstI;
-    }
+  if (j == 0) {
+    return true;
   }
 
-  return numValidEqual >= j;
+  auto src_edges = *g.edges(src).begin();
+  auto dest_edges = *g.edges(dest).begin();
+
+  //! Count the common neighbors whose edges to src and dest are both valid,
+  //! stopping as soon as there are j of them.
+  size_t numValidEqual = 0;
+  return katana::ForEachCommonPositionUntil(
+      g.sorted_dests(src), g.degree(src), g.sorted_dests(dest), g.degree(dest),
+      [&](size_t src_i, size_t dest_i) {
+        if (!(g.GetEdgeData<EdgeFlag>(src_edges + src_i) & removed) &&
+            !(g.GetEdgeData<EdgeFlag>(dest_edges + dest_i) & removed)) {
+          numValidEqual += 1;
+        }
+        return numValidEqual >= j;
+      });
 }
 
 struct PickUnsupportedEdges {
@@ -20,6 +20,7 @@
 #include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
 
 #include "katana/AtomicHelpers.h"
+#include "katana/SetIntersection.h"
 
 using namespace katana::analytics;
 
@@ -36,6 +37,23 @@ using SortedGraphView =
     katana::TypedPropertyGraphView<SortedPropertyGraphView, NodeData, EdgeData>;
 using Node = SortedGraphView::Node;
 
+/// Call fn(v, w) for each triangle (n, v, w) with w <= v <= n
+template <typename F>
+void
+ForEachOrderedTriangle(const SortedGraphView& graph, Node n, F fn) {
+  const Node* n_begin = graph.sorted_dests(n);
+  const Node* n_end = n_begin + graph.degree(n);
+  for (const Node* v = n_begin; v != n_end && *v <= n; ++v) {
+    const Node* v_begin = graph.sorted_dests(*v);
+    const Node* v_end =
+        std::upper_bound(v_begin, v_begin + graph.degree(*v), *v);
+    const Node* n_low_end = std::upper_bound(v, n_end, *v);
+    katana::ForEachCommon(
+        v_begin, v_end - v_begin, n_begin, n_low_end - n_begin,
+        [&](Node w) { fn(*v, w); });
+  }
+}
+
 struct LocalClusteringCoefficientAtomics {
   /**
    * Counts the number of triangles for each node
@@ -49,28 +67,11 @@ struct LocalClusteringCoefficientAtomics {
   void OrderedCountFunc(
       const SortedGraphView& graph, Node n, CountVec* count_vec) {
     // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.edges(n)) {
-      auto v = graph.edge_dest(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.edges(n).begin();
-
-      for (auto edges_v : graph.edges(v)) {
-        auto dst_v = graph.edge_dest(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.edge_dest(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.edge_dest(*e_it_n)) {
-          __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[v], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[dst_v], uint32_t{1});
-        }
-      }
-    }
+    ForEachOrderedTriangle(graph, n, [&](Node v, Node w) {
+      __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
+      __sync_fetch_and_add(&(*count_vec)[v], uint32_t{1});
+      __sync_fetch_and_add(&(*count_vec)[w], uint32_t{1});
+    });
   }
 
   void ComputeLocalClusteringCoefficient(SortedGraphView* graph) {
@@ -134,28 +135,11 @@ struct LocalClusteringCoefficientPerThread {
   void OrderedCountFunc(
       const SortedGraphView& graph, Node n, IterPair per_thread_count_range) {
     // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.edges(n)) {
-      auto v = graph.edge_dest(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.edges(n).begin();
-
-      for (auto edges_v : graph.edges(v)) {
-        auto dst_v = graph.edge_dest(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.edge_dest(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.edge_dest(*e_it_n)) {
-          *(per_thread_count_range.first + n) += 1;
-          *(per_thread_count_range.first + v) += 1;
-          *(per_thread_count_range.first + dst_v) += 1;
-        }
-      }
-    }
+    ForEachOrderedTriangle(graph, n, [&](Node v, Node w) {
+      *(per_thread_count_range.first + n) += 1;
+      *(per_thread_count_range.first + v) += 1;
+      *(per_thread_count_range.first + w) += 1;
+    });
   }
 
   /*
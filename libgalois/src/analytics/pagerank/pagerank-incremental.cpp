@@ -0,0 +1,207 @@
+#include <cmath>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/DynamicBitset.h"
+#include "katana/ErrorCode.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/Utils.h"
+#include "pagerank-impl.h"
+
+using katana::atomicAdd;
+using katana::analytics::PagerankPlan;
+
+namespace {
+
+struct NodeResidual : katana::AtomicPODProperty<PRTy> {};
+
+using NodeData = std::tuple<NodeValue, NodeResidual>;
+using EdgeData = std::tuple<>;
+typedef katana::TypedPropertyGraph<NodeData, EdgeData> Graph;
+typedef typename Graph::Node GNode;
+
+using BiDirView = katana::PropertyGraphViews::BiDirectional;
+
+/// The residual of n for the current ranks: how far its rank is from the
+/// right-hand side of its rank equation. It may be negative.
+PRTy
+Residual(
+    Graph* graph, const BiDirView& view, GNode n, const PagerankPlan& plan) {
+  PRTy sum = 0;
+  for (auto e : view.in_edges(n)) {
+    auto src = view.in_edge_dest(e);
+    sum += graph->GetData<NodeValue>(src) / view.degree(src);
+  }
+  return plan.initial_residual() + plan.alpha() * sum -
+         graph->GetData<NodeValue>(n);
+}
+
+/// Set the residual of each node of nodes and return the ones to push
+katana::InsertBag<GNode>
+ComputeResiduals(
+    Graph* graph, const BiDirView& view,
+    const katana::InsertBag<GNode>& nodes, const PagerankPlan& plan) {
+  katana::InsertBag<GNode> active;
+  katana::do_all(
+      katana::iterate(nodes),
+      [&](const GNode& n) {
+        PRTy residual = Residual(graph, view, n, plan);
+        graph->GetData<NodeResidual>(n) = residual;
+        if (std::fabs(residual) > plan.tolerance()) {
+          active.push(n);
+        }
+      },
+      katana::steal(), katana::chunk_size<PagerankPlan::kChunkSize>(),
+      katana::loopname("ComputeResiduals"));
+  return active;
+}
+
+/// Push residuals from active until every residual is within the tolerance.
+/// Unlike the push algorithms, residuals can be negative when ranks start
+/// above their final value.
+uint64_t
+PushResiduals(
+    Graph* graph, const katana::InsertBag<GNode>& active,
+    const PagerankPlan& plan) {
+  typedef katana::PerSocketChunkFIFO<PagerankPlan::kChunkSize> WL;
+  katana::GAccumulator<uint64_t> num_pushes;
+  katana::for_each(
+      katana::iterate(active),
+      [&](const GNode& src, auto& ctx) {
+        auto& src_residual = graph->GetData<NodeResidual>(src);
+        if (std::fabs(src_residual) <= plan.tolerance()) {
+          return;
+        }
+        num_pushes += 1;
+        PRTy old_residual = src_residual.exchange(0.0);
+        graph->GetData<NodeValue>(src) += old_residual;
+        int src_nout = graph->edges(src).size();
+        if (src_nout == 0) {
+          return;
+        }
+        PRTy delta = old_residual * plan.alpha() / src_nout;
+        for (const auto& jj : graph->edges(src)) {
+          auto dest = graph->GetEdgeDest(jj);
+          auto old = atomicAdd(graph->GetData<NodeResidual>(dest), delta);
+          if (std::fabs(old) <= plan.tolerance() &&
+              std::fabs(old + delta) > plan.tolerance()) {
+            ctx.push(*dest);
+          }
+        }
+      },
+      katana::loopname("PushResidualWarmStart"),
+      katana::disable_conflict_detection(), katana::wl<WL>());
+  return num_pushes.reduce();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::PagerankWarmStart(
+    PropertyGraph* pg, const std::string& initial_rank_property_name,
+    const std::string& output_property_name, PagerankPlan plan) {
+  using InitialGraph =
+      katana::TypedPropertyGraph<std::tuple<NodeValue>, std::tuple<>>;
+  auto initial_graph = KATANA_CHECKED_CONTEXT(
+      InitialGraph::Make(pg, {initial_rank_property_name}, {}),
+      "initial ranks");
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+  KATANA_CHECKED(katana::analytics::ConstructNodeProperties<NodeData>(
+      pg, {output_property_name, temporary_property.name()}));
+  auto graph = KATANA_CHECKED(
+      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
+  auto view = pg->BuildView<BiDirView>();
+
+  katana::StatTimer exec_time("PagerankWarmStart");
+  exec_time.start();
+
+  katana::InsertBag<GNode> nodes;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        graph.GetData<NodeValue>(n) = initial_graph.GetData<NodeValue>(n);
+        nodes.push(n);
+      },
+      katana::no_stats());
+
+  auto active = ComputeResiduals(&graph, view, nodes, plan);
+  uint64_t num_pushes = PushResiduals(&graph, active, plan);
+
+  exec_time.stop();
+  katana::ReportStatSingle("PagerankWarmStart", "Pushes", num_pushes);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::IncrementalPagerank(
+    PropertyGraph* pg, const std::vector<PropertyGraph::Node>& srcs,
+    const std::vector<PropertyGraph::Node>& dests,
+    const std::string& output_property_name, PagerankPlan plan) {
+  if (srcs.size() != dests.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} sources but {} destinations", srcs.size(), dests.size());
+  }
+  for (size_t i = 0; i < srcs.size(); ++i) {
+    if (srcs[i] >= pg->num_nodes() || dests[i] >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge {} -> {} out of range: graph has {} nodes", srcs[i], dests[i],
+          pg->num_nodes());
+    }
+  }
+
+  katana::analytics::TemporaryPropertyGuard temporary_property{
+      pg->NodeMutablePropertyView()};
+  KATANA_CHECKED(
+      katana::analytics::ConstructNodeProperties<std::tuple<NodeResidual>>(
+          pg, {temporary_property.name()}));
+  auto graph = KATANA_CHECKED(
+      Graph::Make(pg, {output_property_name, temporary_property.name()}, {}));
+  auto view = pg->BuildView<BiDirView>();
+
+  katana::StatTimer exec_time("IncrementalPagerank");
+  exec_time.start();
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) { graph.GetData<NodeResidual>(n) = 0; },
+      katana::no_stats());
+
+  // A changed edge changes the rank equation of its destination and, through
+  // the degree of its source, of every out neighbor of the source
+  katana::DynamicBitset expanded;
+  expanded.resize(pg->num_nodes());
+  katana::DynamicBitset affected;
+  affected.resize(pg->num_nodes());
+  katana::InsertBag<GNode> nodes;
+  katana::do_all(
+      katana::iterate(size_t{0}, srcs.size()),
+      [&](size_t i) {
+        auto add = [&](GNode n) {
+          if (!affected.set(n)) {
+            nodes.push(n);
+          }
+        };
+        add(srcs[i]);
+        add(dests[i]);
+        if (!expanded.set(srcs[i])) {
+          for (auto e : view.edges(srcs[i])) {
+            add(view.edge_dest(e));
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  auto active = ComputeResiduals(&graph, view, nodes, plan);
+  uint64_t num_pushes = PushResiduals(&graph, active, plan);
+
+  exec_time.stop();
+  katana::ReportStatSingle("IncrementalPagerank", "Pushes", num_pushes);
+
+  return katana::ResultSuccess();
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+
+#include "katana/ErrorCode.h"
+#include "katana/Loops.h"
+#include "katana/PerThreadStorage.h"
+#include "katana/Result.h"
+#include "katana/Statistics.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Node = katana::PropertyGraph::Node;
+
+/// The rank and residual of the nodes a query has touched; a thread reuses
+/// one for all of its queries so that the maps keep their buckets
+struct ForwardPushState {
+  std::unordered_map<Node, float> rank;
+  std::unordered_map<Node, float> residual;
+  std::deque<Node> queue;
+
+  void clear() {
+    rank.clear();
+    residual.clear();
+    queue.clear();
+  }
+};
+
+/// Whether a node with the given residual is pushed. Nodes without out
+/// edges count as having one, their restart.
+bool
+IsActive(const katana::GraphTopology& topo, Node n, float r, float epsilon) {
+  return r > epsilon * std::max<uint64_t>(topo.degree(n), 1);
+}
+
+PersonalizedPagerankTopK
+ForwardPush(
+    const katana::GraphTopology& topo, const Node* seeds, size_t num_seeds,
+    const PersonalizedPagerankPlan& plan, ForwardPushState* state) {
+  float alpha = plan.alpha();
+  float epsilon = plan.epsilon();
+  state->clear();
+
+  auto add_residual = [&](Node n, float r) {
+    float& residual = state->residual[n];
+    bool was_active = IsActive(topo, n, residual, epsilon);
+    residual += r;
+    if (!was_active && IsActive(topo, n, residual, epsilon)) {
+      state->queue.push_back(n);
+    }
+  };
+
+  float seed_residual = 1.0f / num_seeds;
+  for (size_t i = 0; i < num_seeds; ++i) {
+    add_residual(seeds[i], seed_residual);
+  }
+
+  while (!state->queue.empty()) {
+    Node n = state->queue.front();
+    state->queue.pop_front();
+    float& residual = state->residual[n];
+    float r = residual;
+    residual = 0;
+    state->rank[n] += (1 - alpha) * r;
+
+    uint64_t degree = topo.degree(n);
+    if (degree == 0) {
+      // The walk restarts
+      for (size_t i = 0; i < num_seeds; ++i) {
+        add_residual(seeds[i], alpha * r * seed_residual);
+      }
+      continue;
+    }
+    float share = alpha * r / degree;
+    for (auto e : topo.edges(n)) {
+      add_residual(topo.edge_dest(e), share);
+    }
+  }
+
+  PersonalizedPagerankTopK top(state->rank.begin(), state->rank.end());
+  auto mid = top.begin() + std::min<size_t>(plan.top_k(), top.size());
+  std::partial_sort(
+      top.begin(), mid, top.end(), [](const auto& a, const auto& b) {
+        return a.second > b.second ||
+               (a.second == b.second && a.first < b.first);
+      });
+  top.erase(mid, top.end());
+  return top;
+}
+
+katana::Result<void>
+CheckArguments(
+    const katana::PropertyGraph* pg, const std::vector<Node>& seeds,
+    const PersonalizedPagerankPlan& plan) {
+  if (seeds.empty()) {
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "no seeds");
+  }
+  for (auto seed : seeds) {
+    if (seed >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "seed {} out of range: graph has {} nodes", seed, pg->num_nodes());
+    }
+  }
+  if (!(plan.alpha() >= 0 && plan.alpha() < 1)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "alpha must be in [0, 1): {}",
+        plan.alpha());
+  }
+  if (!(plan.epsilon() > 0)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "epsilon must be positive: {}",
+        plan.epsilon());
+  }
+  if (plan.algorithm() != PersonalizedPagerankPlan::kForwardPush) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "Unsupported algorithm: {}",
+        plan.algorithm());
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<PersonalizedPagerankTopK>
+katana::analytics::PersonalizedPagerank(
+    PropertyGraph* pg, const std::vector<PropertyGraph::Node>& seeds,
+    PersonalizedPagerankPlan plan) {
+  KATANA_CHECKED(CheckArguments(pg, seeds, plan));
+
+  katana::StatTimer exec_time("PersonalizedPagerank");
+  exec_time.start();
+  ForwardPushState state;
+  auto top =
+      ForwardPush(pg->topology(), seeds.data(), seeds.size(), plan, &state);
+  exec_time.stop();
+  return top;
+}
+
+katana::Result<std::vector<PersonalizedPagerankTopK>>
+katana::analytics::PersonalizedPagerankBatch(
+    PropertyGraph* pg, const std::vector<PropertyGraph::Node>& seeds,
+    PersonalizedPagerankPlan plan) {
+  KATANA_CHECKED(CheckArguments(pg, seeds, plan));
+
+  const katana::GraphTopology& topo = pg->topology();
+  std::vector<PersonalizedPagerankTopK> results(seeds.size());
+  katana::PerThreadStorage<ForwardPushState> states;
+
+  katana::StatTimer exec_time("PersonalizedPagerankBatch");
+  exec_time.start();
+  katana::do_all(
+      katana::iterate(size_t{0}, seeds.size()),
+      [&](size_t i) {
+        results[i] = ForwardPush(topo, &seeds[i], 1, plan, states.getLocal());
+      },
+      katana::steal(), katana::chunk_size<1>(),
+      katana::loopname("PersonalizedPagerankBatch"));
+  exec_time.stop();
+  return results;
+}
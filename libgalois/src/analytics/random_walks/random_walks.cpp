@@ -19,6 +19,11 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include <arrow/api.h>
+
+#include "katana/ErrorCode.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -27,7 +32,255 @@ const int RandomWalksPlan::kChunkSize = 1;
 
 namespace {
 
-using SortedPropertyGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
+// The walks test has_edge(prev, nbr) for most steps, so hubs get hash sets
+using SortedPropertyGraphView =
+    katana::PropertyGraphViews::EdgesSortedByDestIDIndexed;
+
+/// What happens to an Edge2Vec walk that reaches a node without edges before
+/// it has its full length. Node2Vec walks always end there.
+enum class DeadEnds {
+  /// Drop the walk, as RandomWalks always has
+  kDrop,
+  /// Keep the walk up to the node without edges
+  kTruncate,
+};
+
+/// The walks of a run in one preallocated buffer: walk i occupies the
+/// stride() entries from i * stride(), of which length(i) are used. Walks
+/// are written in place, so nothing is allocated per walk.
+class WalkBuffer {
+public:
+  using Node = katana::PropertyGraph::Node;
+
+  WalkBuffer(uint64_t num_walks, uint32_t walk_length)
+      : num_walks_(num_walks), stride_(walk_length + 1) {}
+
+  katana::Result<void> Allocate() {
+    nodes_ = KATANA_CHECKED_CONTEXT(
+        arrow::AllocateBuffer(num_walks_ * stride_ * sizeof(Node)),
+        "allocating walks");
+    lengths_.allocateInterleaved(num_walks_);
+    return katana::ResultSuccess();
+  }
+
+  uint64_t num_walks() const { return num_walks_; }
+  uint32_t stride() const { return stride_; }
+
+  Node* walk(uint64_t i) {
+    return reinterpret_cast<Node*>(nodes_->mutable_data()) + i * stride_;
+  }
+  const Node* walk(uint64_t i) const {
+    return reinterpret_cast<const Node*>(nodes_->data()) + i * stride_;
+  }
+
+  uint32_t length(uint64_t i) const { return lengths_[i]; }
+  void set_length(uint64_t i, uint32_t length) { lengths_[i] = length; }
+
+  /// The walks as vectors, leaving out empty ones
+  std::vector<std::vector<Node>> ToVectors() const {
+    std::vector<std::vector<Node>> walks;
+    for (uint64_t i = 0; i < num_walks_; ++i) {
+      if (lengths_[i] > 0) {
+        walks.emplace_back(walk(i), walk(i) + lengths_[i]);
+      }
+    }
+    return walks;
+  }
+
+  /// The walks as a list array of node ids, which are uint32 or uint64 as
+  /// PropertyGraph::Node is. If every walk has full length the buffer
+  /// becomes the values of the array as is; otherwise the walks are packed
+  /// into a new buffer.
+  katana::Result<std::shared_ptr<arrow::LargeListArray>> ToArrow() const {
+    std::shared_ptr<arrow::Buffer> offsets_buffer = KATANA_CHECKED_CONTEXT(
+        arrow::AllocateBuffer((num_walks_ + 1) * sizeof(int64_t)),
+        "allocating walk offsets");
+    auto* offsets = reinterpret_cast<int64_t*>(offsets_buffer->mutable_data());
+
+    katana::GAccumulator<uint64_t> num_short_walks;
+    offsets[0] = 0;
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_walks_),
+        [&](uint64_t i) {
+          offsets[i + 1] = lengths_[i];
+          if (lengths_[i] != stride_) {
+            num_short_walks += 1;
+          }
+        },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        offsets + 1, offsets + num_walks_ + 1, offsets + 1);
+    int64_t num_values = offsets[num_walks_];
+
+    std::shared_ptr<arrow::Buffer> values_buffer = nodes_;
+    if (num_short_walks.reduce() > 0) {
+      values_buffer = KATANA_CHECKED_CONTEXT(
+          arrow::AllocateBuffer(num_values * sizeof(Node)),
+          "allocating packed walks");
+      auto* values = reinterpret_cast<Node*>(values_buffer->mutable_data());
+      katana::do_all(
+          katana::iterate(uint64_t{0}, num_walks_),
+          [&](uint64_t i) {
+            std::copy(walk(i), walk(i) + lengths_[i], values + offsets[i]);
+          },
+          katana::steal(), katana::no_stats());
+    }
+
+    using NodeTraits = arrow::CTypeTraits<Node>;
+    auto values = std::make_shared<NodeTraits::ArrayType>(
+        num_values, values_buffer);
+    return std::make_shared<arrow::LargeListArray>(
+        arrow::large_list(NodeTraits::type_singleton()), num_walks_,
+        offsets_buffer, values);
+  }
+
+private:
+  uint64_t num_walks_;
+  uint32_t stride_;
+  std::shared_ptr<arrow::Buffer> nodes_;
+  katana::NUMAArray<uint32_t> lengths_;
+};
+
+/// Draws an out edge of a node, with probability proportional to its weight
+/// if there are weights and uniformly otherwise.
+///
+/// Weighted draws take constant time with an alias table per node (Walker's
+/// alias method with Vose's construction): a slot i of the node is drawn
+/// uniformly and kept with probability prob_[e] of its edge e, or else
+/// replaced by the slot alias_[e]. Tables are indexed by the edges of the
+/// sorted view that the walks use and are built once for all walks.
+class EdgeSampler {
+public:
+  /// Build the tables from edge_weight_property_name, or leave the draws
+  /// uniform if it is empty
+  katana::Result<void> Init(
+      katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+    if (edge_weight_property_name.empty()) {
+      return katana::ResultSuccess();
+    }
+    switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+                ->type()
+                ->id()) {
+    case arrow::UInt32Type::type_id:
+      return Build<uint32_t>(pg, edge_weight_property_name);
+    case arrow::Int32Type::type_id:
+      return Build<int32_t>(pg, edge_weight_property_name);
+    case arrow::UInt64Type::type_id:
+      return Build<uint64_t>(pg, edge_weight_property_name);
+    case arrow::Int64Type::type_id:
+      return Build<int64_t>(pg, edge_weight_property_name);
+    case arrow::FloatType::type_id:
+      return Build<float>(pg, edge_weight_property_name);
+    case arrow::DoubleType::type_id:
+      return Build<double>(pg, edge_weight_property_name);
+    default:
+      return KATANA_ERROR(
+          katana::ErrorCode::TypeError, "Unsupported type: {}",
+          KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->ToString());
+    }
+  }
+
+  /// The index among its degree out edges of the edge drawn for a node whose
+  /// first edge is first, given prob uniform in [0, 1)
+  uint64_t Sample(uint64_t first, uint64_t degree, double prob) const {
+    double slot = prob * degree;
+    uint64_t i = std::min<uint64_t>(std::floor(slot), degree - 1);
+    if (!weighted_) {
+      return i;
+    }
+    return slot - i < prob_[first + i] ? i : alias_[first + i];
+  }
+
+private:
+  template <typename Weight>
+  katana::Result<void> Build(
+      katana::PropertyGraph* pg, const std::string& edge_weight_property_name) {
+    using EdgeWeight = katana::PODProperty<Weight>;
+    using WeightedGraphView = katana::TypedPropertyGraphView<
+        SortedPropertyGraphView, std::tuple<>, std::tuple<EdgeWeight>>;
+
+    auto graph = KATANA_CHECKED(
+        WeightedGraphView::Make(pg, {}, {edge_weight_property_name}));
+    prob_.allocateInterleaved(graph.num_edges());
+    alias_.allocateInterleaved(graph.num_edges());
+
+    struct Worklists {
+      std::vector<uint32_t> small;
+      std::vector<uint32_t> large;
+    };
+    katana::PerThreadStorage<Worklists> worklists;
+    katana::GReduceLogicalOr negative;
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](typename WeightedGraphView::Node n) {
+          auto edges = graph.edges(n);
+          uint32_t degree = edges.size();
+          if (degree == 0) {
+            return;
+          }
+          uint64_t first = *edges.begin();
+
+          double total = 0;
+          for (uint32_t i = 0; i < degree; ++i) {
+            double weight = graph.template GetEdgeData<EdgeWeight>(first + i);
+            if (!(weight >= 0)) {
+              negative.update(true);
+              return;
+            }
+            total += weight;
+          }
+
+          // Scale the weights to average 1, or make them equal if all are 0
+          auto& small = worklists.getLocal()->small;
+          auto& large = worklists.getLocal()->large;
+          small.clear();
+          large.clear();
+          for (uint32_t i = 0; i < degree; ++i) {
+            double weight = graph.template GetEdgeData<EdgeWeight>(first + i);
+            prob_[first + i] = total > 0 ? weight * degree / total : 1.0;
+            alias_[first + i] = i;
+            (prob_[first + i] < 1 ? small : large).emplace_back(i);
+          }
+
+          // Fill each small slot up to 1 with a large one
+          while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back();
+            small.pop_back();
+            uint32_t l = large.back();
+            alias_[first + s] = l;
+            prob_[first + l] -= 1 - prob_[first + s];
+            if (prob_[first + l] < 1) {
+              large.pop_back();
+              small.emplace_back(l);
+            }
+          }
+          // What is left is 1 up to rounding
+          for (uint32_t i : small) {
+            prob_[first + i] = 1;
+          }
+          for (uint32_t i : large) {
+            prob_[first + i] = 1;
+          }
+        },
+        katana::steal(), katana::no_stats(),
+        katana::loopname("BuildAliasTables"));
+
+    if (negative.reduce()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge weights in {} must be non-negative", edge_weight_property_name);
+    }
+    weighted_ = true;
+    return katana::ResultSuccess();
+  }
+
+  bool weighted_{false};
+  katana::NUMAArray<float> prob_;
+  katana::NUMAArray<uint32_t> alias_;
+};
 
 struct Node2VecAlgo {
   using NodeData = std::tuple<>;
@@ -38,25 +291,25 @@ struct Node2VecAlgo {
   using GNode = typename SortedGraphView::Node;
 
   const RandomWalksPlan& plan_;
-  Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
+  Node2VecAlgo(const RandomWalksPlan& plan, DeadEnds) : plan_(plan) {}
+
+  /// Rounds of walks generated
+  static uint32_t NumRounds(const RandomWalksPlan&) { return 1; }
 
   GNode FindSampleNeighbor(
-      const SortedGraphView& graph, const GNode& n,
+      const SortedGraphView& graph, const EdgeSampler& sampler, const GNode& n,
       const katana::NUMAArray<uint64_t>& degree, const double prob) {
     if (degree[n] == 0) {
       return graph.num_nodes();
     }
-    double total_wt = degree[n];
-
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto ei = graph.edges(n).begin() + edge_index;
+    auto first = graph.edges(n).begin();
+    auto ei = first + sampler.Sample(*first, degree[n], prob);
     return graph.edge_dest(*ei);
   }
 
   void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
+      const SortedGraphView& graph, const EdgeSampler& sampler,
+      WalkBuffer* walks, const katana::NUMAArray<uint64_t>& degree) {
     katana::PerThreadStorage<std::mt19937> generator;
     katana::PerThreadStorage<std::uniform_real_distribution<double>*>
         distribution;
@@ -88,28 +341,30 @@ struct Node2VecAlgo {
 
           //check if n has no neighbor
           if (degree[n] == 0) {
+            walks->set_length(idx, 0);
             return;
           }
 
           std::uniform_real_distribution<double>* dist =
               *distribution.getLocal();
 
-          std::vector<uint32_t> walk;
-          walk.push_back(n);
+          GNode* walk = walks->walk(idx);
+          uint32_t length = 0;
+          walk[length++] = n;
 
           //random value between 0 and 1
           double prob = (*dist)(*generator.getLocal());
 
-          //Assumption: All edges have weight 1
-          auto nbr = FindSampleNeighbor(graph, n, degree, prob);
+          //First order step, in proportion to the edge weights
+          auto nbr = FindSampleNeighbor(graph, sampler, n, degree, prob);
           KATANA_LOG_ASSERT(nbr < graph.num_nodes());
 
-          walk.push_back(std::move(nbr));
+          walk[length++] = nbr;
 
           for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
                current_walk++) {
-            uint32_t curr = walk[current_walk - 1];
-            uint32_t prev = walk[current_walk - 2];
+            GNode curr = walk[length - 1];
+            GNode prev = walk[length - 2];
 
             //check if n has no neighbor
             if (degree[curr] == 0) {
@@ -120,7 +375,7 @@ struct Node2VecAlgo {
               //sample x
               double prob = (*dist)(*generator.getLocal());
 
-              auto nbr = FindSampleNeighbor(graph, curr, degree, prob);
+              auto nbr = FindSampleNeighbor(graph, sampler, curr, degree, prob);
               KATANA_LOG_ASSERT(nbr < graph.num_nodes());
 
               //sample y
@@ -129,7 +384,7 @@ struct Node2VecAlgo {
 
               if (y <= lower_bound) {
                 //accept this sample
-                walk.push_back(std::move(nbr));
+                walk[length++] = nbr;
                 break;
               } else {
                 //compute transition probability
@@ -147,14 +402,14 @@ struct Node2VecAlgo {
 
                 if (y <= alpha) {
                   //accept y
-                  walk.push_back(std::move(nbr));
+                  walk[length++] = nbr;
                   break;
                 }
               }
             }
           }
 
-          walks->push(std::move(walk));
+          walks->set_length(idx, length);
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
         katana::loopname("Node2vec walks"), katana::no_stats());
@@ -165,10 +420,9 @@ struct Node2VecAlgo {
   }
 
   void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    GraphRandomWalk(graph, walks, degree);
+      const SortedGraphView& graph, const EdgeSampler& sampler,
+      WalkBuffer* walks, const katana::NUMAArray<uint64_t>& degree) {
+    GraphRandomWalk(graph, sampler, walks, degree);
   }
 };
 
@@ -183,7 +437,14 @@ struct Edge2VecAlgo {
   using GNode = typename SortedGraphView::Node;
 
   const RandomWalksPlan& plan_;
-  Edge2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
+  const DeadEnds dead_ends_;
+  Edge2VecAlgo(const RandomWalksPlan& plan, DeadEnds dead_ends)
+      : plan_(plan), dead_ends_(dead_ends) {}
+
+  /// Rounds of walks generated, one per iteration
+  static uint32_t NumRounds(const RandomWalksPlan& plan) {
+    return plan.max_iterations();
+  }
 
   //transition matrix
   std::vector<std::vector<double>> transition_matrix_;
@@ -199,23 +460,23 @@ struct Edge2VecAlgo {
   }
 
   std::pair<GNode, EdgeType::ViewType::value_type> FindSampleNeighbor(
-      const SortedGraphView& graph, const GNode& n,
+      const SortedGraphView& graph, const EdgeSampler& sampler, const GNode& n,
       const katana::NUMAArray<uint64_t>& degree, const double prob) {
     if (degree[n] == 0) {
       return std::make_pair(graph.num_nodes(), 1);
     }
-    double total_wt = degree[n];
-
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto ei = graph.edges(n).begin() + edge_index;
+    auto first = graph.edges(n).begin();
+    auto ei = first + sampler.Sample(*first, degree[n], prob);
     return std::make_pair(
         graph.edge_dest(*ei), graph.GetEdgeData<EdgeType>(*ei));
   }
 
+  /// Generate the walks from first_walk on, and the types of their edges in
+  /// types, walk_length() entries per walk
   void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      katana::InsertBag<std::vector<uint32_t>>* types_walks,
+      const SortedGraphView& graph, const EdgeSampler& sampler,
+      WalkBuffer* walks, uint64_t first_walk,
+      katana::NUMAArray<uint32_t>* types,
       const katana::NUMAArray<uint64_t>& degree) {
     katana::PerThreadStorage<std::mt19937> generator;
     katana::PerThreadStorage<std::uniform_real_distribution<double>*>
@@ -243,37 +504,42 @@ struct Edge2VecAlgo {
 
           //check if n has no neighbor
           if (degree[n] == 0) {
+            walks->set_length(first_walk + idx, 0);
             return;
           }
 
           std::uniform_real_distribution<double>* dist =
               *distribution.getLocal();
 
-          std::vector<uint32_t> walk;
-          std::vector<uint32_t> types_vec;
+          GNode* walk = walks->walk(first_walk + idx);
+          uint32_t* walk_types = &(*types)[idx * plan_.walk_length()];
+          uint32_t length = 0;
 
-          walk.push_back(n);
+          walk[length++] = n;
 
           //random value between 0 and 1
           double prob = (*dist)(*generator.getLocal());
 
-          //Assumption: All edges have weight 1
-          auto nbr_pair = FindSampleNeighbor(graph, n, degree, prob);
+          //First order step, in proportion to the edge weights
+          auto nbr_pair = FindSampleNeighbor(graph, sampler, n, degree, prob);
           KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
 
-          walk.push_back(std::move(nbr_pair.first));
-          types_vec.push_back(nbr_pair.second);
+          walk_types[length - 1] = nbr_pair.second;
+          walk[length++] = nbr_pair.first;
 
           for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
                current_walk++) {
-            uint32_t curr = walk[walk.size() - 1];
+            GNode curr = walk[length - 1];
             //check if n has no neighbor
             if (degree[curr] == 0) {
-              return;
+              if (dead_ends_ == DeadEnds::kDrop) {
+                length = 0;
+              }
+              break;
             }
-            uint32_t prev = walk[walk.size() - 2];
+            GNode prev = walk[length - 2];
 
-            uint32_t p1 = types_vec.back();  //last element of types_vec
+            uint32_t p1 = walk_types[length - 2];  //type of the last edge
 
             //acceptance-rejection sampling
             while (true) {
@@ -281,8 +547,8 @@ struct Edge2VecAlgo {
               double prob = (*dist)(*generator.getLocal());
 
               auto nbr_type_pair =
-                  FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr_pair.first < graph.num_nodes());
+                  FindSampleNeighbor(graph, sampler, curr, degree, prob);
+              KATANA_LOG_ASSERT(nbr_type_pair.first < graph.num_nodes());
 
               GNode nbr = nbr_type_pair.first;
               EdgeType::ViewType::value_type p2 = nbr_type_pair.second;
@@ -307,36 +573,42 @@ struct Edge2VecAlgo {
               alpha = alpha * transition_matrix_[p1][p2];
               if (alpha >= y) {
                 //accept y
-                walk.push_back(std::move(nbr));
-                types_vec.push_back(p2);
+                walk_types[length - 1] = p2;
+                walk[length++] = nbr;
                 break;
               }
             }  //end while
 
           }  //end for
 
-          (*walks).push(std::move(walk));
-          (*types_walks).push(std::move(types_vec));
+          walks->set_length(first_walk + idx, length);
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
         katana::loopname("Edge2vec walks"), katana::no_stats());
   }
 
-  //compute the histogram of edge types for each walk
+  //compute the histogram of edge types for each walk that has full length;
+  //walks that reached a node without edges are left out even if truncated
   std::vector<std::vector<uint32_t>> ComputeNumEdgeTypeVectors(
-      const katana::InsertBag<std::vector<uint32_t>>& types_walks) {
+      const WalkBuffer& walks, uint64_t first_walk, uint64_t num_walks,
+      const katana::NUMAArray<uint32_t>& types) {
     std::vector<std::vector<uint32_t>> num_edge_types_walks;
 
     katana::PerThreadStorage<std::vector<std::vector<uint32_t>>>
         per_thread_num_edge_types_walks;
     katana::do_all(
-        katana::iterate(types_walks),
-        [&](const std::vector<uint32_t>& types_walk) {
+        katana::iterate(uint64_t(0), num_walks),
+        [&](uint64_t idx) {
+          uint32_t length = walks.length(first_walk + idx);
+          if (length != walks.stride()) {
+            return;
+          }
           std::vector<uint32_t> num_edge_types(
               plan_.number_of_edge_types() + 1, 0);
 
-          for (auto type : types_walk) {
-            num_edge_types[type]++;
+          const uint32_t* walk_types = &types[idx * plan_.walk_length()];
+          for (uint32_t i = 0; i + 1 < length; i++) {
+            num_edge_types[walk_types[i]]++;
           }
 
           per_thread_num_edge_types_walks.getLocal()->emplace_back(
@@ -439,22 +711,24 @@ struct Edge2VecAlgo {
   }
 
   void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
+      const SortedGraphView& graph, const EdgeSampler& sampler,
+      WalkBuffer* walks, const katana::NUMAArray<uint64_t>& degree) {
     uint32_t iterations = plan_.max_iterations();
+    uint64_t total_walks = graph.size() * plan_.number_of_walks();
 
     Initialize();
 
+    katana::NUMAArray<uint32_t> types;
+    types.allocateInterleaved(total_walks * plan_.walk_length());
+
     for (uint32_t iter = 0; iter < iterations; iter++) {
       //E step; generate walks
-      katana::InsertBag<std::vector<uint32_t>> types_walks;
-
-      GraphRandomWalk(graph, walks, &types_walks, degree);
+      uint64_t first_walk = iter * total_walks;
+      GraphRandomWalk(graph, sampler, walks, first_walk, &types, degree);
 
       //Update transition matrix
       std::vector<std::vector<uint32_t>> num_edge_types_walks =
-          ComputeNumEdgeTypeVectors(types_walks);
+          ComputeNumEdgeTypeVectors(*walks, first_walk, total_walks, types);
 
       std::vector<std::vector<uint32_t>> transformed_num_edge_types_walks =
           TransformVectors(num_edge_types_walks);
@@ -480,48 +754,77 @@ InitializeDegrees(const Graph& graph, katana::NUMAArray<uint64_t>* degree) {
 }  //namespace
 
 template <typename Algorithm>
-static katana::Result<std::vector<std::vector<uint32_t>>>
+static katana::Result<std::unique_ptr<WalkBuffer>>
 RandomWalksWithWrap(
-    const typename Algorithm::SortedGraphView& graph, RandomWalksPlan plan) {
+    const typename Algorithm::SortedGraphView& graph,
+    const EdgeSampler& sampler, RandomWalksPlan plan, DeadEnds dead_ends) {
   katana::ReportPageAllocGuard page_alloc;
 
-  Algorithm algo(plan);
+  Algorithm algo(plan, dead_ends);
 
   katana::NUMAArray<uint64_t> degree;
   degree.allocateBlocked(graph.size());
   InitializeDegrees(graph, &degree);
 
+  auto walks = std::make_unique<WalkBuffer>(
+      graph.size() * plan.number_of_walks() * Algorithm::NumRounds(plan),
+      plan.walk_length());
+  KATANA_CHECKED(walks->Allocate());
+
   katana::StatTimer execTime("RandomWalks");
   execTime.start();
-  katana::InsertBag<std::vector<uint32_t>> walks;
-  algo(graph, &walks, degree);
+  algo(graph, sampler, walks.get(), degree);
   execTime.stop();
 
-  std::vector<std::vector<uint32_t>> walks_in_vector;
-  walks_in_vector.reserve(plan.number_of_walks());
-  std::move(walks.begin(), walks.end(), std::back_inserter(walks_in_vector));
-  return walks_in_vector;
+  return walks;
 }
 
-katana::Result<std::vector<std::vector<uint32_t>>>
-katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
+static katana::Result<std::unique_ptr<WalkBuffer>>
+ComputeRandomWalks(
+    katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
+    RandomWalksPlan plan, DeadEnds dead_ends) {
+  if (plan.walk_length() == 0) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "walk length must be positive");
+  }
+
+  EdgeSampler sampler;
+  KATANA_CHECKED(sampler.Init(pg, edge_weight_property_name));
+
   switch (plan.algorithm()) {
   case RandomWalksPlan::kNode2Vec: {
     auto graph =
         KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
-    return RandomWalksWithWrap<Node2VecAlgo>(graph, plan);
+    return RandomWalksWithWrap<Node2VecAlgo>(graph, sampler, plan, dead_ends);
   }
   case RandomWalksPlan::kEdge2Vec: {
-    TemporaryPropertyGuard tmp_edge_prop{pg->NodeMutablePropertyView()};
+    katana::analytics::TemporaryPropertyGuard tmp_edge_prop{
+        pg->NodeMutablePropertyView()};
     auto graph = KATANA_CHECKED(
         Edge2VecAlgo::SortedGraphView::Make(pg, {}, {tmp_edge_prop.name()}));
-    return RandomWalksWithWrap<Edge2VecAlgo>(graph, plan);
+    return RandomWalksWithWrap<Edge2VecAlgo>(graph, sampler, plan, dead_ends);
   }
   default:
-    return ErrorCode::InvalidArgument;
+    return katana::ErrorCode::InvalidArgument;
   }
 }
 
+katana::Result<std::vector<std::vector<katana::PropertyGraph::Node>>>
+katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
+  auto walks =
+      KATANA_CHECKED(ComputeRandomWalks(pg, "", plan, DeadEnds::kDrop));
+  return walks->ToVectors();
+}
+
+katana::Result<std::shared_ptr<arrow::LargeListArray>>
+katana::analytics::RandomWalksAsArrow(
+    PropertyGraph* pg, const std::string& edge_weight_property_name,
+    RandomWalksPlan plan) {
+  auto walks = KATANA_CHECKED(ComputeRandomWalks(
+      pg, edge_weight_property_name, plan, DeadEnds::kTruncate));
+  return walks->ToArrow();
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::RandomWalksAssertValid([
@@ -19,6 +19,11 @@
 
 #include "katana/analytics/sssp/sssp.h"
 
+#include <limits>
+#include <vector>
+
+#include <arrow/api.h>
+
 #include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
@@ -579,6 +584,309 @@ katana::analytics::Sssp(
 
 namespace {
 
+template <typename Weight>
+using SsspWeightGraph = katana::TypedPropertyGraph<
+    std::tuple<>, std::tuple<SsspEdgeWeight<Weight>>>;
+
+/// A pending update of the path length from sources[column] to node
+template <typename Weight>
+struct MultiSourceUpdateRequest {
+  katana::PropertyGraph::Node node;
+  uint32_t column;
+  Weight dist;
+};
+
+template <typename Weight, typename OBIMTy>
+void
+MultiSourceDeltaStepAlgo(
+    SsspWeightGraph<Weight>* graph,
+    const std::vector<katana::PropertyGraph::Node>& sources,
+    katana::NUMAArray<std::atomic<Weight>>* node_data, unsigned step_shift) {
+  using Impl = SsspImplementation<Weight>;
+  using Request = MultiSourceUpdateRequest<Weight>;
+  uint64_t num_columns = sources.size();
+
+  katana::InsertBag<Request> init_bag;
+  for (uint32_t i = 0; i < sources.size(); ++i) {
+    (*node_data)[sources[i] * num_columns + i] = 0;
+    init_bag.push(Request{sources[i], i, 0});
+  }
+
+  katana::for_each(
+      katana::iterate(init_bag),
+      [&](const Request& item, auto& ctx) {
+        Weight sdist = (*node_data)[item.node * num_columns + item.column];
+        if (sdist < item.dist) {
+          return;
+        }
+
+        for (auto ii : graph->edges(item.node)) {
+          auto dest = *graph->GetEdgeDest(ii);
+          auto& ddist = (*node_data)[dest * num_columns + item.column];
+          Weight new_dist =
+              sdist +
+              graph->template GetEdgeData<SsspEdgeWeight<Weight>>(ii);
+          Weight old_dist = katana::atomicMin(ddist, new_dist);
+          if (new_dist < old_dist) {
+            ctx.push(Request{dest, item.column, new_dist});
+          }
+        }
+      },
+      katana::wl<OBIMTy>(typename Impl::UpdateRequestIndexer{step_shift}),
+      katana::disable_conflict_detection(),
+      katana::loopname("MultiSourceSssp"));
+}
+
+template <typename Weight>
+katana::Result<void>
+MultiSourceSsspWithWrap(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, SsspPlan plan) {
+  using Impl = SsspImplementation<Weight>;
+  using ArrowType = typename arrow::CTypeTraits<Weight>::ArrowType;
+
+  auto graph = KATANA_CHECKED(
+      SsspWeightGraph<Weight>::Make(pg, {}, {edge_weight_property_name}));
+
+  uint64_t num_columns = sources.size();
+  uint64_t num_values = graph.size() * num_columns;
+  katana::NUMAArray<std::atomic<Weight>> node_data;
+  node_data.allocateInterleaved(num_values);
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_values),
+      [&](uint64_t i) { node_data[i] = Impl::kDistanceInfinity; },
+      katana::no_stats());
+
+  katana::StatTimer exec_time("MultiSourceSssp");
+  exec_time.start();
+  switch (plan.algorithm()) {
+  case SsspPlan::kDeltaStep:
+    MultiSourceDeltaStepAlgo<Weight, typename Impl::OBIM>(
+        &graph, sources, &node_data, plan.delta());
+    break;
+  case SsspPlan::kDeltaStepBarrier:
+    MultiSourceDeltaStepAlgo<Weight, typename Impl::OBIMBarrier>(
+        &graph, sources, &node_data, plan.delta());
+    break;
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "Unsupported algorithm: {}",
+        plan.algorithm());
+  }
+  exec_time.stop();
+
+  std::shared_ptr<arrow::Buffer> buffer = KATANA_CHECKED_CONTEXT(
+      arrow::AllocateBuffer(num_values * sizeof(Weight)),
+      "allocating path lengths");
+  auto* values = reinterpret_cast<Weight*>(buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_values),
+      [&](uint64_t i) { values[i] = node_data[i].load(); }, katana::no_stats());
+
+  auto lengths =
+      std::make_shared<arrow::NumericArray<ArrowType>>(num_values, buffer);
+  std::shared_ptr<arrow::Array> column = KATANA_CHECKED_CONTEXT(
+      arrow::FixedSizeListArray::FromArrays(lengths, num_columns),
+      "building path length lists");
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, column->type())}),
+      {column});
+  return pg->AddNodeProperties(table);
+}
+
+template <typename Weight>
+katana::Result<void>
+IncrementalSsspWithWrap(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& srcs,
+    const std::vector<katana::PropertyGraph::Node>& dests,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, SsspPlan plan) {
+  using Impl = SsspImplementation<Weight>;
+  using NodeDistance = typename Impl::NodeDistance;
+  using EdgeWeight = typename Impl::EdgeWeight;
+  using UpdateRequest = typename Impl::UpdateRequest;
+
+  auto graph = KATANA_CHECKED(Impl::Graph::Make(
+      pg, {output_property_name}, {edge_weight_property_name}));
+
+  katana::StatTimer exec_time("IncrementalSssp");
+  exec_time.start();
+
+  // Relax the changed edges; the nodes they improve seed the repair
+  katana::InsertBag<UpdateRequest> init_bag;
+  katana::do_all(
+      katana::iterate(size_t{0}, srcs.size()),
+      [&](size_t i) {
+        Weight sdist = graph.template GetData<NodeDistance>(srcs[i]);
+        if (sdist >= Impl::kDistanceInfinity) {
+          return;
+        }
+        for (auto ii : graph.edges(srcs[i])) {
+          if (*graph.GetEdgeDest(ii) != dests[i]) {
+            continue;
+          }
+          auto& ddist = graph.template GetData<NodeDistance>(dests[i]);
+          Weight new_dist = sdist + graph.template GetEdgeData<EdgeWeight>(ii);
+          if (new_dist < katana::atomicMin(ddist, new_dist)) {
+            init_bag.push(UpdateRequest(dests[i], new_dist));
+          }
+        }
+      },
+      katana::no_stats());
+
+  katana::GAccumulator<uint64_t> num_updates;
+  katana::for_each(
+      katana::iterate(init_bag),
+      [&](const UpdateRequest& item, auto& ctx) {
+        Weight sdist = graph.template GetData<NodeDistance>(item.src);
+        if (sdist < item.dist) {
+          return;
+        }
+        num_updates += 1;
+
+        for (auto ii : graph.edges(item.src)) {
+          auto dest = graph.GetEdgeDest(ii);
+          auto& ddist = graph.template GetData<NodeDistance>(dest);
+          Weight new_dist = sdist + graph.template GetEdgeData<EdgeWeight>(ii);
+          if (new_dist < katana::atomicMin(ddist, new_dist)) {
+            ctx.push(UpdateRequest(*dest, new_dist));
+          }
+        }
+      },
+      katana::wl<typename Impl::OBIM>(typename Impl::UpdateRequestIndexer{
+          plan.delta() > 0 ? plan.delta() : SsspPlan::kDefaultDelta}),
+      katana::disable_conflict_detection(),
+      katana::loopname("IncrementalSssp"));
+
+  exec_time.stop();
+  katana::ReportStatSingle(
+      "IncrementalSssp", "UpdatedNodes", num_updates.reduce());
+
+  return katana::ResultSuccess();
+}
+
+/// Check the nodes given to MultiSourceSssp or IncrementalSssp and resolve a
+/// kAutomatic plan
+katana::Result<void>
+CheckNodesAndPlan(
+    katana::PropertyGraph* pg,
+    const std::vector<katana::PropertyGraph::Node>& nodes, SsspPlan* plan) {
+  for (auto node : nodes) {
+    if (node >= pg->num_nodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "node {} out of range: graph has {} nodes", node, pg->num_nodes());
+    }
+  }
+  if (plan->algorithm() == SsspPlan::kAutomatic) {
+    *plan = SsspPlan(pg);
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MultiSourceSssp(
+    PropertyGraph* pg, const std::vector<PropertyGraph::Node>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, SsspPlan plan) {
+  if (sources.empty()) {
+    return KATANA_ERROR(katana::ErrorCode::InvalidArgument, "no sources");
+  }
+  if (sources.size() > std::numeric_limits<int32_t>::max()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "too many sources: {}",
+        sources.size());
+  }
+  KATANA_CHECKED(CheckNodesAndPlan(pg, sources, &plan));
+
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return MultiSourceSsspWithWrap<uint32_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int32Type::type_id:
+    return MultiSourceSsspWithWrap<int32_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  case arrow::UInt64Type::type_id:
+    return MultiSourceSsspWithWrap<uint64_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  case arrow::Int64Type::type_id:
+    return MultiSourceSsspWithWrap<int64_t>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  case arrow::FloatType::type_id:
+    return MultiSourceSsspWithWrap<float>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  case arrow::DoubleType::type_id:
+    return MultiSourceSsspWithWrap<double>(
+        pg, sources, edge_weight_property_name, output_property_name, plan);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+katana::Result<void>
+katana::analytics::IncrementalSssp(
+    PropertyGraph* pg, const std::vector<PropertyGraph::Node>& srcs,
+    const std::vector<PropertyGraph::Node>& dests,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, SsspPlan plan) {
+  if (srcs.size() != dests.size()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "sources and destinations differ in length: {} != {}", srcs.size(),
+        dests.size());
+  }
+  KATANA_CHECKED(CheckNodesAndPlan(pg, srcs, &plan));
+  KATANA_CHECKED(CheckNodesAndPlan(pg, dests, &plan));
+
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return IncrementalSsspWithWrap<uint32_t>(
+        pg, srcs, dests, edge_weight_property_name, output_property_name,
+        plan);
+  case arrow::Int32Type::type_id:
+    return IncrementalSsspWithWrap<int32_t>(
+        pg, srcs, dests, edge_weight_property_name, output_property_name,
+        plan);
+  case arrow::UInt64Type::type_id:
+    return IncrementalSsspWithWrap<uint64_t>(
+        pg, srcs, dests, edge_weight_property_name, output_property_name,
+        plan);
+  case arrow::Int64Type::type_id:
+    return IncrementalSsspWithWrap<int64_t>(
+        pg, srcs, dests, edge_weight_property_name, output_property_name,
+        plan);
+  case arrow::FloatType::type_id:
+    return IncrementalSsspWithWrap<float>(
+        pg, srcs, dests, edge_weight_property_name, output_property_name,
+        plan);
+  case arrow::DoubleType::type_id:
+    return IncrementalSsspWithWrap<double>(
+        pg, srcs, dests, edge_weight_property_name, output_property_name,
+        plan);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+namespace {
+
 template <typename Weight>
 static katana::Result<void>
 SsspValidateImpl(
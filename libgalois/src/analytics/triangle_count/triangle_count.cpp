@@ -19,6 +19,7 @@
 
 #include "katana/analytics/triangle_count/triangle_count.h"
 
+#include "katana/SetIntersection.h"
 #include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
@@ -26,80 +27,44 @@ using namespace katana::analytics;
 using SortedGraphView =
     katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
 using Node = SortedGraphView::Node;
-using edge_iterator = SortedGraphView::edge_iterator;
 
 constexpr static const unsigned kChunkSize = 16U;
 
-/**
- * Like std::lower_bound but doesn't dereference iterators. Returns the first
- * element for which comp is not true.
- */
-template <typename Iterator, typename Compare>
-Iterator
-LowerBound(Iterator first, Iterator last, Compare comp) {
-  using difference_type =
-      typename std::iterator_traits<Iterator>::difference_type;
-
-  Iterator it;
-  difference_type count;
-  difference_type half;
-
-  count = std::distance(first, last);
-  while (count > 0) {
-    it = first;
-    half = count / 2;
-    std::advance(it, half);
-    if (comp(it)) {
-      first = ++it;
-      count -= half + 1;
-    } else {
-      count = half;
-    }
-  }
-  return first;
-}
+/// Nodes with at least this many neighbors to intersect with are hubs: their
+/// neighbors are put in a bitmap that the neighbors of other nodes probe,
+/// rather than intersected with each of them
+constexpr static const size_t kHubDegree = 1024;
 
-/**
- * std::set_intersection over edge_iterators.
- */
-template <typename G>
-size_t
-CountEqual(
-    const G& g, typename G::edge_iterator aa, typename G::edge_iterator ea,
-    typename G::edge_iterator bb, typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::Node a = g.edge_dest(*aa);
-    typename G::Node b = g.edge_dest(*bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
-  }
-  return retval;
-}
+/// The sorted neighbors of a node
+struct Neighbors {
+  const Node* begin;
+  const Node* end;
 
-template <typename G>
-struct LessThan {
-  const G& g;
-  typename G::Node n;
-  LessThan(const G& g, typename G::Node n) : g(g), n(n) {}
-  bool operator()(typename G::edge_iterator it) { return g.edge_dest(*it) < n; }
+  size_t size() const { return end - begin; }
 };
 
-template <typename G>
-struct GreaterThanOrEqual {
-  const G& g;
-  typename G::Node n;
-  GreaterThanOrEqual(const G& g, typename G::Node n) : g(g), n(n) {}
-  bool operator()(typename G::edge_iterator it) {
-    return n >= g.edge_dest(*it);
+Neighbors
+GetNeighbors(const SortedGraphView& graph, Node n) {
+  const Node* begin = graph.sorted_dests(n);
+  return Neighbors{begin, begin + graph.degree(n)};
+}
+
+/// A bitmap for each thread, sized on first use
+class HubBitmaps {
+public:
+  explicit HubBitmaps(size_t num_nodes) : num_nodes_(num_nodes) {}
+
+  katana::SetBitmap* Get() {
+    katana::SetBitmap* bitmap = bitmaps_.getLocal();
+    if (bitmap->universe() < num_nodes_) {
+      bitmap->resize(num_nodes_);
+    }
+    return bitmap;
   }
+
+private:
+  size_t num_nodes_;
+  katana::PerThreadStorage<katana::SetBitmap> bitmaps_;
 };
 
 /**
@@ -117,31 +82,39 @@ struct GreaterThanOrEqual {
 size_t
 NodeIteratingAlgo(const SortedGraphView* graph) {
   katana::GAccumulator<size_t> numTriangles;
+  HubBitmaps hub_bitmaps(graph->num_nodes());
 
   katana::do_all(
       katana::iterate(*graph),
       [&](const Node& n) {
         // Partition neighbors
-        // [first, ea) [n] [bb, last)
-        edge_iterator first = graph->edges(n).begin();
-        edge_iterator last = graph->edges(n).end();
-        edge_iterator ea =
-            LowerBound(first, last, LessThan<SortedGraphView>(*graph, n));
-        edge_iterator bb = LowerBound(
-            first, last, GreaterThanOrEqual<SortedGraphView>(*graph, n));
-
-        for (; bb != last; ++bb) {
-          Node B = graph->edge_dest(*bb);
-          for (auto aa = first; aa != ea; ++aa) {
-            Node A = graph->edge_dest(*aa);
-            edge_iterator vv = graph->edges(A).begin();
-            edge_iterator ev = graph->edges(A).end();
-            edge_iterator it =
-                LowerBound(vv, ev, LessThan<SortedGraphView>(*graph, B));
-            if (it != ev && graph->edge_dest(*it) == B) {
-              numTriangles += 1;
-            }
+        // [low.begin, low.end) [n] [high.begin, high.end)
+        Neighbors neighbors = GetNeighbors(*graph, n);
+        Neighbors low{
+            neighbors.begin,
+            std::lower_bound(neighbors.begin, neighbors.end, n)};
+        Neighbors high{
+            std::upper_bound(low.end, neighbors.end, n), neighbors.end};
+
+        // Count the pairs (A, B) of low and high neighbors that are
+        // connected. A bitmap of a hub's high neighbors pays off once it is
+        // probed more than once.
+        if (high.size() >= kHubDegree && low.size() > 1) {
+          katana::SetBitmap* bitmap = hub_bitmaps.Get();
+          bitmap->Insert(high.begin, high.size());
+          for (const Node* A = low.begin; A != low.end; ++A) {
+            Neighbors a_neighbors = GetNeighbors(*graph, *A);
+            numTriangles +=
+                bitmap->Count(a_neighbors.begin, a_neighbors.size());
           }
+          bitmap->Erase(high.begin, high.size());
+          return;
+        }
+
+        for (const Node* A = low.begin; A != low.end; ++A) {
+          Neighbors a_neighbors = GetNeighbors(*graph, *A);
+          numTriangles += katana::IntersectCount(
+              a_neighbors.begin, a_neighbors.size(), high.begin, high.size());
         }
       },
       katana::chunk_size<kChunkSize>(), katana::steal(),
@@ -155,29 +128,37 @@ NodeIteratingAlgo(const SortedGraphView* graph) {
  */
 void
 OrderedCountFunc(
-    const SortedGraphView* graph, Node n,
+    const SortedGraphView* graph, Node n, HubBitmaps* hub_bitmaps,
     katana::GAccumulator<size_t>& numTriangles) {
   size_t numTriangles_local = 0;
-  for (auto edges_n : graph->edges(n)) {
-    Node v = graph->edge_dest(edges_n);
-    if (v > n) {
-      break;
-    }
-    edge_iterator it_n = graph->edges(n).begin();
-
-    for (auto edges_v : graph->edges(v)) {
-      auto dst_v = graph->edge_dest(edges_v);
-      if (dst_v > v) {
-        break;
-      }
-      while (graph->edge_dest(*it_n) < dst_v) {
-        it_n++;
-      }
-      if (dst_v == graph->edge_dest(*it_n)) {
-        numTriangles_local += 1;
-      }
+  Neighbors neighbors = GetNeighbors(*graph, n);
+  // Triangles (n, v, w) with w <= v <= n
+  Neighbors low{
+      neighbors.begin, std::upper_bound(neighbors.begin, neighbors.end, n)};
+
+  katana::SetBitmap* bitmap = nullptr;
+  if (low.size() >= kHubDegree) {
+    bitmap = hub_bitmaps->Get();
+    bitmap->Insert(low.begin, low.size());
+  }
+
+  for (const Node* v = low.begin; v != low.end; ++v) {
+    Neighbors v_neighbors = GetNeighbors(*graph, *v);
+    Neighbors v_low{
+        v_neighbors.begin,
+        std::upper_bound(v_neighbors.begin, v_neighbors.end, *v)};
+    if (bitmap) {
+      numTriangles_local += bitmap->Count(v_low.begin, v_low.size());
+    } else {
+      numTriangles_local += katana::IntersectCount(
+          v_low.begin, v_low.size(), low.begin,
+          std::upper_bound(v, low.end, *v) - low.begin);
     }
   }
+
+  if (bitmap) {
+    bitmap->Erase(low.begin, low.size());
+  }
   numTriangles += numTriangles_local;
 }
 
@@ -187,9 +168,12 @@ OrderedCountFunc(
 size_t
 OrderedCountAlgo(const SortedGraphView* graph) {
   katana::GAccumulator<size_t> numTriangles;
+  HubBitmaps hub_bitmaps(graph->num_nodes());
   katana::do_all(
       katana::iterate(*graph),
-      [&](const Node& n) { OrderedCountFunc(graph, n, numTriangles); },
+      [&](const Node& n) {
+        OrderedCountFunc(graph, n, &hub_bitmaps, numTriangles);
+      },
       katana::chunk_size<kChunkSize>(), katana::steal(),
       katana::loopname("TriangleCount_OrderedCountAlgo"));
 
@@ -237,21 +221,17 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
       [&](const WorkItem& w) {
         // Compute intersection of range (w.src, w.dst) in neighbors of
         // w.src and w.dst
-        edge_iterator abegin = graph->edges(w.src).begin();
-        edge_iterator aend = graph->edges(w.src).end();
-        edge_iterator bbegin = graph->edges(w.dst).begin();
-        edge_iterator bend = graph->edges(w.dst).end();
-
-        edge_iterator aa = LowerBound(
-            abegin, aend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
-        edge_iterator ea =
-            LowerBound(abegin, aend, LessThan<SortedGraphView>(*graph, w.dst));
-        edge_iterator bb = LowerBound(
-            bbegin, bend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
-        edge_iterator eb =
-            LowerBound(bbegin, bend, LessThan<SortedGraphView>(*graph, w.dst));
-
-        numTriangles += CountEqual(*graph, aa, ea, bb, eb);
+        auto between = [&w](Neighbors neighbors) {
+          const Node* begin =
+              std::upper_bound(neighbors.begin, neighbors.end, w.src);
+          return Neighbors{
+              begin, std::lower_bound(begin, neighbors.end, w.dst)};
+        };
+        Neighbors a = between(GetNeighbors(*graph, w.src));
+        Neighbors b = between(GetNeighbors(*graph, w.dst));
+
+        numTriangles +=
+            katana::IntersectCount(a.begin, a.size(), b.begin, b.size());
       },
       katana::loopname("TriangleCount_EdgeIteratingAlgo"),
       katana::chunk_size<kChunkSize>(), katana::steal());
@@ -0,0 +1,250 @@
+#include "katana/MutablePropertyGraph.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::MutablePropertyGraph::Node;
+
+/// The expected (dest, weight) pairs out of each node
+using Expected = std::vector<std::multimap<Node, uint64_t>>;
+
+constexpr uint64_t kFirstInsertedWeight = 1000000;
+
+std::shared_ptr<arrow::Table>
+WeightTable(std::vector<uint64_t> weights) {
+  return arrow::Table::Make(
+      arrow::schema({arrow::field("weight", arrow::uint64())}),
+      {katana::BuildArray(weights)});
+}
+
+/// A graph whose edges have a weight equal to their id
+std::shared_ptr<katana::PropertyGraph>
+MakeGraph(size_t num_nodes, size_t edges_per_node, Expected* expected) {
+  auto res = katana::PropertyGraph::Make(
+      katana::CreateUniformRandomTopology(num_nodes, edges_per_node));
+  KATANA_LOG_ASSERT(res);
+  std::shared_ptr<katana::PropertyGraph> pg = std::move(res.value());
+
+  katana::ColumnOptions options;
+  options.name = "weight";
+  options.ascending_values = true;
+  katana::TableBuilder builder{pg->num_edges()};
+  builder.AddColumn<uint64_t>(options);
+  if (auto r = pg->AddEdgeProperties(builder.Finish()); !r) {
+    KATANA_LOG_FATAL("could not add edge property: {}", r.error());
+  }
+
+  const katana::GraphTopology& topo = pg->topology();
+  expected->assign(num_nodes, {});
+  for (auto n : topo.all_nodes()) {
+    for (auto e : topo.edges(n)) {
+      (*expected)[n].emplace(topo.edge_dest(e), e);
+    }
+  }
+  return pg;
+}
+
+void
+CheckNeighbors(
+    const katana::MutablePropertyGraph& g, const Expected& expected) {
+  uint64_t num_edges = 0;
+  for (Node n = 0; n < g.num_nodes(); ++n) {
+    std::vector<Node> actual;
+    g.ForEachNeighbor(n, [&](Node dest) { actual.emplace_back(dest); });
+    std::sort(actual.begin(), actual.end());
+
+    std::vector<Node> want;
+    for (const auto& [dest, weight] : expected[n]) {
+      want.emplace_back(dest);
+    }
+    KATANA_LOG_VASSERT(actual == want, "neighbors of {} differ", n);
+    num_edges += want.size();
+  }
+  KATANA_LOG_ASSERT(g.num_edges() == num_edges);
+}
+
+/// Check the edges of a snapshot, including their weights
+void
+CheckSnapshot(const katana::PropertyGraph& pg, const Expected& expected) {
+  std::vector<uint64_t> weights;
+  for (const auto& chunk : pg.GetEdgeProperty(0)->chunks()) {
+    auto array = std::static_pointer_cast<arrow::UInt64Array>(chunk);
+    for (int64_t i = 0; i < array->length(); ++i) {
+      weights.emplace_back(array->Value(i));
+    }
+  }
+  KATANA_LOG_ASSERT(weights.size() == pg.num_edges());
+
+  const katana::GraphTopology& topo = pg.topology();
+  for (auto n : topo.all_nodes()) {
+    std::vector<std::pair<Node, uint64_t>> actual;
+    for (auto e : topo.edges(n)) {
+      actual.emplace_back(topo.edge_dest(e), weights[e]);
+      KATANA_LOG_ASSERT(
+          weights[e] < kFirstInsertedWeight ||
+          pg.GetTypeOfEdge(e) == katana::kUnknownEntityType);
+    }
+    std::sort(actual.begin(), actual.end());
+    std::vector<std::pair<Node, uint64_t>> want(
+        expected[n].begin(), expected[n].end());
+    std::sort(want.begin(), want.end());
+    KATANA_LOG_VASSERT(actual == want, "snapshot edges of {} differ", n);
+  }
+}
+
+class Updater {
+public:
+  Updater(katana::MutablePropertyGraph* g, Expected* expected)
+      : g_(g), expected_(expected) {}
+
+  void Insert(size_t num_edges) {
+    std::vector<Node> srcs;
+    std::vector<Node> dests;
+    std::vector<uint64_t> weights;
+    for (size_t i = 0; i < num_edges; ++i) {
+      Node src = RandomNode();
+      Node dest = RandomNode();
+      srcs.emplace_back(src);
+      dests.emplace_back(dest);
+      weights.emplace_back(next_weight_);
+      (*expected_)[src].emplace(dest, next_weight_++);
+    }
+    auto res = g_->InsertEdges(srcs, dests, WeightTable(weights));
+    KATANA_LOG_VASSERT(res, "insert failed: {}", res.error());
+  }
+
+  /// Delete num_edges existing edges and a few that do not exist
+  void Delete(size_t num_edges) {
+    std::vector<Node> srcs;
+    std::vector<Node> dests;
+    uint64_t want = 0;
+    for (size_t i = 0; i < num_edges; ++i) {
+      Node src = RandomNode();
+      auto& edges = (*expected_)[src];
+      if (edges.empty()) {
+        continue;
+      }
+      auto it = edges.begin();
+      std::advance(
+          it, std::uniform_int_distribution<size_t>(0, edges.size() - 1)(gen_));
+      Node dest = it->first;
+      srcs.emplace_back(src);
+      dests.emplace_back(dest);
+      want += edges.erase(dest);
+    }
+    // Absent edges and repeated pairs delete nothing
+    if (!srcs.empty()) {
+      srcs.emplace_back(srcs.front());
+      dests.emplace_back(dests.front());
+    }
+
+    auto res = g_->DeleteEdges(srcs, dests);
+    KATANA_LOG_VASSERT(res, "delete failed: {}", res.error());
+    KATANA_LOG_ASSERT(res.value() == want);
+  }
+
+private:
+  Node RandomNode() {
+    return std::uniform_int_distribution<Node>(0, g_->num_nodes() - 1)(gen_);
+  }
+
+  katana::MutablePropertyGraph* g_;
+  Expected* expected_;
+  uint64_t next_weight_{kFirstInsertedWeight};
+  std::mt19937 gen_{0};
+};
+
+void
+TestUpdates() {
+  Expected expected;
+  auto pg = MakeGraph(500, 4, &expected);
+  auto res = katana::MutablePropertyGraph::Make(pg);
+  KATANA_LOG_ASSERT(res);
+  std::unique_ptr<katana::MutablePropertyGraph> g = std::move(res.value());
+  Updater updater(g.get(), &expected);
+
+  for (size_t batch = 0; batch < 3; ++batch) {
+    updater.Insert(100);
+    updater.Delete(50);
+  }
+  CheckNeighbors(*g, expected);
+  KATANA_LOG_ASSERT(g->num_delta_blocks() == 3);
+  KATANA_LOG_ASSERT(g->snapshot() == pg);
+
+  for (Node n = 0; n < g->num_nodes(); ++n) {
+    for (Node dest = 0; dest < g->num_nodes(); dest += 7) {
+      KATANA_LOG_ASSERT(g->has_edge(n, dest) == (expected[n].count(dest) > 0));
+    }
+  }
+
+  // Blocks are merged instead of piling up
+  constexpr size_t kNumBatches =
+      2 * katana::MutablePropertyGraph::kMaxDeltaBlocks;
+  for (size_t batch = 0; batch < kNumBatches; ++batch) {
+    updater.Insert(20);
+    updater.Delete(10);
+  }
+  KATANA_LOG_ASSERT(
+      g->num_delta_blocks() <= katana::MutablePropertyGraph::kMaxDeltaBlocks);
+  CheckNeighbors(*g, expected);
+
+  auto snapshot_res = g->Snapshot();
+  KATANA_LOG_ASSERT(snapshot_res);
+  std::shared_ptr<katana::PropertyGraph> snapshot = snapshot_res.value();
+  KATANA_LOG_ASSERT(snapshot != pg);
+  KATANA_LOG_ASSERT(g->num_delta_blocks() == 0);
+  KATANA_LOG_ASSERT(!g->NeedsCompaction());
+  CheckSnapshot(*snapshot, expected);
+  CheckNeighbors(*g, expected);
+
+  // The old snapshot is untouched
+  KATANA_LOG_ASSERT(pg->num_edges() == 500 * 4);
+
+  // Updates continue on the new snapshot
+  updater.Delete(100);
+  updater.Insert(100);
+  CheckNeighbors(*g, expected);
+  KATANA_LOG_ASSERT(g->Compact());
+  CheckSnapshot(*g->snapshot(), expected);
+}
+
+void
+TestInvalidUpdates() {
+  Expected expected;
+  auto res = katana::MutablePropertyGraph::Make(MakeGraph(10, 2, &expected));
+  KATANA_LOG_ASSERT(res);
+  std::unique_ptr<katana::MutablePropertyGraph> g = std::move(res.value());
+
+  KATANA_LOG_ASSERT(!g->InsertEdges({0, 1}, {1}, WeightTable({0})));
+  KATANA_LOG_ASSERT(!g->InsertEdges({0}, {10}, WeightTable({0})));
+  KATANA_LOG_ASSERT(!g->InsertEdges({0}, {1}));
+  KATANA_LOG_ASSERT(!g->InsertEdges({0}, {1}, WeightTable({0, 1})));
+  KATANA_LOG_ASSERT(!g->DeleteEdges({0}, {}));
+  KATANA_LOG_ASSERT(g->num_delta_blocks() == 0);
+  CheckNeighbors(*g, expected);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestUpdates();
+  TestInvalidUpdates();
+
+  return 0;
+}
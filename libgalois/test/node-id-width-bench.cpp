@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/Reduction.h"
+
+// Compare the cost of 32-bit and 64-bit node ids (see KATANA_NODE_ID_64):
+// the memory taken by a CSR topology and the time to traverse it, which is
+// dominated by reading the edge destination array.
+
+namespace {
+
+constexpr uint64_t kDegree = 16;
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long size : {64 * 1024, 1024 * 1024, 4 * 1024 * 1024}) {
+    b->Args({size});
+  }
+}
+
+template <typename Dest>
+struct Csr {
+  katana::NUMAArray<uint64_t> adj_indices;
+  katana::NUMAArray<Dest> dests;
+
+  uint64_t num_bytes() const {
+    return adj_indices.size() * sizeof(uint64_t) + dests.size() * sizeof(Dest);
+  }
+};
+
+/// Make a graph where every node has kDegree uniformly random neighbors
+template <typename Dest>
+Csr<Dest>
+MakeCsr(uint64_t num_nodes) {
+  Csr<Dest> csr;
+  csr.adj_indices.allocateInterleaved(num_nodes);
+  csr.dests.allocateInterleaved(num_nodes * kDegree);
+
+  std::mt19937_64 gen(num_nodes);
+  std::uniform_int_distribution<uint64_t> dist(0, num_nodes - 1);
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    csr.adj_indices[n] = (n + 1) * kDegree;
+    for (uint64_t e = n * kDegree; e < (n + 1) * kDegree; ++e) {
+      csr.dests[e] = dist(gen);
+    }
+  }
+  return csr;
+}
+
+/// Sum the values of the neighbors of every node, the access pattern of a
+/// pull-style traversal
+template <typename Dest>
+uint64_t
+Gather(const Csr<Dest>& csr, const katana::NUMAArray<uint32_t>& values) {
+  katana::GAccumulator<uint64_t> sum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, csr.adj_indices.size()),
+      [&](uint64_t n) {
+        uint64_t begin = n == 0 ? 0 : csr.adj_indices[n - 1];
+        uint64_t end = csr.adj_indices[n];
+        uint64_t local = 0;
+        for (uint64_t e = begin; e < end; ++e) {
+          local += values[csr.dests[e]];
+        }
+        sum += local;
+      },
+      katana::no_stats());
+  return sum.reduce();
+}
+
+template <typename Dest>
+void
+GatherNeighbors(benchmark::State& state) {
+  uint64_t num_nodes = state.range(0);
+  Csr<Dest> csr = MakeCsr<Dest>(num_nodes);
+
+  katana::NUMAArray<uint32_t> values;
+  values.allocateInterleaved(num_nodes);
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    values[n] = 1;
+  }
+
+  for (auto _ : state) {
+    uint64_t sum = Gather(csr, values);
+    KATANA_LOG_VASSERT(
+        sum == num_nodes * kDegree, "{} != {}", sum, num_nodes * kDegree);
+    benchmark::DoNotOptimize(sum);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_nodes * kDegree);
+  state.SetBytesProcessed(state.iterations() * csr.num_bytes());
+  state.counters["topology_bytes"] = csr.num_bytes();
+}
+
+BENCHMARK_TEMPLATE(GatherNeighbors, uint32_t)->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(GatherNeighbors, uint64_t)->Apply(MakeArguments);
+BENCHMARK_TEMPLATE(GatherNeighbors, katana::GraphTopology::Node)
+    ->Apply(MakeArguments);
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
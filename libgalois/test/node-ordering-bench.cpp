@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "katana/Bag.h"
+#include "katana/Galois.h"
+#include "katana/GraphTopology.h"
+#include "katana/Logging.h"
+#include "katana/NUMAArray.h"
+#include "katana/PropertyGraph.h"
+#include "katana/Reduction.h"
+
+// Compare node orderings (see katana/NodeOrdering.h) on traversals whose
+// cost is dominated by reading the data of neighbors: an iteration of
+// PageRank, connected components by label propagation and BFS. Hardware
+// cache counters are not portable, so every benchmark also reports the miss
+// rate of a simulated cache on the neighbor reads of a full traversal.
+
+namespace {
+
+using Node = katana::GraphTopology::Node;
+using NodeSortKind = katana::ShuffleTopology::NodeSortKind;
+
+constexpr uint32_t kScale = 20;
+constexpr uint64_t kEdgesPerNode = 8;
+
+constexpr uint64_t kCacheLineBytes = 64;
+constexpr uint64_t kCacheBytes = 1 << 20;
+constexpr uint64_t kCacheWays = 8;
+
+constexpr uint64_t kInfinity = std::numeric_limits<uint64_t>::max();
+
+const char*
+OrderName(NodeSortKind kind) {
+  switch (kind) {
+  case NodeSortKind::kAny:
+    return "original";
+  case NodeSortKind::kSortedByDegree:
+    return "degree";
+  case NodeSortKind::kReverseCuthillMcKee:
+    return "rcm";
+  case NodeSortKind::kHubSorted:
+    return "hub-sort";
+  case NodeSortKind::kHubClustered:
+    return "hub-cluster";
+  case NodeSortKind::kGorder:
+    return "gorder";
+  case NodeSortKind::kRabbitOrder:
+    return "rabbit";
+  default:
+    return "unknown";
+  }
+}
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (auto kind :
+       {NodeSortKind::kAny, NodeSortKind::kSortedByDegree,
+        NodeSortKind::kReverseCuthillMcKee, NodeSortKind::kHubSorted,
+        NodeSortKind::kHubClustered, NodeSortKind::kGorder,
+        NodeSortKind::kRabbitOrder}) {
+    b->Args({static_cast<long>(kind)});
+  }
+  b->Unit(benchmark::kMillisecond);
+}
+
+/// An undirected RMAT graph whose node ids are shuffled so that, like many
+/// real inputs, its numbering carries no locality
+katana::GraphTopology
+MakeInput() {
+  uint64_t num_nodes = uint64_t{1} << kScale;
+  std::mt19937_64 gen(kScale);
+  std::uniform_real_distribution<double> dist;
+
+  std::vector<Node> relabel(num_nodes);
+  std::iota(relabel.begin(), relabel.end(), Node{0});
+  std::shuffle(relabel.begin(), relabel.end(), gen);
+
+  std::vector<std::pair<Node, Node>> edges;
+  edges.reserve(2 * num_nodes * kEdgesPerNode);
+  for (uint64_t i = 0; i < num_nodes * kEdgesPerNode; ++i) {
+    uint64_t src = 0;
+    uint64_t dst = 0;
+    for (uint32_t bit = 0; bit < kScale; ++bit) {
+      double r = dist(gen);
+      if (r >= 0.57 + 0.19 + 0.19) {
+        src |= uint64_t{1} << bit;
+        dst |= uint64_t{1} << bit;
+      } else if (r >= 0.57 + 0.19) {
+        src |= uint64_t{1} << bit;
+      } else if (r >= 0.57) {
+        dst |= uint64_t{1} << bit;
+      }
+    }
+    if (src != dst) {
+      edges.emplace_back(relabel[src], relabel[dst]);
+      edges.emplace_back(relabel[dst], relabel[src]);
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+
+  katana::NUMAArray<uint64_t> adj_indices;
+  katana::NUMAArray<Node> dests;
+  adj_indices.allocateInterleaved(num_nodes);
+  dests.allocateInterleaved(edges.size());
+  uint64_t e = 0;
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    for (; e < edges.size() && edges[e].first == n; ++e) {
+      dests[e] = edges[e].second;
+    }
+    adj_indices[n] = e;
+  }
+
+  return katana::GraphTopology(std::move(adj_indices), std::move(dests));
+}
+
+katana::PropertyGraph&
+Input() {
+  static std::unique_ptr<katana::PropertyGraph> pg = [] {
+    auto res = katana::PropertyGraph::Make(MakeInput());
+    KATANA_LOG_ASSERT(res);
+    return std::move(res.value());
+  }();
+  return *pg;
+}
+
+/// The input reordered by kind, built on first use
+const katana::ShuffleTopology&
+Reordered(NodeSortKind kind) {
+  static std::map<NodeSortKind, std::unique_ptr<katana::ShuffleTopology>>
+      topos;
+  auto& topo = topos[kind];
+  if (!topo) {
+    auto seed_topo = katana::EdgeShuffleTopology::MakeOriginalCopy(&Input());
+    topo = katana::ShuffleTopology::MakeFromTopo(
+        &Input(), *seed_topo, kind,
+        katana::EdgeShuffleTopology::EdgeSortKind::kAny);
+  }
+  return *topo;
+}
+
+/// Miss rate of reading the 8-byte data of every neighbor, in edge order,
+/// through a set-associative LRU cache
+double
+SimulatedMissRate(const katana::GraphTopology& topo) {
+  uint64_t num_sets = kCacheBytes / kCacheLineBytes / kCacheWays;
+  std::vector<uint64_t> lines(num_sets * kCacheWays, kInfinity);
+  uint64_t misses = 0;
+
+  for (auto n : topo.all_nodes()) {
+    for (auto e : topo.edges(n)) {
+      uint64_t line = topo.edge_dest(e) * sizeof(uint64_t) / kCacheLineBytes;
+      // Each set is kept in order of most recent use
+      auto set = lines.begin() + (line % num_sets) * kCacheWays;
+      auto way = std::find(set, set + kCacheWays, line);
+      if (way == set + kCacheWays) {
+        ++misses;
+        --way;
+      }
+      std::rotate(set, way, way + 1);
+      *set = line;
+    }
+  }
+
+  return static_cast<double>(misses) / topo.num_edges();
+}
+
+void
+ReportCounters(benchmark::State& state, const katana::GraphTopology& topo) {
+  state.SetLabel(OrderName(static_cast<NodeSortKind>(state.range(0))));
+  state.SetItemsProcessed(state.iterations() * topo.num_edges());
+  state.counters["simulated_miss_rate"] = SimulatedMissRate(topo);
+}
+
+void
+Reorder(benchmark::State& state) {
+  auto kind = static_cast<NodeSortKind>(state.range(0));
+  auto seed_topo = katana::EdgeShuffleTopology::MakeOriginalCopy(&Input());
+
+  for (auto _ : state) {
+    auto topo = katana::ShuffleTopology::MakeFromTopo(
+        &Input(), *seed_topo, kind,
+        katana::EdgeShuffleTopology::EdgeSortKind::kAny);
+    benchmark::DoNotOptimize(topo);
+  }
+
+  ReportCounters(state, Reordered(kind));
+}
+
+/// One pull iteration of PageRank
+void
+PageRank(benchmark::State& state) {
+  const auto& topo = Reordered(static_cast<NodeSortKind>(state.range(0)));
+  constexpr double kAlpha = 0.85;
+
+  katana::NUMAArray<double> contribution;
+  katana::NUMAArray<double> rank;
+  contribution.allocateInterleaved(topo.num_nodes());
+  rank.allocateInterleaved(topo.num_nodes());
+  katana::do_all(
+      katana::iterate(topo.all_nodes()),
+      [&](Node n) {
+        auto degree = topo.degree(n);
+        contribution[n] = degree == 0 ? 0 : 1.0 / topo.num_nodes() / degree;
+      },
+      katana::no_stats());
+
+  for (auto _ : state) {
+    katana::do_all(
+        katana::iterate(topo.all_nodes()),
+        [&](Node n) {
+          double sum = 0;
+          for (auto e : topo.edges(n)) {
+            sum += contribution[topo.edge_dest(e)];
+          }
+          rank[n] = (1 - kAlpha) / topo.num_nodes() + kAlpha * sum;
+        },
+        katana::steal(), katana::no_stats());
+    benchmark::DoNotOptimize(rank.data());
+  }
+
+  ReportCounters(state, topo);
+}
+
+/// Connected components by synchronous label propagation
+void
+ConnectedComponents(benchmark::State& state) {
+  const auto& topo = Reordered(static_cast<NodeSortKind>(state.range(0)));
+
+  katana::NUMAArray<uint64_t> label;
+  katana::NUMAArray<uint64_t> next_label;
+  label.allocateInterleaved(topo.num_nodes());
+  next_label.allocateInterleaved(topo.num_nodes());
+
+  for (auto _ : state) {
+    katana::do_all(
+        katana::iterate(topo.all_nodes()), [&](Node n) { label[n] = n; },
+        katana::no_stats());
+
+    katana::GReduceLogicalOr changed;
+    do {
+      changed.reset();
+      katana::do_all(
+          katana::iterate(topo.all_nodes()),
+          [&](Node n) {
+            uint64_t min_label = label[n];
+            for (auto e : topo.edges(n)) {
+              min_label = std::min(min_label, label[topo.edge_dest(e)]);
+            }
+            next_label[n] = min_label;
+            changed.update(min_label != label[n]);
+          },
+          katana::steal(), katana::no_stats());
+      std::swap(label, next_label);
+    } while (changed.reduce());
+  }
+
+  ReportCounters(state, topo);
+}
+
+/// Top-down BFS from the node with the most edges
+void
+Bfs(benchmark::State& state) {
+  const auto& topo = Reordered(static_cast<NodeSortKind>(state.range(0)));
+
+  Node source = 0;
+  for (auto n : topo.all_nodes()) {
+    if (topo.degree(n) > topo.degree(source)) {
+      source = n;
+    }
+  }
+
+  katana::NUMAArray<uint64_t> level;
+  level.allocateInterleaved(topo.num_nodes());
+  katana::InsertBag<Node> frontiers[2];
+
+  for (auto _ : state) {
+    katana::do_all(
+        katana::iterate(topo.all_nodes()), [&](Node n) { level[n] = kInfinity; },
+        katana::no_stats());
+    level[source] = 0;
+    frontiers[0].push(source);
+
+    for (uint64_t depth = 1; !frontiers[(depth - 1) % 2].empty(); ++depth) {
+      auto& current = frontiers[(depth - 1) % 2];
+      auto& next = frontiers[depth % 2];
+      katana::do_all(
+          katana::iterate(current),
+          [&](Node n) {
+            for (auto e : topo.edges(n)) {
+              Node dest = topo.edge_dest(e);
+              uint64_t old = kInfinity;
+              if (level[dest] == kInfinity &&
+                  __atomic_compare_exchange_n(
+                      &level[dest], &old, depth, false, __ATOMIC_RELAXED,
+                      __ATOMIC_RELAXED)) {
+                next.push(dest);
+              }
+            }
+          },
+          katana::steal(), katana::no_stats());
+      current.clear();
+    }
+  }
+
+  ReportCounters(state, topo);
+}
+
+BENCHMARK(Reorder)->Apply(MakeArguments);
+BENCHMARK(PageRank)->Apply(MakeArguments);
+BENCHMARK(ConnectedComponents)->Apply(MakeArguments);
+BENCHMARK(Bfs)->Apply(MakeArguments);
+}  // namespace
+
+int
+main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  katana::SharedMemSys G;
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -54,6 +54,78 @@ SplitString(std::string& str, std::vector<std::string>* vec) {
   }
 }
 
+void
+TestProjectionCache(
+    katana::PropertyGraph* g, const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types) {
+  auto projected = g->BuildProjectedTopology(node_types, edge_types);
+
+  // The order of the types does not matter
+  std::vector<std::string> reversed(node_types.rbegin(), node_types.rend());
+  KATANA_LOG_ASSERT(
+      g->BuildProjectedTopology(reversed, edge_types) == projected);
+
+  // Other projections are cached alongside
+  auto all = g->BuildProjectedTopology({}, {});
+  KATANA_LOG_ASSERT(all != projected);
+  KATANA_LOG_ASSERT(all->num_nodes() == g->num_nodes());
+  KATANA_LOG_ASSERT(all->num_edges() == g->num_edges());
+  KATANA_LOG_ASSERT(
+      g->BuildProjectedTopology(node_types, edge_types) == projected);
+
+  // With no budget, only the most recently used projection is kept
+  g->SetProjectedTopologyCacheBudget(0);
+  KATANA_LOG_ASSERT(g->BuildProjectedTopology({}, {}) != all);
+  KATANA_LOG_ASSERT(all->num_edges() == g->num_edges());
+}
+
+void
+TestMaskedTopology(
+    katana::PropertyGraph* g, const std::vector<std::string>& node_types,
+    const std::vector<std::string>& edge_types) {
+  auto projected = g->BuildProjectedTopology(node_types, edge_types);
+  auto masked = g->BuildView<katana::PropertyGraphViews::MaskedGraph>(
+      node_types, edge_types);
+
+  KATANA_LOG_ASSERT(masked.num_selected_nodes() == projected->num_nodes());
+  KATANA_LOG_ASSERT(masked.num_selected_edges() == projected->num_edges());
+
+  // Masked nodes and edges keep their ids, which the projection maps back to
+  GNode p = 0;
+  for (auto n : masked.all_nodes()) {
+    KATANA_LOG_ASSERT(projected->projected_to_original_node_id(p) == n);
+    auto p_edges = projected->edges(p);
+    auto p_edge = p_edges.begin();
+    for (auto e : masked.edges(n)) {
+      KATANA_LOG_ASSERT(p_edge != p_edges.end());
+      KATANA_LOG_ASSERT(
+          projected->projected_to_original_edge_id(*p_edge) == e);
+      ++p_edge;
+    }
+    KATANA_LOG_ASSERT(p_edge == p_edges.end());
+    ++p;
+  }
+  KATANA_LOG_ASSERT(p == projected->num_nodes());
+
+  // A filter that selects everything is masked unless it is already
+  // projected, so check it on a graph without cached projections; either way
+  // the filtered topology has the projection's edges
+  katana::PropertyGraph fresh = LoadGraph(inputFile);
+  KATANA_LOG_ASSERT(fresh.BuildFilteredTopology({}, {}).is_masked());
+  auto filtered = g->BuildFilteredTopology(node_types, edge_types);
+  uint64_t num_filtered_edges =
+      filtered.Visit([](const auto& topo) -> uint64_t {
+        uint64_t count = 0;
+        for (auto n : topo.all_nodes()) {
+          for ([[maybe_unused]] auto e : topo.edges(n)) {
+            ++count;
+          }
+        }
+        return count;
+      });
+  KATANA_LOG_ASSERT(num_filtered_edges == projected->num_edges());
+}
+
 int
 main(int argc, char** argv) {
   katana::SharedMemSys sys;
@@ -76,5 +148,8 @@ main(int argc, char** argv) {
   katana::gPrint("\n Num Nodes: ", graph->num_nodes());
   katana::gPrint("\n Num Edges: ", graph->num_edges());
 
+  TestMaskedTopology(&g, node_types, edge_types);
+  TestProjectionCache(&g, node_types, edge_types);
+
   return 0;
 }
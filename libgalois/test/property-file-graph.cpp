@@ -1,3 +1,8 @@
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+
 #include <arrow/api.h>
 #include <boost/filesystem.hpp>
 
@@ -6,6 +11,10 @@
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
 #include "katana/URI.h"
+#include "katana/analytics/connected_components/connected_components.h"
+#include "tsuba/CSRTopology.h"
+#include "tsuba/RDGSlice.h"
+#include "tsuba/tsuba.h"
 
 namespace {
 
@@ -440,6 +449,489 @@ TestTopologyAccess() {
   }
   KATANA_LOG_ASSERT(n_nodes == 10);
 }
+
+void
+TestMappedTopology() {
+  RandomPolicy policy{2};
+  auto g = MakeFileGraph<uint32_t>(10, 1, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  KATANA_LOG_WARN("creating temp file {}", rdg_dir);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  tsuba::RDGLoadOptions opts;
+  opts.map_topology = true;
+  opts.topology_access_hint = tsuba::FileView::AccessHint::kRandom;
+  opts.interleave_topology = true;
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  KATANA_LOG_ASSERT(g2->topology().is_borrowed());
+  KATANA_LOG_ASSERT(g2->topology().Equals(g->topology()));
+
+  // modifying the topology must not touch the mapped file
+  auto sort_result = katana::SortAllEdgesByDest(g2.get());
+  KATANA_LOG_ASSERT(sort_result);
+  KATANA_LOG_ASSERT(!g2->topology().is_borrowed());
+  KATANA_LOG_ASSERT(g2->topology().num_edges() == g->topology().num_edges());
+
+  make_result = katana::PropertyGraph::Make(rdg_dir, opts);
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(make_result);
+  KATANA_LOG_ASSERT(make_result.value()->topology().Equals(g->topology()));
+}
+
+size_t
+CountFilesWithSuffix(const std::string& rdg_dir, const std::string& suffix) {
+  size_t count = 0;
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (entry.path().extension() == suffix) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+void
+TestArrowIPCProperties() {
+  constexpr size_t test_length = 10;
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int32_t>("node-name", test_length)));
+  KATANA_LOG_ASSERT(
+      g->AddEdgeProperties(MakeProps<int32_t>("edge-name", test_length)));
+  KATANA_LOG_ASSERT(
+      g->SetNodePropertyFormat("node-name", tsuba::PropertyFormat::kArrowIPC));
+  KATANA_LOG_ASSERT(
+      !g->SetNodePropertyFormat("no-such", tsuba::PropertyFormat::kArrowIPC));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  KATANA_LOG_WARN("creating temp file {}", rdg_dir);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+  size_t ipc_files = CountFilesWithSuffix(rdg_dir, ".arrow");
+
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g2->GetNodeProperty(0)->Equals(g->GetNodeProperty(0)));
+  KATANA_LOG_ASSERT(g2->GetNodeProperty(0)->num_chunks() == 1);
+  KATANA_LOG_ASSERT(g2->GetEdgeProperty(0)->Equals(g->GetEdgeProperty(0)));
+
+  // converting a loaded property rewrites it on the next commit
+  KATANA_LOG_ASSERT(
+      g2->SetEdgePropertyFormat("edge-name", tsuba::PropertyFormat::kArrowIPC));
+  auto commit_result = g2->Commit(command_line);
+  size_t converted_ipc_files = CountFilesWithSuffix(rdg_dir, ".arrow");
+
+  make_result = katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_ASSERT(commit_result);
+  KATANA_LOG_ASSERT(make_result);
+  KATANA_LOG_ASSERT(ipc_files == 1);
+  KATANA_LOG_ASSERT(converted_ipc_files == 2);
+  KATANA_LOG_ASSERT(make_result.value()->GetEdgeProperty(0)->Equals(
+      g->GetEdgeProperty(0)));
+}
+
+uint64_t
+TopologyFileSize(const std::string& rdg_dir) {
+  uint64_t size = 0;
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().rfind("topology", 0) == 0) {
+      size = fs::file_size(entry.path());
+    }
+  }
+  return size;
+}
+
+using Node = katana::GraphTopology::Node;
+
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+
+/// The push loop of BFS: the level of each node reachable from source
+template <typename Graph>
+std::vector<uint32_t>
+BfsLevels(const Graph& graph, Node source) {
+  std::vector<uint32_t> levels(graph.num_nodes(), kUnreached);
+  std::vector<Node> frontier{source};
+  levels[source] = 0;
+  for (uint32_t level = 1; !frontier.empty(); ++level) {
+    std::vector<Node> next;
+    for (Node n : frontier) {
+      for (auto e : graph.edges(n)) {
+        Node dest = graph.edge_dest(e);
+        if (levels[dest] == kUnreached) {
+          levels[dest] = level;
+          next.push_back(dest);
+        }
+      }
+    }
+    frontier = std::move(next);
+  }
+  return levels;
+}
+
+/// Label propagation CC: the least node id of the (weak) component of each
+/// node
+template <typename Graph>
+std::vector<Node>
+ComponentLabels(const Graph& graph) {
+  std::vector<Node> labels(graph.num_nodes());
+  std::iota(labels.begin(), labels.end(), Node{0});
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (Node n : graph.all_nodes()) {
+      for (auto e : graph.edges(n)) {
+        Node dest = graph.edge_dest(e);
+        Node label = std::min(labels[n], labels[dest]);
+        if (labels[n] != label || labels[dest] != label) {
+          labels[n] = label;
+          labels[dest] = label;
+          changed = true;
+        }
+      }
+    }
+  }
+  return labels;
+}
+
+/// Push PageRank for a fixed number of rounds
+template <typename Graph>
+std::vector<double>
+PageRanks(const Graph& graph, int rounds) {
+  constexpr double kAlpha = 0.85;
+  const double num_nodes = graph.num_nodes();
+  std::vector<double> ranks(graph.num_nodes(), 1.0 / num_nodes);
+  for (int round = 0; round < rounds; ++round) {
+    std::vector<double> next(graph.num_nodes(), (1.0 - kAlpha) / num_nodes);
+    for (Node n : graph.all_nodes()) {
+      if (graph.degree(n) == 0) {
+        continue;
+      }
+      double share = kAlpha * ranks[n] / graph.degree(n);
+      for (auto e : graph.edges(n)) {
+        next[graph.edge_dest(e)] += share;
+      }
+    }
+    ranks = std::move(next);
+  }
+  return ranks;
+}
+
+/// Push label propagation: the least node id that reaches each node, which is
+/// what ConnectedComponentsPlan::LabelProp computes on a directed graph
+template <typename Graph>
+std::vector<Node>
+PushLabels(const Graph& graph) {
+  std::vector<Node> labels(graph.num_nodes());
+  std::iota(labels.begin(), labels.end(), Node{0});
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (Node n : graph.all_nodes()) {
+      for (auto e : graph.edges(n)) {
+        Node dest = graph.edge_dest(e);
+        if (labels[n] < labels[dest]) {
+          labels[dest] = labels[n];
+          changed = true;
+        }
+      }
+    }
+  }
+  return labels;
+}
+
+/// Run katana::analytics::ConnectedComponents on pg, which runs on the
+/// compressed view if pg has a compressed topology, and check it against
+/// expected
+void
+TestCompressedAnalytics(
+    katana::PropertyGraph* pg, const katana::GraphTopology& expected) {
+  const std::string name = "label-prop";
+  auto cc_res = katana::analytics::ConnectedComponents(
+      pg, name, katana::analytics::ConnectedComponentsPlan::LabelProp());
+  KATANA_LOG_VASSERT(cc_res, "connected components: {}", cc_res.error());
+
+  auto labels_res = pg->GetNodePropertyTyped<uint64_t>(name);
+  KATANA_LOG_ASSERT(labels_res);
+  auto labels = labels_res.value();
+  std::vector<Node> expected_labels = PushLabels(expected);
+  for (Node n : expected.all_nodes()) {
+    KATANA_LOG_ASSERT(labels->Value(n) == expected_labels[n]);
+  }
+
+  auto remove_res = pg->RemoveNodeProperty(name);
+  KATANA_LOG_ASSERT(remove_res);
+}
+
+/// Run BFS, CC and PageRank on the compressed view of pg and check that
+/// they match the same kernels on expected
+void
+TestCompressedAlgorithms(
+    katana::PropertyGraph* pg, const katana::GraphTopology& expected) {
+  auto view = pg->BuildView<katana::PropertyGraphViews::Compressed>();
+  KATANA_LOG_ASSERT(view.num_nodes() == expected.num_nodes());
+  KATANA_LOG_ASSERT(view.num_edges() == expected.num_edges());
+
+  KATANA_LOG_ASSERT(BfsLevels(view, 0) == BfsLevels(expected, 0));
+  KATANA_LOG_ASSERT(ComponentLabels(view) == ComponentLabels(expected));
+  // Edges are visited in the same order, so the sums are identical
+  KATANA_LOG_ASSERT(PageRanks(view, 10) == PageRanks(expected, 10));
+
+  TestCompressedAnalytics(pg, expected);
+}
+
+void
+TestCompressedTopology() {
+  // enough nodes for several blocks
+  RandomPolicy policy{4};
+  auto g = MakeFileGraph<uint32_t>(10000, 1, &policy);
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  setenv("KATANA_COMPRESS_TOPOLOGY", "1", 1);
+  auto write_result = g->Write(rdg_dir, command_line);
+  unsetenv("KATANA_COMPRESS_TOPOLOGY");
+  KATANA_LOG_WARN("creating temp file {}", rdg_dir);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  uint64_t uncompressed_size =
+      sizeof(tsuba::CSRTopologyHeader) +
+      g->num_nodes() * sizeof(uint64_t) + g->num_edges() * sizeof(uint32_t);
+  uint64_t compressed_size = TopologyFileSize(rdg_dir);
+
+  for (bool map_topology : {false, true}) {
+    tsuba::RDGLoadOptions opts;
+    opts.map_topology = map_topology;
+    katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+        katana::PropertyGraph::Make(rdg_dir, opts);
+    if (!make_result) {
+      fs::remove_all(rdg_dir);
+      KATANA_LOG_FATAL("making result: {}", make_result.error());
+    }
+    // The view shares the loaded compressed topology, so run it before
+    // anything decodes the CSR
+    KATANA_LOG_ASSERT(make_result.value()->has_compressed_topology());
+    TestCompressedAlgorithms(make_result.value().get(), g->topology());
+    KATANA_LOG_ASSERT(!make_result.value()->topology().is_borrowed());
+    KATANA_LOG_ASSERT(make_result.value()->topology().Equals(g->topology()));
+
+    // Once the topology may change, the cached compressed topology must be
+    // rebuilt from it
+    make_result.value()->MakeTopologyMutable();
+    TestCompressedAlgorithms(make_result.value().get(), g->topology());
+  }
+
+  // Compressing the CSR of an uncompressed topology
+  TestCompressedAlgorithms(g.get(), g->topology());
+
+  // Slices are byte ranges of an uncompressed CSR, so slicing a compressed
+  // topology must fail rather than misread it
+  auto manifest_res = tsuba::FindManifest(rdg_dir);
+  KATANA_LOG_ASSERT(manifest_res);
+  auto handle_res =
+      tsuba::Open(std::move(manifest_res.value()), tsuba::kReadOnly);
+  KATANA_LOG_ASSERT(handle_res);
+  tsuba::RDGSlice::SliceArg slice{
+      .node_range = {0, 10},
+      .edge_range = {0, 10},
+      .topo_off = sizeof(tsuba::CSRTopologyHeader),
+      .topo_size = 10 * sizeof(uint64_t),
+  };
+  auto slice_res = tsuba::RDGSlice::Make(handle_res.value(), slice);
+  KATANA_LOG_ASSERT(tsuba::Close(handle_res.value()));
+
+  fs::remove_all(rdg_dir);
+  KATANA_LOG_VASSERT(
+      !slice_res && slice_res.error() == tsuba::ErrorCode::NotImplemented,
+      "slicing a compressed topology should not be implemented");
+  KATANA_LOG_ASSERT(compressed_size > 0);
+  KATANA_LOG_ASSERT(compressed_size < uncompressed_size);
+}
+
+template <typename View>
+void
+AssertSameView(const View& expected, const View& actual) {
+  KATANA_LOG_ASSERT(expected.num_nodes() == actual.num_nodes());
+  KATANA_LOG_ASSERT(expected.num_edges() == actual.num_edges());
+  for (auto n : expected.all_nodes()) {
+    KATANA_LOG_ASSERT(expected.degree(n) == actual.degree(n));
+  }
+  for (auto e : expected.all_edges()) {
+    KATANA_LOG_ASSERT(expected.edge_dest(e) == actual.edge_dest(e));
+    KATANA_LOG_ASSERT(
+        expected.edge_property_index(e) == actual.edge_property_index(e));
+  }
+}
+
+size_t
+CountDerivedTopologyFiles(const std::string& rdg_dir) {
+  size_t count = 0;
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    if (entry.path().filename().string().rfind("derived_topology", 0) == 0) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+void
+TestDerivedTopologies() {
+  using SortedView = katana::PropertyGraphViews::EdgesSortedByDestID;
+  using NodeSortedView =
+      katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+
+  RandomPolicy policy{3};
+  auto g = MakeFileGraph<uint32_t>(10, 1, &policy);
+  auto sorted = g->BuildView<SortedView>();
+  auto node_sorted = g->BuildView<NodeSortedView>();
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  KATANA_LOG_WARN("creating temp file {}", rdg_dir);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  // one for each view; the edge sorted topology also seeded the node sorted one
+  KATANA_LOG_ASSERT(CountDerivedTopologyFiles(rdg_dir) == 2);
+
+  katana::Result<std::unique_ptr<katana::PropertyGraph>> make_result =
+      katana::PropertyGraph::Make(rdg_dir, tsuba::RDGLoadOptions());
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  AssertSameView(sorted, g2->BuildView<SortedView>());
+  AssertSameView(node_sorted, g2->BuildView<NodeSortedView>());
+
+  // nothing new to persist
+  auto commit_result = g2->Commit(command_line);
+  size_t num_files = CountDerivedTopologyFiles(rdg_dir);
+
+  // copies carry the derived topologies along
+  auto copy_uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(copy_uri_res);
+  std::string copy_dir(copy_uri_res.value().path());
+  auto views_res = tsuba::ListViewsOfVersion(rdg_dir);
+  KATANA_LOG_ASSERT(views_res);
+  auto src_dst = tsuba::CreateSrcDestFromViewsForCopy(
+      rdg_dir, copy_dir, views_res.value().first);
+  KATANA_LOG_ASSERT(src_dst);
+  auto copy_result = tsuba::CopyRDG(src_dst.value());
+  fs::remove_all(rdg_dir);
+  size_t num_copied_files = CountDerivedTopologyFiles(copy_dir);
+  fs::remove_all(copy_dir);
+
+  KATANA_LOG_ASSERT(commit_result);
+  KATANA_LOG_ASSERT(copy_result);
+  KATANA_LOG_ASSERT(num_files == 2);
+  KATANA_LOG_ASSERT(num_copied_files == 2);
+}
+
+/// Copying an RDG copies every file that its chunked properties are stored
+/// in, including base files written by earlier versions
+void
+TestCopyChunkedProperties() {
+  constexpr size_t test_length = 1000;
+  constexpr int32_t changed_row = 500;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy);
+  KATANA_LOG_ASSERT(
+      g->AddNodeProperties(MakeProps<int32_t>("node-name", test_length)));
+
+  auto src_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  auto dst_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(src_res && dst_res);
+  std::string src_dir(src_res.value().path());  // path() because local
+  std::string dst_dir(dst_res.value().path());
+
+  setenv("KATANA_PROPERTY_CHUNK_ROWS", "64", 1);
+  auto write_result = g->Write(src_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(src_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  // Change one chunk so that the next version points at a delta file as
+  // well as at the base file of the first version
+  auto g2_res = katana::PropertyGraph::Make(src_dir, tsuba::RDGLoadOptions());
+  KATANA_LOG_ASSERT(g2_res);
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(g2_res.value());
+  arrow::Int32Builder builder;
+  for (int32_t i = 0; i < static_cast<int32_t>(test_length); ++i) {
+    KATANA_LOG_ASSERT(builder.Append(i == changed_row ? -1 : i).ok());
+  }
+  std::shared_ptr<arrow::Array> changed;
+  KATANA_LOG_ASSERT(builder.Finish(&changed).ok());
+  auto expected = std::make_shared<arrow::ChunkedArray>(changed);
+  KATANA_LOG_ASSERT(g2->UpsertNodeProperties(arrow::Table::Make(
+      arrow::schema({arrow::field("node-name", arrow::int32())}),
+      {expected})));
+  auto commit_result = g2->Commit(command_line);
+  unsetenv("KATANA_PROPERTY_CHUNK_ROWS");
+  if (!commit_result) {
+    fs::remove_all(src_dir);
+    KATANA_LOG_FATAL("committing result: {}", commit_result.error());
+  }
+
+  auto views_res = tsuba::ListViewsOfVersion(src_dir);
+  KATANA_LOG_ASSERT(views_res);
+  auto src_dst = tsuba::CreateSrcDestFromViewsForCopy(
+      src_dir, dst_dir, views_res.value().first);
+  KATANA_LOG_ASSERT(src_dst);
+  auto copy_result = tsuba::CopyRDG(src_dst.value());
+  fs::remove_all(src_dir);
+  if (!copy_result) {
+    fs::remove_all(dst_dir);
+    KATANA_LOG_FATAL("copying result: {}", copy_result.error());
+  }
+
+  auto copy_res = katana::PropertyGraph::Make(dst_dir, tsuba::RDGLoadOptions());
+  fs::remove_all(dst_dir);
+  if (!copy_res) {
+    KATANA_LOG_FATAL("making copy: {}", copy_res.error());
+  }
+  auto property = copy_res.value()->GetNodeProperty("node-name");
+  KATANA_LOG_ASSERT(property);
+  KATANA_LOG_ASSERT(property.value()->Equals(expected));
+}
+
 }  // namespace
 
 int
@@ -458,6 +950,11 @@ main(int argc, char** argv) {
   TestGarbageMetadata();
   TestSimplePGs();
   TestTopologyAccess();
+  TestMappedTopology();
+  TestCompressedTopology();
+  TestArrowIPCProperties();
+  TestDerivedTopologies();
+  TestCopyChunkedProperties();
   TestTypesFromPropertiesCompareTypesFromStorage();
   TestCompositeTypesFromPropertiesCompareCompositeTypesFromStorage();
 
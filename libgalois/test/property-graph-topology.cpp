@@ -1,3 +1,6 @@
+#include <memory>
+#include <vector>
+
 #include "katana/Logging.h"
 #include "katana/PropertyGraph.h"
 #include "katana/SharedMemSys.h"
@@ -12,6 +15,135 @@ TestEdgeSource(const katana::GraphTopology& topo) noexcept {
   }
 }
 
+void
+TestBorrowed(const katana::GraphTopology& topo) noexcept {
+  katana::GraphTopology borrowed = katana::GraphTopology::MakeBorrowed(
+      topo.adj_data(), topo.num_nodes(), topo.dest_data(), topo.num_edges());
+  KATANA_LOG_ASSERT(borrowed.is_borrowed());
+  KATANA_LOG_ASSERT(borrowed.dest_data() == topo.dest_data());
+  KATANA_LOG_ASSERT(borrowed.Equals(topo));
+
+  katana::GraphTopology moved = std::move(borrowed);
+  moved.MakeMutable();
+  KATANA_LOG_ASSERT(!moved.is_borrowed());
+  KATANA_LOG_ASSERT(moved.dest_data() != topo.dest_data());
+  KATANA_LOG_ASSERT(moved.Equals(topo));
+}
+
+void
+TestNodeOrderings(const katana::GraphTopology& topo) noexcept {
+  using NodeSortKind = katana::ShuffleTopology::NodeSortKind;
+
+  auto pg_res = katana::PropertyGraph::Make(katana::GraphTopology::Copy(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  auto seed_topo = katana::EdgeShuffleTopology::MakeOriginalCopy(pg.get());
+
+  for (auto kind :
+       {NodeSortKind::kReverseCuthillMcKee, NodeSortKind::kHubSorted,
+        NodeSortKind::kHubClustered, NodeSortKind::kGorder,
+        NodeSortKind::kRabbitOrder}) {
+    auto reordered = katana::ShuffleTopology::MakeFromTopo(
+        pg.get(), *seed_topo, kind,
+        katana::EdgeShuffleTopology::EdgeSortKind::kAny);
+    KATANA_LOG_ASSERT(reordered->has_nodes_sorted_by(kind));
+    KATANA_LOG_ASSERT(reordered->num_nodes() == topo.num_nodes());
+    KATANA_LOG_ASSERT(reordered->num_edges() == topo.num_edges());
+
+    // Every edge of the reordered topology is an edge of the original one
+    std::vector<bool> seen(topo.num_nodes(), false);
+    for (auto n : reordered->all_nodes()) {
+      auto old_n = reordered->node_property_index(n);
+      KATANA_LOG_ASSERT(!seen[old_n]);
+      seen[old_n] = true;
+      KATANA_LOG_ASSERT(reordered->degree(n) == topo.degree(old_n));
+      for (auto e : reordered->edges(n)) {
+        auto old_e = reordered->edge_property_index(e);
+        KATANA_LOG_ASSERT(topo.edge_source(old_e) == old_n);
+        KATANA_LOG_ASSERT(
+            topo.edge_dest(old_e) ==
+            reordered->node_property_index(reordered->edge_dest(e)));
+      }
+    }
+
+    auto reordered_pg_res = katana::CreateReorderedGraph(pg.get(), kind);
+    KATANA_LOG_ASSERT(reordered_pg_res);
+    KATANA_LOG_ASSERT(reordered_pg_res.value()->topology().Equals(*reordered));
+  }
+}
+
+void
+TestCompressed(const katana::GraphTopology& topo) noexcept {
+  auto compressed = katana::CompressedTopology::Make(topo);
+  KATANA_LOG_ASSERT(compressed.num_nodes() == topo.num_nodes());
+  KATANA_LOG_ASSERT(compressed.num_edges() == topo.num_edges());
+
+  for (auto n : topo.all_nodes()) {
+    KATANA_LOG_ASSERT(compressed.degree(n) == topo.degree(n));
+
+    auto e = topo.edges(n).begin();
+    for (auto ce : compressed.edges(n)) {
+      KATANA_LOG_ASSERT(ce.id == *e);
+      KATANA_LOG_ASSERT(compressed.edge_dest(ce) == topo.edge_dest(*e));
+      KATANA_LOG_ASSERT(compressed.edge_source(ce) == n);
+      ++e;
+    }
+    KATANA_LOG_ASSERT(e == topo.edges(n).end());
+
+    std::vector<katana::GraphTopology::Node> dests(topo.degree(n));
+    KATANA_LOG_ASSERT(
+        compressed.DecodeNeighbors(n, dests.data()) == topo.degree(n));
+    for (size_t i = 0; i < dests.size(); ++i) {
+      KATANA_LOG_ASSERT(dests[i] == topo.edge_dest(*topo.edges(n).begin() + i));
+    }
+  }
+
+  uint64_t num_edges = 0;
+  for (auto ce : compressed.all_edges()) {
+    KATANA_LOG_ASSERT(ce.id == num_edges);
+    KATANA_LOG_ASSERT(compressed.edge_dest(ce) == topo.edge_dest(ce.id));
+    ++num_edges;
+  }
+  KATANA_LOG_ASSERT(num_edges == topo.num_edges());
+}
+
+void
+TestMembershipIndex(const katana::GraphTopology& topo) noexcept {
+  auto pg_res = katana::PropertyGraph::Make(katana::GraphTopology::Copy(topo));
+  KATANA_LOG_ASSERT(pg_res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_res.value());
+  auto sorted = katana::EdgeShuffleTopology::Make(
+      pg.get(), katana::EdgeShuffleTopology::TransposeKind::kNo,
+      katana::EdgeShuffleTopology::EdgeSortKind::kSortedByDestID);
+
+  std::vector<bool> is_neighbor(topo.num_nodes(), false);
+  // Hash every node with an edge, only hubs, and no node
+  for (uint64_t hash_degree : {uint64_t{1}, uint64_t{6}, uint64_t{1} << 40}) {
+    auto index = katana::EdgeMembershipIndex::Make(sorted.get(), hash_degree);
+    for (auto n : topo.all_nodes()) {
+      for (auto e : topo.edges(n)) {
+        is_neighbor[topo.edge_dest(e)] = true;
+      }
+      for (auto m : topo.all_nodes()) {
+        KATANA_LOG_ASSERT(index.has_edge(n, m) == is_neighbor[m]);
+      }
+      for (auto e : topo.edges(n)) {
+        is_neighbor[topo.edge_dest(e)] = false;
+      }
+    }
+  }
+
+  auto view =
+      pg->BuildView<katana::PropertyGraphViews::EdgesSortedByDestIDIndexed>();
+  for (auto n : topo.all_nodes()) {
+    for (auto e : topo.edges(n)) {
+      auto dest = topo.edge_dest(e);
+      KATANA_LOG_ASSERT(view.has_edge(n, dest));
+      KATANA_LOG_ASSERT(view.edge_dest(*view.find_edge(n, dest)) == dest);
+    }
+  }
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -23,6 +155,19 @@ main() {
       katana::CreateUniformRandomTopology(kNumNodes, kEdgesPerNode);
 
   TestEdgeSource(topo);
+  TestBorrowed(topo);
+  TestNodeOrderings(topo);
+  TestCompressed(topo);
+  TestMembershipIndex(topo);
+
+  // Empty nodes, self loops, unsorted edges and long deltas
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(kNumNodes);
+  builder.AddEdge(1, kNumNodes - 1);
+  builder.AddEdge(1, 0);
+  builder.AddEdge(1, 1);
+  builder.AddEdge(kNumNodes - 1, 2);
+  TestCompressed(builder.ConvertToCSR());
 
   return 0;
 }
@@ -126,6 +126,156 @@ TestError1(size_t num_nodes, size_t line_width) {
       "Should return PropertyNotFound when node property doesn't exist.");
 }
 
+/// Test that properties permuted into the order of a view read the same as
+/// properties reached through the view
+void
+TestPermutedProperties(size_t num_nodes, size_t line_width) {
+  using NodeType = std::tuple<Field0>;
+  using EdgeType = std::tuple<Field0>;
+  using PGView =
+      katana::PropertyGraphViews::NodesSortedByDegreeEdgesSortedByDestID;
+  using View = katana::TypedPropertyGraphView<PGView, NodeType, EdgeType>;
+
+  RandomPolicy policy{line_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 1, &policy);
+
+  katana::ColumnOptions options;
+  options.name = "ascending";
+  options.ascending_values = true;
+  katana::TableBuilder node_builder{g->topology().num_nodes()};
+  katana::TableBuilder edge_builder{g->topology().num_edges()};
+  node_builder.AddColumn<DataType>(options);
+  edge_builder.AddColumn<DataType>(options);
+  if (auto r = g->AddNodeProperties(node_builder.Finish()); !r) {
+    KATANA_LOG_FATAL("could not add node property: {}", r.error());
+  }
+  if (auto r = g->AddEdgeProperties(edge_builder.Finish()); !r) {
+    KATANA_LOG_FATAL("could not add edge property: {}", r.error());
+  }
+
+  auto gathered_res = View::Make(g.get(), {"ascending"}, {"ascending"});
+  KATANA_LOG_ASSERT(gathered_res);
+  auto permuted_res = View::Make(
+      g.get(), {"ascending"}, {"ascending"},
+      katana::PermutedProperties{{"ascending"}, {"ascending"}});
+  KATANA_LOG_ASSERT(permuted_res);
+  const View& gathered = gathered_res.value();
+  const View& permuted = permuted_res.value();
+
+  for (auto n : gathered.all_nodes()) {
+    KATANA_LOG_ASSERT(
+        gathered.GetData<Field0>(n) == permuted.GetData<Field0>(n));
+    for (auto e : gathered.edges(n)) {
+      KATANA_LOG_ASSERT(
+          gathered.GetEdgeData<Field0>(e) == permuted.GetEdgeData<Field0>(e));
+    }
+  }
+
+  const PGView& pg_view = permuted;
+  auto first = g->GetPermutedEdgeProperty(pg_view, "ascending");
+  auto second = g->GetPermutedEdgeProperty(pg_view, "ascending");
+  KATANA_LOG_ASSERT(first && second);
+  KATANA_LOG_VASSERT(
+      first.value() == second.value(), "permuted copy should be cached");
+
+  if (auto r = g->RemoveEdgeProperty("ascending"); !r) {
+    KATANA_LOG_FATAL("could not remove edge property: {}", r.error());
+  }
+  KATANA_LOG_VASSERT(
+      !g->GetPermutedEdgeProperty(pg_view, "ascending"),
+      "permuted copy of a removed property should not be returned");
+}
+
+/// Test that views with permuted properties share cached copies: views of one
+/// type with different orders get their own copies, views with the same order
+/// share one, views keep their copies across upserts, and copies are evicted
+/// once they exceed the cache budget
+void
+TestPermutedPropertiesSharedByViews(size_t num_nodes, size_t line_width) {
+  using NodeType = std::tuple<Field0>;
+  using EdgeType = std::tuple<>;
+  using PGView = katana::PropertyGraphViews::NodesReordered;
+  using View = katana::TypedPropertyGraphView<PGView, NodeType, EdgeType>;
+  using NodeSortKind = katana::ShuffleTopology::NodeSortKind;
+
+  RandomPolicy policy{line_width};
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<DataType>(num_nodes, 1, &policy);
+
+  katana::ColumnOptions options;
+  options.name = "ascending";
+  options.ascending_values = true;
+  katana::TableBuilder builder{g->topology().num_nodes()};
+  builder.AddColumn<DataType>(options);
+  if (auto r = g->AddNodeProperties(builder.Finish()); !r) {
+    KATANA_LOG_FATAL("could not add node property: {}", r.error());
+  }
+
+  auto make_view = [&g](NodeSortKind kind) {
+    auto pg_view = g->BuildView<PGView>(kind);
+    auto res = View::Make(
+        g.get(), pg_view, {"ascending"}, {},
+        katana::PermutedProperties{{"ascending"}, {}});
+    KATANA_LOG_ASSERT(res);
+    return std::move(res.value());
+  };
+  auto get_copy = [&g](NodeSortKind kind) {
+    auto res =
+        g->GetPermutedNodeProperty(g->BuildView<PGView>(kind), "ascending");
+    KATANA_LOG_ASSERT(res);
+    return res.value();
+  };
+  View by_degree = make_view(NodeSortKind::kSortedByDegree);
+  View by_rcm = make_view(NodeSortKind::kReverseCuthillMcKee);
+
+  KATANA_LOG_VASSERT(
+      get_copy(NodeSortKind::kSortedByDegree) ==
+          get_copy(NodeSortKind::kSortedByDegree),
+      "views with the same order should share a copy");
+  KATANA_LOG_VASSERT(
+      get_copy(NodeSortKind::kSortedByDegree) !=
+          get_copy(NodeSortKind::kReverseCuthillMcKee),
+      "views with different orders should not share a copy");
+
+  // Replace the values of the property while both views are alive
+  options.ascending_values = false;
+  katana::TableBuilder upsert_builder{g->topology().num_nodes()};
+  upsert_builder.AddColumn<DataType>(options);
+  if (auto r = g->UpsertNodeProperties(upsert_builder.Finish()); !r) {
+    KATANA_LOG_FATAL("could not upsert node property: {}", r.error());
+  }
+
+  for (const View* view : {&by_degree, &by_rcm}) {
+    for (auto n : view->all_nodes()) {
+      KATANA_LOG_VASSERT(
+          view->GetData<Field0>(n) ==
+              static_cast<DataType>(view->node_property_index(n)),
+          "permuted copy should keep the values it was made with");
+    }
+  }
+
+  View after_upsert = make_view(NodeSortKind::kSortedByDegree);
+  for (auto n : after_upsert.all_nodes()) {
+    KATANA_LOG_VASSERT(
+        after_upsert.GetData<Field0>(n) == 1,
+        "views made after an upsert should see the new values");
+  }
+
+  // Without a budget, copies are not kept but views still get them
+  g->SetPermutedPropertyCacheBudget(0);
+  auto first = get_copy(NodeSortKind::kSortedByDegree);
+  KATANA_LOG_VASSERT(
+      first != get_copy(NodeSortKind::kSortedByDegree),
+      "copies should not be cached without a budget");
+  View uncached = make_view(NodeSortKind::kSortedByDegree);
+  for (auto n : uncached.all_nodes()) {
+    KATANA_LOG_ASSERT(uncached.GetData<Field0>(n) == 1);
+  }
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -134,6 +284,8 @@ main() {
   TestIterate3(10, 3);
   TestIterate4(10, 3);
   TestError1(10, 3);
+  TestPermutedProperties(100, 5);
+  TestPermutedPropertiesSharedByViews(100, 5);
 
   return 0;
 }
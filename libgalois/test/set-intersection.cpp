@@ -0,0 +1,150 @@
+#include "katana/SetIntersection.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "katana/Logging.h"
+
+namespace {
+
+/// A strictly increasing set of size elements of [0, universe)
+template <typename T>
+std::vector<T>
+MakeSet(std::mt19937_64* gen, size_t size, uint64_t universe) {
+  std::uniform_int_distribution<uint64_t> dist(0, universe - 1);
+  std::vector<T> set;
+  for (size_t i = 0; i < size; ++i) {
+    set.emplace_back(dist(*gen));
+  }
+  std::sort(set.begin(), set.end());
+  set.erase(std::unique(set.begin(), set.end()), set.end());
+  return set;
+}
+
+template <typename T>
+void
+CheckPair(const std::vector<T>& a, const std::vector<T>& b) {
+  std::vector<T> expected;
+  std::set_intersection(
+      a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+  for (auto kind :
+       {katana::IntersectionKind::kMerge, katana::IntersectionKind::kGalloping,
+        katana::IntersectionKind::kBlock}) {
+    std::vector<T> found;
+    katana::ForEachCommon(
+        a.data(), a.size(), b.data(), b.size(), kind,
+        [&](T x) { found.emplace_back(x); });
+    KATANA_LOG_VASSERT(
+        found == expected, "kind {}: found {} common elements, expected {}",
+        static_cast<int>(kind), found.size(), expected.size());
+
+    size_t count =
+        katana::IntersectCount(a.data(), a.size(), b.data(), b.size(), kind);
+    KATANA_LOG_VASSERT(
+        count == expected.size(), "kind {}: counted {}, expected {}",
+        static_cast<int>(kind), count, expected.size());
+  }
+
+  KATANA_LOG_ASSERT(
+      katana::IntersectCount(a.data(), a.size(), b.data(), b.size()) ==
+      expected.size());
+
+  std::vector<T> out(std::min(a.size(), b.size()));
+  size_t written = katana::IntersectInto(
+      a.data(), a.size(), b.data(), b.size(), out.data());
+  out.resize(written);
+  KATANA_LOG_ASSERT(out == expected);
+
+  size_t num_positions = 0;
+  katana::ForEachCommonPosition(
+      a.data(), a.size(), b.data(), b.size(), [&](size_t i, size_t j) {
+        KATANA_LOG_ASSERT(a[i] == b[j]);
+        KATANA_LOG_ASSERT(a[i] == expected[num_positions]);
+        ++num_positions;
+      });
+  KATANA_LOG_ASSERT(num_positions == expected.size());
+
+  // Stopping after half of the common elements visits exactly those
+  size_t limit = expected.size() / 2;
+  size_t num_visited = 0;
+  bool stopped = katana::ForEachCommonPositionUntil(
+      a.data(), a.size(), b.data(), b.size(), [&](size_t i, size_t j) {
+        KATANA_LOG_ASSERT(a[i] == b[j]);
+        KATANA_LOG_ASSERT(a[i] == expected[num_visited]);
+        ++num_visited;
+        return num_visited > limit;
+      });
+  KATANA_LOG_ASSERT(stopped == (limit < expected.size()));
+  KATANA_LOG_ASSERT(num_visited == std::min(limit + 1, expected.size()));
+}
+
+template <typename T>
+void
+TestIntersection(uint64_t universe) {
+  std::mt19937_64 gen(universe);
+  // Sizes around the block sizes of each instruction set, with similar and
+  // very different ratios
+  for (size_t na : {0, 1, 3, 4, 7, 8, 15, 16, 17, 33, 100, 1000}) {
+    for (size_t nb : {0, 1, 5, 8, 16, 31, 64, 250, 5000}) {
+      CheckPair(MakeSet<T>(&gen, na, universe), MakeSet<T>(&gen, nb, universe));
+    }
+  }
+
+  // Identical and disjoint sets
+  auto a = MakeSet<T>(&gen, 1000, universe);
+  CheckPair(a, a);
+  std::vector<T> evens;
+  std::vector<T> odds;
+  for (T x = 0; x < 2000; ++x) {
+    (x % 2 == 0 ? evens : odds).emplace_back(x);
+  }
+  CheckPair(evens, odds);
+}
+
+void
+TestBitmap() {
+  std::mt19937_64 gen(0);
+  constexpr uint64_t kUniverse = 10000;
+  katana::SetBitmap bitmap(kUniverse);
+  KATANA_LOG_ASSERT(bitmap.universe() >= kUniverse);
+
+  for (size_t i = 0; i < 10; ++i) {
+    auto a = MakeSet<uint32_t>(&gen, 500, kUniverse);
+    auto b = MakeSet<uint32_t>(&gen, 2000, kUniverse);
+    std::shuffle(b.begin(), b.end(), gen);
+
+    bitmap.Insert(a.data(), a.size());
+    size_t expected = 0;
+    for (auto x : b) {
+      expected += std::binary_search(a.begin(), a.end(), x);
+    }
+    KATANA_LOG_ASSERT(bitmap.Count(b.data(), b.size()) == expected);
+
+    size_t visited = 0;
+    bitmap.ForEachCommon(b.data(), b.size(), [&](uint32_t x) {
+      KATANA_LOG_ASSERT(std::binary_search(a.begin(), a.end(), x));
+      ++visited;
+    });
+    KATANA_LOG_ASSERT(visited == expected);
+
+    // Erasing leaves the bitmap empty for the next set
+    bitmap.Erase(a.data(), a.size());
+    KATANA_LOG_ASSERT(bitmap.Count(a.data(), a.size()) == 0);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  TestIntersection<uint32_t>(100);
+  TestIntersection<uint32_t>(1 << 20);
+  TestIntersection<uint64_t>(uint64_t{1} << 40);
+  TestBitmap();
+
+  return 0;
+}
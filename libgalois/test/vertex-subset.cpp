@@ -0,0 +1,179 @@
+#include "katana/VertexSubset.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+
+namespace {
+
+using Node = katana::VertexSubset::Node;
+
+constexpr uint64_t kUnvisited = std::numeric_limits<uint64_t>::max();
+
+struct LevelUpdate {
+  std::vector<uint64_t>* level;
+  uint64_t depth;
+
+  bool Cond(Node dst) const { return (*level)[dst] == kUnvisited; }
+
+  bool Update(Node, Node dst) const {
+    (*level)[dst] = depth;
+    return true;
+  }
+
+  bool UpdateAtomic(Node, Node dst) const {
+    uint64_t old = kUnvisited;
+    return __atomic_compare_exchange_n(
+        &(*level)[dst], &old, depth, false, __ATOMIC_RELAXED,
+        __ATOMIC_RELAXED);
+  }
+};
+
+/// BFS levels from node 0 by EdgeMap
+template <typename Graph>
+std::vector<uint64_t>
+EdgeMapLevels(
+    const Graph& graph, katana::EdgeMapDirection direction,
+    bool symmetric = false) {
+  std::vector<uint64_t> level(graph.num_nodes(), kUnvisited);
+  katana::EdgeMapOptions options;
+  options.direction = direction;
+  options.symmetric = symmetric;
+
+  katana::VertexSubset frontier(graph.num_nodes());
+  level[0] = 0;
+  frontier.push(0);
+  for (uint64_t depth = 1; !frontier.empty(); ++depth) {
+    frontier = katana::EdgeMap(
+        graph, &frontier, LevelUpdate{&level, depth}, options);
+  }
+  return level;
+}
+
+template <typename Graph>
+std::vector<uint64_t>
+SerialLevels(const Graph& graph) {
+  std::vector<uint64_t> level(graph.num_nodes(), kUnvisited);
+  std::vector<Node> queue{0};
+  level[0] = 0;
+  for (size_t i = 0; i < queue.size(); ++i) {
+    for (auto e : graph.edges(queue[i])) {
+      Node dst = graph.edge_dest(e);
+      if (level[dst] == kUnvisited) {
+        level[dst] = level[queue[i]] + 1;
+        queue.emplace_back(dst);
+      }
+    }
+  }
+  return level;
+}
+
+void
+TestConversions(uint64_t num_nodes) {
+  katana::VertexSubset subset(num_nodes);
+  KATANA_LOG_ASSERT(subset.empty());
+  for (Node n = 0; n < num_nodes; n += 3) {
+    subset.push(n);
+  }
+  uint64_t expected = (num_nodes + 2) / 3;
+  KATANA_LOG_ASSERT(!subset.IsDense());
+  KATANA_LOG_ASSERT(subset.size() == expected);
+
+  subset.ToDense();
+  KATANA_LOG_ASSERT(subset.IsDense());
+  KATANA_LOG_ASSERT(subset.size() == expected);
+  for (Node n = 0; n < num_nodes; ++n) {
+    KATANA_LOG_ASSERT(subset.contains(n) == (n % 3 == 0));
+  }
+
+  subset.ToSparse();
+  KATANA_LOG_ASSERT(!subset.IsDense());
+  std::vector<bool> seen(num_nodes, false);
+  for (Node n : subset.sparse()) {
+    KATANA_LOG_ASSERT(n % 3 == 0 && !seen[n]);
+    seen[n] = true;
+  }
+  KATANA_LOG_ASSERT(subset.size() == expected);
+
+  subset.clear();
+  KATANA_LOG_ASSERT(subset.empty());
+
+  katana::VertexSubset dense = katana::VertexSubset::MakeDense(num_nodes);
+  KATANA_LOG_ASSERT(dense.IsDense() && dense.empty());
+  dense.push(1);
+  dense.push(1);
+  KATANA_LOG_ASSERT(dense.size() == 1);
+}
+
+/// The graph with an edge in both directions for each edge of topo
+katana::GraphTopology
+MakeSymmetric(const katana::GraphTopology& topo) {
+  std::set<std::pair<Node, Node>> edges;
+  for (auto n : topo.all_nodes()) {
+    for (auto e : topo.edges(n)) {
+      Node dest = topo.edge_dest(e);
+      if (n != dest) {
+        edges.emplace(std::min(n, dest), std::max(n, dest));
+      }
+    }
+  }
+
+  katana::SymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(topo.num_nodes());
+  for (const auto& [src, dest] : edges) {
+    builder.AddEdge(src, dest);
+  }
+  return builder.ConvertToCSR();
+}
+
+void
+TestEdgeMap(katana::GraphTopology&& topo) {
+  auto expected = SerialLevels(topo);
+  for (auto direction :
+       {katana::EdgeMapDirection::kAuto, katana::EdgeMapDirection::kPush,
+        katana::EdgeMapDirection::kPull}) {
+    // A plain topology has no in edges, so it always pushes
+    KATANA_LOG_ASSERT(EdgeMapLevels(topo, direction) == expected);
+  }
+
+  auto symmetric = MakeSymmetric(topo);
+  auto symmetric_expected = SerialLevels(symmetric);
+  for (auto direction :
+       {katana::EdgeMapDirection::kAuto, katana::EdgeMapDirection::kPush,
+        katana::EdgeMapDirection::kPull}) {
+    KATANA_LOG_ASSERT(
+        EdgeMapLevels(symmetric, direction, true) == symmetric_expected);
+  }
+
+  auto res = katana::PropertyGraph::Make(std::move(topo));
+  KATANA_LOG_ASSERT(res);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(res.value());
+  auto bidir = pg->BuildView<katana::PropertyGraphViews::BiDirectional>();
+  for (auto direction :
+       {katana::EdgeMapDirection::kAuto, katana::EdgeMapDirection::kPush,
+        katana::EdgeMapDirection::kPull}) {
+    KATANA_LOG_ASSERT(EdgeMapLevels(bidir, direction) == expected);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestConversions(1000);
+  TestConversions(64);
+  TestEdgeMap(katana::CreateUniformRandomTopology(1000, 5));
+  TestEdgeMap(katana::CreateUniformRandomTopology(5000, 1));
+
+  return 0;
+}
@@ -0,0 +1,575 @@
+#ifndef KATANA_LIBSUPPORT_KATANA_SHARDEDCACHE_H_
+#define KATANA_LIBSUPPORT_KATANA_SHARDEDCACHE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/ProgressTracer.h"
+#include "katana/Time.h"
+
+namespace katana {
+
+/// A thread-safe cache with a byte budget, meant for values like property
+/// columns that are large and expensive to reload. (Cache is the single
+/// threaded version for small values.)
+///
+/// Entries are spread over independently locked shards by key hash. The byte
+/// budget is shared by all shards. Keys may also be sorted into groups (e.g.,
+/// the properties of one RDG) that each have their own byte budget.
+///
+/// Admission follows 2Q: an entry starts out on probation and is promoted to
+/// the protected segment when it is hit again, or when it is reinserted soon
+/// after being evicted from probation. Entries on probation are evicted
+/// first, so scanning many values once does not flush the ones that are used
+/// over and over.
+///
+/// Pinned entries are never evicted; the budget is exceeded rather than
+/// evicting them. Pins are held by an owner (any pointer that is stable for
+/// the life of the pins) so that an owner can drop all of its pins at once.
+template <typename Key, typename Value, typename CallerPointer = void*>
+class KATANA_EXPORT ShardedCache {
+public:
+  using Group = std::string;
+  using EvictCallback = std::function<void(
+      const Key& key, uint64_t approx_bytes, CallerPointer caller)>;
+
+  struct Config {
+    /// Budget for the bytes of all entries
+    size_t capacity_bytes{0};
+    /// Budget for the bytes of the entries of any one group; 0 means none
+    size_t group_capacity_bytes{0};
+    /// Number of independently locked shards
+    uint32_t num_shards{16};
+    /// Share of the budget that entries on probation may use before they are
+    /// evicted in preference to protected entries
+    double probation_fraction{0.25};
+    /// Number of keys evicted from probation that each shard remembers
+    size_t ghost_entries_per_shard{256};
+  };
+
+  struct Stats {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t inserts{0};
+    uint64_t promotions{0};
+    uint64_t evictions{0};
+    uint64_t evicted_bytes{0};
+    uint64_t bytes{0};
+  };
+
+  /// Construct a cache; value_to_bytes estimates the size of a value and
+  /// key_to_group, if given, names the group of a key
+  ShardedCache(
+      const Config& config,
+      std::function<size_t(const Value& value)> value_to_bytes,
+      std::function<Group(const Key& key)> key_to_group = nullptr,
+      EvictCallback evict_cb = nullptr)
+      : config_(config),
+        value_to_bytes_(std::move(value_to_bytes)),
+        key_to_group_(std::move(key_to_group)),
+        evict_cb_(std::move(evict_cb)) {
+    KATANA_LOG_VASSERT(
+        config_.capacity_bytes > 0, "cache requires positive capacity");
+    KATANA_LOG_VASSERT(
+        value_to_bytes_ != nullptr, "cache requires value to bytes function");
+    KATANA_LOG_VASSERT(config_.num_shards > 0, "cache requires shards");
+    for (uint32_t i = 0; i < config_.num_shards; ++i) {
+      shards_.emplace_back(std::make_unique<Shard>());
+    }
+    probation_share_ = static_cast<size_t>(
+        config_.probation_fraction * config_.capacity_bytes /
+        config_.num_shards);
+  }
+
+  /// Construct a cache that holds a fixed number of bytes with default
+  /// sharding and admission
+  ShardedCache(
+      size_t capacity_bytes,
+      std::function<size_t(const Value& value)> value_to_bytes,
+      EvictCallback evict_cb = nullptr)
+      : ShardedCache(
+            Config{.capacity_bytes = capacity_bytes}, std::move(value_to_bytes),
+            nullptr, std::move(evict_cb)) {}
+
+  ShardedCache(const ShardedCache& no_copy) = delete;
+  ShardedCache& operator=(const ShardedCache& no_copy) = delete;
+
+  /// Total bytes of all entries
+  size_t size() const { return total_bytes_.load(std::memory_order_relaxed); }
+
+  size_t capacity() const { return config_.capacity_bytes; }
+
+  bool Empty() const { return NumEntries() == 0; }
+
+  size_t NumEntries() const {
+    size_t num = 0;
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      num += shard->entries.size();
+    }
+    return num;
+  }
+
+  bool Contains(const Key& key) const {
+    const Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.entries.find(key) != shard.entries.end();
+  }
+
+  std::optional<Value> Get(const Key& key) { return DoGet(key, nullptr); }
+
+  /// Get the value for key and, if it is present, pin it on behalf of owner
+  std::optional<Value> GetAndPin(const Key& key, const void* owner) {
+    KATANA_LOG_DEBUG_ASSERT(owner != nullptr);
+    return DoGet(key, owner);
+  }
+
+  void Insert(
+      const Key& key, const Value& value, CallerPointer caller = nullptr) {
+    DoInsert(key, value, nullptr, caller);
+  }
+
+  /// Insert value for key and pin it on behalf of owner
+  void InsertAndPin(
+      const Key& key, const Value& value, const void* owner,
+      CallerPointer caller = nullptr) {
+    KATANA_LOG_DEBUG_ASSERT(owner != nullptr);
+    DoInsert(key, value, owner, caller);
+  }
+
+  /// Drop one pin that owner holds on key
+  void Unpin(const Key& key, const void* owner, CallerPointer caller = nullptr) {
+    {
+      Shard& shard = ShardFor(key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      auto it = shard.entries.find(key);
+      if (it == shard.entries.end()) {
+        return;
+      }
+      auto& pinners = it->second.pinners;
+      auto pin_it = std::find(pinners.begin(), pinners.end(), owner);
+      if (pin_it != pinners.end()) {
+        pinners.erase(pin_it);
+      }
+    }
+    EnforceBudgets(nullptr, caller);
+  }
+
+  /// Drop every pin that owner holds
+  void UnpinAll(const void* owner, CallerPointer caller = nullptr) {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      for (auto& [key, entry] : shard->entries) {
+        auto& pinners = entry.pinners;
+        pinners.erase(
+            std::remove(pinners.begin(), pinners.end(), owner), pinners.end());
+      }
+    }
+    EnforceBudgets(nullptr, caller);
+  }
+
+  bool IsPinned(const Key& key) const {
+    const Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    return it != shard.entries.end() && !it->second.pinners.empty();
+  }
+
+  Stats GetStats() const {
+    return Stats{
+        .hits = hits_.load(std::memory_order_relaxed),
+        .misses = misses_.load(std::memory_order_relaxed),
+        .inserts = inserts_.load(std::memory_order_relaxed),
+        .promotions = promotions_.load(std::memory_order_relaxed),
+        .evictions = evictions_.load(std::memory_order_relaxed),
+        .evicted_bytes = evicted_bytes_.load(std::memory_order_relaxed),
+        .bytes = total_bytes_.load(std::memory_order_relaxed),
+    };
+  }
+
+  /// Statistics for the entries of one group; promotions are not tracked
+  /// per group
+  Stats GetGroupStats(const Group& group) const {
+    std::shared_lock<std::shared_mutex> lock(groups_mutex_);
+    auto it = groups_.find(group);
+    if (it == groups_.end()) {
+      return Stats{};
+    }
+    return it->second->ToStats();
+  }
+
+  /// Log hit, miss and eviction counts, in total and for each group, to the
+  /// active span of the tracer
+  void LogStats(const std::string& message) const {
+    Stats stats = GetStats();
+    auto& span = katana::GetTracer().GetActiveSpan();
+    span.Log(
+        message,
+        {{"cache_hits", stats.hits},
+         {"cache_misses", stats.misses},
+         {"cache_inserts", stats.inserts},
+         {"cache_promotions", stats.promotions},
+         {"cache_evictions", stats.evictions},
+         {"cache_evicted_bytes", stats.evicted_bytes},
+         {"cache_bytes", stats.bytes},
+         {"cache_bytes_human", katana::BytesToStr("{:.2f}{}", stats.bytes)},
+         {"cache_capacity", config_.capacity_bytes}});
+
+    std::shared_lock<std::shared_mutex> lock(groups_mutex_);
+    for (const auto& [group, state] : groups_) {
+      Stats group_stats = state->ToStats();
+      span.Log(
+          message,
+          {{"cache_group", group},
+           {"cache_hits", group_stats.hits},
+           {"cache_misses", group_stats.misses},
+           {"cache_inserts", group_stats.inserts},
+           {"cache_evictions", group_stats.evictions},
+           {"cache_evicted_bytes", group_stats.evicted_bytes},
+           {"cache_bytes", group_stats.bytes},
+           {"cache_bytes_human",
+            katana::BytesToStr("{:.2f}{}", group_stats.bytes)}});
+    }
+  }
+
+private:
+  struct GroupState {
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> inserts{0};
+    std::atomic<uint64_t> evictions{0};
+    std::atomic<uint64_t> evicted_bytes{0};
+    std::atomic<uint64_t> bytes{0};
+
+    Stats ToStats() const {
+      return Stats{
+          .hits = hits.load(std::memory_order_relaxed),
+          .misses = misses.load(std::memory_order_relaxed),
+          .inserts = inserts.load(std::memory_order_relaxed),
+          .evictions = evictions.load(std::memory_order_relaxed),
+          .evicted_bytes = evicted_bytes.load(std::memory_order_relaxed),
+          .bytes = bytes.load(std::memory_order_relaxed),
+      };
+    }
+  };
+
+  using ListType = std::list<Key>;
+
+  struct Entry {
+    Value value;
+    size_t bytes{0};
+    bool on_probation{true};
+    // This allows us to delete the old position in the lists without a scan
+    typename ListType::iterator list_it;
+    GroupState* group{nullptr};
+    std::vector<const void*> pinners;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Entry, typename Key::Hash> entries;
+    // front is the most recently used (protected) or inserted (probation)
+    ListType probation;
+    ListType protected_lru;
+    size_t probation_bytes{0};
+    // keys recently evicted from probation, front is the most recent
+    ListType ghosts;
+    std::unordered_map<Key, typename ListType::iterator, typename Key::Hash>
+        ghost_index;
+  };
+
+  struct Evicted {
+    Key key;
+    Value value;
+    size_t bytes;
+  };
+
+  Shard& ShardFor(const Key& key) {
+    return *shards_[ShardIndex(key)];
+  }
+  const Shard& ShardFor(const Key& key) const {
+    return *shards_[ShardIndex(key)];
+  }
+  size_t ShardIndex(const Key& key) const {
+    size_t hash = typename Key::Hash()(key);
+    // the low bits of hash also pick the bucket inside the shard's map
+    return (hash ^ (hash >> 17)) % shards_.size();
+  }
+
+  GroupState* GetGroupState(const Key& key) {
+    Group group = key_to_group_ ? key_to_group_(key) : Group();
+    {
+      std::shared_lock<std::shared_mutex> lock(groups_mutex_);
+      if (auto it = groups_.find(group); it != groups_.end()) {
+        return it->second.get();
+      }
+    }
+    std::lock_guard<std::shared_mutex> lock(groups_mutex_);
+    auto& state = groups_[group];
+    if (!state) {
+      state = std::make_unique<GroupState>();
+    }
+    return state.get();
+  }
+
+  std::optional<Value> DoGet(const Key& key, const void* owner) {
+    GroupState* group = GetGroupState(key);
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end()) {
+      misses_.fetch_add(1, std::memory_order_relaxed);
+      group->misses.fetch_add(1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    group->hits.fetch_add(1, std::memory_order_relaxed);
+    Touch(&shard, &it->second);
+    if (owner != nullptr) {
+      it->second.pinners.emplace_back(owner);
+    }
+    return it->second.value;
+  }
+
+  void DoInsert(
+      const Key& key, const Value& value, const void* owner,
+      CallerPointer caller) {
+    size_t bytes = value_to_bytes_(value);
+    GroupState* group = GetGroupState(key);
+    {
+      Shard& shard = ShardFor(key);
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      inserts_.fetch_add(1, std::memory_order_relaxed);
+      group->inserts.fetch_add(1, std::memory_order_relaxed);
+
+      auto it = shard.entries.find(key);
+      if (it != shard.entries.end()) {
+        Entry& entry = it->second;
+        RemoveBytes(&shard, entry);
+        entry.value = value;
+        entry.bytes = bytes;
+        AddBytes(&shard, entry);
+        Touch(&shard, &entry);
+      } else {
+        Entry entry;
+        entry.value = value;
+        entry.bytes = bytes;
+        entry.group = group;
+        if (auto ghost_it = shard.ghost_index.find(key);
+            ghost_it != shard.ghost_index.end()) {
+          // evicted from probation but wanted again: it is not a one-off
+          shard.ghosts.erase(ghost_it->second);
+          shard.ghost_index.erase(ghost_it);
+          entry.on_probation = false;
+          shard.protected_lru.push_front(key);
+          entry.list_it = shard.protected_lru.begin();
+          promotions_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          shard.probation.push_front(key);
+          entry.list_it = shard.probation.begin();
+        }
+        AddBytes(&shard, entry);
+        it = shard.entries.emplace(key, std::move(entry)).first;
+      }
+      if (owner != nullptr) {
+        it->second.pinners.emplace_back(owner);
+      }
+    }
+    EnforceBudgets(&key, caller);
+  }
+
+  /// Record a hit on entry; shard's lock must be held
+  void Touch(Shard* shard, Entry* entry) {
+    if (entry->on_probation) {
+      shard->protected_lru.splice(
+          shard->protected_lru.begin(), shard->probation, entry->list_it);
+      entry->list_it = shard->protected_lru.begin();
+      entry->on_probation = false;
+      shard->probation_bytes -= entry->bytes;
+      promotions_.fetch_add(1, std::memory_order_relaxed);
+    } else if (entry->list_it != shard->protected_lru.begin()) {
+      shard->protected_lru.splice(
+          shard->protected_lru.begin(), shard->protected_lru, entry->list_it);
+      entry->list_it = shard->protected_lru.begin();
+    }
+  }
+
+  void AddBytes(Shard* shard, const Entry& entry) {
+    if (entry.on_probation) {
+      shard->probation_bytes += entry.bytes;
+    }
+    total_bytes_.fetch_add(entry.bytes, std::memory_order_relaxed);
+    entry.group->bytes.fetch_add(entry.bytes, std::memory_order_relaxed);
+  }
+
+  void RemoveBytes(Shard* shard, const Entry& entry) {
+    if (entry.on_probation) {
+      shard->probation_bytes -= entry.bytes;
+    }
+    total_bytes_.fetch_sub(entry.bytes, std::memory_order_relaxed);
+    entry.group->bytes.fetch_sub(entry.bytes, std::memory_order_relaxed);
+  }
+
+  /// Find the least recently used entry of list that may be evicted; shard's
+  /// lock must be held
+  typename std::unordered_map<Key, Entry, typename Key::Hash>::iterator
+  FindVictim(
+      Shard* shard, const ListType& list, const Key* keep,
+      const GroupState* group) {
+    for (auto it = list.rbegin(); it != list.rend(); ++it) {
+      if (keep != nullptr && *it == *keep) {
+        continue;
+      }
+      auto entry_it = shard->entries.find(*it);
+      KATANA_LOG_DEBUG_ASSERT(entry_it != shard->entries.end());
+      const Entry& entry = entry_it->second;
+      if (entry.pinners.empty() && (group == nullptr || entry.group == group)) {
+        return entry_it;
+      }
+    }
+    return shard->entries.end();
+  }
+
+  /// Evict one entry from shard. With only_excess_probation, only evict from
+  /// probation and only if it holds more than its share; otherwise prefer
+  /// protected entries since probation is within its share. shard's lock must
+  /// be held.
+  bool EvictOne(
+      Shard* shard, bool only_excess_probation, const Key* keep,
+      const GroupState* group, std::vector<Evicted>* evicted) {
+    auto victim = shard->entries.end();
+    if (only_excess_probation) {
+      if (shard->probation_bytes > probation_share_) {
+        victim = FindVictim(shard, shard->probation, keep, group);
+      }
+    } else {
+      victim = FindVictim(shard, shard->protected_lru, keep, group);
+      if (victim == shard->entries.end()) {
+        victim = FindVictim(shard, shard->probation, keep, group);
+      }
+    }
+    if (victim == shard->entries.end()) {
+      return false;
+    }
+
+    Entry& entry = victim->second;
+    RemoveBytes(shard, entry);
+    if (entry.on_probation) {
+      shard->probation.erase(entry.list_it);
+      shard->ghosts.push_front(victim->first);
+      shard->ghost_index[victim->first] = shard->ghosts.begin();
+      while (shard->ghosts.size() > config_.ghost_entries_per_shard) {
+        shard->ghost_index.erase(shard->ghosts.back());
+        shard->ghosts.pop_back();
+      }
+    } else {
+      shard->protected_lru.erase(entry.list_it);
+    }
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+    evicted_bytes_.fetch_add(entry.bytes, std::memory_order_relaxed);
+    entry.group->evictions.fetch_add(1, std::memory_order_relaxed);
+    entry.group->evicted_bytes.fetch_add(entry.bytes, std::memory_order_relaxed);
+
+    // values are destroyed outside of the lock since freeing them may be slow
+    evicted->emplace_back(
+        Evicted{victim->first, std::move(entry.value), entry.bytes});
+    shard->entries.erase(victim);
+    return true;
+  }
+
+  /// Evict entries, visiting shards round robin, while over_budget is true
+  /// and there is something left to evict
+  void EvictWhile(
+      const std::function<bool()>& over_budget, const Key* keep,
+      const GroupState* group, std::vector<Evicted>* evicted) {
+    for (bool only_excess_probation : {true, false}) {
+      bool progress = true;
+      while (progress && over_budget()) {
+        progress = false;
+        for (size_t i = 0; i < shards_.size() && over_budget(); ++i) {
+          Shard& shard = *shards_
+              [next_victim_shard_.fetch_add(1, std::memory_order_relaxed) %
+               shards_.size()];
+          std::lock_guard<std::mutex> lock(shard.mutex);
+          progress |=
+              EvictOne(&shard, only_excess_probation, keep, group, evicted);
+        }
+      }
+    }
+  }
+
+  /// Evict until the global budget and every group budget are met; keep, if
+  /// given, is not evicted so that a single entry may exceed a budget
+  void EnforceBudgets(const Key* keep, CallerPointer caller) {
+    std::vector<Evicted> evicted;
+    EvictWhile(
+        [this]() {
+          return total_bytes_.load(std::memory_order_relaxed) >
+                 config_.capacity_bytes;
+        },
+        keep, nullptr, &evicted);
+
+    if (config_.group_capacity_bytes > 0) {
+      std::vector<GroupState*> over;
+      {
+        std::shared_lock<std::shared_mutex> lock(groups_mutex_);
+        for (const auto& [name, state] : groups_) {
+          if (state->bytes.load(std::memory_order_relaxed) >
+              config_.group_capacity_bytes) {
+            over.emplace_back(state.get());
+          }
+        }
+      }
+      for (GroupState* group : over) {
+        EvictWhile(
+            [this, group]() {
+              return group->bytes.load(std::memory_order_relaxed) >
+                     config_.group_capacity_bytes;
+            },
+            keep, group, &evicted);
+      }
+    }
+
+    if (evict_cb_) {
+      for (const Evicted& e : evicted) {
+        evict_cb_(e.key, e.bytes, caller);
+      }
+    }
+  }
+
+  Config config_;
+  size_t probation_share_{0};
+  std::function<size_t(const Value& value)> value_to_bytes_;
+  std::function<Group(const Key& key)> key_to_group_;
+  EvictCallback evict_cb_;
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<size_t> next_victim_shard_{0};
+  std::atomic<size_t> total_bytes_{0};
+
+  // group states are never removed so entries can point to them
+  mutable std::shared_mutex groups_mutex_;
+  std::unordered_map<Group, std::unique_ptr<GroupState>> groups_;
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> inserts_{0};
+  std::atomic<uint64_t> promotions_{0};
+  std::atomic<uint64_t> evictions_{0};
+  std::atomic<uint64_t> evicted_bytes_{0};
+};
+
+}  // namespace katana
+
+#endif
@@ -0,0 +1,209 @@
+#include "katana/ShardedCache.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/container_hash/hash.hpp>
+
+#include "katana/Logging.h"
+
+namespace {
+
+struct TestKey {
+  std::string group;
+  int id;
+
+  TestKey(std::string _group, int _id) : group(std::move(_group)), id(_id) {}
+
+  bool operator==(const TestKey& o) const {
+    return group == o.group && id == o.id;
+  }
+  struct Hash {
+    std::size_t operator()(const TestKey& k) const {
+      std::size_t seed = 0;
+      boost::hash_combine(seed, boost::hash_value(k.group));
+      boost::hash_combine(seed, boost::hash_value(k.id));
+      return seed;
+    }
+  };
+};
+
+// the value is its size in bytes
+using TestCache = katana::ShardedCache<TestKey, size_t>;
+
+size_t
+ValueBytes(const size_t& value) {
+  return value;
+}
+
+std::string
+KeyGroup(const TestKey& key) {
+  return key.group;
+}
+
+TestCache::Config
+MakeConfig(size_t capacity, uint32_t num_shards) {
+  TestCache::Config config;
+  config.capacity_bytes = capacity;
+  config.num_shards = num_shards;
+  return config;
+}
+
+void
+TestBudget() {
+  uint64_t evictions = 0;
+  TestCache cache(
+      MakeConfig(10, 4), ValueBytes, nullptr,
+      [&](const TestKey&, uint64_t approx_bytes, void*) {
+        KATANA_LOG_ASSERT(approx_bytes == 2);
+        ++evictions;
+      });
+
+  for (int i = 0; i < 5; ++i) {
+    cache.Insert(TestKey("g", i), 2);
+  }
+  KATANA_LOG_ASSERT(cache.size() == 10);
+  KATANA_LOG_ASSERT(evictions == 0);
+
+  cache.Insert(TestKey("g", 5), 2);
+  KATANA_LOG_ASSERT(cache.size() == 10);
+  KATANA_LOG_ASSERT(evictions == 1);
+  KATANA_LOG_ASSERT(cache.Contains(TestKey("g", 5)));
+
+  auto value = cache.Get(TestKey("g", 5));
+  KATANA_LOG_ASSERT(value && value.value() == 2);
+  KATANA_LOG_ASSERT(!cache.Get(TestKey("g", 100)));
+
+  auto stats = cache.GetStats();
+  KATANA_LOG_ASSERT(stats.hits == 1);
+  KATANA_LOG_ASSERT(stats.misses == 1);
+  KATANA_LOG_ASSERT(stats.evictions == 1);
+  KATANA_LOG_ASSERT(stats.evicted_bytes == 2);
+
+  // a single entry may exceed the budget
+  cache.Insert(TestKey("g", 6), 20);
+  KATANA_LOG_ASSERT(cache.Contains(TestKey("g", 6)));
+  KATANA_LOG_ASSERT(cache.NumEntries() == 1);
+}
+
+void
+TestScanResistance() {
+  TestCache cache(MakeConfig(20, 2), ValueBytes);
+
+  // hot entries are used twice and so are promoted out of probation
+  for (int i = 0; i < 5; ++i) {
+    cache.Insert(TestKey("hot", i), 2);
+    KATANA_LOG_ASSERT(cache.Get(TestKey("hot", i)));
+  }
+  KATANA_LOG_ASSERT(cache.GetStats().promotions == 5);
+
+  // a scan touches many entries once
+  for (int i = 0; i < 100; ++i) {
+    cache.Insert(TestKey("scan", i), 2);
+  }
+
+  for (int i = 0; i < 5; ++i) {
+    KATANA_LOG_ASSERT(cache.Contains(TestKey("hot", i)));
+  }
+  KATANA_LOG_ASSERT(cache.size() <= 20);
+
+  // an entry reinserted soon after eviction is no longer on probation
+  uint64_t promotions = cache.GetStats().promotions;
+  cache.Insert(TestKey("scan", 0), 2);
+  KATANA_LOG_ASSERT(cache.GetStats().promotions == promotions + 1);
+}
+
+void
+TestPins() {
+  TestCache cache(MakeConfig(4, 2), ValueBytes);
+  int owner1 = 0;
+  int owner2 = 0;
+
+  cache.InsertAndPin(TestKey("g", 0), 2, &owner1);
+  KATANA_LOG_ASSERT(cache.GetAndPin(TestKey("g", 0), &owner2));
+  cache.InsertAndPin(TestKey("g", 1), 2, &owner1);
+  cache.Insert(TestKey("g", 2), 2);
+
+  // everything but the unpinned entry stays even though we are over budget
+  cache.Insert(TestKey("g", 3), 2);
+  KATANA_LOG_ASSERT(cache.Contains(TestKey("g", 0)));
+  KATANA_LOG_ASSERT(cache.Contains(TestKey("g", 1)));
+  KATANA_LOG_ASSERT(!cache.Contains(TestKey("g", 2)));
+  KATANA_LOG_ASSERT(cache.size() == 6);
+
+  // owner2 still pins the first entry
+  cache.UnpinAll(&owner1);
+  KATANA_LOG_ASSERT(cache.IsPinned(TestKey("g", 0)));
+  KATANA_LOG_ASSERT(!cache.IsPinned(TestKey("g", 1)));
+  KATANA_LOG_ASSERT(cache.Contains(TestKey("g", 0)));
+  KATANA_LOG_ASSERT(cache.size() == 4);
+
+  cache.Unpin(TestKey("g", 0), &owner2);
+  KATANA_LOG_ASSERT(!cache.IsPinned(TestKey("g", 0)));
+}
+
+void
+TestGroupBudget() {
+  TestCache::Config config = MakeConfig(100, 4);
+  config.group_capacity_bytes = 6;
+  TestCache cache(config, ValueBytes, KeyGroup);
+
+  for (int i = 0; i < 3; ++i) {
+    cache.Insert(TestKey("a", i), 2);
+    cache.Insert(TestKey("b", i), 2);
+  }
+  cache.Insert(TestKey("a", 3), 2);
+
+  KATANA_LOG_ASSERT(cache.GetGroupStats("a").bytes == 6);
+  KATANA_LOG_ASSERT(cache.GetGroupStats("a").evictions == 1);
+  KATANA_LOG_ASSERT(cache.GetGroupStats("b").bytes == 6);
+  KATANA_LOG_ASSERT(cache.GetGroupStats("b").evictions == 0);
+  for (int i = 0; i < 3; ++i) {
+    KATANA_LOG_ASSERT(cache.Contains(TestKey("b", i)));
+  }
+}
+
+void
+TestConcurrent() {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumOps = 2000;
+  constexpr int kNumKeys = 64;
+  TestCache cache(MakeConfig(64, 8), ValueBytes);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&cache, t]() {
+      for (int i = 0; i < kNumOps; ++i) {
+        TestKey key("g", (i * 7 + t) % kNumKeys);
+        if (!cache.GetAndPin(key, &cache)) {
+          cache.Insert(key, 2);
+        } else {
+          cache.Unpin(key, &cache);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto stats = cache.GetStats();
+  KATANA_LOG_ASSERT(stats.hits + stats.misses == kNumThreads * kNumOps);
+  KATANA_LOG_ASSERT(stats.inserts == stats.misses);
+  KATANA_LOG_ASSERT(cache.size() <= 64);
+  KATANA_LOG_ASSERT(cache.size() == 2 * cache.NumEntries());
+}
+
+}  // namespace
+
+int
+main() {
+  TestBudget();
+  TestScanResistance();
+  TestPins();
+  TestGroupBudget();
+  TestConcurrent();
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+#ifndef KATANA_LIBTSUBA_TSUBA_ARROWIPC_H_
+#define KATANA_LIBTSUBA_TSUBA_ARROWIPC_H_
+
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+#include "tsuba/WriteGroup.h"
+
+namespace tsuba {
+
+/// How a property is stored
+enum class PropertyFormat {
+  /// Compressed and encoded; the smallest on disk, but every load decodes it
+  /// into new buffers
+  kParquet,
+  /// The Arrow IPC file format (Feather V2): uncompressed Arrow buffers that
+  /// are used in place when loaded, see ReadArrowIPC. Best for fixed width
+  /// properties that are loaded often.
+  kArrowIPC,
+};
+
+/// Writes tables in the Arrow IPC file format. Columns are combined into one
+/// record batch so that readers get one chunk per column without copying.
+class KATANA_EXPORT ArrowIPCWriter {
+public:
+  /// Suffix of the files written for properties, which identifies their
+  /// format on load
+  static constexpr const char* kSuffix = ".arrow";
+
+  /// \returns a Writer that will write a table consisting of a single column
+  /// \param array will become the lone column in the table
+  /// \param name will become the name of the column in the table
+  static katana::Result<std::unique_ptr<ArrowIPCWriter>> Make(
+      const std::shared_ptr<arrow::ChunkedArray>& array,
+      const std::string& name);
+
+  static katana::Result<std::unique_ptr<ArrowIPCWriter>> Make(
+      std::shared_ptr<arrow::Table> table);
+
+  /// write table out to a storage location. If `group` is null,
+  /// the write is synchronous, if not an asynchronous write is started to be
+  /// managed by group
+  katana::Result<void> WriteToUri(
+      const katana::Uri& uri, WriteGroup* group = nullptr);
+
+private:
+  explicit ArrowIPCWriter(std::shared_ptr<arrow::Table> table)
+      : table_(std::move(table)) {}
+
+  std::shared_ptr<arrow::Table> table_;
+};
+
+/// \returns true if path names a file written by ArrowIPCWriter for a
+/// property
+KATANA_EXPORT bool IsArrowIPCPath(const std::string& path);
+
+/// Read a table written by ArrowIPCWriter. Files on the local file system are
+/// mapped read-only and the table's buffers point into the mapping, so the
+/// cost of a load does not depend on the size of the table and every process
+/// that loads the file shares its pages. Other files are read into memory
+/// once and used in place.
+///
+/// The buffers of the table must not be modified.
+KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> ReadArrowIPC(
+    const katana::Uri& uri);
+
+}  // namespace tsuba
+
+#endif
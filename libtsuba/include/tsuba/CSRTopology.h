@@ -2,8 +2,11 @@
 #define KATANA_LIBTSUBA_TSUBA_CSRTOPOLOGY_H_
 
 #include <cstdint>
+#include <vector>
 
 #include "katana/BitMath.h"
+#include "katana/Result.h"
+#include "katana/config.h"
 
 namespace tsuba {
 
@@ -11,6 +14,10 @@ namespace tsuba {
 /// files used to have the file extension .gr (a name tradition continued here)
 /// The structs in this file describe how these GR files are laid out
 
+/// Version of CSR files whose destinations are compressed. See
+/// CSRCompressedHeader.
+constexpr uint64_t kCompressedCSRVersion = 3;
+
 /// The metadata block at the head of every CSR file
 struct CSRTopologyHeader {
   uint64_t version{0};
@@ -35,6 +42,91 @@ CSRTopologyFileSize(const CSRTopologyHeader& header) {
          (header.num_edges * header.edge_type_size);
 }
 
+/// Compressed CSR files (version kCompressedCSRVersion) replace the out index
+/// and destination arrays with independently decodable blocks of nodes:
+///
+///   CSRTopologyHeader header
+///   CSRCompressedHeader compressed_header
+///   CSRBlockIndexEntry[num_blocks + 1] block_index
+///   uint8_t[] block data
+///
+/// A block holds, for each of its nodes, the node's degree followed by the
+/// difference between each destination and the previous one (the first
+/// destination is relative to the node itself). Degrees and differences are
+/// zigzag encoded LEB128 varints, so neighbors with nearby ids take one or
+/// two bytes per edge rather than four. Edges keep their order, so edge
+/// property indexes are unaffected.
+struct CSRCompressedHeader {
+  uint64_t nodes_per_block{0};
+  uint64_t num_blocks{0};
+};
+
+/// Where block i starts. Entry num_blocks marks the end of the last block.
+struct CSRBlockIndexEntry {
+  /// offset of the block from the start of the block data
+  uint64_t data_offset{0};
+  /// index of the first edge of the block
+  uint64_t first_edge{0};
+};
+
+/// Append the compressed adjacency of nodes [first_node, last_node) to out.
+/// The encoding does not depend on the width of the destinations.
+KATANA_EXPORT void EncodeCSRBlock(
+    const uint64_t* out_indexes, const uint32_t* out_dests, uint64_t first_node,
+    uint64_t last_node, std::vector<uint8_t>* out);
+KATANA_EXPORT void EncodeCSRBlock(
+    const uint64_t* out_indexes, const uint64_t* out_dests, uint64_t first_node,
+    uint64_t last_node, std::vector<uint8_t>* out);
+
+/// A read-only view of the blocks of a compressed CSR file in memory
+class KATANA_EXPORT CompressedCSRView {
+public:
+  /// Validate the headers and block index of the compressed CSR file in
+  /// [data, data + size)
+  static katana::Result<CompressedCSRView> Make(
+      const uint8_t* data, uint64_t size);
+
+  const CSRTopologyHeader& header() const { return *header_; }
+  uint64_t num_blocks() const { return compressed_header_->num_blocks; }
+  uint64_t nodes_per_block() const {
+    return compressed_header_->nodes_per_block;
+  }
+
+  /// The index of the first edge of block. Block num_blocks() is the end of
+  /// the last block.
+  uint64_t block_first_edge(uint64_t block) const {
+    return index_[block].first_edge;
+  }
+
+  /// Decode block into the full size out index and destination arrays. Blocks
+  /// write disjoint parts of the arrays, so they may be decoded in parallel.
+  katana::Result<void> DecodeBlock(
+      uint64_t block, uint64_t* out_indexes, uint32_t* out_dests) const;
+  katana::Result<void> DecodeBlock(
+      uint64_t block, uint64_t* out_indexes, uint64_t* out_dests) const;
+
+  /// Like DecodeBlock but write the destinations of the edges of block to
+  /// block_dests starting at index 0, so that a block can be decoded into a
+  /// buffer of just its edges rather than into a full destination array
+  katana::Result<void> DecodeBlockLocal(
+      uint64_t block, uint64_t* out_indexes, uint32_t* block_dests) const;
+  katana::Result<void> DecodeBlockLocal(
+      uint64_t block, uint64_t* out_indexes, uint64_t* block_dests) const;
+
+private:
+  const CSRTopologyHeader* header_{nullptr};
+  const CSRCompressedHeader* compressed_header_{nullptr};
+  const CSRBlockIndexEntry* index_{nullptr};
+  const uint8_t* block_data_{nullptr};
+
+  /// Decode block, writing the destination of edge e to
+  /// out_dests[e - first_dest]
+  template <typename Dest>
+  katana::Result<void> DoDecodeBlock(
+      uint64_t block, uint64_t* out_indexes, Dest* out_dests,
+      uint64_t first_dest) const;
+};
+
 }  // namespace tsuba
 
 #endif
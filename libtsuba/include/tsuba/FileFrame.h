@@ -67,6 +67,8 @@ public:
   katana::Result<void> Destroy();
 
   katana::Result<void> Persist();
+  /// Persist on tsuba's I/O executor. The frame must outlive the returned
+  /// future.
   std::future<katana::CopyableResult<void>> PersistAsync();
 
   uint64_t map_size() const { return map_size_; }
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <future>
+#include <memory>
 #include <optional>
 #include <string>
 
@@ -16,6 +17,9 @@ namespace tsuba {
 
 class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
 public:
+  /// Access pattern hints for views bound with BindMapped, see madvise(2)
+  enum class AccessHint { kNormal, kSequential, kRandom, kWillNeed };
+
   FileView() = default;
   FileView(const FileView&) = delete;
   FileView& operator=(const FileView&) = delete;
@@ -28,9 +32,12 @@ public:
         mem_start_(other.mem_start_),
         filename_(std::move(other.filename_)),
         bound_(other.bound_),
+        mapped_(other.mapped_),
+        mapping_(std::move(other.mapping_)),
         filling_(std::move(other.filling_)),
         fetches_(std::move(other.fetches_)) {
     other.bound_ = false;
+    other.mapped_ = false;
   }
 
   FileView& operator=(FileView&& other) noexcept {
@@ -45,10 +52,13 @@ public:
       mem_start_ = other.mem_start_;
       filename_ = std::move(other.filename_);
       bound_ = other.bound_;
+      mapped_ = other.mapped_;
+      mapping_ = std::move(other.mapping_);
       filling_ = std::move(other.filling_);
       fetches_ =
           std::unique_ptr<std::vector<FillingRange>>(std::move(other.fetches_));
       other.bound_ = false;
+      other.mapped_ = false;
     }
     return *this;
   }
@@ -75,10 +85,30 @@ public:
     return Bind(filename, 0, std::numeric_limits<uint64_t>::max(), resolve);
   }
 
+  /// Map a file on the local file system read-only instead of reading it into
+  /// private memory. Pages are faulted in from the page cache on first access
+  /// and are shared with every other process that maps the same file, so
+  /// pointers returned by ptr() must never be written through.
+  /// \param filename path or file:// URI of a local file
+  katana::Result<void> BindMapped(std::string_view filename);
+
+  /// Pass an access pattern hint for the whole file to the kernel. Only has
+  /// an effect on views bound with BindMapped.
+  katana::Result<void> Advise(AccessHint hint) const;
+
   katana::Result<void> Fill(uint64_t begin, uint64_t end, bool resolve);
 
   bool Valid() const { return bound_; }
 
+  /// \returns true if this view is a read-only mapping of the file itself
+  bool mapped() const { return mapped_; }
+
+  /// \returns the mapping of a view bound with BindMapped, or nullptr.
+  /// Unbinding or rebinding the view only drops its reference; the file
+  /// stays mapped until every holder of the mapping releases it, so memory
+  /// that borrows from ptr() can keep the mapping alive this way.
+  std::shared_ptr<const void> mapping() const { return mapping_; }
+
   katana::Result<void> Unbind();
 
   /// Be very careful with this function. It is the caller's responsibility to
@@ -168,6 +198,9 @@ private:
   int64_t mem_start_{0};
   std::string filename_;
   bool bound_{false};
+  bool mapped_{false};
+  /// Owns the mapping when mapped_; unmaps it when the last holder lets go
+  std::shared_ptr<const void> mapping_;
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
 };
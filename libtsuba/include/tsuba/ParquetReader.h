@@ -29,7 +29,9 @@ public:
     bool make_cannonical{true};
 
     /// if provided, slice the resulting table so that it only contains
-    /// Slice.length rows starting from Slice.offset
+    /// Slice.length rows starting from Slice.offset. Only the row groups (and
+    /// for column reads, only the column chunks) that overlap the slice are
+    /// fetched from storage.
     std::optional<Slice> slice{std::nullopt};
 
     static ReadOpts Defaults() { return ReadOpts{}; }
@@ -48,7 +50,6 @@ public:
       const katana::Uri& uri);
 
   /// read part of a table from storage
-  /// n.b. support for the `slice` read option is missing here
   ///   \param uri an identifier for a parquet file
   ///   \param column_bitmap must have the same length as the number of columns
   ///      in the table in the parquet file. The loaded table will only contain
@@ -61,7 +62,6 @@ public:
       const katana::Uri& uri);
 
   /// read a column part of a table from storage
-  /// n.b. support for the `slice` read option is missing here
   ///   \param uri an identifier for a parquet file
   ///   \param column_idx must be a valid column index for the table in that
   ///      file
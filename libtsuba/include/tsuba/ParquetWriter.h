@@ -2,6 +2,9 @@
 #define KATANA_LIBTSUBA_TSUBA_PARQUETWRITER_H_
 
 #include <limits>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <arrow/api.h>
@@ -15,6 +18,20 @@ namespace tsuba {
 
 class KATANA_EXPORT ParquetWriter {
 public:
+  /// Encoding settings for a single column. Unset fields fall back to the
+  /// table-wide setting in WriteOpts and then to a default chosen from the
+  /// column type.
+  struct ColumnOpts {
+    std::optional<parquet::Compression::type> compression{std::nullopt};
+    /// codec specific; e.g., 1-22 for zstd
+    std::optional<int> compression_level{std::nullopt};
+    /// if true, dictionary encode values and write the dictionary indices
+    /// with the RLE/bit-packing hybrid; Parquet falls back to plain encoding
+    /// when the dictionary grows too large
+    std::optional<bool> dictionary{std::nullopt};
+    std::optional<bool> statistics{std::nullopt};
+  };
+
   struct WriteOpts {
     /// int64 timestamps with nanosecond resolution requires Parquet version
     /// 2.0. In Arrow to Parquet version 1.0, nanosecond timestamps will get
@@ -31,6 +48,20 @@ public:
 
     /// control the approximate size of blocked files when writing blocked
     uint64_t mbs_per_block{256};
+
+    /// settings for every column; unset fields are chosen per column type:
+    /// strings are compressed with zstd, integers are dictionary encoded when
+    /// a sample of their values has few distinct values, and everything else
+    /// keeps the Arrow defaults
+    ColumnOpts columns{};
+
+    /// overrides of `columns` by column (property) name
+    std::unordered_map<std::string, ColumnOpts> column_overrides{};
+
+    /// maximum number of rows in a row group. Smaller row groups let sliced
+    /// reads skip more of a file at the cost of some compression.
+    int64_t max_row_group_length{INT64_C(1) << 20};
+
     static WriteOpts Defaults() { return WriteOpts{}; }
   };
 
@@ -62,7 +93,8 @@ private:
       std::vector<std::shared_ptr<arrow::Table>> tables, WriteOpts opts)
       : tables_(std::move(tables)), opts_(opts) {}
 
-  std::shared_ptr<parquet::WriterProperties> StandardWriterProperties();
+  std::shared_ptr<parquet::WriterProperties> StandardWriterProperties(
+      const std::shared_ptr<arrow::Table>& table);
 
   std::shared_ptr<parquet::ArrowWriterProperties> StandardArrowProperties();
 
@@ -1,7 +1,13 @@
 #ifndef KATANA_LIBTSUBA_TSUBA_PROPERTYCACHE_H_
 #define KATANA_LIBTSUBA_TSUBA_PROPERTYCACHE_H_
 
-#include "katana/Cache.h"
+#include <memory>
+#include <string>
+
+#include <arrow/api.h>
+#include <boost/container_hash/hash.hpp>
+
+#include "katana/ShardedCache.h"
 
 namespace tsuba {
 
@@ -22,6 +28,7 @@ public:
   }
   NodeEdge node_edge() const { return node_edge_; }
   std::string prop_name() const { return prop_name_; }
+  const std::string& rdg_dir() const { return rdg_dir_; }
   struct Hash {
     std::size_t operator()(const PropertyCacheKey& k) const {
       using boost::hash_combine;
@@ -48,8 +55,21 @@ private:
 };
 
 class RDG;
+
+/// Property columns are shared by every thread loading graphs, so the cache
+/// is sharded and has a byte budget. Groups are RDG directories, which lets
+/// the cache cap how much of the budget one graph can take. An RDG pins the
+/// columns it has loaded (with its RDGCore as the owner) until it unloads
+/// them or is destroyed.
 using PropertyCache =
-    katana::Cache<PropertyCacheKey, std::shared_ptr<arrow::Table>, RDG*>;
+    katana::ShardedCache<PropertyCacheKey, std::shared_ptr<arrow::Table>, RDG*>;
+
+/// Returns the group of a property cache key, for use as the key_to_group
+/// function of a PropertyCache
+inline std::string
+PropertyCacheGroup(const PropertyCacheKey& key) {
+  return key.rdg_dir();
+}
 
 }  // namespace tsuba
 
@@ -6,6 +6,8 @@
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <arrow/api.h>
 #include <arrow/chunked_array.h>
@@ -15,6 +17,7 @@
 #include "katana/Result.h"
 #include "katana/URI.h"
 #include "katana/config.h"
+#include "tsuba/ArrowIPC.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileFrame.h"
 #include "tsuba/FileView.h"
@@ -45,7 +48,45 @@ struct KATANA_EXPORT RDGLoadOptions {
   // Each table should only contain a single column.
   // Callback provides a pointer to the RDG so we can evict
   // even before the PropertyGraph is created.
+  // Columns stay pinned in the cache while the RDG has them loaded.
   tsuba::PropertyCache* prop_cache{nullptr};
+  /// Number of threads in tsuba's shared I/O executor; nullopt keeps the
+  /// current setting (initially KATANA_IO_WORKERS or a default). The executor
+  /// is sized by the first load that sets io_workers or io_queue_depth, and
+  /// later loads do not change it.
+  std::optional<uint32_t> io_workers{std::nullopt};
+  /// Number of I/O tasks that may wait for a worker before submitters block;
+  /// nullopt keeps the current setting (initially KATANA_IO_QUEUE_DEPTH or a
+  /// default)
+  std::optional<uint32_t> io_queue_depth{std::nullopt};
+  /// Map a topology file on the local file system read-only and let the
+  /// loaded topology borrow the mapping instead of copying it (also enabled by
+  /// KATANA_MAP_TOPOLOGY). Topologies on other storage are read as usual.
+  bool map_topology{false};
+  /// Access pattern hint for a mapped topology
+  FileView::AccessHint topology_access_hint{FileView::AccessHint::kNormal};
+  /// Fault in a mapped topology from all threads once it is loaded so that
+  /// its pages are interleaved across NUMA nodes
+  bool interleave_topology{false};
+};
+
+/// Identifies a topology derived from the stored topology of an RDG, e.g., a
+/// transposed copy or a copy with sorted edges. tsuba treats the fields as
+/// opaque tags; their meaning is defined by the library that builds the
+/// derived topology.
+struct KATANA_EXPORT DerivedTopologyKind {
+  int32_t transpose_kind{0};
+  int32_t edge_sort_kind{0};
+  int32_t node_sort_kind{0};
+
+  bool operator==(const DerivedTopologyKind& other) const {
+    return transpose_kind == other.transpose_kind &&
+           edge_sort_kind == other.edge_sort_kind &&
+           node_sort_kind == other.node_sort_kind;
+  }
+  bool operator!=(const DerivedTopologyKind& other) const {
+    return !(*this == other);
+  }
 };
 
 class KATANA_EXPORT RDG {
@@ -174,12 +215,40 @@ public:
   /// cannot be loaded more than once
   katana::Result<void> LoadEdgeProperty(const std::string& name, int i = -1);
 
+  /// Write the node property with a particular name in this format from now
+  /// on. By default, properties are written in the format they were read in,
+  /// and new properties are written as Parquet. A loaded property in another
+  /// format is rewritten by the next Store; one that is not loaded is
+  /// converted the next time it is modified.
+  katana::Result<void> SetNodePropertyFormat(
+      const std::string& name, PropertyFormat format);
+
+  /// Write the edge property with a particular name in this format from now
+  /// on, see SetNodePropertyFormat
+  katana::Result<void> SetEdgePropertyFormat(
+      const std::string& name, PropertyFormat format);
+
   std::vector<std::string> ListNodeProperties() const;
   std::vector<std::string> ListEdgeProperties() const;
 
   /// Explain to graph how it is derived from previous version
   void AddLineage(const std::string& command_line);
 
+  /// Return true if a derived topology of this kind is in storage or will be
+  /// written by the next Store
+  bool HasDerivedTopology(const DerivedTopologyKind& kind) const;
+
+  /// Load the stored derived topology of this kind. Returns nullptr if there
+  /// is none. Files on the local file system are mapped rather than read.
+  katana::Result<std::unique_ptr<FileView>> LoadDerivedTopology(
+      const DerivedTopologyKind& kind) const;
+
+  /// Write ff as the derived topology of this kind on the next Store,
+  /// replacing any stored one. Derived topologies are dropped whenever a new
+  /// topology is stored since they would no longer match it.
+  void AddDerivedTopology(
+      const DerivedTopologyKind& kind, std::unique_ptr<FileFrame> ff);
+
   /// Load the RDG described by the metadata in handle into memory.
   static katana::Result<RDG> Make(RDGHandle handle, const RDGLoadOptions& opts);
 
@@ -299,6 +368,9 @@ private:
       RDGHandle handle, std::unique_ptr<FileFrame> topology_ff,
       std::unique_ptr<WriteGroup>& write_group);
 
+  katana::Result<void> DoStoreDerivedTopologies(
+      RDGHandle handle, std::unique_ptr<WriteGroup>& write_group);
+
   katana::Result<void> DoStoreNodeEntityTypeIDArray(
       RDGHandle handle, std::unique_ptr<FileFrame> node_entity_type_id_array_ff,
       std::unique_ptr<WriteGroup>& write_group);
@@ -314,6 +386,11 @@ private:
   std::unique_ptr<RDGCore> core_;
   // Optional property cache
   tsuba::PropertyCache* prop_cache_{nullptr};
+  bool map_topology_{false};
+  FileView::AccessHint topology_access_hint_{FileView::AccessHint::kNormal};
+  // Derived topologies to be written by the next Store
+  std::vector<std::pair<DerivedTopologyKind, std::unique_ptr<FileFrame>>>
+      pending_derived_topologies_;
 };
 
 }  // namespace tsuba
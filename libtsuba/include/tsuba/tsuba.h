@@ -65,6 +65,11 @@ KATANA_EXPORT katana::Result<RDGHandle> Open(
 /// out-of-core conversion
 KATANA_EXPORT katana::Uri MakeTopologyFileName(RDGHandle handle);
 
+/// Generate a new canonically named file name for a derived topology (e.g.,
+/// a transposed or sorted copy of the topology) in the directory associated
+/// with handle
+KATANA_EXPORT katana::Uri MakeDerivedTopologyFileName(RDGHandle handle);
+
 /// Generate a new canonically named node_entity_type_id file name in the
 /// directory associated with handle. Exported to support
 /// out-of-core conversion
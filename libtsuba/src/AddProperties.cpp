@@ -1,14 +1,17 @@
 #include "AddProperties.h"
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 
 #include <arrow/chunked_array.h>
 
+#include "IOExecutor.h"
 #include "katana/ArrowInterchange.h"
 #include "katana/ProgressTracer.h"
 #include "katana/Result.h"
 #include "katana/Time.h"
+#include "tsuba/ArrowIPC.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileView.h"
 #include "tsuba/ParquetReader.h"
@@ -20,20 +23,33 @@ katana::Result<std::shared_ptr<arrow::Table>>
 DoLoadProperties(
     const std::string& expected_name, const katana::Uri& file_path,
     std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt) {
-  auto read_opts = tsuba::ParquetReader::ReadOpts::Defaults();
-  read_opts.slice = slice;
-  auto reader_res = tsuba::ParquetReader::Make(read_opts);
-  if (!reader_res) {
-    return reader_res.error().WithContext("loading property");
-  }
-  std::unique_ptr<tsuba::ParquetReader> reader = std::move(reader_res.value());
+  std::shared_ptr<arrow::Table> out;
+  if (tsuba::IsArrowIPCPath(file_path.string())) {
+    // mapped in place; slicing is free
+    out = KATANA_CHECKED_CONTEXT(
+        tsuba::ReadArrowIPC(file_path), "loading property");
+    if (slice) {
+      int64_t offset = std::min(slice->offset, out->num_rows());
+      out = out->Slice(
+          offset, std::min(slice->length, out->num_rows() - offset));
+    }
+  } else {
+    auto read_opts = tsuba::ParquetReader::ReadOpts::Defaults();
+    read_opts.slice = slice;
+    auto reader_res = tsuba::ParquetReader::Make(read_opts);
+    if (!reader_res) {
+      return reader_res.error().WithContext("loading property");
+    }
+    std::unique_ptr<tsuba::ParquetReader> reader =
+        std::move(reader_res.value());
 
-  auto out_res = reader->ReadTable(file_path);
-  if (!out_res) {
-    return out_res.error().WithContext("loading property");
-  }
+    auto out_res = reader->ReadTable(file_path);
+    if (!out_res) {
+      return out_res.error().WithContext("loading property");
+    }
 
-  std::shared_ptr<arrow::Table> out = std::move(out_res.value());
+    out = std::move(out_res.value());
+  }
 
   std::shared_ptr<arrow::Schema> schema = out->schema();
   if (schema->num_fields() != 1) {
@@ -80,7 +96,7 @@ tsuba::LoadPropertySlice(
 katana::Result<void>
 tsuba::AddProperties(
     const katana::Uri& uri, tsuba::NodeEdge node_edge,
-    tsuba::PropertyCache* cache, tsuba::RDG* rdg,
+    tsuba::PropertyCache* cache, tsuba::RDG* rdg, const void* pin_owner,
     const std::vector<tsuba::PropStorageInfo*>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
         add_fn) {
@@ -93,12 +109,16 @@ tsuba::AddProperties(
     if (cache != nullptr) {
       tsuba::PropertyCacheKey cache_key(
           node_edge, rdg->rdg_dir().string(), prop->name());
-      auto column_table = cache->Get(cache_key);
+      // Pin the column so that it is not evicted while it is loaded in rdg
+      auto column_table = pin_owner != nullptr
+                              ? cache->GetAndPin(cache_key, pin_owner)
+                              : cache->Get(cache_key);
       if (column_table) {
         auto props = column_table.value();
         KATANA_CHECKED_CONTEXT(
             add_fn(props), "adding {}", std::quoted(prop->name()));
         prop->WasLoaded(props->field(0)->type());
+        prop->set_stored_arrays(tsuba::StoredArrays::Of(*props->column(0)));
         auto& tracer = katana::GetTracer();
         tracer.GetActiveSpan().Log(
             "property loaded from cache",
@@ -108,21 +128,20 @@ tsuba::AddProperties(
              {"approx_size_human",
               katana::BytesToStr(
                   "{:.2f}{}", katana::ApproxTableMemUse(props))}});
-        return katana::ResultSuccess();
+        continue;
       }
     }
     const katana::Uri& path = uri.Join(prop->path());
 
     std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
-        std::async(
-            std::launch::async,
+        IO()->Submit<std::shared_ptr<arrow::Table>>(
             [prop,
              path]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
               return KATANA_CHECKED_CONTEXT(
                   LoadProperties(prop->name(), path), "error loading {}", path);
             });
-    auto on_complete = [add_fn, prop, node_edge, cache,
-                        rdg](const std::shared_ptr<arrow::Table>& props)
+    auto on_complete = [add_fn, prop, node_edge, cache, rdg,
+                        pin_owner](const std::shared_ptr<arrow::Table>& props)
         -> katana::CopyableResult<void> {
       if (cache != nullptr) {
         auto& tracer = katana::GetTracer();
@@ -145,12 +164,17 @@ tsuba::AddProperties(
           // Only match properties from the same RDG prefix
           tsuba::PropertyCacheKey cache_key(
               node_edge, rdg->rdg_dir().string(), prop->name());
-          cache->Insert(cache_key, props, rdg);
+          if (pin_owner != nullptr) {
+            cache->InsertAndPin(cache_key, props, pin_owner, rdg);
+          } else {
+            cache->Insert(cache_key, props, rdg);
+          }
         }
       }
       KATANA_CHECKED_CONTEXT(
           add_fn(props), "adding {}", std::quoted(prop->name()));
       prop->WasLoaded(props->field(0)->type());
+      prop->set_stored_arrays(tsuba::StoredArrays::Of(*props->column(0)));
       return katana::CopyableResultSuccess();
     };
     if (grp) {
@@ -184,8 +208,7 @@ tsuba::AddPropertySlice(
     const katana::Uri& path = dir.Join(prop->path());
 
     std::future<katana::CopyableResult<std::shared_ptr<arrow::Table>>> future =
-        std::async(
-            std::launch::async,
+        IO()->Submit<std::shared_ptr<arrow::Table>>(
             [path, prop, begin,
              size]() -> katana::CopyableResult<std::shared_ptr<arrow::Table>> {
               auto load_result =
@@ -19,7 +19,7 @@ KATANA_EXPORT katana::Result<std::shared_ptr<arrow::Table>> LoadPropertySlice(
 
 KATANA_EXPORT katana::Result<void> AddProperties(
     const katana::Uri& uri, tsuba::NodeEdge node_edge,
-    tsuba::PropertyCache* cache, tsuba::RDG* rdg,
+    tsuba::PropertyCache* cache, tsuba::RDG* rdg, const void* pin_owner,
     const std::vector<tsuba::PropStorageInfo*>& properties, ReadGroup* grp,
     const std::function<katana::Result<void>(std::shared_ptr<arrow::Table>)>&
         add_fn);
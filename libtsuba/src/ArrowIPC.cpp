@@ -0,0 +1,148 @@
+#include "tsuba/ArrowIPC.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <arrow/io/memory.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+
+#include "IOExecutor.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FaultTest.h"
+#include "tsuba/FileFrame.h"
+#include "tsuba/FileView.h"
+
+namespace {
+
+/// A buffer over the contents of a file view. Slices of the buffer (which is
+/// what the IPC reader hands out) keep it, and so the view, alive.
+class FileViewBuffer : public arrow::Buffer {
+public:
+  explicit FileViewBuffer(std::unique_ptr<tsuba::FileView> fv)
+      : arrow::Buffer(fv->ptr<uint8_t>(), fv->size()), fv_(std::move(fv)) {}
+
+private:
+  std::unique_ptr<tsuba::FileView> fv_;
+};
+
+katana::Result<std::unique_ptr<tsuba::FileView>>
+BindFile(const katana::Uri& uri) {
+  auto fv = std::make_unique<tsuba::FileView>();
+  if (uri.scheme() == katana::Uri::kFileScheme) {
+    if (auto res = fv->BindMapped(uri.string()); !res) {
+      KATANA_LOG_DEBUG(
+          "mapping {} failed, reading it instead: {}", uri, res.error());
+    }
+  }
+  if (!fv->mapped()) {
+    KATANA_CHECKED_CONTEXT(fv->Bind(uri.string(), true), "reading {}", uri);
+  }
+  return std::unique_ptr<tsuba::FileView>(std::move(fv));
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+DoReadArrowIPC(const katana::Uri& uri) {
+  auto buffer =
+      std::make_shared<FileViewBuffer>(KATANA_CHECKED(BindFile(uri)));
+  auto reader = KATANA_CHECKED(arrow::ipc::RecordBatchFileReader::Open(
+      std::make_shared<arrow::io::BufferReader>(std::move(buffer))));
+
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int i = 0, n = reader->num_record_batches(); i < n; ++i) {
+    batches.emplace_back(KATANA_CHECKED(reader->ReadRecordBatch(i)));
+  }
+  std::shared_ptr<arrow::Table> table = KATANA_CHECKED(
+      arrow::Table::FromRecordBatches(reader->schema(), batches));
+
+  // lots of the code base assumes chunks will exist, see ParquetReader
+  if (table->num_rows() == 0) {
+    auto columns = table->columns();
+    for (auto& col : columns) {
+      if (col->num_chunks() == 0) {
+        col = std::make_shared<arrow::ChunkedArray>(
+            KATANA_CHECKED(arrow::MakeArrayOfNull(col->type(), 0)));
+      }
+    }
+    table = arrow::Table::Make(table->schema(), columns);
+  }
+
+  return table;
+}
+
+}  // namespace
+
+katana::Result<std::unique_ptr<tsuba::ArrowIPCWriter>>
+tsuba::ArrowIPCWriter::Make(
+    const std::shared_ptr<arrow::ChunkedArray>& array,
+    const std::string& name) {
+  return Make(arrow::Table::Make(
+      arrow::schema({arrow::field(name, array->type())}), {array}));
+}
+
+katana::Result<std::unique_ptr<tsuba::ArrowIPCWriter>>
+tsuba::ArrowIPCWriter::Make(std::shared_ptr<arrow::Table> table) {
+  return std::unique_ptr<ArrowIPCWriter>(new ArrowIPCWriter(std::move(table)));
+}
+
+katana::Result<void>
+tsuba::ArrowIPCWriter::WriteToUri(const katana::Uri& uri, WriteGroup* group) {
+  auto ff = std::make_shared<tsuba::FileFrame>();
+  KATANA_CHECKED(ff->Init());
+  ff->Bind(uri.string());
+
+  auto future = tsuba::IO()->Submit<void>(
+      [table = table_, ff = std::move(ff),
+       group]() mutable -> katana::CopyableResult<void> {
+        try {
+          // one record batch, so that readers get one chunk per column
+          // without copying
+          auto combined = KATANA_CHECKED(
+              table->CombineChunks(arrow::default_memory_pool()));
+          table.reset();
+
+          auto writer = KATANA_CHECKED(
+              arrow::ipc::MakeFileWriter(ff, combined->schema()));
+          KATANA_CHECKED(writer->WriteTable(*combined));
+          KATANA_CHECKED(writer->Close());
+        } catch (const std::exception& exp) {
+          return KATANA_ERROR(
+              tsuba::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
+        }
+        if (group) {
+          group->AddToOutstanding(ff->map_size());
+        }
+
+        TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
+        KATANA_CHECKED(ff->Persist());
+        return katana::CopyableResultSuccess();
+      });
+
+  if (!group) {
+    KATANA_CHECKED(future.get());
+    return katana::ResultSuccess();
+  }
+
+  group->AddOp(std::move(future), uri.string());
+  return katana::ResultSuccess();
+}
+
+bool
+tsuba::IsArrowIPCPath(const std::string& path) {
+  std::string_view suffix(ArrowIPCWriter::kSuffix);
+  return path.size() >= suffix.size() &&
+         path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+tsuba::ReadArrowIPC(const katana::Uri& uri) {
+  try {
+    return DoReadArrowIPC(uri);
+  } catch (const std::exception& exp) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::ArrowError, "arrow exception: {}", exp.what());
+  }
+}
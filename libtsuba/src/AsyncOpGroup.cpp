@@ -1,5 +1,7 @@
 #include "tsuba/AsyncOpGroup.h"
 
+#include "IOExecutor.h"
+
 bool
 tsuba::AsyncOpGroup::FinishOne() {
   auto op_it = pending_ops_.begin();
@@ -30,6 +32,10 @@ tsuba::AsyncOpGroup::Finish() {
     // Wait for all ops
   }
 
+  if (total_ > 0) {
+    IO()->LogStats("async op group finished");
+  }
+
   if (errors_ > 0) {
     return last_error_.WithContext(
         "{} of {} async write ops returned errors", errors_, total_);
@@ -0,0 +1,216 @@
+#include "tsuba/CSRTopology.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "katana/Logging.h"
+#include "tsuba/Errors.h"
+
+namespace {
+
+void
+PutVarint(uint64_t v, std::vector<uint8_t>* out) {
+  while (v >= 0x80) {
+    out->emplace_back(static_cast<uint8_t>(v) | 0x80);
+    v >>= 7;
+  }
+  out->emplace_back(static_cast<uint8_t>(v));
+}
+
+/// Read a varint from [*pos, end) and advance pos past it
+bool
+GetVarint(const uint8_t** pos, const uint8_t* end, uint64_t* v) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64 && *pos < end; shift += 7) {
+    uint8_t byte = *(*pos)++;
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *v = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint64_t
+ZigZag(int64_t v) {
+  return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t
+UnZigZag(uint64_t v) {
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+template <typename Dest>
+void
+DoEncodeCSRBlock(
+    const uint64_t* out_indexes, const Dest* out_dests, uint64_t first_node,
+    uint64_t last_node, std::vector<uint8_t>* out) {
+  for (uint64_t n = first_node; n < last_node; ++n) {
+    uint64_t begin = n == 0 ? 0 : out_indexes[n - 1];
+    uint64_t end = out_indexes[n];
+    PutVarint(end - begin, out);
+
+    int64_t prev = n;
+    for (uint64_t e = begin; e < end; ++e) {
+      int64_t dest = out_dests[e];
+      PutVarint(ZigZag(dest - prev), out);
+      prev = dest;
+    }
+  }
+}
+
+}  // namespace
+
+void
+tsuba::EncodeCSRBlock(
+    const uint64_t* out_indexes, const uint32_t* out_dests, uint64_t first_node,
+    uint64_t last_node, std::vector<uint8_t>* out) {
+  DoEncodeCSRBlock(out_indexes, out_dests, first_node, last_node, out);
+}
+
+void
+tsuba::EncodeCSRBlock(
+    const uint64_t* out_indexes, const uint64_t* out_dests, uint64_t first_node,
+    uint64_t last_node, std::vector<uint8_t>* out) {
+  DoEncodeCSRBlock(out_indexes, out_dests, first_node, last_node, out);
+}
+
+katana::Result<tsuba::CompressedCSRView>
+tsuba::CompressedCSRView::Make(const uint8_t* data, uint64_t size) {
+  uint64_t prefix_size =
+      sizeof(CSRTopologyHeader) + sizeof(CSRCompressedHeader);
+  if (size < prefix_size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "compressed topology too small: {}", size);
+  }
+
+  CompressedCSRView view;
+  view.header_ = reinterpret_cast<const CSRTopologyHeader*>(data);
+  view.compressed_header_ = reinterpret_cast<const CSRCompressedHeader*>(
+      data + sizeof(CSRTopologyHeader));
+  if (view.header_->version != kCompressedCSRVersion) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "unexpected topology version: {}",
+        view.header_->version);
+  }
+
+  const CSRTopologyHeader& header = view.header();
+  const CSRCompressedHeader& compressed = *view.compressed_header_;
+  if (compressed.nodes_per_block == 0 ||
+      compressed.num_blocks !=
+          (header.num_nodes + compressed.nodes_per_block - 1) /
+              compressed.nodes_per_block) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "{} blocks of {} nodes do not cover {} nodes", compressed.num_blocks,
+        compressed.nodes_per_block, header.num_nodes);
+  }
+
+  uint64_t index_size =
+      (compressed.num_blocks + 1) * sizeof(CSRBlockIndexEntry);
+  if (size - prefix_size < index_size) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "compressed topology index truncated");
+  }
+  view.index_ =
+      reinterpret_cast<const CSRBlockIndexEntry*>(data + prefix_size);
+  view.block_data_ = data + prefix_size + index_size;
+
+  uint64_t data_size = size - prefix_size - index_size;
+  for (uint64_t i = 0; i < compressed.num_blocks; ++i) {
+    if (view.index_[i].data_offset > view.index_[i + 1].data_offset ||
+        view.index_[i].first_edge > view.index_[i + 1].first_edge) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "compressed topology block {} corrupt",
+          i);
+    }
+  }
+  const CSRBlockIndexEntry& last = view.index_[compressed.num_blocks];
+  if (view.index_[0].data_offset != 0 || view.index_[0].first_edge != 0 ||
+      last.data_offset > data_size || last.first_edge != header.num_edges) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "compressed topology index corrupt");
+  }
+
+  return view;
+}
+
+katana::Result<void>
+tsuba::CompressedCSRView::DecodeBlock(
+    uint64_t block, uint64_t* out_indexes, uint32_t* out_dests) const {
+  return DoDecodeBlock(block, out_indexes, out_dests, 0);
+}
+
+katana::Result<void>
+tsuba::CompressedCSRView::DecodeBlock(
+    uint64_t block, uint64_t* out_indexes, uint64_t* out_dests) const {
+  return DoDecodeBlock(block, out_indexes, out_dests, 0);
+}
+
+katana::Result<void>
+tsuba::CompressedCSRView::DecodeBlockLocal(
+    uint64_t block, uint64_t* out_indexes, uint32_t* block_dests) const {
+  return DoDecodeBlock(
+      block, out_indexes, block_dests, block_first_edge(block));
+}
+
+katana::Result<void>
+tsuba::CompressedCSRView::DecodeBlockLocal(
+    uint64_t block, uint64_t* out_indexes, uint64_t* block_dests) const {
+  return DoDecodeBlock(
+      block, out_indexes, block_dests, block_first_edge(block));
+}
+
+template <typename Dest>
+katana::Result<void>
+tsuba::CompressedCSRView::DoDecodeBlock(
+    uint64_t block, uint64_t* out_indexes, Dest* out_dests,
+    uint64_t first_dest) const {
+  KATANA_LOG_DEBUG_ASSERT(block < num_blocks());
+  const uint64_t nodes_per_block = compressed_header_->nodes_per_block;
+  const uint64_t num_nodes = header_->num_nodes;
+  uint64_t first_node = block * nodes_per_block;
+  uint64_t last_node = std::min(first_node + nodes_per_block, num_nodes);
+
+  const uint8_t* pos = block_data_ + index_[block].data_offset;
+  const uint8_t* end = block_data_ + index_[block + 1].data_offset;
+  uint64_t edge = index_[block].first_edge;
+  const uint64_t last_edge = index_[block + 1].first_edge;
+
+  for (uint64_t n = first_node; n < last_node; ++n) {
+    uint64_t degree = 0;
+    if (!GetVarint(&pos, end, &degree) || degree > last_edge - edge) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "bad degree for node {}", n);
+    }
+
+    int64_t prev = n;
+    for (uint64_t i = 0; i < degree; ++i, ++edge) {
+      uint64_t delta = 0;
+      if (!GetVarint(&pos, end, &delta)) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "truncated edges for node {}", n);
+      }
+      int64_t dest = prev + UnZigZag(delta);
+      if (dest < 0 || static_cast<uint64_t>(dest) >= num_nodes ||
+          static_cast<uint64_t>(dest) > std::numeric_limits<Dest>::max()) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "bad destination for node {}: {}", n,
+            dest);
+      }
+      out_dests[edge - first_dest] = dest;
+      prev = dest;
+    }
+    out_indexes[n] = edge;
+  }
+
+  if (edge != last_edge || pos != end) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "compressed topology block {} corrupt",
+        block);
+  }
+
+  return katana::ResultSuccess();
+}
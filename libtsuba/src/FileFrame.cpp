@@ -2,6 +2,7 @@
 
 #include <sys/mman.h>
 
+#include "IOExecutor.h"
 #include "katana/Logging.h"
 #include "katana/Platform.h"
 #include "katana/Result.h"
@@ -122,19 +123,12 @@ FileFrame::Persist() {
 
 std::future<katana::CopyableResult<void>>
 FileFrame::PersistAsync() {
-  if (!valid_) {
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
-        });
-  }
-  if (path_.empty()) {
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return KATANA_ERROR(ErrorCode::InvalidArgument, "no path provided");
-        });
-  }
-  return tsuba::FileStoreAsync(path_, map_start_, cursor_);
+  return IO()->Submit<void>([this]() -> katana::CopyableResult<void> {
+    if (auto res = Persist(); !res) {
+      return res.error();
+    }
+    return katana::CopyableResultSuccess();
+  });
 }
 
 katana::Result<void>
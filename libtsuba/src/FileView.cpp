@@ -1,6 +1,8 @@
 #include "tsuba/FileView.h"
 
+#include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include <cassert>
@@ -9,6 +11,7 @@
 
 #include "katana/Logging.h"
 #include "katana/Result.h"
+#include "katana/URI.h"
 #include "tsuba/Errors.h"
 #include "tsuba/file.h"
 
@@ -46,7 +49,10 @@ FileView::Unbind() {
     if (auto res = Resolve(0, file_size_); !res) {
       return res.error().WithContext("resolving for unmap");
     }
-    if (map_start_ != nullptr) {
+    if (mapped_) {
+      // unmapped once nothing borrows from the mapping anymore
+      mapping_.reset();
+    } else if (map_start_ != nullptr) {
       if (int err = munmap(map_start_, file_size_); err) {
         return KATANA_ERROR(katana::ResultErrno(), "unmapping buffer");
       }
@@ -61,6 +67,7 @@ FileView::Unbind() {
     KATANA_LOG_DEBUG_ASSERT(fetches_->empty());
 
     bound_ = false;
+    mapped_ = false;
   }
   return katana::ResultSuccess();
 }
@@ -119,8 +126,102 @@ FileView::Bind(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+FileView::BindMapped(std::string_view filename) {
+  katana::Uri uri = KATANA_CHECKED(katana::Uri::Make(std::string(filename)));
+  if (uri.scheme() != katana::Uri::kFileScheme) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "only local files can be mapped: {}",
+        uri);
+  }
+
+  int fd = open(uri.path().c_str(), O_RDONLY);
+  if (fd < 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "opening {}", uri.path());
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    std::error_code err = katana::ResultErrno();
+    close(fd);
+    return KATANA_ERROR(err, "stat {}", uri.path());
+  }
+
+  void* tmp = nullptr;
+  if (st.st_size > 0) {
+    // MAP_PRIVATE so that a stray write can never reach the file; until such
+    // a write happens the pages are the page cache's
+    tmp = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (tmp == MAP_FAILED) {
+      std::error_code err = katana::ResultErrno();
+      close(fd);
+      return KATANA_ERROR(
+          err, "mapping {} ({} bytes)", uri.path(), st.st_size);
+    }
+  }
+  close(fd);
+
+  if (auto res = Unbind(); !res) {
+    if (tmp != nullptr) {
+      munmap(tmp, st.st_size);
+    }
+    return res.error().WithContext("resetting for new content");
+  }
+
+  map_start_ = static_cast<uint8_t*>(tmp);
+  if (tmp != nullptr) {
+    size_t length = st.st_size;
+    mapping_ = std::shared_ptr<const void>(tmp, [length](const void* ptr) {
+      if (munmap(const_cast<void*>(ptr), length) != 0) {
+        KATANA_LOG_ERROR(
+            "unmapping buffer: {}", katana::ResultErrno().message());
+      }
+    });
+  }
+  file_size_ = st.st_size;
+  page_shift_ = 20; /* 1M */
+  mem_start_ = 0;
+  cursor_ = 0;
+  filename_ = filename;
+  filling_.clear();
+  fetches_ = std::make_unique<std::vector<FillingRange>>();
+  mapped_ = true;
+  bound_ = true;
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+FileView::Advise(AccessHint hint) const {
+  if (!mapped_ || map_start_ == nullptr) {
+    return katana::ResultSuccess();
+  }
+  int advice = MADV_NORMAL;
+  switch (hint) {
+  case AccessHint::kNormal:
+    advice = MADV_NORMAL;
+    break;
+  case AccessHint::kSequential:
+    advice = MADV_SEQUENTIAL;
+    break;
+  case AccessHint::kRandom:
+    advice = MADV_RANDOM;
+    break;
+  case AccessHint::kWillNeed:
+    advice = MADV_WILLNEED;
+    break;
+  }
+  if (madvise(map_start_, file_size_, advice) != 0) {
+    return KATANA_ERROR(katana::ResultErrno(), "madvise {}", filename_);
+  }
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
+  if (mapped_) {
+    // the whole file is already mapped
+    return katana::ResultSuccess();
+  }
+
   uint64_t in_end = std::min<uint64_t>(end, file_size_);
   uint64_t in_begin = std::min<uint64_t>(begin, in_end);
   uint64_t first_page = 0;
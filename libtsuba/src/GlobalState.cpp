@@ -16,6 +16,12 @@ tsuba::GlobalState::Comm() const {
   return comm_;
 }
 
+tsuba::IOExecutor*
+tsuba::GlobalState::IO() const {
+  KATANA_LOG_DEBUG_ASSERT(io_executor_ != nullptr);
+  return io_executor_.get();
+}
+
 tsuba::FileStorage*
 tsuba::GlobalState::GetDefaultFS() const {
   KATANA_LOG_DEBUG_ASSERT(file_stores_.size() > 0);
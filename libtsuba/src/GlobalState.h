@@ -4,6 +4,7 @@
 #include <memory>
 #include <vector>
 
+#include "IOExecutor.h"
 #include "LocalStorage.h"
 #include "katana/CommBackend.h"
 #include "katana/Logging.h"
@@ -19,8 +20,10 @@ class GlobalState {
   katana::CommBackend* comm_;
 
   tsuba::LocalStorage local_storage_;
+  std::unique_ptr<IOExecutor> io_executor_;
 
-  GlobalState(katana::CommBackend* comm) : comm_(comm) {
+  GlobalState(katana::CommBackend* comm)
+      : comm_(comm), io_executor_(IOExecutor::MakeFromEnv()) {
     file_stores_.emplace_back(&local_storage_);
   }
 
@@ -36,6 +39,9 @@ public:
 
   katana::CommBackend* Comm() const;
 
+  /// The executor that runs blocking storage work for all of tsuba
+  IOExecutor* IO() const;
+
   /// Get the correct FileStorage based on the URI
   ///
   /// store object is selected based on scheme:
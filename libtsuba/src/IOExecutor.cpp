@@ -0,0 +1,204 @@
+#include "IOExecutor.h"
+
+#include <algorithm>
+
+#include "GlobalState.h"
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/ProgressTracer.h"
+
+namespace {
+
+thread_local bool tl_is_io_worker = false;
+
+void
+AtomicMax(std::atomic<uint64_t>* dst, uint64_t val) {
+  uint64_t prev = dst->load(std::memory_order_relaxed);
+  while (prev < val &&
+         !dst->compare_exchange_weak(prev, val, std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+tsuba::IOExecutor::IOExecutor(uint32_t num_workers, uint32_t max_queue_depth) {
+  Resize(num_workers, max_queue_depth);
+}
+
+tsuba::IOExecutor::~IOExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  task_ready_.notify_all();
+  slot_ready_.notify_all();
+  for (std::thread& worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+std::unique_ptr<tsuba::IOExecutor>
+tsuba::IOExecutor::MakeFromEnv() {
+  uint32_t num_workers = std::min<uint32_t>(
+      kDefaultMaxWorkers, std::max(1U, std::thread::hardware_concurrency()));
+  uint32_t max_queue_depth = kDefaultMaxQueueDepth;
+
+  if (int val = 0; katana::GetEnv(kNumWorkersEnv, &val)) {
+    if (val > 0) {
+      num_workers = val;
+    } else {
+      KATANA_LOG_WARN("ignoring non-positive {}={}", kNumWorkersEnv, val);
+    }
+  }
+  if (int val = 0; katana::GetEnv(kMaxQueueDepthEnv, &val)) {
+    if (val > 0) {
+      max_queue_depth = val;
+    } else {
+      KATANA_LOG_WARN("ignoring non-positive {}={}", kMaxQueueDepthEnv, val);
+    }
+  }
+
+  return std::make_unique<IOExecutor>(num_workers, max_queue_depth);
+}
+
+void
+tsuba::IOExecutor::Resize(uint32_t num_workers, uint32_t max_queue_depth) {
+  KATANA_LOG_DEBUG_ASSERT(num_workers > 0);
+  KATANA_LOG_DEBUG_ASSERT(max_queue_depth > 0);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    target_workers_ = std::max(1U, num_workers);
+    max_queue_depth_ = std::max(1U, max_queue_depth);
+    while (live_workers_ < target_workers_) {
+      workers_.emplace_back([this]() { WorkerLoop(); });
+      live_workers_ += 1;
+    }
+  }
+  // wake idle workers so surplus ones can exit, and blocked submitters in case
+  // the queue got deeper
+  task_ready_.notify_all();
+  slot_ready_.notify_all();
+}
+
+bool
+tsuba::IOExecutor::ConfigureOnce(
+    uint32_t num_workers, uint32_t max_queue_depth) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (configured_) {
+      return false;
+    }
+    configured_ = true;
+  }
+  Resize(num_workers, max_queue_depth);
+  return true;
+}
+
+void
+tsuba::IOExecutor::Enqueue(std::function<void()> fn) {
+  if (tl_is_io_worker) {
+    katana::TimePoint start = katana::Now();
+    fn();
+    Record(0, katana::UsSince(start), true);
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    slot_ready_.wait(lock, [this]() {
+      return stopping_ || queue_.size() < max_queue_depth_;
+    });
+    KATANA_LOG_ASSERT(!stopping_);
+    queue_.emplace_back(Task{.fn = std::move(fn), .enqueued = katana::Now()});
+  }
+  task_ready_.notify_one();
+}
+
+void
+tsuba::IOExecutor::WorkerLoop() {
+  tl_is_io_worker = true;
+  for (;;) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_ready_.wait(lock, [this]() {
+        return stopping_ || !queue_.empty() || live_workers_ > target_workers_;
+      });
+      if (queue_.empty()) {
+        // stopping, or there are more workers than we want
+        live_workers_ -= 1;
+        return;
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    slot_ready_.notify_one();
+
+    katana::TimePoint start = katana::Now();
+    task.fn();
+    Record(
+        katana::UsBetween(task.enqueued, start), katana::UsSince(start), false);
+  }
+}
+
+void
+tsuba::IOExecutor::Record(
+    uint64_t wait_us, uint64_t service_us, bool was_inline) {
+  tasks_.fetch_add(1, std::memory_order_relaxed);
+  if (was_inline) {
+    inline_tasks_.fetch_add(1, std::memory_order_relaxed);
+  }
+  queue_wait_us_.fetch_add(wait_us, std::memory_order_relaxed);
+  service_us_.fetch_add(service_us, std::memory_order_relaxed);
+  AtomicMax(&max_queue_wait_us_, wait_us);
+  AtomicMax(&max_service_us_, service_us);
+}
+
+tsuba::IOExecutor::Stats
+tsuba::IOExecutor::GetStats() const {
+  return Stats{
+      .tasks = tasks_.load(std::memory_order_relaxed),
+      .inline_tasks = inline_tasks_.load(std::memory_order_relaxed),
+      .queue_wait_us = queue_wait_us_.load(std::memory_order_relaxed),
+      .max_queue_wait_us = max_queue_wait_us_.load(std::memory_order_relaxed),
+      .service_us = service_us_.load(std::memory_order_relaxed),
+      .max_service_us = max_service_us_.load(std::memory_order_relaxed),
+  };
+}
+
+void
+tsuba::IOExecutor::LogStats(const std::string& message) const {
+  Stats stats = GetStats();
+  uint64_t avg_wait_us = stats.tasks ? stats.queue_wait_us / stats.tasks : 0;
+  uint64_t avg_service_us = stats.tasks ? stats.service_us / stats.tasks : 0;
+  katana::GetTracer().GetActiveSpan().Log(
+      message,
+      {{"io_workers", num_workers()},
+       {"io_queue_depth", max_queue_depth()},
+       {"io_tasks", stats.tasks},
+       {"io_inline_tasks", stats.inline_tasks},
+       {"io_avg_queue_wait", katana::UsToStr("{:.2f}{}", avg_wait_us)},
+       {"io_max_queue_wait",
+        katana::UsToStr("{:.2f}{}", stats.max_queue_wait_us)},
+       {"io_avg_service", katana::UsToStr("{:.2f}{}", avg_service_us)},
+       {"io_max_service", katana::UsToStr("{:.2f}{}", stats.max_service_us)}});
+}
+
+uint32_t
+tsuba::IOExecutor::num_workers() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return target_workers_;
+}
+
+uint32_t
+tsuba::IOExecutor::max_queue_depth() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return max_queue_depth_;
+}
+
+tsuba::IOExecutor*
+tsuba::IO() {
+  return GlobalState::Get().IO();
+}
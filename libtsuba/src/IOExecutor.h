@@ -0,0 +1,125 @@
+#ifndef KATANA_LIBTSUBA_IOEXECUTOR_H_
+#define KATANA_LIBTSUBA_IOEXECUTOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/Time.h"
+#include "katana/config.h"
+
+namespace tsuba {
+
+/// A fixed size pool of threads shared by all of tsuba for blocking storage
+/// work (property loads, parquet encoding, file persists). Replaces one
+/// std::async thread per file so that opening an RDG with hundreds of
+/// properties does not start hundreds of threads at once.
+///
+/// Submit blocks the caller when max_queue_depth tasks are already waiting.
+/// Tasks submitted from one of the executor's own workers run inline so that
+/// a task that waits on a nested submission cannot deadlock the pool.
+class KATANA_EXPORT IOExecutor {
+public:
+  static constexpr uint32_t kDefaultMaxWorkers = 16;
+  static constexpr uint32_t kDefaultMaxQueueDepth = 256;
+
+  /// Environment variables consulted by MakeFromEnv
+  static constexpr const char* kNumWorkersEnv = "KATANA_IO_WORKERS";
+  static constexpr const char* kMaxQueueDepthEnv = "KATANA_IO_QUEUE_DEPTH";
+
+  struct Stats {
+    uint64_t tasks{0};
+    uint64_t inline_tasks{0};
+    uint64_t queue_wait_us{0};
+    uint64_t max_queue_wait_us{0};
+    uint64_t service_us{0};
+    uint64_t max_service_us{0};
+  };
+
+  IOExecutor(uint32_t num_workers, uint32_t max_queue_depth);
+  ~IOExecutor();
+
+  IOExecutor(const IOExecutor& no_copy) = delete;
+  IOExecutor(IOExecutor&& no_move) = delete;
+  IOExecutor& operator=(const IOExecutor& no_copy) = delete;
+  IOExecutor& operator=(IOExecutor&& no_move) = delete;
+
+  /// Build an executor sized by kNumWorkersEnv and kMaxQueueDepthEnv, falling
+  /// back to the defaults (workers are also capped by hardware concurrency)
+  static std::unique_ptr<IOExecutor> MakeFromEnv();
+
+  /// Change the number of workers and the queue depth. Workers are added
+  /// immediately; surplus workers exit once they are idle.
+  void Resize(uint32_t num_workers, uint32_t max_queue_depth);
+
+  /// Resize the executor the first time this is called and do nothing
+  /// afterwards, so that options passed with every RDG load size the
+  /// executor once rather than on each load.
+  ///
+  /// @returns false if the executor was already configured
+  bool ConfigureOnce(uint32_t num_workers, uint32_t max_queue_depth);
+
+  /// Run fn on a worker and return a future for its result
+  template <typename RetType>
+  std::future<katana::CopyableResult<RetType>> Submit(
+      std::function<katana::CopyableResult<RetType>()> fn) {
+    auto task = std::make_shared<
+        std::packaged_task<katana::CopyableResult<RetType>()>>(std::move(fn));
+    std::future<katana::CopyableResult<RetType>> future = task->get_future();
+    Enqueue([task]() { (*task)(); });
+    return future;
+  }
+
+  /// Log cumulative queue-wait and service-time statistics to the active
+  /// span of the tracer
+  void LogStats(const std::string& message) const;
+
+  Stats GetStats() const;
+  uint32_t num_workers() const;
+  uint32_t max_queue_depth() const;
+
+private:
+  struct Task {
+    std::function<void()> fn;
+    katana::TimePoint enqueued;
+  };
+
+  void Enqueue(std::function<void()> fn);
+  void WorkerLoop();
+  void Record(uint64_t wait_us, uint64_t service_us, bool was_inline);
+
+  mutable std::mutex mutex_;
+  std::condition_variable task_ready_;
+  std::condition_variable slot_ready_;
+  std::deque<Task> queue_;
+  std::vector<std::thread> workers_;
+  uint32_t target_workers_{0};
+  uint32_t live_workers_{0};
+  uint32_t max_queue_depth_{0};
+  bool configured_{false};
+  bool stopping_{false};
+
+  std::atomic<uint64_t> tasks_{0};
+  std::atomic<uint64_t> inline_tasks_{0};
+  std::atomic<uint64_t> queue_wait_us_{0};
+  std::atomic<uint64_t> max_queue_wait_us_{0};
+  std::atomic<uint64_t> service_us_{0};
+  std::atomic<uint64_t> max_service_us_{0};
+};
+
+/// The executor owned by tsuba's GlobalState; valid between tsuba::Init and
+/// tsuba::Fini
+KATANA_EXPORT IOExecutor* IO();
+
+}  // namespace tsuba
+
+#endif
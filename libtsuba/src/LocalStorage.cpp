@@ -23,10 +23,8 @@
 
 namespace fs = boost::filesystem;
 
-namespace {
-
 katana::Result<void>
-EnsureDirectories(const std::string& uri) {
+tsuba::LocalStorage::EnsureDirectories(const std::string& uri) {
   fs::path m_path{uri};
   fs::path dir = m_path.parent_path();
   if (!dir.empty()) {
@@ -41,8 +39,6 @@ EnsureDirectories(const std::string& uri) {
   return katana::ResultSuccess();
 }
 
-}  // namespace
-
 void
 tsuba::LocalStorage::CleanUri(std::string* uri) {
   if (uri->find(uri_scheme()) != 0) {
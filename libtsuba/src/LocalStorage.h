@@ -16,7 +16,6 @@ namespace tsuba {
 /// Store byte arrays to the local file system; Provided as a convenience for
 /// testing only (un-optimized)
 class LocalStorage : public FileStorage {
-  void CleanUri(std::string* uri);
   katana::Result<void> WriteFile(
       std::string, const uint8_t* data, uint64_t size);
   katana::Result<void> ReadFile(
@@ -25,6 +24,13 @@ class LocalStorage : public FileStorage {
       std::string source_uri, std::string dest_uri, uint64_t begin,
       uint64_t size);
 
+protected:
+  /// Strip the file:// scheme, if any, from uri
+  void CleanUri(std::string* uri);
+
+  /// Create the parent directories of path if they do not exist
+  static katana::Result<void> EnsureDirectories(const std::string& path);
+
 public:
   LocalStorage() : FileStorage("file://") {}
 
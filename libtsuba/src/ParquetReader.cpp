@@ -1,8 +1,8 @@
 #include "tsuba/ParquetReader.h"
 
+#include <algorithm>
 #include <limits>
 #include <memory>
-#include <unordered_map>
 
 #include <arrow/array/util.h>
 #include <arrow/chunked_array.h>
@@ -11,6 +11,7 @@
 #include <arrow/type_fwd.h>
 #include <parquet/arrow/schema.h>
 
+#include "PropertyChunks.h"
 #include "katana/JSON.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FileView.h"
@@ -74,38 +75,104 @@ BuildReader(
   return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
 }
 
+/// Append the leaf (Parquet) column indexes of field to leaves
+void
+CollectLeafColumns(
+    const parquet::arrow::SchemaField& field, std::vector<int>* leaves) {
+  if (field.children.empty()) {
+    leaves->emplace_back(field.column_index);
+    return;
+  }
+  for (const auto& child : field.children) {
+    CollectLeafColumns(child, leaves);
+  }
+}
+
+/// \returns the byte range [begin, end) in the file of the given leaf columns
+/// of a row group; all columns if leaves is empty
+std::pair<int64_t, int64_t>
+RowGroupByteRange(
+    const parquet::RowGroupMetaData& rg_md, const std::vector<int>& leaves) {
+  int64_t begin = std::numeric_limits<int64_t>::max();
+  int64_t end = 0;
+  auto add_column = [&](int col) {
+    auto col_md = rg_md.ColumnChunk(col);
+    int64_t col_begin = col_md->data_page_offset();
+    if (col_md->has_dictionary_page() && col_md->dictionary_page_offset() > 0) {
+      col_begin = std::min(col_begin, col_md->dictionary_page_offset());
+    }
+    begin = std::min(begin, col_begin);
+    end = std::max(end, col_begin + col_md->total_compressed_size());
+  };
+  if (leaves.empty()) {
+    for (int col = 0, num_cols = rg_md.num_columns(); col < num_cols; ++col) {
+      add_column(col);
+    }
+  } else {
+    for (int col : leaves) {
+      add_column(col);
+    }
+  }
+  return {std::min(begin, end), end};
+}
+
+/// Read rows [first_row, last_row) of a file. Only the row groups that
+/// overlap those rows are fetched and decoded; their column chunks are
+/// located with the footer and fetched in parallel before decoding starts.
+///
+/// \param fields if not nullopt, only read these top-level fields
 Result<std::shared_ptr<arrow::Table>>
 ReadTableSlice(
     parquet::arrow::FileReader* reader, tsuba::FileView* fv, int64_t first_row,
-    int64_t last_row) {
+    int64_t last_row, const std::optional<std::vector<int>>& fields) {
+  std::shared_ptr<parquet::FileMetaData> md =
+      reader->parquet_reader()->metadata();
+
+  std::vector<int> leaves;
+  if (fields) {
+    for (int field : fields.value()) {
+      CollectLeafColumns(reader->manifest().schema_fields.at(field), &leaves);
+    }
+  }
+
   std::vector<int> row_groups;
+  std::vector<std::pair<int64_t, int64_t>> byte_ranges;
   int rg_count = reader->num_row_groups();
   int64_t row_offset = 0;
   int64_t cumulative_rows = 0;
-  int64_t file_offset = 0;
-  int64_t cumulative_bytes = 0;
 
   for (int i = 0; cumulative_rows < last_row && i < rg_count; ++i) {
-    auto rg_md = reader->parquet_reader()->metadata()->RowGroup(i);
+    auto rg_md = md->RowGroup(i);
     int64_t new_rows = rg_md->num_rows();
-    int64_t new_bytes = rg_md->total_byte_size();
     if (first_row < cumulative_rows + new_rows) {
       if (row_groups.empty()) {
         row_offset = first_row - cumulative_rows;
-        file_offset = cumulative_bytes;
       }
       row_groups.push_back(i);
+
+      auto range = RowGroupByteRange(*rg_md, leaves);
+      if (!byte_ranges.empty() && range.first <= byte_ranges.back().second) {
+        byte_ranges.back().second =
+            std::max(byte_ranges.back().second, range.second);
+      } else {
+        byte_ranges.emplace_back(range);
+      }
     }
     cumulative_rows += new_rows;
-    cumulative_bytes += new_bytes;
   }
 
-  if (auto res = fv->Fill(file_offset, cumulative_bytes, false); !res) {
-    return res.error();
+  // Start all of the fetches before waiting on any of them
+  for (const auto& [begin, end] : byte_ranges) {
+    KATANA_CHECKED_CONTEXT(
+        fv->Fill(begin, end, false), "fetching bytes {}-{}", begin, end);
   }
 
   std::shared_ptr<arrow::Table> out;
-  KATANA_CHECKED(reader->ReadRowGroups(row_groups, &out));
+  if (fields) {
+    KATANA_CHECKED(reader->ReadRowGroups(row_groups, leaves, &out));
+  } else {
+    KATANA_CHECKED(reader->ReadRowGroups(row_groups, &out));
+  }
   return out->Slice(row_offset, last_row - first_row);
 }
 
@@ -113,11 +180,12 @@ class BlockedParquetReader {
 public:
   /// Read a potentially blocked Parquet file at the provide uri
   ///
-  /// We consider 2 cases:
+  /// We consider 3 cases:
   ///  1) uri is a single parquet file
   ///  2) uri is a json file that contains a list of offsets
+  ///  3) uri is a json chunk manifest (see PropertyChunkManifest)
   ///
-  /// We attempt 1) first and fall back on 2) if it fails.
+  /// We attempt 1) first and fall back on 2) or 3) if it fails.
   /// In both cases care is taken to read as few row groups and
   /// files as possible when accessing only metadata when preload
   /// is false. Setting preload to true will provide better performance
@@ -141,7 +209,7 @@ public:
       fvs.emplace_back(std::move(fv));
 
       return std::unique_ptr<BlockedParquetReader>(new BlockedParquetReader(
-          uri.string(), std::move(fvs), std::move(readers), {0}));
+          {uri.string()}, {0}, std::move(fvs), std::move(readers), {0}));
     }
 
     if (builder_res.error() != katana::ErrorCode::InvalidArgument) {
@@ -153,6 +221,9 @@ public:
 
     KATANA_CHECKED(fv->Fill(0, std::numeric_limits<uint64_t>::max(), true));
     std::string raw_data(fv->ptr<char>(), fv->size());
+    if (!raw_data.empty() && raw_data[0] == '{') {
+      return MakeChunked(uri, raw_data);
+    }
     KATANA_CHECKED_CONTEXT(
         katana::JsonParse(raw_data, &row_offsets),
         "trying to parse invalid parquet as list of offsets");
@@ -166,10 +237,15 @@ public:
     std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers(
         row_offsets.size());
     std::vector<std::shared_ptr<tsuba::FileView>> fvs(row_offsets.size());
+    std::vector<std::string> paths;
+    for (size_t i = 0, num_files = row_offsets.size(); i < num_files; ++i) {
+      paths.emplace_back(fmt::format("{}.part_{:09}", uri.string(), i));
+    }
+    std::vector<int64_t> file_rows(row_offsets.size(), 0);
 
     std::unique_ptr<BlockedParquetReader> bpr(new BlockedParquetReader(
-        uri.string(), std::move(fvs), std::move(readers),
-        std::move(row_offsets)));
+        std::move(paths), std::move(file_rows), std::move(fvs),
+        std::move(readers), std::move(row_offsets)));
 
     if (preload) {
       for (size_t i = 0, num_files = bpr->row_offsets_.size(); i < num_files;
@@ -181,6 +257,9 @@ public:
   }
 
   Result<int64_t> NumRows() {
+    if (num_rows_) {
+      return num_rows_.value();
+    }
     size_t last_reader_idx = readers_.size() - 1;
     KATANA_CHECKED(EnsureReader(last_reader_idx));
     return row_offsets_[last_reader_idx] +
@@ -200,9 +279,15 @@ public:
     return schema;
   }
 
+  /// Read a table, or part of one
+  ///
+  /// \param slice if not nullopt, only read these rows
+  /// \param fields if not nullopt, only read these top-level fields; they
+  ///   must be valid, sorted and unique
   Result<std::shared_ptr<arrow::Table>> ReadTable(
-      std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt) {
-    if (!slice) {
+      std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt,
+      const std::optional<std::vector<int>>& fields = std::nullopt) {
+    if (!slice && !fields && whole_files_) {
       std::vector<std::shared_ptr<arrow::Table>> tables;
       for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
         KATANA_CHECKED(EnsureReader(i, true));
@@ -213,9 +298,10 @@ public:
       return KATANA_CHECKED(arrow::ConcatenateTables(tables));
     }
 
-    int64_t curr_global_row = slice->offset;
+    int64_t num_rows = KATANA_CHECKED(NumRows());
+    int64_t curr_global_row = slice ? slice->offset : 0;
     int64_t last_global_row =
-        std::min(KATANA_CHECKED(NumRows()), curr_global_row + slice->length);
+        slice ? std::min(num_rows, curr_global_row + slice->length) : num_rows;
 
     if (last_global_row < curr_global_row) {
       return KATANA_ERROR(
@@ -238,18 +324,16 @@ public:
           (idx == row_offsets_.size() - 1 ? std::numeric_limits<int64_t>::max()
                                           : row_offsets_[idx + 1]);
       std::shared_ptr<arrow::Table> table;
-      if (curr_global_row == table_offset &&
+      if (whole_files_ && !fields && curr_global_row == table_offset &&
           last_global_row >= next_table_offset) {
         KATANA_CHECKED(EnsureReader(idx, true));
         KATANA_CHECKED(readers_[idx]->ReadTable(&table));
       } else {
         KATANA_CHECKED(EnsureReader(idx, false));
+        int64_t file_row = file_rows_[idx] - table_offset;
         table = KATANA_CHECKED(ReadTableSlice(
-            readers_[idx].get(), fvs_[idx].get(),
-            curr_global_row - table_offset,
-            std::min(
-                next_table_offset - table_offset,
-                last_global_row - table_offset)));
+            readers_[idx].get(), fvs_[idx].get(), file_row + curr_global_row,
+            file_row + std::min(next_table_offset, last_global_row), fields));
       }
       tables.emplace_back(std::move(table));
       curr_global_row = next_table_offset;
@@ -258,7 +342,10 @@ public:
     if (tables.empty()) {
       KATANA_CHECKED(EnsureReader(0, false));
       std::shared_ptr<arrow::Schema> schema;
-      KATANA_CHECKED(readers_[idx]->GetSchema(&schema));
+      KATANA_CHECKED(readers_[0]->GetSchema(&schema));
+      if (fields) {
+        schema = KATANA_CHECKED(schema->SelectFields(fields.value()));
+      }
 
       std::vector<std::shared_ptr<arrow::ChunkedArray>> cols;
       for (const auto& field : schema->fields()) {
@@ -272,76 +359,120 @@ public:
   }
 
   Result<std::shared_ptr<arrow::Table>> ReadTable(
-      std::vector<int32_t> col_indexes,
+      const std::vector<int32_t>& col_indexes,
       std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt) {
-    std::vector<std::shared_ptr<arrow::Table>> tables;
-
-    for (auto& reader : readers_) {
-      std::vector<std::shared_ptr<arrow::Field>> fields;
-      std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
-      std::unordered_map<int32_t, std::shared_ptr<arrow::ChunkedArray>>
-          read_arrays;
-
-      std::shared_ptr<arrow::Schema> schema;
-      KATANA_CHECKED(reader->GetSchema(&schema));
-      for (int32_t idx : col_indexes) {
-        if (idx < 0) {
-          return KATANA_ERROR(
-              ErrorCode::InvalidArgument, "column indexes must be positive");
-        }
-        if (idx >= schema->num_fields()) {
-          return KATANA_ERROR(
-              ErrorCode::InvalidArgument,
-              "column index {} should be less than the number of columns {}",
-              idx, schema->num_fields());
-        }
-        std::shared_ptr<arrow::ChunkedArray> column;
-        if (auto arr_it = read_arrays.find(idx); arr_it != read_arrays.end()) {
-          column = arr_it->second;
-        } else {
-          KATANA_CHECKED(reader->ReadColumn(idx, &column));
-          read_arrays.emplace(idx, column);
-        }
-        fields.emplace_back(schema->field(idx));
-        columns.emplace_back(std::move(column));
+    std::shared_ptr<arrow::Schema> schema = KATANA_CHECKED(ReadSchema());
+    for (int32_t idx : col_indexes) {
+      if (idx < 0) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument, "column indexes must be positive");
+      }
+      if (idx >= schema->num_fields()) {
+        return KATANA_ERROR(
+            ErrorCode::InvalidArgument,
+            "column index {} should be less than the number of columns {}",
+            idx, schema->num_fields());
       }
-      tables.emplace_back(arrow::Table::Make(arrow::schema(fields), columns));
     }
 
-    std::shared_ptr<arrow::Table> concatenated_table =
-        KATANA_CHECKED(arrow::ConcatenateTables(tables));
-    if (slice) {
-      concatenated_table =
-          concatenated_table->Slice(slice->offset, slice->length);
+    // read each column once even if it is requested more than once
+    std::vector<int> fields(col_indexes.begin(), col_indexes.end());
+    std::sort(fields.begin(), fields.end());
+    fields.erase(std::unique(fields.begin(), fields.end()), fields.end());
+
+    std::shared_ptr<arrow::Table> table =
+        KATANA_CHECKED(ReadTable(slice, fields));
+
+    std::vector<std::shared_ptr<arrow::Field>> out_fields;
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> out_columns;
+    for (int32_t idx : col_indexes) {
+      int pos = std::lower_bound(fields.begin(), fields.end(), idx) -
+                fields.begin();
+      out_fields.emplace_back(table->field(pos));
+      out_columns.emplace_back(table->column(pos));
     }
-    return concatenated_table;
+    return arrow::Table::Make(
+        arrow::schema(out_fields), out_columns, table->num_rows());
   }
 
 private:
   BlockedParquetReader(
-      std::string prefix, std::vector<std::shared_ptr<tsuba::FileView>>&& fvs,
+      std::vector<std::string>&& paths, std::vector<int64_t>&& file_rows,
+      std::vector<std::shared_ptr<tsuba::FileView>>&& fvs,
       std::vector<std::unique_ptr<parquet::arrow::FileReader>>&& readers,
       std::vector<int64_t>&& row_offsets)
-      : prefix_(std::move(prefix)),
+      : paths_(std::move(paths)),
+        file_rows_(std::move(file_rows)),
         fvs_(std::move(fvs)),
         readers_(std::move(readers)),
         row_offsets_(std::move(row_offsets)) {}
 
+  /// Each run of chunks that are consecutive in the same file becomes a
+  /// block
+  static Result<std::unique_ptr<BlockedParquetReader>> MakeChunked(
+      const katana::Uri& uri, const std::string& raw_data) {
+    tsuba::PropertyChunkManifest manifest;
+    KATANA_CHECKED_CONTEXT(
+        katana::JsonParse(raw_data, &manifest), "parsing chunk manifest {}",
+        uri);
+    if (manifest.chunks.empty()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "chunk manifest {} is empty",
+          uri);
+    }
+
+    katana::Uri dir = uri.DirName();
+    std::vector<std::string> paths;
+    std::vector<int64_t> file_rows;
+    std::vector<int64_t> row_offsets;
+    for (size_t i = 0, num_chunks = manifest.chunks.size(); i < num_chunks;
+         ++i) {
+      const tsuba::PropertyChunk& chunk = manifest.chunks[i];
+      if (i > 0) {
+        const tsuba::PropertyChunk& last = manifest.chunks[i - 1];
+        if (last.path == chunk.path &&
+            last.file_row + manifest.chunk_rows == chunk.file_row) {
+          continue;
+        }
+      }
+      paths.emplace_back(dir.Join(chunk.path).string());
+      file_rows.emplace_back(chunk.file_row);
+      row_offsets.emplace_back(i * manifest.chunk_rows);
+    }
+
+    std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers(
+        paths.size());
+    std::vector<std::shared_ptr<tsuba::FileView>> fvs(paths.size());
+    std::unique_ptr<BlockedParquetReader> bpr(new BlockedParquetReader(
+        std::move(paths), std::move(file_rows), std::move(fvs),
+        std::move(readers), std::move(row_offsets)));
+    bpr->num_rows_ = manifest.num_rows;
+    bpr->whole_files_ = false;
+    return std::unique_ptr<BlockedParquetReader>(std::move(bpr));
+  }
+
   Result<void> EnsureReader(size_t idx, bool preload = false) {
     if (readers_[idx]) {
       KATANA_LOG_ASSERT(fvs_[idx]);
       return katana::ResultSuccess();
     }
-    readers_[idx] = KATANA_CHECKED(BuildReader(
-        fmt::format("{}.part_{:09}", prefix_, idx), preload, &fvs_[idx]));
+    readers_[idx] =
+        KATANA_CHECKED(BuildReader(paths_[idx], preload, &fvs_[idx]));
 
     return katana::ResultSuccess();
   }
 
-  std::string prefix_;
+  std::vector<std::string> paths_;
+  /// Row in each file where its block starts
+  std::vector<int64_t> file_rows_;
   std::vector<std::shared_ptr<tsuba::FileView>> fvs_;
   std::vector<std::unique_ptr<parquet::arrow::FileReader>> readers_;
+  /// Row in the table where each block starts
   std::vector<int64_t> row_offsets_;
+  /// Rows in the table if known without opening the last file
+  std::optional<int64_t> num_rows_;
+  /// True if each block is a whole file
+  bool whole_files_{true};
 };
 
 }  // namespace
@@ -377,14 +508,14 @@ tsuba::ParquetReader::GetSchema(const katana::Uri& uri) {
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadColumn(const katana::Uri& uri, int32_t column_idx) {
   auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
-  return FixTable(KATANA_CHECKED(bpr->ReadTable({column_idx})));
+  return FixTable(KATANA_CHECKED(bpr->ReadTable({column_idx}, slice_)));
 }
 
 Result<std::shared_ptr<arrow::Table>>
 tsuba::ParquetReader::ReadTable(
     const katana::Uri& uri, const std::vector<int32_t>& column_indexes) {
   auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
-  return FixTable(KATANA_CHECKED(bpr->ReadTable(column_indexes)));
+  return FixTable(KATANA_CHECKED(bpr->ReadTable(column_indexes, slice_)));
 }
 
 Result<int32_t>
@@ -1,5 +1,12 @@
 #include "tsuba/ParquetWriter.h"
 
+#include <string>
+#include <unordered_set>
+
+#include <arrow/type_traits.h>
+#include <parquet/types.h>
+
+#include "IOExecutor.h"
 #include "katana/ArrowInterchange.h"
 #include "katana/JSON.h"
 #include "katana/Result.h"
@@ -34,6 +41,90 @@ EstimateRowSize(const std::shared_ptr<arrow::Table>& table) {
 
 constexpr uint64_t kMB = 1UL << 20;
 
+// Number of values sampled to estimate the cardinality of an integer column
+constexpr int64_t kCardinalitySampleSize = 4096;
+// Integer columns are dictionary encoded when at most 1/kLowCardinalityDivisor
+// of their sampled values are distinct
+constexpr int64_t kLowCardinalityDivisor = 8;
+
+bool
+IsStringLike(const std::shared_ptr<arrow::DataType>& type) {
+  switch (type->id()) {
+  case arrow::Type::STRING:
+  case arrow::Type::LARGE_STRING:
+  case arrow::Type::BINARY:
+  case arrow::Type::LARGE_BINARY:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Estimate whether a column has few distinct values from evenly spaced
+/// samples of it
+bool
+IsLowCardinality(const std::shared_ptr<arrow::ChunkedArray>& column) {
+  int64_t length = column->length();
+  if (length == 0) {
+    return false;
+  }
+  int64_t step = std::max<int64_t>(1, length / kCardinalitySampleSize);
+
+  std::unordered_set<std::string> distinct;
+  int64_t num_sampled = 0;
+  for (int64_t i = 0; i < length && num_sampled < kCardinalitySampleSize;
+       i += step) {
+    auto scalar_res = column->GetScalar(i);
+    if (!scalar_res.ok() || !scalar_res.ValueOrDie()->is_valid) {
+      continue;
+    }
+    distinct.emplace(scalar_res.ValueOrDie()->ToString());
+    ++num_sampled;
+  }
+  return num_sampled > 0 &&
+         static_cast<int64_t>(distinct.size()) * kLowCardinalityDivisor <=
+             num_sampled;
+}
+
+/// Fill in the unset fields of opts with defaults for column
+void
+SetTypeDefaults(
+    const std::shared_ptr<arrow::ChunkedArray>& column,
+    tsuba::ParquetWriter::ColumnOpts* opts) {
+  const auto& type = column->type();
+  if (IsStringLike(type)) {
+    if (!opts->compression &&
+        parquet::IsCodecSupported(parquet::Compression::ZSTD)) {
+      opts->compression = parquet::Compression::ZSTD;
+    }
+  } else if (arrow::is_integer(type->id())) {
+    if (!opts->dictionary) {
+      opts->dictionary = IsLowCardinality(column);
+    }
+  }
+}
+
+/// Merge per column settings: fields set in col_override take precedence
+tsuba::ParquetWriter::ColumnOpts
+MergeColumnOpts(
+    const tsuba::ParquetWriter::ColumnOpts& base,
+    const tsuba::ParquetWriter::ColumnOpts& col_override) {
+  tsuba::ParquetWriter::ColumnOpts merged = base;
+  if (col_override.compression) {
+    merged.compression = col_override.compression;
+  }
+  if (col_override.compression_level) {
+    merged.compression_level = col_override.compression_level;
+  }
+  if (col_override.dictionary) {
+    merged.dictionary = col_override.dictionary;
+  }
+  if (col_override.statistics) {
+    merged.statistics = col_override.statistics;
+  }
+  return merged;
+}
+
 std::vector<std::shared_ptr<arrow::Table>>
 BlockTable(std::shared_ptr<arrow::Table> table, uint64_t mbs_per_block) {
   if (table->num_rows() <= 1) {
@@ -63,18 +154,18 @@ DoStoreParquet(
     const std::string& path, std::shared_ptr<arrow::Table> table,
     const std::shared_ptr<parquet::WriterProperties>& writer_props,
     const std::shared_ptr<parquet::ArrowWriterProperties>& arrow_props,
-    tsuba::WriteGroup* desc) {
+    int64_t max_row_group_length, tsuba::WriteGroup* desc) {
   auto ff = std::make_shared<tsuba::FileFrame>();
   KATANA_CHECKED(ff->Init());
   ff->Bind(path);
 
-  auto future = std::async(
-      std::launch::async,
+  auto future = tsuba::IO()->Submit<void>(
       [table = std::move(table), ff = std::move(ff), desc, writer_props,
-       arrow_props]() mutable -> katana::CopyableResult<void> {
+       arrow_props,
+       max_row_group_length]() mutable -> katana::CopyableResult<void> {
         auto write_result = parquet::arrow::WriteTable(
-            *table, arrow::default_memory_pool(), ff,
-            std::numeric_limits<int64_t>::max(), writer_props, arrow_props);
+            *table, arrow::default_memory_pool(), ff, max_row_group_length,
+            writer_props, arrow_props);
         table.reset();
 
         if (!write_result.ok()) {
@@ -138,11 +229,46 @@ tsuba::ParquetWriter::WriteToUri(const katana::Uri& uri, WriteGroup* group) {
 }
 
 std::shared_ptr<parquet::WriterProperties>
-tsuba::ParquetWriter::StandardWriterProperties() {
-  return parquet::WriterProperties::Builder()
-      .version(opts_.parquet_version)
+tsuba::ParquetWriter::StandardWriterProperties(
+    const std::shared_ptr<arrow::Table>& table) {
+  parquet::WriterProperties::Builder builder;
+  builder.version(opts_.parquet_version)
       ->data_page_version(opts_.data_page_version)
-      ->build();
+      ->max_row_group_length(opts_.max_row_group_length);
+
+  // Settings are keyed by column path, which for the flat columns we write is
+  // just the field name
+  for (int i = 0, num_columns = table->num_columns(); i < num_columns; ++i) {
+    const std::string& name = table->field(i)->name();
+    ColumnOpts col_opts = opts_.columns;
+    if (auto it = opts_.column_overrides.find(name);
+        it != opts_.column_overrides.end()) {
+      col_opts = MergeColumnOpts(col_opts, it->second);
+    }
+    SetTypeDefaults(table->column(i), &col_opts);
+
+    if (col_opts.compression) {
+      builder.compression(name, col_opts.compression.value());
+    }
+    if (col_opts.compression_level) {
+      builder.compression_level(name, col_opts.compression_level.value());
+    }
+    if (col_opts.dictionary) {
+      if (col_opts.dictionary.value()) {
+        builder.enable_dictionary(name);
+      } else {
+        builder.disable_dictionary(name);
+      }
+    }
+    if (col_opts.statistics) {
+      if (col_opts.statistics.value()) {
+        builder.enable_statistics(name);
+      } else {
+        builder.disable_statistics(name);
+      }
+    }
+  }
+  return builder.build();
 }
 
 std::shared_ptr<parquet::ArrowWriterProperties>
@@ -155,12 +281,19 @@ katana::Result<void>
 tsuba::ParquetWriter::StoreParquet(
     std::shared_ptr<arrow::Table> table, const katana::Uri& uri,
     tsuba::WriteGroup* desc) {
-  auto writer_props = StandardWriterProperties();
+  if (opts_.max_row_group_length <= 0) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::InvalidArgument,
+        "max_row_group_length must be positive");
+  }
+  auto writer_props = StandardWriterProperties(table);
   auto arrow_props = StandardArrowProperties();
   std::string prefix = uri.string();
 
   if (table->num_rows() <= kMaxRowsPerFile) {
-    return DoStoreParquet(prefix, table, writer_props, arrow_props, desc);
+    return DoStoreParquet(
+        prefix, table, writer_props, arrow_props, opts_.max_row_group_length,
+        desc);
   }
 
   std::vector<std::shared_ptr<arrow::Table>> tables;
@@ -183,7 +316,7 @@ tsuba::ParquetWriter::StoreParquet(
   for (const auto& t : tables) {
     KATANA_CHECKED(DoStoreParquet(
         fmt::format("{}.part_{:09}", prefix, table_count++), t, writer_props,
-        arrow_props, desc));
+        arrow_props, opts_.max_row_group_length, desc));
   }
   return FileStore(
       uri.string(), KATANA_CHECKED(katana::JsonDump(table_offsets)));
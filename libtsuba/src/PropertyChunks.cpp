@@ -0,0 +1,430 @@
+#include "PropertyChunks.h"
+
+#include <cstring>
+#include <string_view>
+#include <unordered_set>
+
+#include <arrow/type_traits.h>
+
+#include "katana/Env.h"
+#include "katana/ProgressTracer.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileView.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/file.h"
+
+namespace {
+
+constexpr int kManifestVersion = 2;
+/// Version 1 manifests store 64-bit hashes, which are ignored
+constexpr int kMinManifestVersion = 1;
+
+// Keep files well under the row limit where ParquetWriter splits a table
+// into several files
+constexpr int64_t kMaxRowsPerFile = INT64_C(1) << 29;
+
+constexpr uint64_t kNullHash = 0x9e3779b97f4a7c15;
+
+/// splitmix64 finalizer
+uint64_t
+Mix(uint64_t x) {
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// A 128-bit hash built from two independently mixed 64-bit lanes. It is
+/// not cryptographic, but collisions between versions of a chunk are far
+/// less likely than with a single 64-bit hash.
+class ChunkHasher {
+public:
+  explicit ChunkHasher(uint64_t seed)
+      : a_(Mix(seed ^ 0x243f6a8885a308d3ULL)),
+        b_(Mix(seed ^ 0x13198a2e03707344ULL)) {}
+
+  void Add(uint64_t value) {
+    a_ = Mix(a_ ^ value);
+    b_ = Mix(b_ + value * 0x9fb21c651e98df25ULL) ^ (b_ >> 29);
+    ++count_;
+  }
+
+  void AddBytes(const uint8_t* data, size_t size) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+      uint64_t word;
+      std::memcpy(&word, data + i, sizeof(word));
+      Add(word);
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + i, size - i);
+    Add(tail);
+    Add(size);
+  }
+
+  tsuba::PropertyChunk::Hash Finish() const {
+    return {Mix(a_ ^ count_), Mix(b_ ^ a_ ^ count_)};
+  }
+
+private:
+  uint64_t a_;
+  uint64_t b_;
+  uint64_t count_{0};
+};
+
+template <typename ArrayType>
+void
+HashBinary(const arrow::Array& array, ChunkHasher* hasher) {
+  const auto& typed = static_cast<const ArrayType&>(array);
+  for (int64_t i = 0, length = typed.length(); i < length; ++i) {
+    if (typed.IsNull(i)) {
+      hasher->Add(kNullHash);
+      continue;
+    }
+    auto view = typed.GetView(i);
+    hasher->AddBytes(
+        reinterpret_cast<const uint8_t*>(view.data()), view.size());
+  }
+}
+
+/// Add the values in array to hasher
+///
+/// \returns false if values of this type are not hashed
+bool
+HashArray(const arrow::Array& array, ChunkHasher* hasher) {
+  const auto& type = array.type();
+  switch (type->id()) {
+  case arrow::Type::STRING:
+  case arrow::Type::BINARY:
+    HashBinary<arrow::BinaryArray>(array, hasher);
+    return true;
+  case arrow::Type::LARGE_STRING:
+  case arrow::Type::LARGE_BINARY:
+    HashBinary<arrow::LargeBinaryArray>(array, hasher);
+    return true;
+  case arrow::Type::BOOL: {
+    const auto& typed = static_cast<const arrow::BooleanArray&>(array);
+    for (int64_t i = 0, length = typed.length(); i < length; ++i) {
+      hasher->Add(typed.IsNull(i) ? kNullHash : typed.Value(i));
+    }
+    return true;
+  }
+  default:
+    break;
+  }
+
+  // other fixed width types can be hashed as bytes
+  if (!arrow::is_primitive(type->id()) &&
+      type->id() != arrow::Type::FIXED_SIZE_BINARY &&
+      !arrow::is_decimal(type->id())) {
+    return false;
+  }
+  const auto& fw_type = static_cast<const arrow::FixedWidthType&>(*type);
+  if (fw_type.bit_width() % 8 != 0 || array.data()->buffers.size() < 2 ||
+      array.data()->buffers[1] == nullptr) {
+    return false;
+  }
+  size_t byte_width = fw_type.bit_width() / 8;
+  const uint8_t* values =
+      array.data()->buffers[1]->data() + array.offset() * byte_width;
+
+  if (array.null_count() == 0) {
+    hasher->AddBytes(values, array.length() * byte_width);
+    return true;
+  }
+  // the bytes under null entries are undefined
+  for (int64_t i = 0, length = array.length(); i < length; ++i) {
+    if (array.IsNull(i)) {
+      hasher->Add(kNullHash);
+    } else {
+      hasher->AddBytes(values + i * byte_width, byte_width);
+    }
+  }
+  return true;
+}
+
+/// \returns a hash of rows [offset, offset + length) of column, or nullopt
+/// if values of its type are not hashed
+std::optional<tsuba::PropertyChunk::Hash>
+HashRows(const arrow::ChunkedArray& column, int64_t offset, int64_t length) {
+  ChunkHasher hasher(std::hash<std::string>{}(column.type()->ToString()));
+  hasher.Add(length);
+  for (const auto& chunk : column.Slice(offset, length)->chunks()) {
+    if (!HashArray(*chunk, &hasher)) {
+      return std::nullopt;
+    }
+  }
+  return hasher.Finish();
+}
+
+/// Write num_rows rows of column starting at first_row to a new file in dir
+///
+/// \returns the name of the new file
+katana::Result<std::string>
+WriteRows(
+    const std::shared_ptr<arrow::ChunkedArray>& column, const std::string& name,
+    int64_t first_row, int64_t num_rows, int64_t chunk_rows,
+    const katana::Uri& dir, tsuba::WriteGroup* desc) {
+  tsuba::ParquetWriter::WriteOpts opts;
+  // row groups that do not straddle chunks let reads of a chunk skip the
+  // rest of the file
+  opts.max_row_group_length = std::min(opts.max_row_group_length, chunk_rows);
+  auto writer = KATANA_CHECKED(tsuba::ParquetWriter::Make(
+      column->Slice(first_row, num_rows), name, opts));
+
+  katana::Uri path = dir.RandFile(name);
+  KATANA_CHECKED_CONTEXT(writer->WriteToUri(path, desc), "writing {}", path);
+  return path.BaseName();
+}
+
+}  // namespace
+
+tsuba::ChunkedPropertyOpts
+tsuba::ChunkedPropertyOpts::FromEnv() {
+  ChunkedPropertyOpts opts;
+  if (int val = 0; katana::GetEnv(kChunkRowsEnv, &val) && val >= 0) {
+    opts.chunk_rows = val;
+  }
+  if (int val = 0; katana::GetEnv(kMaxDeltaFilesEnv, &val) && val >= 0) {
+    opts.max_delta_files = val;
+  }
+  return opts;
+}
+
+bool
+tsuba::PropertyChunkManifest::IsManifestPath(const std::string& path) {
+  std::string_view suffix(kSuffix);
+  return path.size() > suffix.size() &&
+         std::string_view(path).substr(path.size() - suffix.size()) == suffix;
+}
+
+katana::Result<tsuba::PropertyChunkManifest>
+tsuba::PropertyChunkManifest::Read(const katana::Uri& uri) {
+  FileView fv;
+  KATANA_CHECKED_CONTEXT(fv.Bind(uri.string(), true), "opening {}", uri);
+
+  PropertyChunkManifest manifest;
+  KATANA_CHECKED_CONTEXT(
+      katana::JsonParse(fv, &manifest), "parsing chunk manifest {}", uri);
+  return manifest;
+}
+
+katana::Result<void>
+tsuba::PropertyChunkManifest::Write(const katana::Uri& uri) const {
+  std::string serialized = KATANA_CHECKED(katana::JsonDump(*this));
+  return FileStore(uri.string(), serialized);
+}
+
+std::vector<std::string>
+tsuba::PropertyChunkManifest::Files() const {
+  std::vector<std::string> files;
+  std::unordered_set<std::string> seen;
+  for (const auto& chunk : chunks) {
+    if (seen.emplace(chunk.path).second) {
+      files.emplace_back(chunk.path);
+    }
+  }
+  return files;
+}
+
+tsuba::StoredArrays
+tsuba::StoredArrays::Of(const arrow::ChunkedArray& column) {
+  StoredArrays stored;
+  int64_t first_row = 0;
+  for (const auto& chunk : column.chunks()) {
+    if (chunk->length() > 0) {
+      stored.arrays_.emplace_back(Entry{first_row, chunk->data()});
+    }
+    first_row += chunk->length();
+  }
+  return stored;
+}
+
+bool
+tsuba::StoredArrays::Unchanged(
+    const arrow::ChunkedArray& column, int64_t offset, int64_t length) const {
+  if (arrays_.empty()) {
+    return false;
+  }
+  int64_t end = offset + length;
+  int64_t first_row = 0;
+  for (const auto& chunk : column.chunks()) {
+    int64_t chunk_end = first_row + chunk->length();
+    if (chunk->length() > 0 && chunk_end > offset && first_row < end) {
+      auto it = std::lower_bound(
+          arrays_.begin(), arrays_.end(), first_row,
+          [](const Entry& e, int64_t row) { return e.first_row < row; });
+      if (it == arrays_.end() || it->first_row != first_row ||
+          it->data.lock() != chunk->data()) {
+        return false;
+      }
+    }
+    if (chunk_end >= end) {
+      break;
+    }
+    first_row = chunk_end;
+  }
+  return true;
+}
+
+void
+tsuba::to_json(nlohmann::json& j, const PropertyChunk& chunk) {
+  j = nlohmann::json{chunk.path, chunk.file_row, nullptr};
+  if (chunk.hash) {
+    j[2] = nlohmann::json{chunk.hash->lo, chunk.hash->hi};
+  }
+}
+
+void
+tsuba::from_json(const nlohmann::json& j, PropertyChunk& chunk) {
+  j.at(0).get_to(chunk.path);
+  j.at(1).get_to(chunk.file_row);
+  // 64-bit hashes of version 1 manifests are not comparable, so their
+  // chunks are treated as unhashed
+  if (const auto& hash = j.at(2); hash.is_array() && hash.size() == 2) {
+    chunk.hash = PropertyChunk::Hash{
+        hash.at(0).get<uint64_t>(), hash.at(1).get<uint64_t>()};
+  } else {
+    chunk.hash = std::nullopt;
+  }
+}
+
+void
+tsuba::to_json(nlohmann::json& j, const PropertyChunkManifest& manifest) {
+  j = nlohmann::json{
+      {"version", kManifestVersion},
+      {"num_rows", manifest.num_rows},
+      {"chunk_rows", manifest.chunk_rows},
+      {"chunks", manifest.chunks},
+  };
+}
+
+void
+tsuba::from_json(const nlohmann::json& j, PropertyChunkManifest& manifest) {
+  if (int version = j.at("version").get<int>();
+      version < kMinManifestVersion || version > kManifestVersion) {
+    throw std::runtime_error("unsupported chunk manifest version");
+  }
+  j.at("num_rows").get_to(manifest.num_rows);
+  j.at("chunk_rows").get_to(manifest.chunk_rows);
+  j.at("chunks").get_to(manifest.chunks);
+
+  if (manifest.chunk_rows <= 0 ||
+      manifest.chunks.size() !=
+          static_cast<size_t>(
+              (manifest.num_rows + manifest.chunk_rows - 1) /
+              manifest.chunk_rows)) {
+    throw std::runtime_error("chunk manifest does not cover its rows");
+  }
+}
+
+katana::Result<std::string>
+tsuba::StoreChunkedProperty(
+    const std::shared_ptr<arrow::ChunkedArray>& column, const std::string& name,
+    const katana::Uri& dir, const PropertyChunkManifest* prev,
+    const StoredArrays* stored, const ChunkedPropertyOpts& opts,
+    WriteGroup* desc) {
+  if (opts.chunk_rows <= 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "chunk_rows must be positive");
+  }
+
+  PropertyChunkManifest manifest;
+  manifest.num_rows = column->length();
+  manifest.chunk_rows = opts.chunk_rows;
+  size_t num_chunks =
+      (manifest.num_rows + manifest.chunk_rows - 1) / manifest.chunk_rows;
+  manifest.chunks.resize(num_chunks);
+
+  bool can_reuse = prev != nullptr && prev->chunk_rows == opts.chunk_rows;
+  std::vector<bool> changed(num_chunks, true);
+  uint64_t chunks_hashed = 0;
+  for (size_t i = 0; i < num_chunks; ++i) {
+    PropertyChunk& chunk = manifest.chunks[i];
+    int64_t offset = i * opts.chunk_rows;
+    int64_t length = manifest.ChunkLength(i);
+    bool comparable = can_reuse && i < prev->chunks.size() &&
+                      prev->ChunkLength(i) == length;
+    if (comparable && stored != nullptr &&
+        stored->Unchanged(*column, offset, length)) {
+      chunk = prev->chunks[i];
+      changed[i] = false;
+      continue;
+    }
+
+    chunk.hash = HashRows(*column, offset, length);
+    ++chunks_hashed;
+    if (comparable && chunk.hash && prev->chunks[i].hash == chunk.hash) {
+      chunk.path = prev->chunks[i].path;
+      chunk.file_row = prev->chunks[i].file_row;
+      changed[i] = false;
+    }
+  }
+
+  // Group changed chunks into runs of consecutive chunks; each run becomes
+  // one file
+  int64_t chunks_per_file =
+      std::max<int64_t>(1, kMaxRowsPerFile / opts.chunk_rows);
+  auto make_runs = [&]() {
+    std::vector<std::pair<size_t, size_t>> runs;
+    for (size_t i = 0; i < num_chunks; ++i) {
+      if (!changed[i]) {
+        continue;
+      }
+      if (!runs.empty() && runs.back().second == i &&
+          static_cast<int64_t>(i - runs.back().first) < chunks_per_file) {
+        runs.back().second = i + 1;
+      } else {
+        runs.emplace_back(i, i + 1);
+      }
+    }
+    return runs;
+  };
+  std::vector<std::pair<size_t, size_t>> runs = make_runs();
+
+  std::unordered_set<std::string> kept_files;
+  for (size_t i = 0; i < num_chunks; ++i) {
+    if (!changed[i]) {
+      kept_files.emplace(manifest.chunks[i].path);
+    }
+  }
+  int64_t num_base_files =
+      (static_cast<int64_t>(num_chunks) + chunks_per_file - 1) /
+      chunks_per_file;
+  bool fold = static_cast<int64_t>(kept_files.size() + runs.size()) >
+              num_base_files + opts.max_delta_files;
+  if (fold) {
+    std::fill(changed.begin(), changed.end(), true);
+    runs = make_runs();
+  }
+
+  int64_t rows_written = 0;
+  for (const auto& [begin, end] : runs) {
+    int64_t first_row = begin * opts.chunk_rows;
+    int64_t num_rows = std::min(
+        static_cast<int64_t>(end - begin) * opts.chunk_rows,
+        manifest.num_rows - first_row);
+    std::string path = KATANA_CHECKED(WriteRows(
+        column, name, first_row, num_rows, opts.chunk_rows, dir, desc));
+    for (size_t i = begin; i < end; ++i) {
+      manifest.chunks[i].path = path;
+      manifest.chunks[i].file_row = (i - begin) * opts.chunk_rows;
+    }
+    rows_written += num_rows;
+  }
+
+  katana::Uri manifest_path =
+      dir.RandFile(name) + std::string(PropertyChunkManifest::kSuffix);
+  KATANA_CHECKED_CONTEXT(
+      manifest.Write(manifest_path), "writing {}", manifest_path);
+
+  katana::GetTracer().GetActiveSpan().Log(
+      "stored chunked property",
+      {{"name", name},
+       {"chunks", static_cast<uint64_t>(num_chunks)},
+       {"chunks_hashed", chunks_hashed},
+       {"files_written", static_cast<uint64_t>(runs.size())},
+       {"rows_written", rows_written},
+       {"folded", fold}});
+
+  return manifest_path.BaseName();
+}
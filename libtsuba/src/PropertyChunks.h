@@ -0,0 +1,143 @@
+#ifndef KATANA_LIBTSUBA_PROPERTYCHUNKS_H_
+#define KATANA_LIBTSUBA_PROPERTYCHUNKS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/JSON.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "katana/config.h"
+#include "tsuba/WriteGroup.h"
+
+namespace tsuba {
+
+/// Large properties are stored as a chunk manifest: a small JSON file that
+/// divides the rows of a property into fixed size chunks and points each
+/// chunk at a range of rows in a Parquet file.
+///
+/// The first write of a property puts all of its chunks in as few files as
+/// possible (base files). Later writes only write the runs of chunks that
+/// changed since the previous manifest (delta files); unchanged chunks keep
+/// pointing at files written by earlier versions of the RDG, so the cost of
+/// a commit follows the size of the change. When a manifest would point at
+/// too many delta files, the write folds the property back into base files.
+///
+/// A chunk is unchanged if it is still held by the arrow arrays that were
+/// loaded from or written to the previous manifest (see StoredArrays), or
+/// else if its content hash matches the previous manifest's.
+struct PropertyChunk {
+  /// 128-bit content hash of a chunk's values
+  struct Hash {
+    uint64_t lo{0};
+    uint64_t hi{0};
+
+    bool operator==(const Hash& other) const {
+      return lo == other.lo && hi == other.hi;
+    }
+  };
+
+  /// file holding the chunk, relative to the RDG directory
+  std::string path;
+  /// row in path where the chunk starts
+  int64_t file_row{0};
+  /// hash of the chunk's values; nullopt if its type is not hashed, in which
+  /// case the chunk is rewritten unless its arrays are unchanged
+  std::optional<Hash> hash;
+};
+
+/// The arrow arrays that held a property when it was last loaded from or
+/// written to storage. Arrays are held weakly, so tracking them does not keep
+/// memory alive; an array that was freed is not recognized anymore.
+///
+/// tsuba only sees changes made by upserting properties, so rows held by the
+/// same arrays at the same positions are taken to be unchanged without
+/// reading them.
+class KATANA_EXPORT StoredArrays {
+public:
+  StoredArrays() = default;
+
+  static StoredArrays Of(const arrow::ChunkedArray& column);
+
+  /// \returns true if rows [offset, offset + length) of column are held by
+  /// the same arrays at the same rows as when stored
+  bool Unchanged(
+      const arrow::ChunkedArray& column, int64_t offset, int64_t length) const;
+
+  bool empty() const { return arrays_.empty(); }
+
+private:
+  struct Entry {
+    int64_t first_row;
+    std::weak_ptr<arrow::ArrayData> data;
+  };
+  /// sorted by first_row
+  std::vector<Entry> arrays_;
+};
+
+struct ChunkedPropertyOpts {
+  static constexpr const char* kChunkRowsEnv = "KATANA_PROPERTY_CHUNK_ROWS";
+  static constexpr const char* kMaxDeltaFilesEnv =
+      "KATANA_PROPERTY_MAX_DELTA_FILES";
+
+  /// Rows per chunk; properties with fewer rows than this are written as
+  /// plain Parquet files. 0 disables chunked storage.
+  int64_t chunk_rows{INT64_C(1) << 22};
+  /// Number of delta files a manifest may point at before the property is
+  /// folded back into base files
+  int64_t max_delta_files{16};
+
+  /// Defaults overridden by kChunkRowsEnv and kMaxDeltaFilesEnv
+  static ChunkedPropertyOpts FromEnv();
+};
+
+struct KATANA_EXPORT PropertyChunkManifest {
+  static constexpr const char* kSuffix = ".chunks";
+
+  int64_t num_rows{0};
+  int64_t chunk_rows{0};
+  std::vector<PropertyChunk> chunks;
+
+  /// \returns true if path names a chunk manifest rather than a Parquet file
+  static bool IsManifestPath(const std::string& path);
+
+  static katana::Result<PropertyChunkManifest> Read(const katana::Uri& uri);
+  katana::Result<void> Write(const katana::Uri& uri) const;
+
+  /// Number of rows in chunk i
+  int64_t ChunkLength(size_t i) const {
+    return std::min(
+        chunk_rows, num_rows - static_cast<int64_t>(i) * chunk_rows);
+  }
+
+  /// The distinct files that chunks point at
+  std::vector<std::string> Files() const;
+};
+
+void to_json(nlohmann::json& j, const PropertyChunk& chunk);
+void from_json(const nlohmann::json& j, PropertyChunk& chunk);
+
+void to_json(nlohmann::json& j, const PropertyChunkManifest& manifest);
+void from_json(const nlohmann::json& j, PropertyChunkManifest& manifest);
+
+/// Store column as a chunked property in dir. Chunks that are unchanged
+/// from prev (which must describe a property stored in dir) are not
+/// written again. If given, stored are the arrays that held prev's rows;
+/// chunks still held by them are not hashed.
+///
+/// \returns the name of the manifest in dir
+KATANA_EXPORT katana::Result<std::string> StoreChunkedProperty(
+    const std::shared_ptr<arrow::ChunkedArray>& column, const std::string& name,
+    const katana::Uri& dir, const PropertyChunkManifest* prev,
+    const StoredArrays* stored, const ChunkedPropertyOpts& opts,
+    WriteGroup* desc);
+
+}  // namespace tsuba
+
+#endif
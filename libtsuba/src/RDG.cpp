@@ -24,14 +24,18 @@
 
 #include "AddProperties.h"
 #include "GlobalState.h"
+#include "IOExecutor.h"
+#include "PropertyChunks.h"
 #include "RDGCore.h"
 #include "RDGHandleImpl.h"
 #include "katana/ArrowInterchange.h"
+#include "katana/Env.h"
 #include "katana/ErrorCode.h"
 #include "katana/JSON.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
+#include "tsuba/ArrowIPC.h"
 #include "tsuba/Errors.h"
 #include "tsuba/FaultTest.h"
 #include "tsuba/ParquetWriter.h"
@@ -45,6 +49,8 @@ using json = nlohmann::json;
 
 namespace {
 
+constexpr const char* kMapTopologyEnv = "KATANA_MAP_TOPOLOGY";
+
 katana::Result<std::string>
 StoreArrowArrayAtName(
     const std::shared_ptr<arrow::ChunkedArray>& array, const katana::Uri& dir,
@@ -62,23 +68,82 @@ StoreArrowArrayAtName(
   return new_path.BaseName();
 }
 
+katana::Result<std::string>
+StoreArrowIPCAtName(
+    const std::shared_ptr<arrow::ChunkedArray>& array, const katana::Uri& dir,
+    const std::string& name, tsuba::WriteGroup* desc) {
+  auto writer = KATANA_CHECKED_CONTEXT(
+      tsuba::ArrowIPCWriter::Make(array, name), "making property writer");
+
+  katana::Uri new_path =
+      dir.RandFile(name) + std::string(tsuba::ArrowIPCWriter::kSuffix);
+  KATANA_CHECKED_CONTEXT(
+      writer->WriteToUri(new_path, desc), "writing property writer");
+  return new_path.BaseName();
+}
+
+/// Write a property as a chunk manifest, sharing the chunks that are
+/// unchanged from its previous version if that was also chunked
+katana::Result<std::string>
+StoreChunkedArrayAtName(
+    const std::shared_ptr<arrow::ChunkedArray>& array, const katana::Uri& dir,
+    const std::string& name, const std::string& prev_path,
+    const tsuba::StoredArrays& stored, const tsuba::ChunkedPropertyOpts& opts,
+    tsuba::WriteGroup* desc) {
+  std::optional<tsuba::PropertyChunkManifest> prev;
+  if (tsuba::PropertyChunkManifest::IsManifestPath(prev_path)) {
+    auto prev_res = tsuba::PropertyChunkManifest::Read(dir.Join(prev_path));
+    if (prev_res) {
+      prev = std::move(prev_res.value());
+    } else {
+      KATANA_LOG_WARN(
+          "rewriting all of {}, cannot read previous version: {}", name,
+          prev_res.error());
+    }
+  }
+  return tsuba::StoreChunkedProperty(
+      array, name, dir, prev ? &prev.value() : nullptr, &stored, opts, desc);
+}
+
+/// Write a dirty property in its format: Arrow IPC, a chunk manifest if it
+/// is large enough to be chunked, or a single parquet file
+katana::Result<void>
+StoreProperty(
+    const std::shared_ptr<arrow::ChunkedArray>& array, const std::string& name,
+    const katana::Uri& dir, const tsuba::ChunkedPropertyOpts& chunk_opts,
+    tsuba::PropStorageInfo* prop_info, tsuba::WriteGroup* desc) {
+  std::string path;
+  if (prop_info->format() == tsuba::PropertyFormat::kArrowIPC) {
+    path = KATANA_CHECKED(StoreArrowIPCAtName(array, dir, name, desc));
+  } else if (
+      chunk_opts.chunk_rows > 0 && array->length() >= chunk_opts.chunk_rows) {
+    path = KATANA_CHECKED(StoreChunkedArrayAtName(
+        array, dir, name, prop_info->prev_path(), prop_info->stored_arrays(),
+        chunk_opts, desc));
+  } else {
+    path = KATANA_CHECKED(StoreArrowArrayAtName(array, dir, name, desc));
+  }
+
+  prop_info->WasWritten(path);
+  prop_info->set_stored_arrays(tsuba::StoredArrays::Of(*array));
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 WriteProperties(
     const arrow::Table& props, std::vector<tsuba::PropStorageInfo*> prop_info,
     const katana::Uri& dir, tsuba::WriteGroup* desc) {
   const auto& schema = props.schema();
+  tsuba::ChunkedPropertyOpts chunk_opts = tsuba::ChunkedPropertyOpts::FromEnv();
 
-  std::vector<std::string> next_paths;
   for (size_t i = 0, n = prop_info.size(); i < n; ++i) {
     if (!prop_info[i]->IsDirty()) {
       continue;
     }
     std::string name = prop_info[i]->name().empty() ? schema->field(i)->name()
                                                     : prop_info[i]->name();
-    std::string path =
-        KATANA_CHECKED(StoreArrowArrayAtName(props.column(i), dir, name, desc));
-
-    prop_info[i]->WasWritten(path);
+    KATANA_CHECKED(StoreProperty(
+        props.column(i), name, dir, chunk_opts, prop_info[i], desc));
   }
   TSUBA_PTP(tsuba::internal::FaultSensitivity::Normal);
 
@@ -139,6 +204,54 @@ tsuba::RDG::AddLineage(const std::string& command_line) {
   core_->AddCommandLine(command_line);
 }
 
+bool
+tsuba::RDG::HasDerivedTopology(const DerivedTopologyKind& kind) const {
+  for (const auto& [pending_kind, ff] : pending_derived_topologies_) {
+    if (pending_kind == kind) {
+      return true;
+    }
+  }
+  // stored derived topologies are dropped when the topology is stored anew
+  return topology_file_storage().Valid() &&
+         core_->part_header().FindDerivedTopology(kind) != nullptr;
+}
+
+katana::Result<std::unique_ptr<tsuba::FileView>>
+tsuba::RDG::LoadDerivedTopology(const DerivedTopologyKind& kind) const {
+  const DerivedTopologyInfo* info =
+      core_->part_header().FindDerivedTopology(kind);
+  if (info == nullptr || rdg_dir().empty() ||
+      !topology_file_storage().Valid()) {
+    return std::unique_ptr<FileView>();
+  }
+
+  katana::Uri path = rdg_dir().Join(info->path);
+  auto fv = std::make_unique<FileView>();
+  if (path.scheme() == katana::Uri::kFileScheme) {
+    if (auto res = fv->BindMapped(path.string()); !res) {
+      KATANA_LOG_DEBUG(
+          "mapping derived topology failed, reading it instead: {}",
+          res.error());
+    }
+  }
+  if (!fv->mapped()) {
+    KATANA_CHECKED_CONTEXT(fv->Bind(path.string(), true), "reading {}", path);
+  }
+  return std::unique_ptr<FileView>(std::move(fv));
+}
+
+void
+tsuba::RDG::AddDerivedTopology(
+    const DerivedTopologyKind& kind, std::unique_ptr<FileFrame> ff) {
+  for (auto& [pending_kind, pending_ff] : pending_derived_topologies_) {
+    if (pending_kind == kind) {
+      pending_ff = std::move(ff);
+      return;
+    }
+  }
+  pending_derived_topologies_.emplace_back(kind, std::move(ff));
+}
+
 tsuba::RDGFile::~RDGFile() {
   auto result = Close(handle_);
   if (!result) {
@@ -256,6 +369,23 @@ tsuba::RDG::DoStoreTopology(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+tsuba::RDG::DoStoreDerivedTopologies(
+    RDGHandle handle, std::unique_ptr<WriteGroup>& write_group) {
+  for (auto& [kind, ff] : pending_derived_topologies_) {
+    katana::Uri path_uri = MakeDerivedTopologyFileName(handle);
+    KATANA_LOG_DEBUG("persisting derived topology {}", path_uri);
+    ff->Bind(path_uri.string());
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    write_group->StartStore(std::move(ff));
+    TSUBA_PTP(internal::FaultSensitivity::Normal);
+    core_->part_header().UpsertDerivedTopology(kind, path_uri.BaseName());
+  }
+  pending_derived_topologies_.clear();
+
+  return katana::ResultSuccess();
+}
+
 //TODO : emcginnis combine the Edge and Node DoStoreNode/EntityTypeIDArray
 // into a single generalized function.
 katana::Result<void>
@@ -424,9 +554,12 @@ tsuba::RDG::DoMake(
     const katana::Uri& metadata_dir) {
   ReadGroup grp;
 
+  // property cache keys include the RDG directory, so set it before loading
+  core_->set_rdg_dir(metadata_dir);
+
   KATANA_CHECKED_CONTEXT(
       AddProperties(
-          metadata_dir, tsuba::NodeEdge::kNode, prop_cache_, this,
+          metadata_dir, tsuba::NodeEdge::kNode, prop_cache_, this, core_.get(),
           node_props_to_be_loaded, &grp,
           [rdg = this](const std::shared_ptr<arrow::Table>& props)
               -> katana::Result<void> {
@@ -449,7 +582,7 @@ tsuba::RDG::DoMake(
 
   KATANA_CHECKED_CONTEXT(
       AddProperties(
-          metadata_dir, tsuba::NodeEdge::kEdge, prop_cache_, this,
+          metadata_dir, tsuba::NodeEdge::kEdge, prop_cache_, this, core_.get(),
           edge_props_to_be_loaded, &grp,
           [rdg = this](const std::shared_ptr<arrow::Table>& props)
               -> katana::Result<void> {
@@ -471,8 +604,17 @@ tsuba::RDG::DoMake(
       "populating edge properties");
 
   katana::Uri t_path = metadata_dir.Join(core_->part_header().topology_path());
-  if (auto res = core_->topology_file_storage().Bind(t_path.string(), true);
-      !res) {
+  FileView& topology_storage = core_->topology_file_storage();
+  if (map_topology_ && t_path.scheme() == katana::Uri::kFileScheme) {
+    if (auto res = topology_storage.BindMapped(t_path.string()); !res) {
+      KATANA_LOG_DEBUG(
+          "mapping topology failed, reading it instead: {}", res.error());
+    }
+  }
+  if (topology_storage.mapped()) {
+    KATANA_CHECKED_CONTEXT(
+        topology_storage.Advise(topology_access_hint_), "advising {}", t_path);
+  } else if (auto res = topology_storage.Bind(t_path.string(), true); !res) {
     return res.error();
   }
 
@@ -493,7 +635,6 @@ tsuba::RDG::DoMake(
       return res.error();
     }
   }
-  core_->set_rdg_dir(metadata_dir);
 
   std::vector<PropStorageInfo*> part_info =
       KATANA_CHECKED(core_->part_header().SelectPartitionProperties());
@@ -509,7 +650,7 @@ tsuba::RDG::DoMake(
   KATANA_CHECKED_CONTEXT(
       AddProperties(
           metadata_dir, tsuba::NodeEdge::kNeitherNodeNorEdge, nullptr, nullptr,
-          part_info, &grp,
+          nullptr, part_info, &grp,
           [rdg = this](const std::shared_ptr<arrow::Table>& props) {
             return rdg->core_->AddPartitionMetadataArray(props);
           }),
@@ -572,8 +713,28 @@ tsuba::RDG::Make(const RDGManifest& manifest, const RDGLoadOptions& opts) {
         "failed to read path {}", partition_path);
   }
 
+  if (opts.io_workers || opts.io_queue_depth) {
+    IOExecutor* io = IO();
+    uint32_t num_workers = opts.io_workers.value_or(io->num_workers());
+    uint32_t max_queue_depth =
+        opts.io_queue_depth.value_or(io->max_queue_depth());
+    if (!io->ConfigureOnce(num_workers, max_queue_depth) &&
+        (num_workers != io->num_workers() ||
+         max_queue_depth != io->max_queue_depth())) {
+      KATANA_LOG_WARN(
+          "I/O executor already configured with {} workers and queue depth "
+          "{}; ignoring the load options",
+          io->num_workers(), io->max_queue_depth());
+    }
+  }
+
   RDG rdg(std::make_unique<RDGCore>(std::move(part_header_res.value())));
   rdg.prop_cache_ = opts.prop_cache;
+  rdg.map_topology_ = opts.map_topology;
+  if (bool map = false; katana::GetEnv(kMapTopologyEnv, &map) && map) {
+    rdg.map_topology_ = true;
+  }
+  rdg.topology_access_hint_ = opts.topology_access_hint;
 
   std::vector<PropStorageInfo*> node_props = KATANA_CHECKED(
       rdg.core_->part_header().SelectNodeProperties(opts.node_properties));
@@ -582,6 +743,9 @@ tsuba::RDG::Make(const RDGManifest& manifest, const RDGLoadOptions& opts) {
       rdg.core_->part_header().SelectEdgeProperties(opts.edge_properties));
 
   KATANA_CHECKED(rdg.DoMake(node_props, edge_props, manifest.dir()));
+  if (rdg.prop_cache_ != nullptr) {
+    rdg.prop_cache_->LogStats("property cache after load");
+  }
 
   rdg.core_->set_partition_id(partition_id_to_load);
 
@@ -636,6 +800,10 @@ tsuba::RDG::Store(
       handle.impl_->rdg_manifest().num_hosts(),
       handle.impl_->rdg_manifest().policy_id(), tsuba::Comm()->Num,
       core_->part_header().metadata().policy_id_, versioning_action);
+  if (topology_ff) {
+    // stored derived topologies were built from the topology being replaced
+    core_->part_header().ClearDerivedTopologies();
+  }
   if (handle.impl_->rdg_manifest().dir() != rdg_dir()) {
     KATANA_CHECKED(core_->part_header().ChangeStorageLocation(
         rdg_dir(), handle.impl_->rdg_manifest().dir()));
@@ -653,6 +821,11 @@ tsuba::RDG::Store(
     return res.error();
   }
 
+  res = DoStoreDerivedTopologies(handle, desc);
+  if (!res) {
+    return res.error();
+  }
+
   res = DoStoreNodeEntityTypeIDArray(
       handle, std::move(node_entity_type_id_array_ff), desc);
   if (!res) {
@@ -714,7 +887,8 @@ namespace {
 katana::Result<std::shared_ptr<arrow::Table>>
 UnloadProperty(
     const std::shared_ptr<arrow::Table>& props, int i,
-    std::vector<tsuba::PropStorageInfo>* prop_info_list,
+    tsuba::NodeEdge node_edge, tsuba::PropertyCache* cache, tsuba::RDG* rdg,
+    const void* pin_owner, std::vector<tsuba::PropStorageInfo>* prop_info_list,
     const katana::Uri& dir) {
   if (i < 0 || i > props->num_columns()) {
     return KATANA_ERROR(
@@ -733,13 +907,19 @@ UnloadProperty(
   KATANA_LOG_ASSERT(!prop_info.IsAbsent());
 
   if (prop_info.IsDirty()) {
-    std::string path = KATANA_CHECKED(
-        StoreArrowArrayAtName(props->column(i), dir, name, nullptr));
-    prop_info.WasWritten(path);
+    KATANA_CHECKED(StoreProperty(
+        props->column(i), name, dir, tsuba::ChunkedPropertyOpts::FromEnv(),
+        &prop_info, nullptr));
   }
 
   prop_info.WasUnloaded();
 
+  // the cached column, if any, may now be evicted
+  if (cache != nullptr) {
+    cache->Unpin(
+        tsuba::PropertyCacheKey(node_edge, dir.string(), name), pin_owner, rdg);
+  }
+
   return KATANA_CHECKED(props->RemoveColumn(i));
 }
 
@@ -747,7 +927,7 @@ katana::Result<std::shared_ptr<arrow::Table>>
 LoadProperty(
     const std::shared_ptr<arrow::Table>& props, const std::string name, int i,
     tsuba::NodeEdge node_edge, tsuba::PropertyCache* cache, tsuba::RDG* rdg,
-    std::vector<tsuba::PropStorageInfo>* prop_info_list,
+    const void* pin_owner, std::vector<tsuba::PropStorageInfo>* prop_info_list,
     const katana::Uri& dir) {
   if (i < 0 || i > props->num_columns()) {
     i = props->num_columns();
@@ -774,7 +954,7 @@ LoadProperty(
   std::shared_ptr<arrow::Table> new_table;
 
   KATANA_CHECKED(tsuba::AddProperties(
-      dir, node_edge, cache, rdg, {&prop_info}, nullptr,
+      dir, node_edge, cache, rdg, pin_owner, {&prop_info}, nullptr,
       [&](const std::shared_ptr<arrow::Table>& col) -> katana::Result<void> {
         if (props->num_columns() > 0) {
           new_table = KATANA_CHECKED(
@@ -790,13 +970,37 @@ LoadProperty(
   return new_table;
 }
 
+katana::Result<void>
+SetPropertyFormat(
+    const std::string& name, tsuba::PropertyFormat format,
+    std::vector<tsuba::PropStorageInfo>* prop_info_list) {
+  auto psi_it = std::find_if(
+      prop_info_list->begin(), prop_info_list->end(),
+      [&](const tsuba::PropStorageInfo& psi) { return psi.name() == name; });
+
+  if (psi_it == prop_info_list->end()) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+
+  tsuba::PropStorageInfo& prop_info = *psi_it;
+  bool convert = prop_info.IsClean() && prop_info.format() != format;
+  prop_info.set_format(format);
+  if (convert) {
+    // so that the next store writes it in the new format
+    prop_info.WasModified(prop_info.type());
+  }
+  return katana::ResultSuccess();
+}
+
 }  // namespace
 
 katana::Result<void>
 tsuba::RDG::UnloadNodeProperty(int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(UnloadProperty(
-      node_properties(), i, &core_->part_header().node_prop_info_list(),
-      rdg_dir()));
+      node_properties(), i, tsuba::NodeEdge::kNode, prop_cache_, this,
+      core_.get(), &core_->part_header().node_prop_info_list(), rdg_dir()));
   core_->set_node_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
@@ -816,8 +1020,8 @@ tsuba::RDG::UnloadNodeProperty(const std::string& name) {
 katana::Result<void>
 tsuba::RDG::UnloadEdgeProperty(int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(UnloadProperty(
-      edge_properties(), i, &core_->part_header().edge_prop_info_list(),
-      rdg_dir()));
+      edge_properties(), i, tsuba::NodeEdge::kEdge, prop_cache_, this,
+      core_.get(), &core_->part_header().edge_prop_info_list(), rdg_dir()));
   core_->set_edge_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
@@ -838,7 +1042,7 @@ katana::Result<void>
 tsuba::RDG::LoadNodeProperty(const std::string& name, int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(LoadProperty(
       node_properties(), name, i, tsuba::NodeEdge::kNode, prop_cache_, this,
-      &core_->part_header().node_prop_info_list(), rdg_dir()));
+      core_.get(), &core_->part_header().node_prop_info_list(), rdg_dir()));
   core_->set_node_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
@@ -847,11 +1051,25 @@ katana::Result<void>
 tsuba::RDG::LoadEdgeProperty(const std::string& name, int i) {
   std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(LoadProperty(
       edge_properties(), name, i, tsuba::NodeEdge::kEdge, prop_cache_, this,
-      &core_->part_header().edge_prop_info_list(), rdg_dir()));
+      core_.get(), &core_->part_header().edge_prop_info_list(), rdg_dir()));
   core_->set_edge_properties(std::move(new_props));
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+tsuba::RDG::SetNodePropertyFormat(
+    const std::string& name, PropertyFormat format) {
+  return SetPropertyFormat(
+      name, format, &core_->part_header().node_prop_info_list());
+}
+
+katana::Result<void>
+tsuba::RDG::SetEdgePropertyFormat(
+    const std::string& name, PropertyFormat format) {
+  return SetPropertyFormat(
+      name, format, &core_->part_header().edge_prop_info_list());
+}
+
 std::vector<std::string>
 tsuba::RDG::ListNodeProperties() const {
   std::vector<std::string> result;
@@ -1082,6 +1300,29 @@ tsuba::RDG::RDG(std::unique_ptr<RDGCore>&& core) : core_(std::move(core)) {}
 
 tsuba::RDG::RDG() : core_(std::make_unique<RDGCore>()) {}
 
-tsuba::RDG::~RDG() = default;
+tsuba::RDG::~RDG() {
+  // core_ is the pin owner rather than this because it stays put when an RDG
+  // is moved
+  if (prop_cache_ != nullptr && core_ != nullptr) {
+    prop_cache_->UnpinAll(core_.get(), this);
+  }
+}
 tsuba::RDG::RDG(tsuba::RDG&& other) noexcept = default;
-tsuba::RDG& tsuba::RDG::operator=(tsuba::RDG&& other) noexcept = default;
+
+tsuba::RDG&
+tsuba::RDG::operator=(tsuba::RDG&& other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  // drop the pins held for the core being replaced
+  if (prop_cache_ != nullptr && core_ != nullptr) {
+    prop_cache_->UnpinAll(core_.get(), this);
+  }
+  core_ = std::move(other.core_);
+  view_type_ = std::move(other.view_type_);
+  prop_cache_ = other.prop_cache_;
+  map_topology_ = other.map_topology_;
+  topology_access_hint_ = other.topology_access_hint_;
+  pending_derived_topologies_ = std::move(other.pending_derived_topologies_);
+  return *this;
+}
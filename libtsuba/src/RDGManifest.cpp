@@ -4,6 +4,7 @@
 
 #include "Constants.h"
 #include "GlobalState.h"
+#include "PropertyChunks.h"
 #include "RDGHandleImpl.h"
 #include "RDGPartHeader.h"
 #include "katana/JSON.h"
@@ -228,14 +229,28 @@ RDGManifest::FileNames() {
           version(), view_specifier(), header_res.error());
     } else {
       auto header = std::move(header_res.value());
+      // Chunked properties are stored in the files their chunk manifest
+      // points at as well as in the manifest itself
+      auto add_prop = [&](const PropStorageInfo& prop) -> Result<void> {
+        fnames.emplace(prop.path());
+        if (PropertyChunkManifest::IsManifestPath(prop.path())) {
+          auto chunks = KATANA_CHECKED_CONTEXT(
+              PropertyChunkManifest::Read(dir().Join(prop.path())),
+              "reading chunk manifest of {}", prop.name());
+          for (const std::string& file : chunks.Files()) {
+            fnames.emplace(file);
+          }
+        }
+        return katana::ResultSuccess();
+      };
       for (const auto& node_prop : header.node_prop_info_list()) {
-        fnames.emplace(node_prop.path());
+        KATANA_CHECKED(add_prop(node_prop));
       }
       for (const auto& edge_prop : header.edge_prop_info_list()) {
-        fnames.emplace(edge_prop.path());
+        KATANA_CHECKED(add_prop(edge_prop));
       }
       for (const auto& part_prop : header.part_prop_info_list()) {
-        fnames.emplace(part_prop.path());
+        KATANA_CHECKED(add_prop(part_prop));
       }
       // Duplicates eliminated by set
       fnames.emplace(header.topology_path());
@@ -245,6 +260,9 @@ RDGManifest::FileNames() {
       if (const auto& n = header.edge_entity_type_id_array_path(); !n.empty()) {
         fnames.emplace(n);
       }
+      for (const auto& derived : header.derived_topologies()) {
+        fnames.emplace(derived.path);
+      }
     }
   }
   return fnames;
@@ -2,6 +2,7 @@
 
 #include "Constants.h"
 #include "GlobalState.h"
+#include "PropertyChunks.h"
 #include "RDGHandleImpl.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
@@ -19,6 +20,8 @@ const char* kEdgePropertyKey = "kg.v1.edge_property";
 const char* kPartPropertyFilesKey = "kg.v1.part_property_files";
 const char* kPartProperyMetaKey = "kg.v1.part_property_meta";
 const char* kStorageFormatVersionKey = "kg.v1.storage_format_version";
+// Optional list of topologies derived from the topology (e.g., transposed)
+const char* kDerivedTopologiesKey = "kg.v1.derived_topologies";
 // Array file at path maps from Node ID to EntityTypeID of that Node
 const char* kNodeEntityTypeIDArrayPathKey = "kg.v1.node_entity_type_id_array";
 // Array file at path maps from Edge ID to EntityTypeID of that Edge
@@ -42,17 +45,31 @@ const char* kEdgeEntityTypeIDNameKey = "kg.v1.edge_entity_type_id_name";
 // special partition property names
 
 katana::Result<void>
-CopyProperty(
-    tsuba::PropStorageInfo* prop, const katana::Uri& old_location,
+CopyFile(
+    const std::string& file_name, const katana::Uri& old_location,
     const katana::Uri& new_location) {
-  katana::Uri old_path = old_location.Join(prop->path());
-  katana::Uri new_path = new_location.Join(prop->path());
+  katana::Uri old_path = old_location.Join(file_name);
+  katana::Uri new_path = new_location.Join(file_name);
   tsuba::FileView fv;
 
   KATANA_CHECKED(fv.Bind(old_path.string(), true));
   return tsuba::FileStore(new_path.string(), fv.ptr<uint8_t>(), fv.size());
 }
 
+katana::Result<void>
+CopyProperty(
+    tsuba::PropStorageInfo* prop, const katana::Uri& old_location,
+    const katana::Uri& new_location) {
+  if (tsuba::PropertyChunkManifest::IsManifestPath(prop->path())) {
+    auto manifest = KATANA_CHECKED(tsuba::PropertyChunkManifest::Read(
+        old_location.Join(prop->path())));
+    for (const std::string& file : manifest.Files()) {
+      KATANA_CHECKED(CopyFile(file, old_location, new_location));
+    }
+  }
+  return CopyFile(prop->path(), old_location, new_location);
+}
+
 }  // namespace
 
 // TODO(vkarthik): repetitive code from RDGManifest, try to unify
@@ -221,6 +238,14 @@ RDGPartHeader::Validate() const {
         ErrorCode::InvalidArgument,
         "topology_path doesn't contain a slash (/): {}", topology_path_);
   }
+  for (const auto& info : derived_topologies_) {
+    if (info.path.empty() || info.path.find('/') != std::string::npos) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "derived topology path is empty or contains a slash (/): {}",
+          info.path);
+    }
+  }
 
   if (IsEntityTypeIDsOutsideProperties()) {
     return ValidateEntityTypeIDStructures();
@@ -236,24 +261,30 @@ RDGPartHeader::ChangeStorageLocation(
     if (prop.IsAbsent()) {
       KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
     } else {
-      prop.WasModified(prop.type());
+      prop.WasRelocated(prop.type());
     }
   }
   for (PropStorageInfo& prop : edge_prop_info_list_) {
     if (prop.IsAbsent()) {
       KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
     } else {
-      prop.WasModified(prop.type());
+      prop.WasRelocated(prop.type());
     }
   }
   for (PropStorageInfo& prop : part_prop_info_list_) {
     if (prop.IsAbsent()) {
       KATANA_CHECKED(CopyProperty(&prop, old_location, new_location));
     } else {
-      prop.WasModified(prop.type());
+      prop.WasRelocated(prop.type());
     }
   }
 
+  // derived topologies are only ever written once, so carry the stored ones
+  // along; pending ones are written to the new location by RDG::Store
+  for (const DerivedTopologyInfo& info : derived_topologies_) {
+    KATANA_CHECKED(CopyFile(info.path, old_location, new_location));
+  }
+
   // clear out specific file paths so that we know to store them later
   topology_path_ = "";
   node_entity_type_id_array_path_ = "";
@@ -288,6 +319,7 @@ tsuba::to_json(json& j, const tsuba::RDGPartHeader& header) {
       {kEdgeEntityTypeIDDictionaryKey, header.edge_entity_type_id_dictionary_},
       {kNodeEntityTypeIDNameKey, header.node_entity_type_id_name_},
       {kEdgeEntityTypeIDNameKey, header.edge_entity_type_id_name_},
+      {kDerivedTopologiesKey, header.derived_topologies_},
   };
 }
 
@@ -319,6 +351,10 @@ tsuba::from_json(const json& j, tsuba::RDGPartHeader& header) {
     j.at(kNodeEntityTypeIDNameKey).get_to(header.node_entity_type_id_name_);
     j.at(kEdgeEntityTypeIDNameKey).get_to(header.edge_entity_type_id_name_);
   }
+
+  if (auto it = j.find(kDerivedTopologiesKey); it != j.end()) {
+    it->get_to(header.derived_topologies_);
+  }
 }
 
 void
@@ -376,3 +412,21 @@ void
 tsuba::to_json(json& j, const tsuba::PropStorageInfo& propmd) {
   j = json{propmd.name(), propmd.path()};
 }
+
+void
+tsuba::to_json(json& j, const tsuba::DerivedTopologyInfo& info) {
+  j = json{
+      {"transpose", info.kind.transpose_kind},
+      {"edge_sort", info.kind.edge_sort_kind},
+      {"node_sort", info.kind.node_sort_kind},
+      {"path", info.path},
+  };
+}
+
+void
+tsuba::from_json(const json& j, tsuba::DerivedTopologyInfo& info) {
+  j.at("transpose").get_to(info.kind.transpose_kind);
+  j.at("edge_sort").get_to(info.kind.edge_sort_kind);
+  j.at("node_sort").get_to(info.kind.node_sort_kind);
+  j.at("path").get_to(info.path);
+}
@@ -11,11 +11,13 @@
 
 #include <arrow/api.h>
 
+#include "PropertyChunks.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/JSON.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
 #include "katana/URI.h"
+#include "tsuba/ArrowIPC.h"
 #include "tsuba/Errors.h"
 #include "tsuba/PartitionMetadata.h"
 #include "tsuba/RDG.h"
@@ -75,20 +77,34 @@ public:
   }
 
   void WasModified(const std::shared_ptr<arrow::DataType>& type) {
+    if (!path_.empty()) {
+      prev_path_ = std::move(path_);
+    }
     path_.clear();
     state_ = State::kDirty;
     type_ = type;
   }
 
+  /// Like WasModified, but the property is going to be written somewhere
+  /// its previous version is not
+  void WasRelocated(const std::shared_ptr<arrow::DataType>& type) {
+    format_ = format();
+    WasModified(type);
+    prev_path_.clear();
+    stored_arrays_ = StoredArrays();
+  }
+
   void WasWritten(std::string_view new_path) {
     KATANA_LOG_ASSERT(state_ == State::kDirty);
     path_ = new_path;
+    prev_path_.clear();
     state_ = State::kClean;
   }
 
   void WasUnloaded() {
     KATANA_LOG_ASSERT(state_ == State::kClean);
     state_ = State::kAbsent;
+    stored_arrays_ = StoredArrays();
   }
 
   bool IsAbsent() const { return state_ == State::kAbsent; }
@@ -99,8 +115,30 @@ public:
 
   const std::string& name() const { return name_; }
   const std::string& path() const { return path_; }
+  /// The stored version of a dirty property, if any. Writes may share the
+  /// parts of it that are unchanged.
+  const std::string& prev_path() const { return prev_path_; }
   const std::shared_ptr<arrow::DataType>& type() const { return type_; }
 
+  /// The format the property is written in: the one last set with
+  /// set_format, or else the format it is stored in now
+  PropertyFormat format() const {
+    if (format_) {
+      return format_.value();
+    }
+    const std::string& stored = path_.empty() ? prev_path_ : path_;
+    return IsArrowIPCPath(stored) ? PropertyFormat::kArrowIPC
+                                  : PropertyFormat::kParquet;
+  }
+  void set_format(PropertyFormat format) { format_ = format; }
+
+  /// The arrays that held this property when it was last loaded or written,
+  /// which describe prev_path() once the property is modified
+  const StoredArrays& stored_arrays() const { return stored_arrays_; }
+  void set_stored_arrays(StoredArrays stored_arrays) {
+    stored_arrays_ = std::move(stored_arrays);
+  }
+
   // since we don't have type info in the header don't know the
   // type when this would have been constructed. Allow others to
   // fix up the type in this case, required until we can get the type
@@ -119,10 +157,20 @@ public:
 private:
   std::string name_;
   std::string path_;
+  std::string prev_path_;
+  std::optional<PropertyFormat> format_;
   std::shared_ptr<arrow::DataType> type_;
+  StoredArrays stored_arrays_;
   State state_;
 };
 
+/// A stored topology derived from the topology of this partition and the
+/// name of the file that holds it
+struct DerivedTopologyInfo {
+  DerivedTopologyKind kind;
+  std::string path;
+};
+
 class KATANA_EXPORT RDGPartHeader {
 public:
   static katana::Result<RDGPartHeader> Make(const katana::Uri& partition_path);
@@ -249,6 +297,33 @@ public:
     edge_entity_type_id_array_path_ = std::move(path);
   }
 
+  const std::vector<DerivedTopologyInfo>& derived_topologies() const {
+    return derived_topologies_;
+  }
+
+  const DerivedTopologyInfo* FindDerivedTopology(
+      const DerivedTopologyKind& kind) const {
+    auto it = std::find_if(
+        derived_topologies_.begin(), derived_topologies_.end(),
+        [&](const DerivedTopologyInfo& info) { return info.kind == kind; });
+    return it == derived_topologies_.end() ? nullptr : &(*it);
+  }
+
+  void UpsertDerivedTopology(
+      const DerivedTopologyKind& kind, std::string path) {
+    auto it = std::find_if(
+        derived_topologies_.begin(), derived_topologies_.end(),
+        [&](const DerivedTopologyInfo& info) { return info.kind == kind; });
+    if (it == derived_topologies_.end()) {
+      derived_topologies_.emplace_back(
+          DerivedTopologyInfo{.kind = kind, .path = std::move(path)});
+    } else {
+      it->path = std::move(path);
+    }
+  }
+
+  void ClearDerivedTopologies() { derived_topologies_.clear(); }
+
   const std::vector<PropStorageInfo>& node_prop_info_list() const {
     return node_prop_info_list_;
   }
@@ -518,6 +593,9 @@ private:
 
   std::string topology_path_;
 
+  /// Optional topologies derived from the one at topology_path_
+  std::vector<DerivedTopologyInfo> derived_topologies_;
+
   std::string node_entity_type_id_array_path_;
   std::string edge_entity_type_id_array_path_;
 
@@ -540,6 +618,9 @@ void from_json(const nlohmann::json& j, RDGPartHeader& header);
 void to_json(nlohmann::json& j, const PropStorageInfo& propmd);
 void from_json(const nlohmann::json& j, PropStorageInfo& propmd);
 
+void to_json(nlohmann::json& j, const DerivedTopologyInfo& info);
+void from_json(const nlohmann::json& j, DerivedTopologyInfo& info);
+
 void to_json(nlohmann::json& j, const PartitionMetadata& propmd);
 void from_json(const nlohmann::json& j, PartitionMetadata& propmd);
 
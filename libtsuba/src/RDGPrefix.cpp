@@ -28,6 +28,11 @@ RDGPrefix::DoMakePrefix(const tsuba::RDGManifest& manifest) {
     return res.error().WithContext(
         "file get failed: {}: sz: {}", t_path, sizeof(gr_header));
   }
+  if (gr_header.version == kCompressedCSRVersion) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "cannot construct RDGPrefix for compressed topology {}", t_path);
+  }
   FileView fv;
   if (auto res = fv.Bind(
           t_path.string(),
@@ -5,7 +5,9 @@
 #include "RDGHandleImpl.h"
 #include "katana/EntityTypeManager.h"
 #include "katana/Logging.h"
+#include "tsuba/CSRTopology.h"
 #include "tsuba/Errors.h"
+#include "tsuba/file.h"
 
 katana::Result<void>
 tsuba::RDGSlice::DoMake(
@@ -15,6 +17,19 @@ tsuba::RDGSlice::DoMake(
   ReadGroup grp;
   katana::Uri topology_path =
       metadata_dir.Join(core_->part_header().topology_path());
+
+  // Slices are byte ranges of an uncompressed CSR, which do not exist in a
+  // compressed topology
+  CSRTopologyHeader gr_header;
+  KATANA_CHECKED_CONTEXT(
+      FileGet(topology_path.string(), &gr_header),
+      "file get failed: {}: sz: {}", topology_path, sizeof(gr_header));
+  if (gr_header.version == kCompressedCSRVersion) {
+    return KATANA_ERROR(
+        ErrorCode::NotImplemented,
+        "cannot construct RDGSlice for compressed topology {}", topology_path);
+  }
+
   KATANA_CHECKED_CONTEXT(
       core_->topology_file_storage().Bind(
           topology_path.string(), slice.topo_off,
@@ -142,7 +157,7 @@ tsuba::RDGSlice::DoMake(
   KATANA_CHECKED_CONTEXT(
       AddProperties(
           metadata_dir, tsuba::NodeEdge::kNeitherNodeNorEdge, nullptr, nullptr,
-          no_slice, &grp,
+          nullptr, no_slice, &grp,
           [rdg = this](const std::shared_ptr<arrow::Table>& props) {
             return rdg->core_->AddPartitionMetadataArray(props);
           }),
@@ -0,0 +1,562 @@
+#include "UringStorage.h"
+
+#include <fcntl.h>
+#include <liburing.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+
+#include "IOExecutor.h"
+#include "katana/Env.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "tsuba/Errors.h"
+#include "tsuba/FileStorage.h"
+#include "tsuba/file.h"
+
+class tsuba::UringStorage::Ring {
+public:
+  static katana::Result<std::unique_ptr<Ring>> Make(bool direct) {
+    std::unique_ptr<Ring> ring(new Ring());
+    if (int ret = io_uring_queue_init(kQueueDepth, &ring->ring_, 0); ret < 0) {
+      return KATANA_ERROR(
+          ErrorCode::LocalStorageError, "io_uring_queue_init: {}",
+          std::strerror(-ret));
+    }
+    ring->initialized_ = true;
+
+    if (!direct) {
+      return std::unique_ptr<Ring>(std::move(ring));
+    }
+
+    void* buffers = nullptr;
+    if (int ret = posix_memalign(
+            &buffers, kBlockSize, kNumFixedBuffers * kChunkSize);
+        ret != 0) {
+      return KATANA_ERROR(
+          ErrorCode::OutOfMemory, "allocating io_uring buffers: {}",
+          std::strerror(ret));
+    }
+    ring->buffers_ = static_cast<uint8_t*>(buffers);
+
+    std::vector<iovec> iovecs(kNumFixedBuffers);
+    for (uint32_t i = 0; i < kNumFixedBuffers; ++i) {
+      iovecs[i].iov_base = ring->buffer(i);
+      iovecs[i].iov_len = kChunkSize;
+    }
+    // Registration pins the buffers and counts against RLIMIT_MEMLOCK; if we
+    // are not allowed to do that, fall back to unregistered buffers.
+    if (int ret = io_uring_register_buffers(
+            &ring->ring_, iovecs.data(), iovecs.size());
+        ret < 0) {
+      KATANA_LOG_DEBUG(
+          "io_uring_register_buffers failed, using unregistered buffers: {}",
+          std::strerror(-ret));
+    } else {
+      ring->fixed_ = true;
+    }
+
+    return std::unique_ptr<Ring>(std::move(ring));
+  }
+
+  ~Ring() {
+    if (fixed_) {
+      io_uring_unregister_buffers(&ring_);
+    }
+    if (initialized_) {
+      io_uring_queue_exit(&ring_);
+    }
+    free(buffers_);  // NOLINT buffers_ came from posix_memalign
+  }
+
+  Ring(const Ring& no_copy) = delete;
+  Ring& operator=(const Ring& no_copy) = delete;
+
+  io_uring* ring() { return &ring_; }
+  uint8_t* buffer(uint32_t i) { return buffers_ + i * kChunkSize; }
+  bool has_buffers() const { return buffers_ != nullptr; }
+  bool fixed() const { return fixed_; }
+
+private:
+  Ring() = default;
+
+  io_uring ring_{};
+  bool initialized_{false};
+  uint8_t* buffers_{nullptr};
+  bool fixed_{false};
+};
+
+namespace {
+
+/// One read or write request against a contiguous range of a file
+struct Chunk {
+  /// offset in the file of the first byte of this chunk
+  uint64_t file_offset{0};
+  /// number of bytes to transfer
+  uint64_t len{0};
+  /// number of bytes transferred so far
+  uint64_t done{0};
+  /// memory the kernel reads from or writes into
+  uint8_t* mem{nullptr};
+  /// registered buffer index of mem, or -1 if mem is not registered
+  int buf_index{-1};
+};
+
+class FileDescriptor {
+public:
+  explicit FileDescriptor(int fd) : fd_(fd) {}
+  ~FileDescriptor() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+  FileDescriptor(const FileDescriptor& no_copy) = delete;
+  FileDescriptor& operator=(const FileDescriptor& no_copy) = delete;
+
+  int get() const { return fd_; }
+
+private:
+  int fd_;
+};
+
+io_uring_sqe*
+PrepChunk(io_uring* ring, int fd, bool is_write, Chunk* chunk) {
+  io_uring_sqe* sqe = io_uring_get_sqe(ring);
+  // we never have more than kQueueDepth requests outstanding and submit after
+  // every batch so there is always a free submission entry
+  KATANA_LOG_ASSERT(sqe != nullptr);
+
+  uint8_t* mem = chunk->mem + chunk->done;
+  auto nbytes = static_cast<unsigned>(chunk->len - chunk->done);
+  uint64_t offset = chunk->file_offset + chunk->done;
+
+  if (chunk->buf_index >= 0) {
+    if (is_write) {
+      io_uring_prep_write_fixed(sqe, fd, mem, nbytes, offset, chunk->buf_index);
+    } else {
+      io_uring_prep_read_fixed(sqe, fd, mem, nbytes, offset, chunk->buf_index);
+    }
+  } else {
+    if (is_write) {
+      io_uring_prep_write(sqe, fd, mem, nbytes, offset);
+    } else {
+      io_uring_prep_read(sqe, fd, mem, nbytes, offset);
+    }
+  }
+  io_uring_sqe_set_data(sqe, chunk);
+  return sqe;
+}
+
+/// Consecutive failures to wait for a completion after which we give up on
+/// the requests in flight
+constexpr int kMaxWaitFailures = 100;
+
+/// Issue num_chunks requests keeping up to max_in_flight of them outstanding.
+/// setup is called to describe a chunk before it is issued for the first
+/// time; finish is called once a chunk has been fully transferred or reached
+/// the end of the file. Each in-flight chunk occupies a slot which
+/// corresponds to one staging buffer when doing direct I/O.
+///
+/// Requests reference the caller's buffers, so on an error no new requests
+/// are issued but all submitted ones are reaped before returning.
+katana::Result<void>
+RunChunks(
+    io_uring* ring, int fd, bool is_write, bool stop_on_short,
+    uint64_t num_chunks, uint32_t max_in_flight,
+    const std::function<void(uint64_t, uint32_t, Chunk*)>& setup,
+    const std::function<void(uint32_t, const Chunk&)>& finish) {
+  // push out no-ops left behind by a failed submission of an earlier call
+  if (io_uring_sq_ready(ring) > 0) {
+    io_uring_submit(ring);
+  }
+
+  std::vector<Chunk> slots(max_in_flight);
+  // prepared requests that the kernel has not taken yet, in order
+  std::vector<io_uring_sqe*> unsubmitted;
+  uint64_t next_chunk = 0;
+  uint32_t in_flight = 0;
+  katana::Result<void> result = katana::ResultSuccess();
+  int wait_failures = 0;
+
+  auto issue = [&](Chunk* chunk) {
+    unsubmitted.emplace_back(PrepChunk(ring, fd, is_write, chunk));
+    in_flight += 1;
+  };
+
+  for (uint32_t slot = 0; slot < max_in_flight && next_chunk < num_chunks;
+       ++slot) {
+    slots[slot] = Chunk{};
+    setup(next_chunk++, slot, &slots[slot]);
+    issue(&slots[slot]);
+  }
+
+  while (in_flight > 0) {
+    if (!unsubmitted.empty()) {
+      int ret = io_uring_submit(ring);
+      if (ret == -EINTR) {
+        continue;
+      }
+      if (ret < 0) {
+        if (result) {
+          result = KATANA_ERROR(
+              tsuba::ErrorCode::LocalStorageError, "io_uring_submit: {}",
+              std::strerror(-ret));
+        }
+        // These will never complete here. Make them harmless no-ops in case
+        // a later submission on this ring picks them up.
+        for (io_uring_sqe* sqe : unsubmitted) {
+          io_uring_prep_nop(sqe);
+          io_uring_sqe_set_data(sqe, nullptr);
+        }
+        in_flight -= unsubmitted.size();
+        unsubmitted.clear();
+        continue;
+      }
+      unsubmitted.erase(
+          unsubmitted.begin(),
+          unsubmitted.begin() + std::min<size_t>(ret, unsubmitted.size()));
+    }
+
+    io_uring_cqe* cqe = nullptr;
+    if (int ret = io_uring_wait_cqe(ring, &cqe); ret < 0) {
+      if (ret == -EINTR) {
+        continue;
+      }
+      if (result) {
+        result = KATANA_ERROR(
+            tsuba::ErrorCode::LocalStorageError, "io_uring_wait_cqe: {}",
+            std::strerror(-ret));
+      }
+      // returning now would free buffers the kernel may still write to
+      if (++wait_failures >= kMaxWaitFailures) {
+        KATANA_LOG_FATAL(
+            "cannot reap {} io_uring requests in flight: {}", in_flight,
+            std::strerror(-ret));
+      }
+      continue;
+    }
+    wait_failures = 0;
+    auto* chunk = static_cast<Chunk*>(io_uring_cqe_get_data(cqe));
+    int res = cqe->res;
+    io_uring_cqe_seen(ring, cqe);
+    if (chunk == nullptr) {
+      // a no-op left behind by an earlier failed submission
+      continue;
+    }
+    in_flight -= 1;
+
+    if (!result) {
+      // stop issuing new requests but drain the ones in flight since they
+      // reference our buffers
+      continue;
+    }
+    if (res == -EINTR || res == -EAGAIN) {
+      issue(chunk);
+      continue;
+    }
+    if (res < 0 || (res == 0 && is_write)) {
+      result = KATANA_ERROR(
+          tsuba::ErrorCode::LocalStorageError, "io_uring {}: {}",
+          is_write ? "write" : "read", std::strerror(res < 0 ? -res : EIO));
+      continue;
+    }
+
+    auto requested = chunk->len - chunk->done;
+    chunk->done += res;
+    bool short_io = static_cast<uint64_t>(res) < requested;
+    bool end_of_file = res == 0 || (short_io && stop_on_short);
+    if (chunk->done < chunk->len && !end_of_file) {
+      issue(chunk);
+      continue;
+    }
+
+    auto slot = static_cast<uint32_t>(chunk - slots.data());
+    finish(slot, *chunk);
+
+    if (next_chunk < num_chunks) {
+      *chunk = Chunk{};
+      setup(next_chunk++, slot, chunk);
+      issue(chunk);
+    }
+  }
+
+  return result;
+}
+
+uint64_t
+NumChunks(uint64_t size) {
+  return (size + tsuba::UringStorage::kChunkSize - 1) /
+         tsuba::UringStorage::kChunkSize;
+}
+
+katana::Result<uint64_t>
+ReadBuffered(
+    io_uring* ring, int fd, uint64_t start, uint64_t size, uint8_t* data) {
+  uint64_t bytes_read = 0;
+  KATANA_CHECKED(RunChunks(
+      ring, fd, /*is_write=*/false, /*stop_on_short=*/false, NumChunks(size),
+      tsuba::UringStorage::kQueueDepth,
+      [&](uint64_t idx, uint32_t, Chunk* chunk) {
+        uint64_t rel = idx * tsuba::UringStorage::kChunkSize;
+        chunk->file_offset = start + rel;
+        chunk->len = std::min(tsuba::UringStorage::kChunkSize, size - rel);
+        chunk->mem = data + rel;
+      },
+      [&](uint32_t, const Chunk& chunk) { bytes_read += chunk.done; }));
+  return bytes_read;
+}
+
+katana::Result<uint64_t>
+ReadDirect(
+    tsuba::UringStorage::Ring* ring, int fd, uint64_t start, uint64_t size,
+    uint8_t* data) {
+  uint64_t aligned_start = tsuba::RoundDownToBlock(start);
+  uint64_t aligned_size = tsuba::RoundUpToBlock(start + size) - aligned_start;
+  uint64_t end = start + size;
+  uint64_t bytes_read = 0;
+
+  KATANA_CHECKED(RunChunks(
+      ring->ring(), fd, /*is_write=*/false, /*stop_on_short=*/true,
+      NumChunks(aligned_size), tsuba::UringStorage::kNumFixedBuffers,
+      [&](uint64_t idx, uint32_t slot, Chunk* chunk) {
+        uint64_t rel = idx * tsuba::UringStorage::kChunkSize;
+        chunk->file_offset = aligned_start + rel;
+        chunk->len =
+            std::min(tsuba::UringStorage::kChunkSize, aligned_size - rel);
+        chunk->mem = ring->buffer(slot);
+        chunk->buf_index = ring->fixed() ? static_cast<int>(slot) : -1;
+      },
+      [&](uint32_t, const Chunk& chunk) {
+        uint64_t copy_begin = std::max(chunk.file_offset, start);
+        uint64_t copy_end = std::min(chunk.file_offset + chunk.done, end);
+        if (copy_begin >= copy_end) {
+          return;
+        }
+        std::memcpy(
+            data + (copy_begin - start),
+            chunk.mem + (copy_begin - chunk.file_offset),
+            copy_end - copy_begin);
+        bytes_read += copy_end - copy_begin;
+      }));
+  return bytes_read;
+}
+
+katana::Result<void>
+WriteBuffered(io_uring* ring, int fd, const uint8_t* data, uint64_t size) {
+  return RunChunks(
+      ring, fd, /*is_write=*/true, /*stop_on_short=*/false, NumChunks(size),
+      tsuba::UringStorage::kQueueDepth,
+      [&](uint64_t idx, uint32_t, Chunk* chunk) {
+        uint64_t rel = idx * tsuba::UringStorage::kChunkSize;
+        chunk->file_offset = rel;
+        chunk->len = std::min(tsuba::UringStorage::kChunkSize, size - rel);
+        // the kernel only reads from this memory
+        chunk->mem = const_cast<uint8_t*>(data + rel);  // NOLINT
+      },
+      [](uint32_t, const Chunk&) {});
+}
+
+katana::Result<void>
+WriteDirect(
+    tsuba::UringStorage::Ring* ring, int fd, const uint8_t* data,
+    uint64_t size) {
+  KATANA_CHECKED(RunChunks(
+      ring->ring(), fd, /*is_write=*/true, /*stop_on_short=*/false,
+      NumChunks(size), tsuba::UringStorage::kNumFixedBuffers,
+      [&](uint64_t idx, uint32_t slot, Chunk* chunk) {
+        uint64_t rel = idx * tsuba::UringStorage::kChunkSize;
+        uint64_t len = std::min(tsuba::UringStorage::kChunkSize, size - rel);
+        uint64_t padded_len = tsuba::RoundUpToBlock(len);
+        uint8_t* buf = ring->buffer(slot);
+        std::memcpy(buf, data + rel, len);
+        std::memset(buf + len, 0, padded_len - len);
+
+        chunk->file_offset = rel;
+        chunk->len = padded_len;
+        chunk->mem = buf;
+        chunk->buf_index = ring->fixed() ? static_cast<int>(slot) : -1;
+      },
+      [](uint32_t, const Chunk&) {}));
+
+  // the last block was padded out to the block size
+  if (ftruncate(fd, size) != 0) {
+    return KATANA_ERROR(
+        tsuba::ErrorCode::LocalStorageError, "truncating file: {}",
+        katana::ResultErrno().message());
+  }
+  return katana::ResultSuccess();
+}
+
+/// Open path, with O_DIRECT if requested and supported by the file system
+int
+OpenFile(const std::string& path, int flags, bool* direct) {
+  if (*direct) {
+    int fd = open(path.c_str(), flags | O_DIRECT, 0666);  // NOLINT
+    if (fd >= 0 || errno != EINVAL) {
+      return fd;
+    }
+    // e.g., tmpfs does not support O_DIRECT
+    KATANA_LOG_DEBUG("O_DIRECT not supported for {}", path);
+    *direct = false;
+  }
+  return open(path.c_str(), flags, 0666);  // NOLINT
+}
+
+}  // namespace
+
+tsuba::UringStorage::UringStorage(bool direct) : direct_(direct) {}
+
+tsuba::UringStorage::~UringStorage() = default;
+
+bool
+tsuba::UringStorage::Available() {
+  io_uring ring{};
+  if (int ret = io_uring_queue_init(1, &ring, 0); ret < 0) {
+    KATANA_LOG_DEBUG("io_uring not available: {}", std::strerror(-ret));
+    return false;
+  }
+  io_uring_queue_exit(&ring);
+  return true;
+}
+
+bool
+tsuba::UringStorage::Enabled() {
+  return !katana::GetEnv(kDisableEnv) && Available();
+}
+
+void
+tsuba::UringStorage::RegisterIfAvailable() {
+  if (!Enabled()) {
+    return;
+  }
+  bool direct = false;
+  katana::GetEnv(kDirectEnv, &direct);
+
+  static UringStorage storage(direct);
+  RegisterFileStorage(&storage);
+}
+
+katana::Result<void>
+tsuba::UringStorage::Init() {
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::UringStorage::Fini() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  free_rings_.clear();
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::unique_ptr<tsuba::UringStorage::Ring>>
+tsuba::UringStorage::AcquireRing() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_rings_.empty()) {
+      std::unique_ptr<Ring> ring = std::move(free_rings_.back());
+      free_rings_.pop_back();
+      return std::unique_ptr<Ring>(std::move(ring));
+    }
+  }
+  return Ring::Make(direct_);
+}
+
+void
+tsuba::UringStorage::ReleaseRing(std::unique_ptr<Ring> ring) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  free_rings_.emplace_back(std::move(ring));
+}
+
+katana::Result<void>
+tsuba::UringStorage::GetMultiSync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  std::string path = uri;
+  CleanUri(&path);
+
+  bool direct = direct_;
+  FileDescriptor fd(OpenFile(path, O_RDONLY, &direct));
+  if (fd.get() < 0) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "failed to open source file {}: {}",
+        std::quoted(path), katana::ResultErrno().message());
+  }
+
+  std::unique_ptr<Ring> ring = KATANA_CHECKED(AcquireRing());
+  uint64_t bytes_read = KATANA_CHECKED_CONTEXT(
+      direct ? ReadDirect(ring.get(), fd.get(), start, size, result_buf)
+             : ReadBuffered(ring->ring(), fd.get(), start, size, result_buf),
+      "reading {}", path);
+  // only reuse rings that have no requests left in flight
+  ReleaseRing(std::move(ring));
+
+  // like LocalStorage, tolerate a short read of less than a block because the
+  // file size isn't necessarily well aligned
+  if (size - bytes_read > kBlockSize) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "short read of {}: {} of {} bytes",
+        std::quoted(path), bytes_read, size);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+tsuba::UringStorage::PutMultiSync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  std::string path = uri;
+  CleanUri(&path);
+  KATANA_CHECKED(EnsureDirectories(path));
+
+  bool direct = direct_;
+  FileDescriptor fd(OpenFile(path, O_WRONLY | O_CREAT | O_TRUNC, &direct));
+  if (fd.get() < 0) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "opening file {}: {}", std::quoted(path),
+        katana::ResultErrno().message());
+  }
+  if (size == 0) {
+    return katana::ResultSuccess();
+  }
+
+  std::unique_ptr<Ring> ring = KATANA_CHECKED(AcquireRing());
+  KATANA_CHECKED_CONTEXT(
+      direct ? WriteDirect(ring.get(), fd.get(), data, size)
+             : WriteBuffered(ring->ring(), fd.get(), data, size),
+      "writing {}", path);
+  // only reuse rings that have no requests left in flight
+  ReleaseRing(std::move(ring));
+
+  return katana::ResultSuccess();
+}
+
+std::future<katana::CopyableResult<void>>
+tsuba::UringStorage::PutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  return IO()->Submit<void>(
+      [this, uri, data, size]() -> katana::CopyableResult<void> {
+        if (auto res = PutMultiSync(uri, data, size); !res) {
+          return res.error();
+        }
+        return katana::CopyableResultSuccess();
+      });
+}
+
+std::future<katana::CopyableResult<void>>
+tsuba::UringStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  return IO()->Submit<void>(
+      [this, uri, start, size, result_buf]() -> katana::CopyableResult<void> {
+        if (auto res = GetMultiSync(uri, start, size, result_buf); !res) {
+          return res.error();
+        }
+        return katana::CopyableResultSuccess();
+      });
+}
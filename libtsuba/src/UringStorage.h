@@ -0,0 +1,87 @@
+#ifndef KATANA_LIBTSUBA_URINGSTORAGE_H_
+#define KATANA_LIBTSUBA_URINGSTORAGE_H_
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "LocalStorage.h"
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace tsuba {
+
+/// Local file system storage that issues reads and writes through Linux
+/// io_uring. Large requests are split into chunks that are all in flight at
+/// once instead of being copied through an ifstream/ofstream.
+///
+/// With direct I/O enabled, files are opened with O_DIRECT and data is staged
+/// through block-aligned buffers registered with the ring, so large property
+/// files do not evict other data (e.g., the topology) from the page cache.
+///
+/// Listing, stat, delete and copy are inherited from LocalStorage.
+class KATANA_EXPORT UringStorage : public LocalStorage {
+public:
+  static constexpr const char* kDisableEnv = "KATANA_DO_NOT_USE_IO_URING";
+  static constexpr const char* kDirectEnv = "KATANA_IO_URING_DIRECT";
+
+  /// Maximum number of requests in flight per ring
+  static constexpr uint32_t kQueueDepth = 32;
+  /// Size of each read or write request
+  static constexpr uint64_t kChunkSize = UINT64_C(1) << 20;  // 1 MB
+  /// Number of registered staging buffers (each kChunkSize) used for direct I/O
+  static constexpr uint32_t kNumFixedBuffers = 8;
+
+  class Ring;
+
+  explicit UringStorage(bool direct);
+  ~UringStorage() override;
+
+  /// Return true if io_uring can be used in this process (kernel support,
+  /// seccomp policy and memlock limits permitting)
+  static bool Available();
+
+  /// Return true if io_uring is available and has not been disabled with
+  /// kDisableEnv. Otherwise local files are left to LocalStorage.
+  static bool Enabled();
+
+  /// Register an UringStorage instance with tsuba if Enabled(). Must be
+  /// called before tsuba's GlobalState is initialized.
+  static void RegisterIfAvailable();
+
+  katana::Result<void> Init() override;
+  katana::Result<void> Fini() override;
+
+  uint32_t Priority() const override { return 2; }
+
+  katana::Result<void> GetMultiSync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+
+  katana::Result<void> PutMultiSync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
+
+  std::future<katana::CopyableResult<void>> PutAsync(
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
+
+  std::future<katana::CopyableResult<void>> GetAsync(
+      const std::string& uri, uint64_t start, uint64_t size,
+      uint8_t* result_buf) override;
+
+  bool direct() const { return direct_; }
+
+private:
+  katana::Result<std::unique_ptr<Ring>> AcquireRing();
+  void ReleaseRing(std::unique_ptr<Ring> ring);
+
+  bool direct_;
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Ring>> free_rings_;
+};
+
+}  // namespace tsuba
+
+#endif
@@ -1,6 +1,7 @@
 #include "tsuba/WriteGroup.h"
 
 #include "GlobalState.h"
+#include "IOExecutor.h"
 #include "katana/Random.h"
 #include "katana/Result.h"
 
@@ -63,9 +64,13 @@ WriteGroup::StartStore(std::shared_ptr<FileFrame> ff) {
   uint64_t size = ff->map_size();
 
   // wrap future to hold onto FileFrame, but free it as soon as possible
-  auto future = std::async(std::launch::async, [ff = std::move(ff)]() mutable {
-    return ff->PersistAsync().get();
-  });
+  auto future = IO()->Submit<void>(
+      [ff = std::move(ff)]() mutable -> katana::CopyableResult<void> {
+        if (auto res = ff->Persist(); !res) {
+          return res.error();
+        }
+        return katana::CopyableResultSuccess();
+      });
   AddOp(std::move(future), file, size);
 }
 
@@ -11,6 +11,10 @@
 #include "tsuba/FileView.h"
 #include "tsuba/file.h"
 
+#if defined(KATANA_USE_IO_URING)
+#include "UringStorage.h"
+#endif
+
 namespace {
 
 katana::NullCommBackend default_comm_backend;
@@ -322,6 +326,11 @@ tsuba::MakeTopologyFileName(tsuba::RDGHandle handle) {
   return GetRDGDir(handle).RandFile("topology");
 }
 
+katana::Uri
+tsuba::MakeDerivedTopologyFileName(tsuba::RDGHandle handle) {
+  return GetRDGDir(handle).RandFile("derived_topology");
+}
+
 katana::Uri
 tsuba::MakeNodeEntityTypeIDArrayFileName(tsuba::RDGHandle handle) {
   return GetRDGDir(handle).RandFile("node_entity_type_id_array");
@@ -340,6 +349,9 @@ tsuba::GetRDGDir(tsuba::RDGHandle handle) {
 katana::Result<void>
 tsuba::Init(katana::CommBackend* comm) {
   katana::InitSignalHandlers();
+#if defined(KATANA_USE_IO_URING)
+  UringStorage::RegisterIfAvailable();
+#endif
   return GlobalState::Init(comm);
 }
 
@@ -1,3 +1,6 @@
+#include <memory>
+#include <string>
+
 #include <boost/filesystem.hpp>
 
 #include "katana/Result.h"
@@ -31,9 +34,45 @@ TestEmpty(const std::string& path) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+TestMappedOutlivesUnbind(const std::string& path) {
+  auto uri = KATANA_CHECKED(katana::Uri::MakeFromFile(path));
+  auto mapped_uri = uri.Join("mapped_file");
+
+  std::string contents(1 << 16, 'x');
+  for (size_t i = 0; i < contents.size(); ++i) {
+    contents[i] = static_cast<char>('a' + i % 26);
+  }
+  KATANA_CHECKED(tsuba::FileStore(mapped_uri.string(), contents));
+
+  tsuba::FileView fv;
+  KATANA_CHECKED(fv.BindMapped(mapped_uri.string()));
+  KATANA_LOG_ASSERT(fv.mapped());
+  KATANA_LOG_ASSERT(fv.size() == contents.size());
+
+  std::shared_ptr<const void> mapping = fv.mapping();
+  KATANA_LOG_ASSERT(mapping != nullptr);
+  const char* data = fv.ptr<char>();
+
+  // Dropping the view must not unmap memory that is still referenced
+  KATANA_CHECKED(fv.Unbind());
+  KATANA_LOG_ASSERT(fv.mapping() == nullptr);
+  KATANA_LOG_ASSERT(std::string(data, contents.size()) == contents);
+
+  // Neither must rebinding it
+  KATANA_CHECKED(fv.BindMapped(mapped_uri.string()));
+  KATANA_LOG_ASSERT(fv.mapping() != mapping);
+  KATANA_CHECKED(fv.Unbind());
+  KATANA_LOG_ASSERT(std::string(data, contents.size()) == contents);
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& path) {
   KATANA_CHECKED_CONTEXT(TestEmpty(path), "TestEmpty");
+  KATANA_CHECKED_CONTEXT(
+      TestMappedOutlivesUnbind(path), "TestMappedOutlivesUnbind");
 
   return katana::ResultSuccess();
 }
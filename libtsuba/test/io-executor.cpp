@@ -0,0 +1,123 @@
+#include <atomic>
+#include <vector>
+
+#include "IOExecutor.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+katana::Result<void>
+TestBoundedWorkers() {
+  constexpr uint32_t kWorkers = 3;
+  constexpr uint32_t kTasks = 64;
+
+  tsuba::IOExecutor executor(kWorkers, 4);
+
+  std::atomic<uint32_t> running{0};
+  std::atomic<uint32_t> max_running{0};
+
+  std::vector<std::future<katana::CopyableResult<uint32_t>>> futures;
+  for (uint32_t i = 0; i < kTasks; ++i) {
+    futures.emplace_back(executor.Submit<uint32_t>(
+        [&running, &max_running, i]() -> katana::CopyableResult<uint32_t> {
+          uint32_t now = ++running;
+          uint32_t prev = max_running.load();
+          while (prev < now && !max_running.compare_exchange_weak(prev, now)) {
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          --running;
+          return i;
+        }));
+  }
+
+  for (uint32_t i = 0; i < kTasks; ++i) {
+    uint32_t val = KATANA_CHECKED(futures[i].get());
+    KATANA_LOG_VASSERT(val == i, "expected {} found {}", i, val);
+  }
+
+  KATANA_LOG_VASSERT(
+      max_running.load() <= kWorkers, "{} tasks ran at once with {} workers",
+      max_running.load(), kWorkers);
+  KATANA_LOG_ASSERT(executor.GetStats().tasks == kTasks);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestNestedSubmit() {
+  // a single worker waiting on a task it submitted must not deadlock
+  tsuba::IOExecutor executor(1, 1);
+
+  auto outer = executor.Submit<void>([&]() -> katana::CopyableResult<void> {
+    auto inner = executor.Submit<void>([]() -> katana::CopyableResult<void> {
+      return katana::CopyableResultSuccess();
+    });
+    return inner.get();
+  });
+  KATANA_CHECKED(outer.get());
+
+  KATANA_LOG_ASSERT(executor.GetStats().inline_tasks == 1);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestResize() {
+  tsuba::IOExecutor executor(4, 8);
+  executor.Resize(1, 2);
+  KATANA_LOG_ASSERT(executor.num_workers() == 1);
+  KATANA_LOG_ASSERT(executor.max_queue_depth() == 2);
+
+  auto res = executor.Submit<int>(
+      []() -> katana::CopyableResult<int> { return 42; });
+  KATANA_LOG_ASSERT(KATANA_CHECKED(res.get()) == 42);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestConfigureOnce() {
+  tsuba::IOExecutor executor(4, 8);
+  KATANA_LOG_ASSERT(executor.ConfigureOnce(2, 3));
+  KATANA_LOG_ASSERT(executor.num_workers() == 2);
+  KATANA_LOG_ASSERT(executor.max_queue_depth() == 3);
+
+  // later configurations are ignored
+  KATANA_LOG_ASSERT(!executor.ConfigureOnce(6, 10));
+  KATANA_LOG_ASSERT(executor.num_workers() == 2);
+  KATANA_LOG_ASSERT(executor.max_queue_depth() == 3);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll() {
+  KATANA_CHECKED_CONTEXT(TestBoundedWorkers(), "TestBoundedWorkers");
+  KATANA_CHECKED_CONTEXT(TestNestedSubmit(), "TestNestedSubmit");
+  KATANA_CHECKED_CONTEXT(TestResize(), "TestResize");
+  KATANA_CHECKED_CONTEXT(TestConfigureOnce(), "TestConfigureOnce");
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main() {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  auto res = TestAll();
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  return 0;
+}
@@ -0,0 +1,205 @@
+#include <string>
+#include <vector>
+
+#include <arrow/api.h>
+#include <benchmark/benchmark.h>
+#include <parquet/types.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/Random.h"
+#include "katana/Result.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/ParquetWriter.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+std::string gDir;
+
+struct Setting {
+  const char* name;
+  tsuba::ParquetWriter::ColumnOpts columns;
+};
+
+const std::vector<Setting>&
+Settings() {
+  static const std::vector<Setting> settings{
+      {"plain",
+       {.compression = parquet::Compression::UNCOMPRESSED,
+        .dictionary = false}},
+      {"type-defaults", {}},
+      {"snappy", {.compression = parquet::Compression::SNAPPY}},
+      {"zstd", {.compression = parquet::Compression::ZSTD}},
+      {"zstd-9",
+       {.compression = parquet::Compression::ZSTD, .compression_level = 9}},
+  };
+  return settings;
+}
+
+void
+MakeArguments(benchmark::internal::Benchmark* b) {
+  for (long setting = 0, num = Settings().size(); setting < num; ++setting) {
+    for (long size : {1024, 1024 * 1024}) {
+      b->Args({setting, size});
+    }
+  }
+}
+
+template <typename Builder, typename T>
+std::shared_ptr<arrow::ChunkedArray>
+Finish(Builder* builder, const std::vector<T>& values) {
+  for (const auto& v : values) {
+    KATANA_LOG_ASSERT(builder->Append(v).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder->Finish(&array).ok());
+  return std::make_shared<arrow::ChunkedArray>(array);
+}
+
+/// A table with columns like the properties we see in practice: a low
+/// cardinality label, a unique id, a string and a weight
+std::shared_ptr<arrow::Table>
+MakeTable(int64_t size) {
+  std::uniform_int_distribution<int64_t> id_dist(0, INT64_MAX);
+  std::uniform_real_distribution<double> weight_dist(0, 1);
+
+  std::vector<int64_t> labels;
+  std::vector<int64_t> ids;
+  std::vector<std::string> names;
+  std::vector<double> weights;
+  for (int64_t i = 0; i < size; ++i) {
+    labels.emplace_back(i % 16);
+    ids.emplace_back(id_dist(katana::GetGenerator()));
+    names.emplace_back(fmt::format("user-name-{}", i % 4096));
+    weights.emplace_back(weight_dist(katana::GetGenerator()));
+  }
+
+  arrow::Int64Builder label_builder;
+  arrow::Int64Builder id_builder;
+  arrow::LargeStringBuilder name_builder;
+  arrow::DoubleBuilder weight_builder;
+
+  return arrow::Table::Make(
+      arrow::schema({
+          arrow::field("label", arrow::int64()),
+          arrow::field("id", arrow::int64()),
+          arrow::field("name", arrow::large_utf8()),
+          arrow::field("weight", arrow::float64()),
+      }),
+      {
+          Finish(&label_builder, labels),
+          Finish(&id_builder, ids),
+          Finish(&name_builder, names),
+          Finish(&weight_builder, weights),
+      });
+}
+
+katana::Result<void>
+Write(
+    const std::shared_ptr<arrow::Table>& table, const Setting& setting,
+    const katana::Uri& uri) {
+  tsuba::ParquetWriter::WriteOpts opts;
+  opts.columns = setting.columns;
+  auto writer = KATANA_CHECKED(tsuba::ParquetWriter::Make(table, opts));
+  return writer->WriteToUri(uri);
+}
+
+bool
+Supported(const Setting& setting) {
+  return !setting.columns.compression ||
+         parquet::IsCodecSupported(setting.columns.compression.value());
+}
+
+katana::Uri
+OutputUri(const Setting& setting, int64_t size) {
+  auto dir_res = katana::Uri::Make(gDir);
+  KATANA_LOG_ASSERT(dir_res);
+  return dir_res.value().Join(fmt::format("{}-{}.parquet", setting.name, size));
+}
+
+void
+SetBytesOnDisk(benchmark::State& state, const katana::Uri& uri) {
+  tsuba::StatBuf buf;
+  auto res = tsuba::FileStat(uri.string(), &buf);
+  KATANA_LOG_VASSERT(res, "stat failed: {}", res.error());
+  state.counters["bytes_on_disk"] = buf.size;
+}
+
+void
+WriteTable(benchmark::State& state) {
+  const Setting& setting = Settings()[state.range(0)];
+  int64_t size = state.range(1);
+  state.SetLabel(setting.name);
+  if (!Supported(setting)) {
+    state.SkipWithError("codec not supported");
+    return;
+  }
+
+  auto table = MakeTable(size);
+  katana::Uri uri = OutputUri(setting, size);
+  for (auto _ : state) {
+    auto res = Write(table, setting, uri);
+    KATANA_LOG_VASSERT(res, "write failed: {}", res.error());
+  }
+
+  SetBytesOnDisk(state, uri);
+  state.SetBytesProcessed(
+      state.iterations() * katana::ApproxTableMemUse(table));
+}
+
+void
+ReadTable(benchmark::State& state) {
+  const Setting& setting = Settings()[state.range(0)];
+  int64_t size = state.range(1);
+  state.SetLabel(setting.name);
+  if (!Supported(setting)) {
+    state.SkipWithError("codec not supported");
+    return;
+  }
+
+  auto table = MakeTable(size);
+  katana::Uri uri = OutputUri(setting, size);
+  auto write_res = Write(table, setting, uri);
+  KATANA_LOG_VASSERT(write_res, "write failed: {}", write_res.error());
+
+  auto reader_res = tsuba::ParquetReader::Make();
+  KATANA_LOG_ASSERT(reader_res);
+  auto reader = std::move(reader_res.value());
+  for (auto _ : state) {
+    auto res = reader->ReadTable(uri);
+    KATANA_LOG_VASSERT(res, "read failed: {}", res.error());
+    benchmark::DoNotOptimize(res.value());
+  }
+
+  SetBytesOnDisk(state, uri);
+  state.SetBytesProcessed(
+      state.iterations() * katana::ApproxTableMemUse(table));
+}
+
+BENCHMARK(WriteTable)->Apply(MakeArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(ReadTable)->Apply(MakeArguments)->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  benchmark::Initialize(&argc, argv);
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} [benchmark options] <empty dir>", argv[0]);
+  }
+  gDir = argv[1];
+
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  return 0;
+}
@@ -1,5 +1,7 @@
 #include <arrow/chunked_array.h>
 #include <arrow/type_fwd.h>
+#include <parquet/file_reader.h>
+#include <parquet/metadata.h>
 
 #include "katana/Result.h"
 #include "tsuba/ParquetReader.h"
@@ -38,10 +40,146 @@ TestLargeStringRoundTrip(const std::string& dir) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+TestWriteOptsRoundTrip(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::Uri::Make(dir)).Join("write_opts.parquet");
+
+  arrow::Int64Builder label_builder;
+  arrow::Int64Builder id_builder;
+  for (int64_t i = 0; i < 100; ++i) {
+    KATANA_CHECKED(label_builder.Append(i % 4));
+    KATANA_CHECKED(id_builder.Append(i));
+  }
+  std::shared_ptr<arrow::Array> labels;
+  KATANA_CHECKED(label_builder.Finish(&labels));
+  std::shared_ptr<arrow::Array> ids;
+  KATANA_CHECKED(id_builder.Finish(&ids));
+  auto strings = KATANA_CHECKED(MakeArrayOfStrings());
+
+  auto table = arrow::Table::Make(
+      arrow::schema({
+          arrow::field("label", arrow::int64()),
+          arrow::field("id", arrow::int64()),
+          arrow::field("name", arrow::large_utf8()),
+      }),
+      {
+          std::make_shared<arrow::ChunkedArray>(labels),
+          std::make_shared<arrow::ChunkedArray>(ids),
+          strings,
+      });
+
+  tsuba::ParquetWriter::WriteOpts opts;
+  opts.columns.compression = parquet::Compression::UNCOMPRESSED;
+  opts.column_overrides["id"] = {.dictionary = false, .statistics = false};
+  opts.max_row_group_length = 16;
+  auto writer = KATANA_CHECKED(tsuba::ParquetWriter::Make(table, opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  auto reader = KATANA_CHECKED(tsuba::ParquetReader::Make());
+  auto read_table = KATANA_CHECKED(reader->ReadTable(uri));
+  KATANA_LOG_ASSERT(read_table->Equals(*table));
+
+  // The options must show up in the file, not just leave the data intact
+  std::unique_ptr<parquet::ParquetFileReader> file_reader =
+      parquet::ParquetFileReader::OpenFile(uri.path());
+  std::shared_ptr<parquet::FileMetaData> md = file_reader->metadata();
+  KATANA_LOG_ASSERT(md->num_rows() == 100);
+  KATANA_LOG_ASSERT(md->num_row_groups() == 7);
+  int label_col = md->schema()->ColumnIndex("label");
+  int id_col = md->schema()->ColumnIndex("id");
+  KATANA_LOG_ASSERT(label_col >= 0 && id_col >= 0);
+  for (int i = 0; i < md->num_row_groups(); ++i) {
+    auto row_group = md->RowGroup(i);
+    KATANA_LOG_VASSERT(
+        row_group->num_rows() == (i < 6 ? 16 : 4), "row group {} has {} rows",
+        i, row_group->num_rows());
+    for (int c = 0; c < row_group->num_columns(); ++c) {
+      KATANA_LOG_ASSERT(
+          row_group->ColumnChunk(c)->compression() ==
+          parquet::Compression::UNCOMPRESSED);
+    }
+    auto label = row_group->ColumnChunk(label_col);
+    auto id = row_group->ColumnChunk(id_col);
+    KATANA_LOG_ASSERT(label->has_dictionary_page());
+    KATANA_LOG_ASSERT(!id->has_dictionary_page());
+    KATANA_LOG_ASSERT(label->is_stats_set());
+    KATANA_LOG_ASSERT(!id->is_stats_set());
+  }
+
+  opts.max_row_group_length = 0;
+  writer = KATANA_CHECKED(tsuba::ParquetWriter::Make(table, opts));
+  KATANA_LOG_ASSERT(!writer->WriteToUri(uri));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestSlicedRead(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::Uri::Make(dir)).Join("sliced.parquet");
+
+  constexpr int64_t kNumRows = 1000;
+  arrow::Int64Builder id_builder;
+  arrow::LargeStringBuilder name_builder;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    KATANA_CHECKED(id_builder.Append(i));
+    KATANA_CHECKED(name_builder.Append(fmt::format("name-{}", i)));
+  }
+  std::shared_ptr<arrow::Array> ids;
+  KATANA_CHECKED(id_builder.Finish(&ids));
+  std::shared_ptr<arrow::Array> names;
+  KATANA_CHECKED(name_builder.Finish(&names));
+  auto table = arrow::Table::Make(
+      arrow::schema({
+          arrow::field("id", arrow::int64()),
+          arrow::field("name", arrow::large_utf8()),
+      }),
+      {
+          std::make_shared<arrow::ChunkedArray>(ids),
+          std::make_shared<arrow::ChunkedArray>(names),
+      });
+
+  tsuba::ParquetWriter::WriteOpts write_opts;
+  write_opts.max_row_group_length = 64;
+  auto writer = KATANA_CHECKED(tsuba::ParquetWriter::Make(table, write_opts));
+  KATANA_CHECKED(writer->WriteToUri(uri));
+
+  std::vector<tsuba::ParquetReader::Slice> slices{
+      {.offset = 0, .length = 10},
+      {.offset = 100, .length = 250},
+      {.offset = 64, .length = 64},
+      {.offset = 990, .length = 100},
+      {.offset = 500, .length = 0},
+  };
+  for (const auto& slice : slices) {
+    auto read_opts = tsuba::ParquetReader::ReadOpts::Defaults();
+    read_opts.slice = slice;
+    auto reader = KATANA_CHECKED(tsuba::ParquetReader::Make(read_opts));
+
+    int64_t length = std::min(slice.length, kNumRows - slice.offset);
+    auto expected = table->Slice(slice.offset, length);
+
+    auto read_table = KATANA_CHECKED(reader->ReadTable(uri));
+    KATANA_LOG_VASSERT(
+        read_table->Equals(*expected), "slice {}+{}", slice.offset,
+        slice.length);
+
+    auto columns = KATANA_CHECKED(reader->ReadTable(uri, {1, 0, 1}));
+    KATANA_LOG_ASSERT(columns->num_columns() == 3);
+    KATANA_LOG_ASSERT(columns->num_rows() == length);
+    KATANA_LOG_ASSERT(columns->column(0)->Equals(expected->column(1)));
+    KATANA_LOG_ASSERT(columns->column(1)->Equals(expected->column(0)));
+    KATANA_LOG_ASSERT(columns->column(2)->Equals(expected->column(1)));
+  }
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& dir) {
   KATANA_CHECKED_CONTEXT(
       TestLargeStringRoundTrip(dir), "TestLargeStringRoundTrip");
+  KATANA_CHECKED_CONTEXT(TestWriteOptsRoundTrip(dir), "TestWriteOptsRoundTrip");
+  KATANA_CHECKED_CONTEXT(TestSlicedRead(dir), "TestSlicedRead");
 
   return katana::ResultSuccess();
 }
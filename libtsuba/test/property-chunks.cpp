@@ -0,0 +1,187 @@
+#include <arrow/chunked_array.h>
+#include <arrow/type_fwd.h>
+
+#include "PropertyChunks.h"
+#include "katana/Result.h"
+#include "tsuba/ParquetReader.h"
+#include "tsuba/tsuba.h"
+
+namespace {
+
+constexpr int64_t kNumRows = 1000;
+constexpr const char* kName = "value";
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+MakeColumn(int64_t changed_row) {
+  arrow::Int64Builder builder;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    KATANA_CHECKED(builder.Append(i == changed_row ? -1 : i));
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_CHECKED(builder.Finish(&array));
+  return std::make_shared<arrow::ChunkedArray>(array);
+}
+
+katana::Result<std::shared_ptr<arrow::Table>>
+ReadColumn(
+    const katana::Uri& uri,
+    std::optional<tsuba::ParquetReader::Slice> slice = std::nullopt) {
+  auto opts = tsuba::ParquetReader::ReadOpts::Defaults();
+  opts.slice = slice;
+  auto reader = KATANA_CHECKED(tsuba::ParquetReader::Make(opts));
+  return reader->ReadTable(uri);
+}
+
+katana::Result<void>
+CheckEqual(
+    const katana::Uri& uri,
+    const std::shared_ptr<arrow::ChunkedArray>& expected) {
+  auto table = KATANA_CHECKED(ReadColumn(uri));
+  KATANA_LOG_ASSERT(table->num_columns() == 1);
+  KATANA_LOG_ASSERT(table->field(0)->name() == kName);
+  KATANA_LOG_ASSERT(table->column(0)->Equals(expected));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestRoundTrip(const katana::Uri& dir) {
+  tsuba::ChunkedPropertyOpts opts{.chunk_rows = 64, .max_delta_files = 4};
+  auto column = KATANA_CHECKED(MakeColumn(-1));
+
+  std::string path = KATANA_CHECKED(tsuba::StoreChunkedProperty(
+      column, kName, dir, nullptr, nullptr, opts, nullptr));
+  KATANA_LOG_ASSERT(tsuba::PropertyChunkManifest::IsManifestPath(path));
+
+  auto manifest =
+      KATANA_CHECKED(tsuba::PropertyChunkManifest::Read(dir.Join(path)));
+  KATANA_LOG_ASSERT(manifest.num_rows == kNumRows);
+  KATANA_LOG_ASSERT(manifest.chunks.size() == 16);
+  KATANA_LOG_ASSERT(manifest.Files().size() == 1);
+
+  KATANA_CHECKED(CheckEqual(dir.Join(path), column));
+
+  std::vector<tsuba::ParquetReader::Slice> slices{
+      {.offset = 0, .length = 10},
+      {.offset = 60, .length = 200},
+      {.offset = 990, .length = 100},
+  };
+  for (const auto& slice : slices) {
+    int64_t length = std::min(slice.length, kNumRows - slice.offset);
+    auto table = KATANA_CHECKED(ReadColumn(dir.Join(path), slice));
+    KATANA_LOG_VASSERT(
+        table->column(0)->Equals(column->Slice(slice.offset, length)),
+        "slice {}+{}", slice.offset, slice.length);
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestDeltaWrite(const katana::Uri& dir) {
+  tsuba::ChunkedPropertyOpts opts{.chunk_rows = 64, .max_delta_files = 1};
+  auto column = KATANA_CHECKED(MakeColumn(-1));
+  std::string base_path = KATANA_CHECKED(tsuba::StoreChunkedProperty(
+      column, kName, dir, nullptr, nullptr, opts, nullptr));
+  auto base =
+      KATANA_CHECKED(tsuba::PropertyChunkManifest::Read(dir.Join(base_path)));
+
+  // Changing a row in chunk 3 only writes chunk 3
+  auto changed = KATANA_CHECKED(MakeColumn(200));
+  std::string delta_path = KATANA_CHECKED(tsuba::StoreChunkedProperty(
+      changed, kName, dir, &base, nullptr, opts, nullptr));
+  auto delta =
+      KATANA_CHECKED(tsuba::PropertyChunkManifest::Read(dir.Join(delta_path)));
+  for (size_t i = 0; i < delta.chunks.size(); ++i) {
+    bool shared = delta.chunks[i].path == base.chunks[i].path;
+    KATANA_LOG_ASSERT(shared == (i != 3));
+  }
+  KATANA_LOG_ASSERT(delta.Files().size() == 2);
+  KATANA_CHECKED(CheckEqual(dir.Join(delta_path), changed));
+
+  // A second delta file exceeds max_delta_files and folds the property back
+  // into one base file
+  auto changed_again = KATANA_CHECKED(MakeColumn(900));
+  std::string folded_path = KATANA_CHECKED(tsuba::StoreChunkedProperty(
+      changed_again, kName, dir, &delta, nullptr, opts, nullptr));
+  auto folded =
+      KATANA_CHECKED(tsuba::PropertyChunkManifest::Read(dir.Join(folded_path)));
+  KATANA_LOG_ASSERT(folded.Files().size() == 1);
+  KATANA_LOG_ASSERT(folded.chunks[0].path != base.chunks[0].path);
+  KATANA_CHECKED(CheckEqual(dir.Join(folded_path), changed_again));
+
+  return katana::ResultSuccess();
+}
+
+/// Chunks held by the arrays that were stored are kept without hashing;
+/// others are compared by hash
+katana::Result<void>
+TestStoredArrays(const katana::Uri& dir) {
+  tsuba::ChunkedPropertyOpts opts{.chunk_rows = 64, .max_delta_files = 4};
+  auto base_column = KATANA_CHECKED(MakeColumn(-1));
+  auto changed_column = KATANA_CHECKED(MakeColumn(900));
+  // rows [0, 640) in one array, the rest in another
+  auto head = base_column->chunk(0)->Slice(0, 640);
+  auto column = std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{head, base_column->chunk(0)->Slice(640)});
+  auto changed = std::make_shared<arrow::ChunkedArray>(
+      arrow::ArrayVector{head, changed_column->chunk(0)->Slice(640)});
+
+  std::string base_path = KATANA_CHECKED(tsuba::StoreChunkedProperty(
+      column, kName, dir, nullptr, nullptr, opts, nullptr));
+  auto base =
+      KATANA_CHECKED(tsuba::PropertyChunkManifest::Read(dir.Join(base_path)));
+  tsuba::StoredArrays stored = tsuba::StoredArrays::Of(*column);
+
+  KATANA_LOG_ASSERT(stored.Unchanged(*changed, 0, 640));
+  KATANA_LOG_ASSERT(stored.Unchanged(*changed, 64, 64));
+  KATANA_LOG_ASSERT(!stored.Unchanged(*changed, 640, 64));
+  KATANA_LOG_ASSERT(!stored.Unchanged(*changed, 600, 64));
+  KATANA_LOG_ASSERT(!tsuba::StoredArrays().Unchanged(*column, 0, 64));
+
+  std::string delta_path = KATANA_CHECKED(tsuba::StoreChunkedProperty(
+      changed, kName, dir, &base, &stored, opts, nullptr));
+  auto delta =
+      KATANA_CHECKED(tsuba::PropertyChunkManifest::Read(dir.Join(delta_path)));
+  for (size_t i = 0; i < delta.chunks.size(); ++i) {
+    bool shared = delta.chunks[i].path == base.chunks[i].path;
+    // row 900 is in chunk 14
+    KATANA_LOG_ASSERT(shared == (i != 14));
+    KATANA_LOG_ASSERT(delta.chunks[i].hash.has_value());
+  }
+  KATANA_CHECKED(CheckEqual(dir.Join(delta_path), changed));
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& dir_str) {
+  auto dir = KATANA_CHECKED(katana::Uri::Make(dir_str));
+  KATANA_CHECKED(TestRoundTrip(dir));
+  KATANA_CHECKED(TestDeltaWrite(dir));
+  KATANA_CHECKED(TestStoredArrays(dir));
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  return 0;
+}
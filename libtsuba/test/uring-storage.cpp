@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "UringStorage.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/URI.h"
+#include "tsuba/Errors.h"
+#include "tsuba/file.h"
+#include "tsuba/tsuba.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+std::vector<uint8_t>
+MakeData(uint64_t size) {
+  std::vector<uint8_t> data(size);
+  for (uint64_t i = 0; i < size; ++i) {
+    // vary with the block too so that misplaced blocks are caught
+    data[i] = static_cast<uint8_t>(i * 31 + i / tsuba::kBlockSize);
+  }
+  return data;
+}
+
+katana::Result<void>
+TestReadWrite(tsuba::UringStorage* storage, const katana::Uri& dir) {
+  // several chunks and a tail that is not a multiple of the block size
+  const uint64_t size = 3 * tsuba::UringStorage::kChunkSize + 123;
+  std::vector<uint8_t> data = MakeData(size);
+  std::string uri = dir.Join("read-write").string();
+
+  KATANA_CHECKED(storage->PutMultiSync(uri, data.data(), data.size()));
+
+  tsuba::StatBuf stat_buf;
+  KATANA_CHECKED(tsuba::FileStat(uri, &stat_buf));
+  KATANA_LOG_VASSERT(
+      stat_buf.size == size, "expected {} bytes found {}", size,
+      stat_buf.size);
+
+  std::vector<uint8_t> read(size);
+  KATANA_CHECKED(storage->GetMultiSync(uri, 0, size, read.data()));
+  KATANA_LOG_ASSERT(read == data);
+
+  // an empty file
+  std::string empty_uri = dir.Join("empty").string();
+  KATANA_CHECKED(storage->PutMultiSync(empty_uri, data.data(), 0));
+  KATANA_CHECKED(tsuba::FileStat(empty_uri, &stat_buf));
+  KATANA_LOG_ASSERT(stat_buf.size == 0);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestPartialReads(tsuba::UringStorage* storage, const katana::Uri& dir) {
+  const uint64_t size = 2 * tsuba::UringStorage::kChunkSize + 5000;
+  std::vector<uint8_t> data = MakeData(size);
+  std::string uri = dir.Join("partial").string();
+  KATANA_CHECKED(storage->PutMultiSync(uri, data.data(), data.size()));
+
+  const uint64_t chunk = tsuba::UringStorage::kChunkSize;
+  std::vector<std::pair<uint64_t, uint64_t>> ranges{
+      {0, 1},
+      {1, tsuba::kBlockSize - 1},
+      {tsuba::kBlockSize - 3, 10},
+      {chunk - 17, chunk + 1000},
+      {size - 100, 100},
+  };
+  for (const auto& [start, length] : ranges) {
+    std::vector<uint8_t> read(length);
+    KATANA_CHECKED(storage->GetMultiSync(uri, start, length, read.data()));
+    KATANA_LOG_VASSERT(
+        std::equal(read.begin(), read.end(), data.begin() + start),
+        "reading [{}, {})", start, start + length);
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestErrors(tsuba::UringStorage* storage, const katana::Uri& dir) {
+  std::vector<uint8_t> buf(4 * tsuba::kBlockSize);
+
+  auto missing_res = storage->GetMultiSync(
+      dir.Join("missing").string(), 0, buf.size(), buf.data());
+  KATANA_LOG_VASSERT(
+      !missing_res &&
+          missing_res.error() == tsuba::ErrorCode::LocalStorageError,
+      "reading a missing file should fail");
+
+  // reading more than a block past the end of a file is a short read
+  std::vector<uint8_t> data = MakeData(100);
+  std::string small_uri = dir.Join("small").string();
+  KATANA_CHECKED(storage->PutMultiSync(small_uri, data.data(), data.size()));
+  auto short_res =
+      storage->GetMultiSync(small_uri, 0, buf.size(), buf.data());
+  KATANA_LOG_VASSERT(
+      !short_res && short_res.error() == tsuba::ErrorCode::LocalStorageError,
+      "reading past the end of a file should fail");
+
+  // a file is in the way of the parent directory
+  auto put_res = storage->PutMultiSync(
+      dir.Join("small").Join("child").string(), data.data(), data.size());
+  KATANA_LOG_VASSERT(!put_res, "writing under a file should fail");
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAsync(tsuba::UringStorage* storage, const katana::Uri& dir) {
+  const uint64_t size = tsuba::UringStorage::kChunkSize + 77;
+  std::vector<uint8_t> data = MakeData(size);
+  std::string uri = dir.Join("async").string();
+
+  KATANA_CHECKED(storage->PutAsync(uri, data.data(), data.size()).get());
+
+  std::vector<uint8_t> read(size);
+  KATANA_CHECKED(storage->GetAsync(uri, 0, size, read.data()).get());
+  KATANA_LOG_ASSERT(read == data);
+
+  // errors come back through the future
+  auto missing_res =
+      storage->GetAsync(dir.Join("missing").string(), 0, size, read.data())
+          .get();
+  KATANA_LOG_VASSERT(!missing_res, "reading a missing file should fail");
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestStorage(bool direct, const katana::Uri& dir) {
+  tsuba::UringStorage storage(direct);
+  KATANA_CHECKED(storage.Init());
+
+  KATANA_CHECKED_CONTEXT(TestReadWrite(&storage, dir), "TestReadWrite");
+  KATANA_CHECKED_CONTEXT(TestPartialReads(&storage, dir), "TestPartialReads");
+  KATANA_CHECKED_CONTEXT(TestErrors(&storage, dir), "TestErrors");
+  KATANA_CHECKED_CONTEXT(TestAsync(&storage, dir), "TestAsync");
+
+  return storage.Fini();
+}
+
+/// tsuba was initialized with io_uring disabled, so local files must be
+/// served by LocalStorage
+katana::Result<void>
+TestFallback(const katana::Uri& dir) {
+  KATANA_LOG_ASSERT(!tsuba::UringStorage::Enabled());
+
+  std::vector<uint8_t> data = MakeData(tsuba::UringStorage::kChunkSize + 9);
+  std::string uri = dir.Join("fallback").string();
+  KATANA_CHECKED(tsuba::FileStore(uri, data.data(), data.size()));
+
+  std::vector<uint8_t> read(data.size());
+  KATANA_CHECKED(tsuba::FileGet(uri, read.data(), 0, read.size()));
+  KATANA_LOG_ASSERT(read == data);
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& path) {
+  if (boost::system::error_code err; !fs::create_directories(path, err)) {
+    if (err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating parent directories: {}", err.message());
+    }
+  }
+  auto dir = KATANA_CHECKED(katana::Uri::MakeFromFile(path));
+
+  KATANA_CHECKED_CONTEXT(TestFallback(dir.Join("fallback")), "TestFallback");
+
+  if (!tsuba::UringStorage::Available()) {
+    KATANA_LOG_WARN("io_uring is not available, skipping io_uring tests");
+    return katana::ResultSuccess();
+  }
+
+  KATANA_CHECKED_CONTEXT(TestStorage(false, dir.Join("buffered")), "buffered");
+  KATANA_CHECKED_CONTEXT(TestStorage(true, dir.Join("direct")), "direct");
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  // Initialize tsuba as if io_uring were unavailable to exercise the
+  // fallback; the UringStorage tests use their own instances
+  setenv(tsuba::UringStorage::kDisableEnv, "1", 1);
+  if (auto init_good = tsuba::Init(); !init_good) {
+    KATANA_LOG_FATAL("tsuba::Init: {}", init_good.error());
+  }
+
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  if (auto fini_good = tsuba::Fini(); !fini_good) {
+    KATANA_LOG_FATAL("tsuba::Fini: {}", fini_good.error());
+  }
+
+  return 0;
+}
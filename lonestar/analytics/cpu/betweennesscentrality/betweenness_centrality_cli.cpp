@@ -112,18 +112,20 @@ main(int argc, char** argv) {
       if (!file.good()) {
         KATANA_LOG_FATAL("failed to open file: {}", startNodesFile);
       }
-      std::vector<uint32_t> startNodes;
+      std::vector<katana::PropertyGraph::Node> startNodes;
       startNodes.insert(
-          startNodes.end(), std::istream_iterator<uint32_t>{file},
-          std::istream_iterator<uint32_t>{});
+          startNodes.end(),
+          std::istream_iterator<katana::PropertyGraph::Node>{file},
+          std::istream_iterator<katana::PropertyGraph::Node>{});
       sources = startNodes;
       num_sources = startNodes.size();
     } else if (!startNodesString.empty()) {
       std::istringstream str(startNodesString);
-      std::vector<uint32_t> startNodes;
+      std::vector<katana::PropertyGraph::Node> startNodes;
       startNodes.insert(
-          startNodes.end(), std::istream_iterator<uint32_t>{str},
-          std::istream_iterator<uint32_t>{});
+          startNodes.end(),
+          std::istream_iterator<katana::PropertyGraph::Node>{str},
+          std::istream_iterator<katana::PropertyGraph::Node>{});
       sources = startNodes;
       num_sources = startNodes.size();
     }
@@ -132,8 +134,9 @@ main(int argc, char** argv) {
       sources = numberOfSources;
       num_sources = numberOfSources;
     } else {
-      KATANA_LOG_ASSERT(std::holds_alternative<std::vector<uint32_t>>(sources));
-      auto& sources_vec = std::get<std::vector<uint32_t>>(sources);
+      using SourceVector = std::vector<katana::PropertyGraph::Node>;
+      KATANA_LOG_ASSERT(std::holds_alternative<SourceVector>(sources));
+      auto& sources_vec = std::get<SourceVector>(sources);
       if (sources_vec.size() > numberOfSources) {
         sources_vec.resize(numberOfSources);
       }
@@ -83,7 +83,7 @@ AlgorithmName(RandomWalksPlan::Algorithm algorithm) {
 
 void
 PrintWalks(
-    const std::vector<std::vector<uint32_t>>& walks,
+    const std::vector<std::vector<katana::PropertyGraph::Node>>& walks,
     const std::string& output_file) {
   std::ofstream f(output_file);
 
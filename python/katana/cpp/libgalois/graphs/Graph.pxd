@@ -116,7 +116,10 @@ cdef extern from "katana/Graph.h" namespace "katana" nogil:
         edge_data& getEdgeData(edge_iterator)
         edge_data& getEdgeData(edge_iterator, MethodFlag)
 
-    ctypedef uint32_t Node "katana::GraphTopology::Node"
+    # Node is 32 or 64 bits depending on KATANA_NODE_ID_64 in the C++ build.
+    # It is declared with the wider type; Cython converts it using its real
+    # size.
+    ctypedef uint64_t Node "katana::GraphTopology::Node"
     ctypedef uint64_t Edge "katana::GraphTopology::Edge"
 
     cppclass GraphTopology:
@@ -124,7 +127,7 @@ cdef extern from "katana/Graph.h" namespace "katana" nogil:
                 const Edge * adj_indices, size_t numNodes, const Node * dests,
                 size_t numEdges)
         GraphTopology(
-                NUMAArray[uint64_t] &&adj_indices, NUMAArray[uint32_t] &&dests)
+                NUMAArray[uint64_t] &&adj_indices, NUMAArray[Node] &&dests)
 
         StandardRange[counting_iterator[Edge]] edges(Node node) const
         Node edge_dest(Edge edge_id) const
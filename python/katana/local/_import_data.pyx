@@ -3,9 +3,9 @@ from libcpp.memory cimport make_shared, shared_ptr, unique_ptr
 from libcpp.string cimport string
 from libcpp.utility cimport move
 
-from . cimport datastructures
+import numpy as np
 
-from . import datastructures
+cimport numpy as np
 
 from katana.cpp.libgalois.graphs cimport Graph as CGraph
 from katana.cpp.libsupport.result cimport Result, raise_error_code
@@ -31,19 +31,18 @@ def from_csr(edge_indices, edge_destinations):
         integer.
     :returns: the new :py:class:`~katana.local.Graph`
     """
-    cdef datastructures.NUMAArray_uint64_t edge_indices_numa = datastructures.NUMAArray_uint64_t(
-        len(edge_indices), datastructures.AllocationPolicy.INTERLEAVED
-    )
-    cdef datastructures.NUMAArray_uint32_t edge_destinations_numa = datastructures.NUMAArray_uint32_t(
-        len(edge_destinations), datastructures.AllocationPolicy.INTERLEAVED
-    )
-
-    edge_indices_numa.as_numpy()[:] = edge_indices
-    edge_destinations_numa.as_numpy()[:] = edge_destinations
+    # Destinations are converted to the node id width of the build
+    node_dtype = np.dtype("uint{}".format(8 * sizeof(CGraph.Node)))
+    cdef np.ndarray indices = np.ascontiguousarray(edge_indices, dtype=np.uint64)
+    cdef np.ndarray dests = np.ascontiguousarray(edge_destinations, dtype=node_dtype)
+    cdef const CGraph.Edge* indices_data = <const CGraph.Edge*>np.PyArray_DATA(indices)
+    cdef const CGraph.Node* dests_data = <const CGraph.Node*>np.PyArray_DATA(dests)
+    cdef size_t num_nodes = len(indices)
+    cdef size_t num_edges = len(dests)
 
     with nogil:
         pg = handle_result_PropertyGraph( CGraph._PropertyGraph.MakeFromTopo(
-             CGraph.GraphTopology(move(edge_indices_numa.underlying), move(edge_destinations_numa.underlying))
+             CGraph.GraphTopology(indices_data, num_nodes, dests_data, num_edges)
              ))
     return Graph.make(pg)
 
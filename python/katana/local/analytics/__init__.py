@@ -44,6 +44,8 @@ Algorithms
 
 .. automodule:: katana.local.analytics._pagerank
 
+.. automodule:: katana.local.analytics._random_walks
+
 .. automodule:: katana.local.analytics._sssp
 
 .. automodule:: katana.local.analytics._triangle_count
@@ -59,7 +61,7 @@ from katana.local.analytics._betweenness_centrality import (
     BetweennessCentralityStatistics,
     betweenness_centrality,
 )
-from katana.local.analytics._bfs import BfsPlan, BfsStatistics, bfs, bfs_assert_valid
+from katana.local.analytics._bfs import BfsPlan, BfsStatistics, bfs, bfs_assert_valid, multi_source_bfs
 from katana.local.analytics._connected_components import (
     ConnectedComponentsPlan,
     ConnectedComponentsStatistics,
@@ -91,8 +93,26 @@ from katana.local.analytics._louvain_clustering import (
     louvain_clustering,
     louvain_clustering_assert_valid,
 )
-from katana.local.analytics._pagerank import PagerankPlan, PagerankStatistics, pagerank, pagerank_assert_valid
-from katana.local.analytics._sssp import SsspPlan, SsspStatistics, sssp, sssp_assert_valid
+from katana.local.analytics._pagerank import (
+    PagerankPlan,
+    PagerankStatistics,
+    PersonalizedPagerankPlan,
+    incremental_pagerank,
+    pagerank,
+    pagerank_assert_valid,
+    pagerank_warm_start,
+    personalized_pagerank,
+    personalized_pagerank_batch,
+)
+from katana.local.analytics._random_walks import RandomWalksPlan, random_walks
+from katana.local.analytics._sssp import (
+    SsspPlan,
+    SsspStatistics,
+    incremental_sssp,
+    multi_source_sssp,
+    sssp,
+    sssp_assert_valid,
+)
 from katana.local.analytics._subgraph_extraction import SubGraphExtractionPlan, subgraph_extraction
 from katana.local.analytics._triangle_count import TriangleCountPlan, triangle_count
 from katana.local.analytics._wrappers import find_edge_sorted_by_dest, sort_all_edges_by_dest, sort_nodes_by_degree
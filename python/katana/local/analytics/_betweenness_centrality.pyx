@@ -22,7 +22,7 @@ from libc.stdint cimport uint32_t
 from libcpp.string cimport string
 from libcpp.vector cimport vector
 
-from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libgalois.graphs.Graph cimport Node, _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
@@ -73,12 +73,12 @@ cdef extern from * nogil:
     katana::analytics::BetweennessCentralitySources BetweennessCentralitySources_from_int(uint32_t v) {
         return v;
     }
-    katana::analytics::BetweennessCentralitySources BetweennessCentralitySources_from_vector(std::vector<uint32_t> v) {
+    katana::analytics::BetweennessCentralitySources BetweennessCentralitySources_from_vector(std::vector<katana::PropertyGraph::Node> v) {
         return v;
     }
     """
     BetweennessCentralitySources BetweennessCentralitySources_from_int(uint32_t v)
-    BetweennessCentralitySources BetweennessCentralitySources_from_vector(vector[uint32_t] v);
+    BetweennessCentralitySources BetweennessCentralitySources_from_vector(vector[Node] v);
 
 
 class _BetweennessCentralityAlgorithm(Enum):
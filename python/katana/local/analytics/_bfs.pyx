@@ -18,13 +18,16 @@ Breadth-first Search
     :undoc-members:
 
 .. autofunction:: katana.local.analytics.bfs_assert_valid
+
+.. autofunction:: katana.local.analytics.multi_source_bfs
 """
 
 from libc.stddef cimport ptrdiff_t
 from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 
-from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libgalois.graphs.Graph cimport Node, _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
@@ -67,13 +70,18 @@ cdef extern from "katana/Analytics.h" namespace "katana::analytics" nogil:
     uint32_t kDefaultBeta "katana::analytics::BfsPlan::kDefaultBeta"
 
     Result[void] Bfs(_PropertyGraph * pg,
-                     uint32_t start_node,
+                     Node start_node,
                      string output_property_name,
                      _BfsPlan algo)
 
-    Result[void] BfsAssertValid(_PropertyGraph* pg, uint32_t start_node,
+    Result[void] BfsAssertValid(_PropertyGraph* pg, Node start_node,
                                 string property_name);
 
+    Result[void] MultiSourceBfs(_PropertyGraph* pg,
+                                vector[Node] sources,
+                                string output_property_name,
+                                _BfsPlan algo)
+
     cppclass _BfsStatistics "katana::analytics::BfsStatistics":
         uint64_t n_reached_nodes
 
@@ -159,7 +167,7 @@ cdef class BfsPlan(Plan):
         return BfsPlan.make(_BfsPlan.SynchronousDirectOpt(alpha, beta))
 
 
-def bfs(Graph pg, uint32_t start_node, str output_property_name, BfsPlan plan = BfsPlan()):
+def bfs(Graph pg, Node start_node, str output_property_name, BfsPlan plan = BfsPlan()):
     """
     Compute the Breadth-First Search parents on `pg` using `start_node` as the source. The computed parents are
     written to the property `output_property_name`.
@@ -194,7 +202,7 @@ def bfs(Graph pg, uint32_t start_node, str output_property_name, BfsPlan plan =
     with nogil:
         handle_result_void(Bfs(pg.underlying_property_graph(), start_node, output_property_name_cstr, plan.underlying_))
 
-def bfs_assert_valid(Graph pg, uint32_t start_node, str property_name):
+def bfs_assert_valid(Graph pg, Node start_node, str property_name):
     """
     Raise an exception if the BFS results in `pg` appear to be incorrect. This is not an
     exhaustive check, just a sanity check.
@@ -206,6 +214,30 @@ def bfs_assert_valid(Graph pg, uint32_t start_node, str property_name):
     with nogil:
         handle_result_assert(BfsAssertValid(pg.underlying_property_graph(), start_node, output_property_name_cstr))
 
+def multi_source_bfs(Graph pg, sources, str output_property_name, BfsPlan plan = BfsPlan()):
+    """
+    Compute the Breadth-First Search distances on `pg` from each node of `sources`. Up to 512 sources are traversed
+    together, which is much faster than running :py:func:`bfs` for each. The distances are written to the property
+    `output_property_name` as a fixed size list per node, with one distance for each source in the order of `sources`.
+    Nodes unreachable from a source have the distance ``2**32 - 1``.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type sources: list of Node IDs
+    :param sources: The source nodes.
+    :type output_property_name: str
+    :param output_property_name: The output property to write distances into. This property must not already exist.
+    :type plan: BfsPlan
+    :param plan: The execution plan to use. Only synchronous and synchronous direction optimizing plans are supported.
+    """
+    cdef vector[Node] sources_vec = sources
+    output_property_name_bytes = bytes(output_property_name, "utf-8")
+    output_property_name_cstr = <string>output_property_name_bytes
+    with nogil:
+        handle_result_void(
+            MultiSourceBfs(pg.underlying_property_graph(), sources_vec, output_property_name_cstr, plan.underlying_)
+        )
+
 cdef _BfsStatistics handle_result_BfsStatistics(Result[_BfsStatistics] res) nogil except *:
     if not res.has_value():
         with gil:
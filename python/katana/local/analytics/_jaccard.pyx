@@ -22,7 +22,7 @@ Jaccard Similarity
 
 from libcpp.string cimport string
 
-from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libgalois.graphs.Graph cimport Node, _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
@@ -48,10 +48,10 @@ cdef extern from "katana/analytics/jaccard/jaccard.h" namespace "katana::analyti
         @staticmethod
         _JaccardPlan Unsorted()
 
-    Result[void] Jaccard(_PropertyGraph* pg, size_t compare_node,
+    Result[void] Jaccard(_PropertyGraph* pg, Node compare_node,
         string output_property_name, _JaccardPlan plan)
 
-    Result[void] JaccardAssertValid(_PropertyGraph* pg, size_t compare_node,
+    Result[void] JaccardAssertValid(_PropertyGraph* pg, Node compare_node,
         string output_property_name)
 
     cppclass _JaccardStatistics  "katana::analytics::JaccardStatistics":
@@ -61,7 +61,7 @@ cdef extern from "katana/analytics/jaccard/jaccard.h" namespace "katana::analyti
         void Print(ostream os)
 
         @staticmethod
-        Result[_JaccardStatistics] Compute(_PropertyGraph* pg, size_t compare_node,
+        Result[_JaccardStatistics] Compute(_PropertyGraph* pg, Node compare_node,
             string output_property_name)
 
 
@@ -132,7 +132,7 @@ cdef class JaccardPlan(Plan):
         return JaccardPlan.make(_JaccardPlan.Unsorted())
 
 
-def jaccard(Graph pg, size_t compare_node, str output_property_name,
+def jaccard(Graph pg, Node compare_node, str output_property_name,
             JaccardPlan plan = JaccardPlan()):
     """
     Compute the Jaccard Similarity between `compare_node` and all nodes in the graph.
@@ -172,7 +172,7 @@ def jaccard(Graph pg, size_t compare_node, str output_property_name,
         handle_result_void(Jaccard(pg.underlying_property_graph(), compare_node, output_property_name_cstr, plan.underlying_))
 
 
-def jaccard_assert_valid(Graph pg, size_t compare_node, str output_property_name):
+def jaccard_assert_valid(Graph pg, Node compare_node, str output_property_name):
     """
     Raise an exception if the Jaccard Similarity results in `pg` are invalid. This is not an exhaustive check, just a
     sanity check.
@@ -200,7 +200,7 @@ cdef class JaccardStatistics:
     """
     cdef _JaccardStatistics underlying
 
-    def __init__(self, Graph pg, size_t compare_node, str output_property_name):
+    def __init__(self, Graph pg, Node compare_node, str output_property_name):
         output_property_name_bytes = bytes(output_property_name, "utf-8")
         output_property_name_cstr = <string> output_property_name_bytes
         with nogil:
@@ -22,10 +22,33 @@ Page Rank
     :undoc-members:
 
 .. autofunction:: katana.local.analytics.pagerank_assert_valid
+
+.. autofunction:: katana.local.analytics.pagerank_warm_start
+
+.. autofunction:: katana.local.analytics.incremental_pagerank
+
+.. autoclass:: katana.local.analytics.PersonalizedPagerankPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. [ANDERSEN] ANDERSEN, Reid; CHUNG, Fan; LANG, Kevin. Local graph partitioning using PageRank vectors. In: 47th
+    Annual IEEE Symposium on Foundations of Computer Science (FOCS'06). IEEE, 2006. p. 475-486.
+
+.. autoclass:: katana.local.analytics._pagerank._PersonalizedPagerankPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.personalized_pagerank
+
+.. autofunction:: katana.local.analytics.personalized_pagerank_batch
 """
+from libc.stdint cimport uint32_t
+from libcpp.pair cimport pair
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 
-from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libgalois.graphs.Graph cimport Node, _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
@@ -67,6 +90,12 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
 
     Result[void] Pagerank(_PropertyGraph* pg, string output_property_name, _PagerankPlan plan)
 
+    Result[void] PagerankWarmStart(_PropertyGraph* pg, string initial_rank_property_name, string output_property_name,
+                                   _PagerankPlan plan)
+
+    Result[void] IncrementalPagerank(_PropertyGraph* pg, const vector[Node]& srcs, const vector[Node]& dests,
+                                     string output_property_name, _PagerankPlan plan)
+
     Result[void] PagerankAssertValid(_PropertyGraph* pg, string output_property_name)
 
     cppclass _PagerankStatistics "katana::analytics::PagerankStatistics":
@@ -79,6 +108,30 @@ cdef extern from "katana/analytics/pagerank/pagerank.h" namespace "katana::analy
         @staticmethod
         Result[_PagerankStatistics] Compute(_PropertyGraph* pg, string output_property_name)
 
+    cppclass _PersonalizedPagerankPlan "katana::analytics::PersonalizedPagerankPlan" (_Plan):
+        enum Algorithm:
+            kForwardPush "katana::analytics::PersonalizedPagerankPlan::kForwardPush"
+
+        _PersonalizedPagerankPlan.Algorithm algorithm() const
+        float alpha() const
+        float epsilon() const
+        uint32_t top_k() const
+
+        PersonalizedPagerankPlan()
+
+        @staticmethod
+        _PersonalizedPagerankPlan ForwardPush(float alpha, float epsilon, uint32_t top_k)
+
+    double kPersonalizedDefaultAlpha "katana::analytics::PersonalizedPagerankPlan::kDefaultAlpha"
+    double kPersonalizedDefaultEpsilon "katana::analytics::PersonalizedPagerankPlan::kDefaultEpsilon"
+    uint32_t kPersonalizedDefaultTopK "katana::analytics::PersonalizedPagerankPlan::kDefaultTopK"
+
+    Result[vector[pair[Node, float]]] PersonalizedPagerank(_PropertyGraph* pg, const vector[Node]& seeds,
+                                                               _PersonalizedPagerankPlan plan)
+
+    Result[vector[vector[pair[Node, float]]]] PersonalizedPagerankBatch(
+        _PropertyGraph* pg, const vector[Node]& seeds, _PersonalizedPagerankPlan plan)
+
 
 class _PagerankPlanAlgorithm(Enum):
     PullTopological = _PagerankPlan.Algorithm.kPullTopological
@@ -203,6 +256,53 @@ def pagerank(Graph pg, str output_property_name, PagerankPlan plan = PagerankPla
         handle_result_void(Pagerank(pg.underlying_property_graph(), output_property_name_cstr, plan.underlying_))
 
 
+def pagerank_warm_start(Graph pg, str initial_rank_property_name, str output_property_name,
+                        PagerankPlan plan = PagerankPlan()):
+    """
+    Compute the Page Rank of each node in the graph starting from the ranks in `initial_rank_property_name`, e.g.,
+    those computed by :py:func:`pagerank` before the graph changed. This takes far fewer rounds than :py:func:`pagerank`
+    when the ranks are close. The initial ranks must be scaled like those of the residual and push algorithms.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type initial_rank_property_name: str
+    :param initial_rank_property_name: The float property with the initial ranks.
+    :type output_property_name: str
+    :param output_property_name: The output property to store the rank. This property must not already exist.
+    :type plan: PagerankPlan
+    :param plan: The execution plan to use; only its tolerance and alpha are used.
+    """
+    cdef string initial_rank_property_name_str = bytes(initial_rank_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(PagerankWarmStart(pg.underlying_property_graph(), initial_rank_property_name_str,
+                                             output_property_name_str, plan.underlying_))
+
+
+def incremental_pagerank(Graph pg, srcs, dests, str output_property_name, PagerankPlan plan = PagerankPlan()):
+    """
+    Update the ranks that :py:func:`pagerank` wrote to `output_property_name` after the edges from `srcs[i]` to
+    `dests[i]` were inserted or deleted. Only the nodes near the changed edges start with a residual.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type srcs: list of Node IDs
+    :param srcs: The sources of the changed edges.
+    :type dests: list of Node IDs
+    :param dests: The destinations of the changed edges.
+    :type output_property_name: str
+    :param output_property_name: The property with the ranks to update.
+    :type plan: PagerankPlan
+    :param plan: The execution plan to use; only its tolerance and alpha are used.
+    """
+    cdef vector[Node] srcs_vec = srcs
+    cdef vector[Node] dests_vec = dests
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(IncrementalPagerank(pg.underlying_property_graph(), srcs_vec, dests_vec,
+                                               output_property_name_str, plan.underlying_))
+
+
 def pagerank_assert_valid(Graph pg, str output_property_name):
     """
     Raise an exception if the pagerank results in `pg` are invalid. This is not an exhaustive check, just a sanity check.
@@ -253,3 +353,114 @@ cdef class PagerankStatistics:
         cdef ostringstream ss
         self.underlying.Print(ss)
         return str(ss.str(), "ascii")
+
+
+class _PersonalizedPagerankPlanAlgorithm(Enum):
+    ForwardPush = _PersonalizedPagerankPlan.Algorithm.kForwardPush
+
+
+cdef class PersonalizedPagerankPlan(Plan):
+    """
+    A computational :ref:`Plan` for Personalized Page Rank, the stationary distribution of a random walk that restarts
+    at a set of seed nodes.
+
+    Static methods construct PersonalizedPagerankPlans.
+    """
+    cdef:
+        _PersonalizedPagerankPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _PersonalizedPagerankPlanAlgorithm
+
+    @staticmethod
+    cdef PersonalizedPagerankPlan make(_PersonalizedPagerankPlan u):
+        f = <PersonalizedPagerankPlan>PersonalizedPagerankPlan.__new__(PersonalizedPagerankPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _PersonalizedPagerankPlanAlgorithm:
+        return _PersonalizedPagerankPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def alpha(self) -> float:
+        return self.underlying_.alpha()
+
+    @property
+    def epsilon(self) -> float:
+        return self.underlying_.epsilon()
+
+    @property
+    def top_k(self) -> int:
+        return self.underlying_.top_k()
+
+    @staticmethod
+    def forward_push(float alpha = kPersonalizedDefaultAlpha, float epsilon = kPersonalizedDefaultEpsilon,
+                     uint32_t top_k = kPersonalizedDefaultTopK):
+        """
+        Forward push algorithm
+
+        Rank is pushed from a node to its out neighbors only while the node holds more than `epsilon` residual per out
+        edge, so a query only reads the neighborhood of its seeds [ANDERSEN]_. Ranks are underestimated by at most
+        `epsilon` times the out degree of a node.
+        """
+        return PersonalizedPagerankPlan.make(_PersonalizedPagerankPlan.ForwardPush(alpha, epsilon, top_k))
+
+
+cdef vector[pair[Node, float]] handle_result_PersonalizedPagerankTopK(
+        Result[vector[pair[Node, float]]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+cdef vector[vector[pair[Node, float]]] handle_result_PersonalizedPagerankTopKs(
+        Result[vector[vector[pair[Node, float]]]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def personalized_pagerank(Graph pg, seeds, PersonalizedPagerankPlan plan = PersonalizedPagerankPlan()):
+    """
+    Compute the Personalized Page Rank of the nodes of `pg` for a walk that restarts at one of `seeds`, chosen
+    uniformly, and return the `plan.top_k` nodes of highest rank. The query only touches the nodes near the seeds.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type seeds: list of Node IDs
+    :param seeds: The nodes the walk restarts at.
+    :type plan: PersonalizedPagerankPlan
+    :param plan: The execution plan to use.
+    :returns: A list of (node, rank) pairs in decreasing order of rank.
+    """
+    cdef vector[Node] seeds_vec = seeds
+    cdef vector[pair[Node, float]] top
+    with nogil:
+        top = handle_result_PersonalizedPagerankTopK(
+            PersonalizedPagerank(pg.underlying_property_graph(), seeds_vec, plan.underlying_))
+    return top
+
+
+def personalized_pagerank_batch(Graph pg, seeds, PersonalizedPagerankPlan plan = PersonalizedPagerankPlan()):
+    """
+    Run :py:func:`personalized_pagerank` with each node of `seeds` as the only seed. The queries run in parallel.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type seeds: list of Node IDs
+    :param seeds: The seed of each query.
+    :type plan: PersonalizedPagerankPlan
+    :param plan: The execution plan to use.
+    :returns: A list with the result of the query for each seed.
+    """
+    cdef vector[Node] seeds_vec = seeds
+    cdef vector[vector[pair[Node, float]]] tops
+    with nogil:
+        tops = handle_result_PersonalizedPagerankTopKs(
+            PersonalizedPagerankBatch(pg.underlying_property_graph(), seeds_vec, plan.underlying_))
+    return tops
@@ -0,0 +1,171 @@
+"""
+Random Walks
+------------
+
+.. autoclass:: katana.local.analytics.RandomWalksPlan
+    :members:
+    :special-members: __init__
+    :undoc-members:
+
+.. autoclass:: katana.local.analytics._random_walks._RandomWalksPlanAlgorithm
+    :members:
+    :undoc-members:
+
+.. autofunction:: katana.local.analytics.random_walks
+"""
+from libc.stdint cimport uint32_t
+from libcpp.memory cimport shared_ptr, static_pointer_cast
+from libcpp.string cimport string
+
+from pyarrow.lib cimport CArray, CLargeListArray, pyarrow_wrap_array
+
+from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libsupport.result cimport Result, raise_error_code
+from katana.local._graph cimport Graph
+from katana.local.analytics.plan cimport Plan, _Plan
+
+from enum import Enum
+
+
+cdef extern from "katana/analytics/random_walks/random_walks.h" namespace "katana::analytics" nogil:
+    cppclass _RandomWalksPlan "katana::analytics::RandomWalksPlan" (_Plan):
+        enum Algorithm:
+            kNode2Vec "katana::analytics::RandomWalksPlan::kNode2Vec"
+            kEdge2Vec "katana::analytics::RandomWalksPlan::kEdge2Vec"
+
+        _RandomWalksPlan.Algorithm algorithm() const
+        uint32_t walk_length() const
+        uint32_t number_of_walks() const
+        double backward_probability() const
+        double forward_probability() const
+        uint32_t max_iterations() const
+        uint32_t number_of_edge_types() const
+
+        RandomWalksPlan()
+
+        @staticmethod
+        _RandomWalksPlan Node2Vec(uint32_t walk_length, uint32_t number_of_walks, double backward_probability,
+                                  double forward_probability)
+
+        @staticmethod
+        _RandomWalksPlan Edge2Vec(uint32_t walk_length, uint32_t number_of_walks, double backward_probability,
+                                  double forward_probability, uint32_t max_iterations, uint32_t number_of_edge_types)
+
+    uint32_t kDefaultWalkLength "katana::analytics::RandomWalksPlan::kDefaultWalkLength"
+    uint32_t kDefaultNumberOfWalks "katana::analytics::RandomWalksPlan::kDefaultNumberOfWalks"
+    double kDefaultBackwardProbability "katana::analytics::RandomWalksPlan::kDefaultBackwardProbability"
+    double kDefaultForwardProbability "katana::analytics::RandomWalksPlan::kDefaultForwardProbability"
+    uint32_t kDefaultMaxIterations "katana::analytics::RandomWalksPlan::kDefaultMaxIterations"
+    uint32_t kDefaultNumberOfEdgeTypes "katana::analytics::RandomWalksPlan::kDefaultNumberOfEdgeTypes"
+
+    Result[shared_ptr[CLargeListArray]] RandomWalksAsArrow(_PropertyGraph* pg, string edge_weight_property_name,
+                                                           _RandomWalksPlan plan)
+
+
+class _RandomWalksPlanAlgorithm(Enum):
+    """
+    :see: :py:class:`~katana.local.analytics.RandomWalksPlan` constructors for algorithm documentation.
+    """
+    Node2Vec = _RandomWalksPlan.Algorithm.kNode2Vec
+    Edge2Vec = _RandomWalksPlan.Algorithm.kEdge2Vec
+
+
+cdef class RandomWalksPlan(Plan):
+    """
+    A computational :ref:`Plan` for Random Walks.
+
+    Static methods construct RandomWalksPlans.
+    """
+    cdef:
+        _RandomWalksPlan underlying_
+
+    cdef _Plan* underlying(self) except NULL:
+        return &self.underlying_
+
+    Algorithm = _RandomWalksPlanAlgorithm
+
+    @staticmethod
+    cdef RandomWalksPlan make(_RandomWalksPlan u):
+        f = <RandomWalksPlan>RandomWalksPlan.__new__(RandomWalksPlan)
+        f.underlying_ = u
+        return f
+
+    @property
+    def algorithm(self) -> _RandomWalksPlanAlgorithm:
+        return _RandomWalksPlanAlgorithm(self.underlying_.algorithm())
+
+    @property
+    def walk_length(self) -> int:
+        return self.underlying_.walk_length()
+
+    @property
+    def number_of_walks(self) -> int:
+        return self.underlying_.number_of_walks()
+
+    @property
+    def backward_probability(self) -> float:
+        return self.underlying_.backward_probability()
+
+    @property
+    def forward_probability(self) -> float:
+        return self.underlying_.forward_probability()
+
+    @property
+    def max_iterations(self) -> int:
+        return self.underlying_.max_iterations()
+
+    @property
+    def number_of_edge_types(self) -> int:
+        return self.underlying_.number_of_edge_types()
+
+    @staticmethod
+    def node2vec(uint32_t walk_length = kDefaultWalkLength, uint32_t number_of_walks = kDefaultNumberOfWalks,
+                 double backward_probability = kDefaultBackwardProbability,
+                 double forward_probability = kDefaultForwardProbability):
+        """
+        Node2Vec algorithm to generate random walks on the graph
+        """
+        return RandomWalksPlan.make(_RandomWalksPlan.Node2Vec(
+            walk_length, number_of_walks, backward_probability, forward_probability))
+
+    @staticmethod
+    def edge2vec(uint32_t walk_length = kDefaultWalkLength, uint32_t number_of_walks = kDefaultNumberOfWalks,
+                 double backward_probability = kDefaultBackwardProbability,
+                 double forward_probability = kDefaultForwardProbability,
+                 uint32_t max_iterations = kDefaultMaxIterations,
+                 uint32_t number_of_edge_types = kDefaultNumberOfEdgeTypes):
+        """
+        Edge2Vec algorithm to generate random walks on the graph. Takes the heterogeneity of the edges into account.
+        """
+        return RandomWalksPlan.make(_RandomWalksPlan.Edge2Vec(
+            walk_length, number_of_walks, backward_probability, forward_probability, max_iterations,
+            number_of_edge_types))
+
+
+cdef shared_ptr[CLargeListArray] handle_result_RandomWalks(Result[shared_ptr[CLargeListArray]] res) nogil except *:
+    if not res.has_value():
+        with gil:
+            raise_error_code(res.error())
+    return res.value()
+
+
+def random_walks(Graph pg, RandomWalksPlan plan = RandomWalksPlan(), str edge_weight_property_name = None):
+    """
+    Compute random walks on `pg`, which is expected to be symmetric. The walks are returned as a `pyarrow` large list
+    array of node IDs without copying them. Walk `i` starts at node `i % pg.num_nodes()` and is empty if that node has no
+    edges.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type plan: RandomWalksPlan
+    :param plan: The execution plan to use.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: If given, the numeric, non-negative edge property in proportion to which walks
+        choose edges. Otherwise all edges are equally likely.
+    """
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name or "", "utf-8")
+    cdef shared_ptr[CLargeListArray] walks
+    with nogil:
+        walks = handle_result_RandomWalks(RandomWalksAsArrow(pg.underlying_property_graph(),
+                                                             edge_weight_property_name_str, plan.underlying_))
+    return pyarrow_wrap_array(static_pointer_cast[CArray, CLargeListArray](walks))
@@ -18,14 +18,19 @@ Single-Source Shortest Path
     :undoc-members:
 
 .. autofunction:: katana.local.analytics.sssp_assert_valid
+
+.. autofunction:: katana.local.analytics.multi_source_sssp
+
+.. autofunction:: katana.local.analytics.incremental_sssp
 """
 from enum import Enum
 
 from libc.stddef cimport ptrdiff_t
 from libc.stdint cimport uint64_t
 from libcpp.string cimport string
+from libcpp.vector cimport vector
 
-from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libgalois.graphs.Graph cimport Node, _PropertyGraph
 from katana.cpp.libstd.iostream cimport ostream, ostringstream
 from katana.cpp.libsupport.result cimport Result, handle_result_assert, handle_result_void, raise_error_code
 from katana.local._graph cimport Graph
@@ -84,6 +89,12 @@ cdef extern from "katana/analytics/sssp/sssp.h" namespace "katana::analytics" no
     Result[void] SsspAssertValid(_PropertyGraph* pg, size_t start_node,
                                  const string& edge_weight_property_name, const string& output_property_name);
 
+    Result[void] MultiSourceSssp(_PropertyGraph* pg, const vector[Node]& sources,
+        const string& edge_weight_property_name, const string& output_property_name, _SsspPlan plan)
+
+    Result[void] IncrementalSssp(_PropertyGraph* pg, const vector[Node]& srcs, const vector[Node]& dests,
+        const string& edge_weight_property_name, const string& output_property_name, _SsspPlan plan)
+
     cppclass _SsspStatistics  "katana::analytics::SsspStatistics":
         uint64_t n_reached_nodes
         double max_distance
@@ -296,6 +307,61 @@ def sssp_assert_valid(Graph pg, size_t start_node, str edge_weight_property_name
         handle_result_assert(SsspAssertValid(pg.underlying_property_graph(), start_node, edge_weight_property_name_str, output_property_name_str))
 
 
+def multi_source_sssp(Graph pg, sources, str edge_weight_property_name, str output_property_name,
+                      SsspPlan plan = SsspPlan()):
+    """
+    Compute the shortest path lengths on `pg` from each node of `sources`. The sources share one delta-stepping
+    worklist, which is much faster than running :py:func:`sssp` for each. The path lengths are written to the property
+    `output_property_name` as a fixed size list per node, with one length for each source in the order of `sources`.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type sources: list of Node IDs
+    :param sources: The source nodes.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The input property containing edge weights.
+    :type output_property_name: str
+    :param output_property_name: The output property to write path lengths into. This property must not already exist.
+    :type plan: SsspPlan
+    :param plan: The execution plan to use. Only delta stepping plans are supported.
+    """
+    cdef vector[Node] sources_vec = sources
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(MultiSourceSssp(pg.underlying_property_graph(), sources_vec, edge_weight_property_name_str,
+                                           output_property_name_str, plan.underlying_))
+
+def incremental_sssp(Graph pg, srcs, dests, str edge_weight_property_name, str output_property_name,
+                     SsspPlan plan = SsspPlan()):
+    """
+    Update the path lengths that :py:func:`sssp` wrote to `output_property_name` after the weights of the edges from
+    `srcs[i]` to `dests[i]` decreased or those edges were inserted. Only the nodes whose path length shrinks are
+    visited. Weight increases and deleted edges need a new :py:func:`sssp`.
+
+    :type pg: katana.local.Graph
+    :param pg: The graph to analyze.
+    :type srcs: list of Node IDs
+    :param srcs: The sources of the changed edges.
+    :type dests: list of Node IDs
+    :param dests: The destinations of the changed edges.
+    :type edge_weight_property_name: str
+    :param edge_weight_property_name: The input property containing the new edge weights.
+    :type output_property_name: str
+    :param output_property_name: The property with the path lengths to update.
+    :type plan: SsspPlan
+    :param plan: The execution plan to use; only its delta is used.
+    """
+    cdef vector[Node] srcs_vec = srcs
+    cdef vector[Node] dests_vec = dests
+    cdef string edge_weight_property_name_str = bytes(edge_weight_property_name, "utf-8")
+    cdef string output_property_name_str = bytes(output_property_name, "utf-8")
+    with nogil:
+        handle_result_void(IncrementalSssp(pg.underlying_property_graph(), srcs_vec, dests_vec,
+                                           edge_weight_property_name_str, output_property_name_str,
+                                           plan.underlying_))
+
+
 cdef _SsspStatistics handle_result_SsspStatistics(Result[_SsspStatistics] res) nogil except *:
     if not res.has_value():
         with gil:
@@ -9,12 +9,11 @@ Subgraph Extraction
 
 .. autofunction:: katana.local.analytics.subgraph_extraction
 """
-from libc.stdint cimport uint32_t
 from libcpp.memory cimport shared_ptr, unique_ptr
 from libcpp.vector cimport vector
 from pyarrow.lib cimport to_shared
 
-from katana.cpp.libgalois.graphs.Graph cimport _PropertyGraph
+from katana.cpp.libgalois.graphs.Graph cimport Node, _PropertyGraph
 from katana.cpp.libsupport.result cimport Result, raise_error_code
 from katana.local._graph cimport Graph
 from katana.local.analytics.plan cimport Plan, _Plan
@@ -35,7 +34,7 @@ cdef extern from "katana/analytics/subgraph_extraction/subgraph_extraction.h" na
         _SubGraphExtractionPlan NodeSet(
             )
 
-    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[uint32_t]& node_vec, _SubGraphExtractionPlan plan)
+    Result[unique_ptr[_PropertyGraph]] SubGraphExtraction(_PropertyGraph* pfg, const vector[Node]& node_vec, _SubGraphExtractionPlan plan)
 
 
 class _SubGraphExtractionPlanAlgorithm(Enum):
@@ -86,7 +85,7 @@ def subgraph_extraction(Graph pg, node_vec, SubGraphExtractionPlan plan = SubGra
     Given a set of node ids, this algorithm constructs a new sub-graph which contains all nodes in the set and edges
     between them.
     """
-    cdef vector[uint32_t] vec = [<uint32_t>n for n in node_vec]
+    cdef vector[Node] vec = [<Node>n for n in node_vec]
     with nogil:
         v = handle_result_property_graph(SubGraphExtraction(pg.underlying_property_graph(), vec, plan.underlying_))
     return Graph.make(v)
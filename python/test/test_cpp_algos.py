@@ -11,6 +11,7 @@ from katana.local import Graph
 from katana.local.analytics import (
     BetweennessCentralityPlan,
     BetweennessCentralityStatistics,
+    BfsPlan,
     BfsStatistics,
     ConnectedComponentsStatistics,
     IndependentSetPlan,
@@ -21,7 +22,10 @@ from katana.local.analytics import (
     KTrussStatistics,
     LeidenClusteringStatistics,
     LouvainClusteringStatistics,
+    PagerankPlan,
     PagerankStatistics,
+    PersonalizedPagerankPlan,
+    RandomWalksPlan,
     SsspStatistics,
     TriangleCountPlan,
     betweenness_centrality,
@@ -30,6 +34,8 @@ from katana.local.analytics import (
     connected_components,
     connected_components_assert_valid,
     find_edge_sorted_by_dest,
+    incremental_pagerank,
+    incremental_sssp,
     independent_set,
     independent_set_assert_valid,
     jaccard,
@@ -43,8 +49,14 @@ from katana.local.analytics import (
     local_clustering_coefficient,
     louvain_clustering,
     louvain_clustering_assert_valid,
+    multi_source_bfs,
+    multi_source_sssp,
     pagerank,
     pagerank_assert_valid,
+    pagerank_warm_start,
+    personalized_pagerank,
+    personalized_pagerank_batch,
+    random_walks,
     sort_all_edges_by_dest,
     sort_nodes_by_degree,
     sssp,
@@ -52,6 +64,7 @@ from katana.local.analytics import (
     subgraph_extraction,
     triangle_count,
 )
+from katana.local.import_data import from_csr
 
 NODES_TO_SAMPLE = 10
 
@@ -126,6 +139,34 @@ def test_bfs(graph: Graph):
     verify_bfs(graph, start_node, new_property_id)
 
 
+def test_multi_source_bfs(graph: Graph):
+    sources = list(range(0, graph.num_nodes(), max(1, graph.num_nodes() // 70)))
+    sources.append(sources[1])
+
+    multi_source_bfs(graph, sources, "distances")
+    multi_source_bfs(graph, sources, "push_distances", BfsPlan.synchronous())
+
+    distances = graph.get_node_property("distances").to_pylist()
+    assert distances == graph.get_node_property("push_distances").to_pylist()
+    assert len(distances[0]) == len(sources)
+
+    unreachable = 2 ** 32 - 1
+    for i in [0, 1, 2, len(sources) - 1]:
+        expected = [unreachable] * graph.num_nodes()
+        expected[sources[i]] = 0
+        frontier = [sources[i]]
+        while frontier:
+            next_frontier = []
+            for n in frontier:
+                for e in graph.edges(n):
+                    dest = graph.get_edge_dest(e)
+                    if expected[dest] == unreachable:
+                        expected[dest] = expected[n] + 1
+                        next_frontier.append(dest)
+            frontier = next_frontier
+        assert [row[i] for row in distances] == expected
+
+
 def test_sssp(graph: Graph):
     property_name = "NewProp"
     weight_name = "workFrom"
@@ -151,6 +192,47 @@ def test_sssp(graph: Graph):
     verify_sssp(graph, start_node, new_property_id)
 
 
+def test_multi_source_sssp(graph: Graph):
+    weights = (np.arange(graph.num_edges(), dtype=np.uint32) % 7) + 1
+    graph.add_edge_property(table({"weight": weights}))
+    sources = [0, 1, 2, graph.num_nodes() // 2, graph.num_nodes() - 1]
+
+    multi_source_sssp(graph, sources, "weight", "lengths")
+
+    lengths = graph.get_node_property("lengths").to_pylist()
+    assert len(lengths[0]) == len(sources)
+    for i, source in enumerate(sources):
+        property_name = f"length_{i}"
+        sssp(graph, source, "weight", property_name)
+        assert [row[i] for row in lengths] == graph.get_node_property(property_name).to_pylist()
+
+
+def test_incremental_sssp(graph: Graph):
+    start_node = 0
+    weights = (np.arange(graph.num_edges(), dtype=np.uint32) % 7) + 10
+    graph.add_edge_property(table({"weight": weights}))
+    sssp(graph, start_node, "weight", "lengths")
+
+    # Make a sample of edges cheaper
+    changed = set(range(0, graph.num_edges(), 97))
+    new_weights = weights.copy()
+    new_weights[list(changed)] = 1
+    graph.add_edge_property(table({"new_weight": new_weights}))
+    srcs = []
+    dests = []
+    for n in range(graph.num_nodes()):
+        for e in graph.edges(n):
+            if e in changed:
+                srcs.append(n)
+                dests.append(graph.get_edge_dest(e))
+
+    incremental_sssp(graph, srcs, dests, "new_weight", "lengths")
+    sssp(graph, start_node, "new_weight", "expected")
+
+    assert graph.get_node_property("lengths").to_pylist() == graph.get_node_property("expected").to_pylist()
+    sssp_assert_valid(graph, start_node, "new_weight", "lengths")
+
+
 def test_jaccard(graph: Graph):
     property_name = "NewProp"
     compare_node = 0
@@ -211,6 +293,125 @@ def test_pagerank(graph: Graph):
     assert stats.average_rank == approx(0.5215466022491455, abs=0.001)
 
 
+def test_pagerank_warm_start(graph: Graph):
+    plan = PagerankPlan.push_asynchronous(tolerance=1e-4)
+    pagerank(graph, "rank", plan)
+    rank = graph.get_node_property("rank").to_numpy()
+
+    # Start from ranks that are off by up to 10%
+    scale = 1 + 0.1 * np.sin(np.arange(graph.num_nodes()))
+    graph.add_node_property(table({"initial": (rank * scale).astype(np.float32)}))
+    pagerank_warm_start(graph, "initial", "warm", plan)
+
+    assert graph.get_node_property("warm").to_numpy() == approx(rank, rel=0.01, abs=0.01)
+    pagerank_assert_valid(graph, "warm")
+
+
+def test_incremental_pagerank(graph: Graph):
+    plan = PagerankPlan.push_asynchronous(tolerance=1e-4)
+    pagerank(graph, "expected", plan)
+    expected = graph.get_node_property("expected").to_numpy()
+
+    # Corrupting the rank of a node changes the same rank equations as changing its out edges
+    changed = list(range(0, graph.num_nodes(), 101))
+    rank = expected.copy()
+    rank[changed] *= 2
+    graph.add_node_property(table({"rank": rank}))
+    incremental_pagerank(graph, changed, changed, "rank", plan)
+
+    assert graph.get_node_property("rank").to_numpy() == approx(expected, rel=0.01, abs=0.01)
+
+    with raises(GaloisError):
+        incremental_pagerank(graph, [0, 1], [0], "rank", plan)
+
+
+def test_incremental_pagerank_after_edge_updates(graph: Graph):
+    plan = PagerankPlan.push_asynchronous(tolerance=1e-4)
+    pagerank(graph, "rank", plan)
+    rank = graph.get_node_property("rank").to_numpy()
+
+    # Build the graph with a sample of edges deleted and new edges inserted
+    deleted = set(range(0, graph.num_edges(), 97))
+    inserted = [(n, (7 * n + 1) % graph.num_nodes()) for n in range(0, graph.num_nodes(), 101)]
+    srcs = []
+    dests = []
+    adjacency = []
+    for n in range(graph.num_nodes()):
+        neighbors = []
+        for e in graph.edges(n):
+            dest = graph.get_edge_dest(e)
+            if e in deleted:
+                srcs.append(n)
+                dests.append(dest)
+            else:
+                neighbors.append(dest)
+        adjacency.append(neighbors)
+    for src, dest in inserted:
+        adjacency[src].append(dest)
+        srcs.append(src)
+        dests.append(dest)
+    updated = from_csr(
+        np.cumsum([len(neighbors) for neighbors in adjacency], dtype=np.uint64),
+        np.array([dest for neighbors in adjacency for dest in neighbors], dtype=np.uint64),
+    )
+
+    updated.add_node_property(table({"rank": rank}))
+    incremental_pagerank(updated, srcs, dests, "rank", plan)
+    pagerank(updated, "expected", plan)
+
+    assert updated.get_node_property("rank").to_numpy() == approx(
+        updated.get_node_property("expected").to_numpy(), rel=0.01, abs=0.01
+    )
+
+
+def personalized_pagerank_reference(graph: Graph, seed, alpha, iterations=100):
+    srcs = np.array([n for n in range(graph.num_nodes()) for _ in graph.edges(n)], dtype=np.int64)
+    dests = np.array([graph.get_edge_dest(e) for e in range(graph.num_edges())], dtype=np.int64)
+    degrees = np.bincount(srcs, minlength=graph.num_nodes())
+    dangling = degrees == 0
+    rank = np.zeros(graph.num_nodes())
+    residual = np.zeros(graph.num_nodes())
+    residual[seed] = 1
+    for _ in range(iterations):
+        rank += (1 - alpha) * residual
+        next_residual = np.zeros(graph.num_nodes())
+        np.add.at(next_residual, dests, alpha * residual[srcs] / degrees[srcs])
+        next_residual[seed] += alpha * residual[dangling].sum()
+        residual = next_residual
+    return rank
+
+
+def test_personalized_pagerank(graph: Graph):
+    seed = 0
+    plan = PersonalizedPagerankPlan.forward_push(epsilon=1e-7, top_k=20)
+
+    top = personalized_pagerank(graph, [seed], plan)
+
+    assert 0 < len(top) <= 20
+    ranks = [rank for _, rank in top]
+    assert ranks == sorted(ranks, reverse=True)
+    assert sum(ranks) <= 1 + 1e-4
+    expected = personalized_pagerank_reference(graph, seed, plan.alpha)
+    for node, rank in top:
+        assert rank == approx(expected[node], abs=1e-3)
+
+    with raises(GaloisError):
+        personalized_pagerank(graph, [graph.num_nodes()])
+    with raises(GaloisError):
+        personalized_pagerank(graph, [])
+
+
+def test_personalized_pagerank_batch(graph: Graph):
+    seeds = [0, 1, 2, graph.num_nodes() // 2, graph.num_nodes() - 1]
+    plan = PersonalizedPagerankPlan.forward_push(top_k=10)
+
+    tops = personalized_pagerank_batch(graph, seeds, plan)
+
+    assert len(tops) == len(seeds)
+    for seed, top in zip(seeds, tops):
+        assert top == personalized_pagerank(graph, [seed], plan)
+
+
 def test_betweenness_centrality_outer(graph: Graph):
     property_name = "NewProp"
 
@@ -419,3 +620,41 @@ def test_busy_wait(graph: Graph):
     # Verify with numba implementation of verifier as well
     verify_bfs(graph, start_node, new_property_id)
     set_busy_wait(0)
+
+
+def test_random_walks(graph: Graph):
+    walk_length = 5
+    walks = random_walks(graph, RandomWalksPlan.node2vec(walk_length, 2))
+
+    assert len(walks) == 2 * graph.num_nodes()
+    edges = {(n, graph.get_edge_dest(e)) for n in range(graph.num_nodes()) for e in graph.edges(n)}
+    for i, walk in enumerate(walks.to_pylist()):
+        assert len(walk) <= walk_length + 1
+        if len(graph.edges(i % graph.num_nodes())) == 0:
+            assert not walk
+            continue
+        assert walk[0] == i % graph.num_nodes()
+        assert all((src, dest) in edges for src, dest in zip(walk, walk[1:]))
+
+
+def test_random_walks_weighted(graph: Graph):
+    weights = (np.arange(graph.num_edges()) % 3 == 0).astype(np.float64)
+    graph.add_edge_property(table({"weight": weights}))
+
+    walks = random_walks(graph, RandomWalksPlan.node2vec(5, 1), "weight")
+
+    # Walks only take edges of weight 0 out of nodes that have no other edges
+    weighted = set()
+    has_weighted_edge = set()
+    for n in range(graph.num_nodes()):
+        for e in graph.edges(n):
+            if weights[e] > 0:
+                weighted.add((n, graph.get_edge_dest(e)))
+                has_weighted_edge.add(n)
+    for walk in walks.to_pylist():
+        for src, dest in zip(walk, walk[1:]):
+            assert (src, dest) in weighted or src not in has_weighted_edge
+
+    graph.add_edge_property(table({"negative_weight": -weights}))
+    with raises(GaloisError):
+        random_walks(graph, RandomWalksPlan.node2vec(5, 1), "negative_weight")